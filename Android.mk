@@ -17,16 +17,21 @@ LOCAL_EXPORT_C_INCLUDES := $(LOCAL_C_INCLUDES)
 LOCAL_SRC_FILES := \
         $(LOCAL_PATH)/synth.c \
         $(LOCAL_PATH)/synth_audio.c \
+        $(LOCAL_PATH)/synth_cache.c \
+        $(LOCAL_PATH)/synth_cursor.c \
         $(LOCAL_PATH)/synth_lexer.c \
+        $(LOCAL_PATH)/synth_list.c \
+        $(LOCAL_PATH)/synth_mixer.c \
         $(LOCAL_PATH)/synth_note.c \
         $(LOCAL_PATH)/synth_parser.c \
         $(LOCAL_PATH)/synth_prng.c \
         $(LOCAL_PATH)/synth_renderer.c \
+        $(LOCAL_PATH)/synth_segments.c \
         $(LOCAL_PATH)/synth_track.c \
         $(LOCAL_PATH)/synth_volume.c
 
 LOCAL_SHARED_LIBRARIES := SDL2
-LOCAL_CFLAGS += -DUSE_SDL2
+LOCAL_CFLAGS += -DUSE_SDL2 -DUSE_PTHREAD
 LOCAL_LDLIBS := -ldl -landroid
 
 include $(BUILD_SHARED_LIBRARY)
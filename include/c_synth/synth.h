@@ -9,6 +9,30 @@ typedef struct stSynthCtx synthCtx;
 
 #endif /* __SYNTHCTX_STRUCT__ */
 
+#ifndef __SYNTHCURSOR_STRUCT__
+#define __SYNTHCURSOR_STRUCT__
+
+/** 'Export' the synthCursor struct */
+typedef struct stSynthCursor synthCursor;
+
+#endif /* __SYNTHCURSOR_STRUCT__ */
+
+#ifndef __SYNTHSEGMENTS_STRUCT__
+#define __SYNTHSEGMENTS_STRUCT__
+
+/** 'Export' the synthSegments struct */
+typedef struct stSynthSegments synthSegments;
+
+#endif /* __SYNTHSEGMENTS_STRUCT__ */
+
+#ifndef __SYNTHSESSION_STRUCT__
+#define __SYNTHSESSION_STRUCT__
+
+/** 'Export' the synthSession struct */
+typedef struct stSynthSession synthSession;
+
+#endif /* __SYNTHSESSION_STRUCT__ */
+
 #ifndef __SYNTHBUFMODE_ENUM__
 #define __SYNTHBUFMODE_ENUM__
 
@@ -40,6 +64,23 @@ typedef enum enSynthBufMode synthBufMode;
 
 #endif /* __SYNTHBUFMODE_ENUM__ */
 
+#ifndef __SYNTHNOISEMODE_ENUM__
+#define __SYNTHNOISEMODE_ENUM__
+
+/* Define how noise waves (w5 to w10) are generated */
+enum enSynthNoiseMode {
+    /* Gaussian white noise (the default) */
+    SYNTH_NOISE_GAUSSIAN = 0,
+    /* Uniform noise from a linear-feedback shift register, like the one used
+     * by chiptune hardware; Much cheaper than the gaussian one */
+    SYNTH_NOISE_LFSR
+};
+
+/* Export the noise mode enum */
+typedef enum enSynthNoiseMode synthNoiseMode;
+
+#endif /* __SYNTHNOISEMODE_ENUM__ */
+
 #ifndef __SYNTH_H__
 #define __SYNTH_H__
 
@@ -82,9 +123,14 @@ synth_err synth_getContextSize(int *pSize, synthCtx *pCtx);
  * version, so the required memory to whatever is desired is calculated, before
  * trying to use this mode;
  * 
+ * Every song, track, note and volume (as well as each track's timeline and
+ * loops) is taken from 'pMem', and compiling a song that would exceed any of
+ * the limits fails with SYNTH_MEM_ERR. Rendered notes aren't cached, since the
+ * cache is dynamically alloc'ed (see 'synth_setNoteCacheSize')
+ * 
  * @param  [out]ppCtx      The new synthesizer context
- * @param  [ in]pMem       'synth_getContextSize' bytes or NULL, if the library
- *                         should alloc the structure however it wants
+ * @param  [ in]pMem       'synth_getStaticContextSize' bytes or NULL, if the
+ *                         library should alloc the structure however it wants
  * @param  [ in]freq       Synthesizer frequency, in samples per seconds
  * @param  [ in]maxSongs   How many songs can be compiled at the same time
  * @param  [ in]maxTracks  How many tracks can be used through all songs
@@ -147,14 +193,75 @@ synth_err synth_compileSongFromFile(int *pHandle, synthCtx *pCtx,
  * @param  [out]pHandle Handle of the loaded song
  * @param  [ in]pCtx    The synthesizer context
  * @param  [ in]pString Song's MML
- * @param  [ in]length  The string's length (must contain the NULL-terminator!)
+ * @param  [ in]length  The string's length (the NULL-terminator must follow it)
  * @param               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR, ...
  */
 synth_err synth_compileSongFromString(int *pHandle, synthCtx *pCtx,
         char *pString, int length);
 
 #define synth_compileSongFromStringStatic(pHandle, pCtx, pString) \
-  synth_compileSongFromString(pHandle, pCtx, pString, sizeof(pString))
+  synth_compileSongFromString(pHandle, pCtx, pString, sizeof(pString) - 1)
+
+/**
+ * Release a compiled song, so its notes, tracks and loops may be reused by
+ * songs compiled later; The song's volumes are kept, since those are shared by
+ * every song
+ * 
+ * The handle (as well as any cursor of the song) becomes invalid, and using it
+ * fails with SYNTH_INVALID_INDEX, even after another song reuses its memory
+ * 
+ * On static contexts, every song compiled after it is moved back over its
+ * memory, so the context's whole free space may be used by the next song
+ * 
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]handle Handle of the audio
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                     SYNTH_MEM_ERR
+ */
+synth_err synth_freeSong(synthCtx *pCtx, int handle);
+
+/**
+ * Save a compiled song into a file, so it may later be loaded (see
+ * 'synth_loadCompiled') without compiling its MML again
+ * 
+ * The file may only be loaded by contexts with the same frequency, but it
+ * doesn't depend on any other song nor on the machine's byte order
+ * 
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]handle    Handle of the audio
+ * @param  [ in]pFilename The file
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                        SYNTH_MEM_ERR, SYNTH_OPEN_FILE_ERR
+ */
+synth_err synth_saveCompiled(synthCtx *pCtx, int handle, char *pFilename);
+
+/**
+ * Load a song previously saved by 'synth_saveCompiled' (and already read into
+ * memory); The buffer isn't referenced after the song is loaded
+ * 
+ * @param  [out]pHandle Handle of the loaded song
+ * @param  [ in]pCtx    The synthesizer context
+ * @param  [ in]pData   The saved song
+ * @param  [ in]length  The saved song's length, in bytes
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR,
+ *                      SYNTH_INVALID_COMPILED_SONG
+ */
+synth_err synth_loadCompiledFromMemory(int *pHandle, synthCtx *pCtx,
+        void *pData, int length);
+
+/**
+ * Load a song previously saved by 'synth_saveCompiled' from a file
+ * 
+ * The file is mapped read-only (if supported by the system) and the song is
+ * loaded straight from the mapping, so nothing is lexed nor parsed
+ * 
+ * @param  [out]pHandle   Handle of the loaded song
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pFilename The file
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR,
+ *                        SYNTH_OPEN_FILE_ERR, SYNTH_INVALID_COMPILED_SONG
+ */
+synth_err synth_loadCompiled(int *pHandle, synthCtx *pCtx, char *pFilename);
 
 /**
  * Return a string representing the compiler error raised
@@ -282,10 +389,359 @@ synth_err synth_getSongIntroLength(int *pLen, synthCtx *pCtx, int handle);
  * @param  [ in]mode   Desired mode for the song
  * @param  [ in]pTmp   Temporary buffer that will be filled with each track
  * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
- *                     SYNTH_COMPLEX_LOOPPOINT
+ *                     SYNTH_COMPLEX_LOOPPOINT, SYNTH_MEM_ERR,
+ *                     SYNTH_THREAD_INIT_FAILED
  */
 synth_err synth_renderSong(char *pBuf, synthCtx *pCtx, int handle,
         synthBufMode mode, char *pTmp);
 
+/**
+ * Set how many threads may be used to render a song's tracks
+ * 
+ * The song is split into ranges, one for each thread (the calling one
+ * included), and each thread mixes its range of every track, so the rendered
+ * song is exactly the same regardless of the number of threads; Only
+ * 'synth_renderSong' is affected
+ * 
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]numThreads Maximum number of threads (1 disables threading)
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR,
+ *                         SYNTH_FUNCTION_NOT_IMPLEMENTED (if the library was
+ *                         built without threads support)
+ */
+synth_err synth_setRenderThreads(synthCtx *pCtx, int numThreads);
+
+/**
+ * Set whether the context's lists are shrunk to fit after each compiled song
+ * 
+ * Songs, tracks, notes and volumes are alloc'ed in blocks, so some of those
+ * (as well as part of the timeline and loops) may be left unused after a song
+ * is compiled; Shrinking releases them, at the cost of re-alloc'ing the last
+ * block when the next song is compiled. Static contexts are never shrunk
+ * 
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]doShrink 1 to shrink the lists, 0 to keep them (the default)
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_setShrinkToFit(synthCtx *pCtx, int doShrink);
+
+/**
+ * Alloc a new cursor, so a song may be rendered in chunks
+ * 
+ * The cursor keeps track of where each of the song's tracks stopped, so the
+ * song may be continually rendered (e.g., from an audio callback) without
+ * buffering it completely
+ * 
+ * @param  [out]ppCursor The new cursor
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]handle   Handle of the audio
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                       SYNTH_MEM_ERR
+ */
+synth_err synth_initCursor(synthCursor **ppCursor, synthCtx *pCtx, int handle);
+
+/**
+ * Place a cursor back at the start of its song
+ * 
+ * @param  [ in]pCursor The cursor
+ * @param  [ in]pCtx    The synthesizer context
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX
+ */
+synth_err synth_resetCursor(synthCursor *pCursor, synthCtx *pCtx);
+
+/**
+ * Release a cursor
+ * 
+ * @param  [ in]ppCursor The cursor
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_freeCursor(synthCursor **ppCursor);
+
+/**
+ * Retrieve how many samples were rendered through a cursor
+ * 
+ * @param  [out]pPos    The cursor's position, in samples
+ * @param  [ in]pCursor The cursor
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_getCursorPosition(int *pPos, synthCursor *pCursor);
+
+/**
+ * Render the next chunk of a song, starting wherever the cursor stopped
+ * 
+ * Tracks that loop go back to their loop point as soon as they end, while the
+ * other ones output silence; Therefore, the song may be played indefinitely.
+ * Since the song's peak can't be known beforehand, any overflowing sample is
+ * clamped to the mode's range
+ * 
+ * @param  [ in]pBuf       Buffer that will be filled with the chunk; It must
+ *                         have 'numSamples' times the number of bytes per
+ *                         samples
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]handle     Handle of the audio
+ * @param  [ in]pCursor    Cursor initialized for the same audio
+ * @param  [ in]numSamples How many samples should be rendered
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                         SYNTH_MEM_ERR
+ */
+synth_err synth_renderSongChunk(char *pBuf, synthCtx *pCtx, int handle,
+        synthCursor *pCursor, int numSamples, synthBufMode mode);
+
+/**
+ * Render a range of a song, starting at any of its samples
+ * 
+ * Only the requested samples are rendered: the note under 'startSample' is
+ * found on each track's timeline (built when the song is compiled), so seeking
+ * doesn't depend on how far into the song the range is. Tracks that loop go
+ * back to their loop point as soon as they end, while the other ones output
+ * silence; Therefore, the range may be anywhere after the song's start. Every
+ * track matches the one rendered by 'synth_renderTrack' but, since the song's
+ * peak isn't known, any overflowing sample is clamped to the mode's range (as
+ * in 'synth_renderSongChunk')
+ * 
+ * @param  [ in]pBuf        Buffer that will be filled with the range; It must
+ *                          have 'numSamples' times the number of bytes per
+ *                          samples
+ * @param  [ in]pCtx        The synthesizer context
+ * @param  [ in]handle      Handle of the audio
+ * @param  [ in]startSample First sample to be rendered
+ * @param  [ in]numSamples  How many samples should be rendered
+ * @param  [ in]mode        Desired mode for the song
+ * @return                  SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                          SYNTH_MEM_ERR
+ */
+synth_err synth_renderSongRange(char *pBuf, synthCtx *pCtx, int handle,
+        int startSample, int numSamples, synthBufMode mode);
+
+/**
+ * Select how noise waves are generated
+ * 
+ * Every song rendered afterward (as well as every session and cursor created
+ * afterward) uses the selected generator
+ * 
+ * @param  [ in]pCtx The synthesizer context
+ * @param  [ in]mode The noise generator
+ * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_setNoiseMode(synthCtx *pCtx, synthNoiseMode mode);
+
+/**
+ * Set the seed from which every noise is generated
+ * 
+ * Noises only depend on this seed and on their position within the song (and
+ * not on the order in which songs, tracks or chunks are rendered), so a song
+ * rendered with the same seed always sounds the same; By default, contexts are
+ * seeded with the current time
+ * 
+ * @param  [ in]pCtx The synthesizer context
+ * @param  [ in]seed The seed
+ * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_setNoiseSeed(synthCtx *pCtx, unsigned int seed);
+
+/**
+ * Alloc a new rendering session for a synthesizer context
+ * 
+ * A session holds all the state that is modified while rendering, so many
+ * threads may render songs from the same context concurrently (as long as each
+ * uses its own session and no song is compiled meanwhile); Only
+ * 'synth_renderTrackSession', 'synth_renderSongSession',
+ * 'synth_renderSongRangeSession', 'synth_initCursorSession' and the functions
+ * that retrieve a song's attributes (e.g., 'synth_getSongLength') may be used
+ * concurrently
+ * 
+ * The session has its own cache of rendered notes, with the same size as the
+ * context's one (see 'synth_setNoteCacheSize'), and uses the context's noise
+ * generator (see 'synth_setNoiseMode')
+ * 
+ * @param  [out]ppSession The new session
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]seed      Seed for the session's pseudo-random number generator
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synth_initSession(synthSession **ppSession, synthCtx *pCtx,
+        unsigned int seed);
+
+/**
+ * Release a rendering session
+ * 
+ * @param  [ in]ppSession The session
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_freeSession(synthSession **ppSession);
+
+/**
+ * Render a track into a buffer, modifying only the session
+ * 
+ * See 'synth_renderTrack'
+ * 
+ * @param  [ in]pBuf     Buffer that will be filled with the track
+ * @param  [ in]pSession The rendering session
+ * @param  [ in]handle   Handle of the audio
+ * @param  [ in]track    The track
+ * @param  [ in]mode     Desired mode for the wave
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX
+ */
+synth_err synth_renderTrackSession(char *pBuf, synthSession *pSession,
+        int handle, int track, synthBufMode mode);
+
+/**
+ * Render all of a song's tracks into a buffer, modifying only the session
+ * 
+ * See 'synth_renderSong'
+ * 
+ * @param  [ in]pBuf     Buffer that will be filled with the song
+ * @param  [ in]pSession The rendering session
+ * @param  [ in]handle   Handle of the audio
+ * @param  [ in]mode     Desired mode for the song
+ * @param  [ in]pTmp     Temporary buffer that will be filled with each track
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                       SYNTH_COMPLEX_LOOPPOINT, SYNTH_MEM_ERR,
+ *                       SYNTH_THREAD_INIT_FAILED
+ */
+synth_err synth_renderSongSession(char *pBuf, synthSession *pSession,
+        int handle, synthBufMode mode, char *pTmp);
+
+/**
+ * Alloc a new cursor, copying the session's PRNG (so the cursor renders the
+ * same noises as the session)
+ * 
+ * The cursor may then be rendered with 'synth_renderSongChunk', which only
+ * modifies the cursor
+ * 
+ * @param  [out]ppCursor The new cursor
+ * @param  [ in]pSession The rendering session
+ * @param  [ in]handle   Handle of the audio
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                       SYNTH_MEM_ERR
+ */
+synth_err synth_initCursorSession(synthCursor **ppCursor,
+        synthSession *pSession, int handle);
+
+/**
+ * Render a range of a song, modifying only the session
+ * 
+ * See 'synth_renderSongRange'
+ * 
+ * @param  [ in]pBuf        Buffer that will be filled with the range
+ * @param  [ in]pSession    The rendering session
+ * @param  [ in]handle      Handle of the audio
+ * @param  [ in]startSample First sample to be rendered
+ * @param  [ in]numSamples  How many samples should be rendered
+ * @param  [ in]mode        Desired mode for the song
+ * @return                  SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                          SYNTH_MEM_ERR
+ */
+synth_err synth_renderSongRangeSession(char *pBuf, synthSession *pSession,
+        int handle, int startSample, int numSamples, synthBufMode mode);
+
+/**
+ * Set how many bytes of rendered notes may be kept by the context
+ * 
+ * Whenever a note is rendered again (with the same wave, pitch, length, volume,
+ * envelope and pan) it's simply copied from this cache; Noises are never
+ * cached. Changing the size releases every cached note
+ * 
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]maxBytes Size of the cache (0 disables it)
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_setNoteCacheSize(synthCtx *pCtx, int maxBytes);
+
+/**
+ * Retrieve how effective the context's cache of rendered notes has been
+ * 
+ * @param  [out]pHits   How many notes were copied from the cache
+ * @param  [out]pMisses How many (non-noise) notes had to be rendered
+ * @param  [out]pBytes  How many bytes are currently used by the cache
+ * @param  [ in]pCtx    The synthesizer context
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_getNoteCacheStats(int *pHits, int *pMisses, int *pBytes,
+        synthCtx *pCtx);
+
+/**
+ * Retrieve how effective a session's cache of rendered notes has been
+ * 
+ * @param  [out]pHits    How many notes were copied from the cache
+ * @param  [out]pMisses  How many (non-noise) notes had to be rendered
+ * @param  [out]pBytes   How many bytes are currently used by the cache
+ * @param  [ in]pSession The rendering session
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_getSessionNoteCacheStats(int *pHits, int *pMisses,
+        int *pBytes, synthSession *pSession);
+
+/**
+ * Render every note of a song only once, so it may be played back from a list
+ * of segments
+ * 
+ * Repeated loops reference the samples rendered for their first iteration,
+ * instead of copying them, so the song takes only as much memory as its unique
+ * notes. Playback behaves just like a cursor (i.e., looping tracks go back to
+ * their loop point and overflowing samples are clamped)
+ * 
+ * @param  [out]ppSegments The new segmented song
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]handle     Handle of the audio
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                         SYNTH_MEM_ERR
+ */
+synth_err synth_initSegments(synthSegments **ppSegments, synthCtx *pCtx,
+        int handle, synthBufMode mode);
+
+/**
+ * Render every note of a song only once, modifying only the session
+ * 
+ * @param  [out]ppSegments The new segmented song
+ * @param  [ in]pSession   The rendering session
+ * @param  [ in]handle     Handle of the audio
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                         SYNTH_MEM_ERR
+ */
+synth_err synth_initSegmentsSession(synthSegments **ppSegments,
+        synthSession *pSession, int handle, synthBufMode mode);
+
+/**
+ * Play the next samples of a segmented song
+ * 
+ * @param  [ in]pBuf       Buffer that will be filled with the samples; It must
+ *                         have 'numSamples' times the number of bytes per
+ *                         samples (in the mode used by the segmented song)
+ * @param  [ in]pSegments  The segmented song
+ * @param  [ in]numSamples How many samples should be played
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_renderSegments(char *pBuf, synthSegments *pSegments,
+        int numSamples);
+
+/**
+ * Place a segmented song back at its start
+ * 
+ * @param  [ in]pSegments The segmented song
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_resetSegments(synthSegments *pSegments);
+
+/**
+ * Retrieve how many bytes are used by a segmented song
+ * 
+ * @param  [out]pBytes    Size of the rendered notes and of the segments
+ * @param  [ in]pSegments The segmented song
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_getSegmentsSize(int *pBytes, synthSegments *pSegments);
+
+/**
+ * Release a segmented song
+ * 
+ * @param  [ in]ppSegments The segmented song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_freeSegments(synthSegments **ppSegments);
+
 #endif /* __SYNTH_H__ */
 
@@ -35,6 +35,8 @@ typedef enum {
     SYNTH_BAD_LOOP_START,
     SYNTH_BAD_LOOP_END,
     SYNTH_BAD_LOOP_POINT,
+    SYNTH_BAD_LOOP_COUNT,
+    SYNTH_INVALID_COMPILED_SONG,
     SYNTH_MAX_ERR
 } synth_err;
 
@@ -10,7 +10,18 @@
 #include <c_synth_internal/synth_types.h>
 
 /**
- * Initialize a new audio, so a song can be compiled into it
+ * How many bits of a song's handle are its index; The remaining ones are its
+ * generation, which is increased every time the song is released
+ */
+#define SYNTHAUDIO_INDEX_BITS 20
+/** Mask of a handle's index */
+#define SYNTHAUDIO_INDEX_MASK ((1 << SYNTHAUDIO_INDEX_BITS) - 1)
+/** Mask of a handle's generation (so handles are never negative) */
+#define SYNTHAUDIO_GENERATION_MASK ((1 << (31 - SYNTHAUDIO_INDEX_BITS)) - 1)
+
+/**
+ * Initialize a new audio, so a song can be compiled into it; Songs released by
+ * 'synthAudio_free' are reused before expanding the list
  * 
  * @param  [out]pAudio Object that will be filled with the compiled song
  * @param  [ in]pCtx   The synthesizer context
@@ -18,6 +29,41 @@
  */
 synth_err synthAudio_init(synthAudio **ppAudio, synthCtx *pCtx);
 
+/**
+ * Retrieve a compiled song from its handle
+ * 
+ * @param  [out]ppAudio The audio
+ * @param  [ in]pCtx    The synthesizer context
+ * @param  [ in]handle  Handle of the audio
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX
+ */
+synth_err synthAudio_getFromHandle(synthAudio **ppAudio, synthCtx *pCtx,
+        int handle);
+
+/**
+ * Release a song, so both the audio and every item used by it (but its
+ * volumes, which are shared by every song) may be reused by another one; Any
+ * handle to the song is invalidated
+ * 
+ * On static contexts, the items of every song compiled after it are moved
+ * back, so the released memory is always at the end of the lists
+ * 
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthAudio_free(synthAudio *pAudio, synthCtx *pCtx);
+
+/**
+ * Release an audio whose song failed to compile, along with every item that
+ * was already used by it
+ * 
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthAudio_discard(synthAudio *pAudio, synthCtx *pCtx);
+
 /**
  * Compile a MML audio SDL_RWops into an object
  * 
@@ -49,6 +95,42 @@ synth_err synthAudio_compileFile(synthAudio *pAudio, synthCtx *pCtx,
 synth_err synthAudio_compileString(synthAudio *pAudio, synthCtx *pCtx,
         char *pString, int len);
 
+/**
+ * Save a compiled song into a newly alloc'ed buffer, which may later be loaded
+ * (by 'synthAudio_load') without compiling the song again
+ * 
+ * Only the volumes used by the song are saved, and every note references those
+ * by its position among them
+ * 
+ * @param  [out]ppData The saved song; Must be freed by the caller
+ * @param  [out]pLen   The saved song's length, in bytes
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthAudio_save(char **ppData, int *pLen, synthAudio *pAudio,
+        synthCtx *pCtx);
+
+/**
+ * Load a song saved by 'synthAudio_save' into an audio, without compiling it
+ * again; Everything is loaded at the end of every list and then moved into
+ * ranges released by previous songs, just like a compiled song
+ * 
+ * Only the notes and loops are loaded; Every length (as well as the timelines
+ * and whether the song loops) is then calculated by the same code that runs
+ * after a song is compiled, so a corrupted song can't make rendering go past
+ * its buffers
+ * 
+ * @param  [ in]pAudio Object that will be filled with the loaded song
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]pData  The saved song
+ * @param  [ in]len    The saved song's length, in bytes
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR,
+ *                     SYNTH_INVALID_COMPILED_SONG
+ */
+synth_err synthAudio_load(synthAudio *pAudio, synthCtx *pCtx, char *pData,
+        int len);
+
 /**
  * Return the audio BPM
  * 
@@ -76,6 +158,34 @@ synth_err synthAudio_getTimeSignature(int *pTime, synthAudio *pAudio);
  */
 synth_err synthAudio_getTrackCount(int *pNum, synthAudio *pAudio);
 
+/**
+ * Retrieve the length, in samples, of the longest track in a song
+ * 
+ * @param  [out]pLen   The length of the song
+ * @param  [ in]pAudio The audio
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthAudio_getLength(int *pLen, synthAudio *pAudio);
+
+/**
+ * Retrieve the number of samples until a song's loop point
+ * 
+ * @param  [out]pLen   The length of the song's intro
+ * @param  [ in]pAudio The audio
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_COMPLEX_LOOPPOINT,
+ *                     SYNTH_NOT_LOOPABLE
+ */
+synth_err synthAudio_getIntroLength(int *pLen, synthAudio *pAudio);
+
+/**
+ * Check whether a song can loop nicely in a single iteration
+ * 
+ * @param  [ in]pAudio The audio
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_COMPLEX_LOOPPOINT,
+ *                     SYNTH_NOT_LOOPABLE
+ */
+synth_err synthAudio_canLoop(synthAudio *pAudio);
+
 /**
  * Retrieve the number of samples in a track
  * 
@@ -117,15 +227,74 @@ synth_bool synthAudio_isTrackLoopable(synthAudio *pAudio, synthCtx *pCtx,
  * The buffer must be prepared by the caller, and it must have
  * 'synth_getTrackLength' bytes times the number of bytes per samples
  * 
+ * Only 'pPRNG' and 'pCache' are modified, so tracks may be rendered
+ * concurrently
+ * 
  * @param  [ in]pBuf   Buffer that will be filled with the track
  * @param  [ in]pAudio The audio
  * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]pPRNG  Pseudo-random number generator used by noises
+ * @param  [ in]pCache Cache of rendered notes (may be NULL)
  * @param  [ in]pTrack The track
  * @param  [ in]mode   Desired mode for the wave
  * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
  */
 synth_err synthAudio_renderTrack(char *pBuf, synthAudio *pAudio, synthCtx *pCtx,
-        int track, synthBufMode mode);
+        synthPRNGCtx *pPRNG, synthCache *pCache, int track,
+        synthBufMode mode);
+
+/**
+ * Render every track of an audio and accumulate them into a bus
+ * 
+ * If the context allows it (see 'synth_setRenderThreads'), the song is split
+ * into as many ranges as there are threads, and each thread renders its range
+ * of every track (from the tracks' timelines) into its range of 'pTmp' and
+ * 'pBus'. Noises are counter-based (and each track uses its own copy of
+ * 'pPRNG'), so the result doesn't depend on the number of threads
+ * 
+ * Each thread only stores notes into its own cache, which looks up 'pCache'
+ * and may keep an equal share of what's left of it. Those are merged into
+ * 'pCache' once every thread is done
+ * 
+ * @param  [ in]pBus    Bus with the length of the whole song (cleared)
+ * @param  [ in]pTmp    Temporary buffer where tracks are rendered, with the
+ *                      length of the longest track
+ * @param  [ in]pAudio  The audio
+ * @param  [ in]pCtx    The synthesizer context
+ * @param  [ in]pPRNG   PRNG copied for each track (left unmodified)
+ * @param  [ in]pCache  Cache of rendered notes (may be NULL)
+ * @param  [ in]songLen Length of the song, in samples
+ * @param  [ in]mode    Desired mode for the song
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR,
+ *                      SYNTH_THREAD_INIT_FAILED
+ */
+synth_err synthAudio_mixTracks(int *pBus, char *pTmp, synthAudio *pAudio,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, synthCache *pCache, int songLen,
+        synthBufMode mode);
+
+/**
+ * Render a range of every track of an audio and mix them into a buffer
+ * 
+ * Each track is rendered from its timeline (see 'synthTrack_renderRange'), so
+ * the range may start anywhere in the song without rendering what comes before
+ * it. Since the song's peak isn't known, overflowing samples are clamped to
+ * the mode's range (as when the song is rendered in chunks)
+ * 
+ * @param  [ in]pBuf       Buffer that will be filled with 'numSamples'
+ * @param  [ in]pTmp       Temporary buffer with 'numSamples', where each track
+ *                         is rendered
+ * @param  [ in]pAudio     The audio
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]pPRNG      PRNG copied for each track (left unmodified)
+ * @param  [ in]pCache     Cache of rendered notes (may be NULL)
+ * @param  [ in]position   First sample to be rendered
+ * @param  [ in]numSamples How many samples should be rendered
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthAudio_renderRange(char *pBuf, char *pTmp, synthAudio *pAudio,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, synthCache *pCache, int position,
+        int numSamples, synthBufMode mode);
 
 #endif /* __SYNTH_INTERNAL_AUDIO_H__ */
 
@@ -0,0 +1,67 @@
+/**
+ * @file src/include/c_synth_internal/synth_cache.h
+ *
+ * Cache of rendered notes, so repeated notes are copied instead of synthesized
+ */
+#ifndef __SYNTH_INTERNAL_CACHE_H__
+#define __SYNTH_INTERNAL_CACHE_H__
+
+#include <c_synth/synth.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_types.h>
+
+/** Default number of bytes of rendered notes kept by a cache */
+#define SYNTH_DEFAULT_CACHE_SIZE (4 * 1024 * 1024)
+
+/**
+ * Initialize an empty cache
+ * 
+ * @param  [ in]pCache   The cache
+ * @param  [ in]maxBytes How many bytes of rendered notes may be kept (0
+ *                       disables the cache)
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthCache_init(synthCache *pCache, int maxBytes);
+
+/**
+ * Release every cached note (but keep the cache's size and statistics)
+ * 
+ * @param  [ in]pCache The cache
+ */
+void synthCache_clear(synthCache *pCache);
+
+/**
+ * Move every note of a cache into another one (as long as it fits and it isn't
+ * already there) and account its statistics into the other
+ * 
+ * The source cache is left empty (but keeps its size and statistics)
+ * 
+ * @param  [ in]pDst The cache that receives the notes
+ * @param  [ in]pSrc The cache whose notes are moved
+ */
+void synthCache_merge(synthCache *pDst, synthCache *pSrc);
+
+/**
+ * Render a note into a buffer, copying it from the cache if it was already
+ * rendered with the same parameters
+ * 
+ * Noises are never cached, since they depend on the PRNG
+ * 
+ * @param  [ in]pBuf     Buffer that will be filled with the note
+ * @param  [ in]pCache   The cache (may be NULL, to always render the note)
+ * @param  [ in]pNote    The note
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]pPRNG    Pseudo-random number generator used by noises
+ * @param  [ in]track    Position of the note's track within its song
+ * @param  [ in]index    Position of the note within its track
+ * @param  [ in]mode     Desired mode for the wave
+ * @param  [ in]duration The note's length in samples
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthCache_render(char *pBuf, synthCache *pCache, synthNote *pNote,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, int track, int index,
+        synthBufMode mode, int duration);
+
+#endif /* __SYNTH_INTERNAL_CACHE_H__ */
+
@@ -0,0 +1,66 @@
+/**
+ * Persistent playback position within a song, so it may be rendered in chunks
+ *
+ * @file src/include/c_synth_internal/synth_cursor.h
+ */
+#ifndef __SYNTH_INTERNAL_CURSOR_H__
+#define __SYNTH_INTERNAL_CURSOR_H__
+
+#include <c_synth/synth.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_types.h>
+
+/**
+ * Alloc a new cursor, placed at the start of a song
+ *
+ * The cursor has its own copy of 'pPRNG', so rendering it doesn't modify
+ * anything but the cursor itself (and its noises match the complete song's)
+ *
+ * @param  [out]ppCursor The new cursor
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]pPRNG    PRNG copied into the cursor
+ * @param  [ in]handle   Handle of the audio
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                       SYNTH_MEM_ERR
+ */
+synth_err synthCursor_init(synthCursor **ppCursor, synthCtx *pCtx,
+        synthPRNGCtx *pPRNG, int handle);
+
+/**
+ * Place the cursor back at the start of its song
+ *
+ * @param  [ in]pCursor The cursor
+ * @param  [ in]pCtx    The synthesizer context
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX
+ */
+synth_err synthCursor_reset(synthCursor *pCursor, synthCtx *pCtx);
+
+/**
+ * Release all memory alloc'ed by a cursor
+ *
+ * @param  [ in]ppCursor The cursor
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthCursor_free(synthCursor **ppCursor);
+
+/**
+ * Render the next samples of the cursor's song, advancing the cursor
+ *
+ * Every track is rendered from wherever it stopped on the previous call and
+ * looping tracks go back to their loop point once they end; Tracks that don't
+ * loop output silence after ending
+ *
+ * @param  [ in]pBuf       Buffer that will be filled with 'numSamples'
+ * @param  [ in]pCursor    The cursor
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]numSamples How many samples should be rendered
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                         SYNTH_MEM_ERR
+ */
+synth_err synthCursor_render(char *pBuf, synthCursor *pCursor, synthCtx *pCtx,
+        int numSamples, synthBufMode mode);
+
+#endif /* __SYNTH_INTERNAL_CURSOR_H__ */
+
@@ -0,0 +1,168 @@
+/**
+ * @file src/include/c_synth_internal/synth_list.h
+ *
+ * Lists of items kept by the context; Songs, tracks, notes and volumes are
+ * stored in blocks of fixed size addressed by index, so expanding a list never
+ * copies its items, while the per-track timeline and loops are contiguous
+ * arrays (since they are searched as such)
+ */
+#ifndef __SYNTH_INTERNAL_LIST_H__
+#define __SYNTH_INTERNAL_LIST_H__
+
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_types.h>
+
+/** log2 of how many songs are alloc'ed at once */
+#define SYNTH_LIST_SONGS_SHIFT   4
+/** log2 of how many tracks are alloc'ed at once */
+#define SYNTH_LIST_TRACKS_SHIFT  4
+/** log2 of how many notes are alloc'ed at once */
+#define SYNTH_LIST_NOTES_SHIFT   8
+/** log2 of how many volumes are alloc'ed at once */
+#define SYNTH_LIST_VOLUMES_SHIFT 6
+
+/**
+ * Retrieve a pointer to an item of a list stored in blocks; Both the list and
+ * the index are evaluated more than once
+ *
+ * @param  [ in]type  Type of the list's items
+ * @param  [ in]pList The list
+ * @param  [ in]i     Index of the item
+ */
+#define SYNTH_LIST_ITEM(type, pList, i) \
+    (((type*)((pList)->ppBlocks[(i) >> (pList)->shift])) + \
+            ((i) & ((1 << (pList)->shift) - 1)))
+
+/** Retrieve a pointer to the context's 'i'-th song */
+#define SYNTH_AUDIO(pCtx, i) SYNTH_LIST_ITEM(synthAudio, &((pCtx)->songs), i)
+/** Retrieve a pointer to the context's 'i'-th track */
+#define SYNTH_TRACK(pCtx, i) SYNTH_LIST_ITEM(synthTrack, &((pCtx)->tracks), i)
+/** Retrieve a pointer to the context's 'i'-th note */
+#define SYNTH_NOTE(pCtx, i) SYNTH_LIST_ITEM(synthNote, &((pCtx)->notes), i)
+/** Retrieve a pointer to the context's 'i'-th volume */
+#define SYNTH_VOLUME(pCtx, i) \
+    SYNTH_LIST_ITEM(synthVolume, &((pCtx)->volumes), i)
+
+/**
+ * Calculate how many bytes a list carved from a static context requires
+ *
+ * @param  [ in]num     How many items the list may hold
+ * @param  [ in]size    Size of each item, in bytes
+ * @param  [ in]shift   log2 of the list's block size (0 for a contiguous list)
+ * @param  [ in]numFree How many ranges of released items may be kept
+ * @return              The list's size, rounded so the next one is aligned
+ */
+int synthList_getStaticSize(int num, int size, int shift, int numFree);
+
+/**
+ * Initialize a list over memory previously carved from a static context; The
+ * list is never expanded (nor shrunk)
+ *
+ * @param  [ in]pList   The list
+ * @param  [ in]pData   'synthList_getStaticSize' bytes
+ * @param  [ in]num     How many items the list may hold
+ * @param  [ in]size    Size of each item, in bytes
+ * @param  [ in]shift   log2 of the list's block size (0 for a contiguous list)
+ * @param  [ in]numFree How many ranges of released items may be kept
+ */
+void synthList_initStatic(synthList *pList, char *pData, int num, int size,
+        int shift, int numFree);
+
+/**
+ * Retrieve a new (cleared) item from a list stored in blocks, alloc'ing
+ * another block as necessary
+ *
+ * @param  [out]ppItem The new item
+ * @param  [ in]pList  The list
+ * @param  [ in]size   Size of each item, in bytes
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthList_append(void **ppItem, synthList *pList, int size);
+
+/**
+ * Retrieve many new (uninitialized) consecutive items from a contiguous list,
+ * expanding it as necessary
+ *
+ * @param  [out]ppItems The first new item
+ * @param  [ in]pList   The list
+ * @param  [ in]num     How many items are required
+ * @param  [ in]size    Size of each item, in bytes
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthList_appendArray(void **ppItems, synthList *pList, int num,
+        int size);
+
+/**
+ * Release a range of items, so they may be reused by 'synthList_acquire'; If
+ * the range reaches the end of the list, it's simply given back to the list
+ *
+ * @param  [ in]pList The list
+ * @param  [ in]first The range's first item
+ * @param  [ in]num   How many items there are in the range
+ * @return            SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthList_release(synthList *pList, int first, int num);
+
+/**
+ * Take the first released range (see 'synthList_release') that fits the
+ * requested number of items
+ *
+ * @param  [out]pFirst The first item taken, or -1 if no range fits
+ * @param  [ in]pList  The list
+ * @param  [ in]num    How many items are required
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthList_acquire(int *pFirst, synthList *pList, int num);
+
+/**
+ * Copy a range of items to another (non-overlapping) position in the list
+ *
+ * @param  [ in]pList The list
+ * @param  [ in]dst   First item of the destination
+ * @param  [ in]src   First item of the source
+ * @param  [ in]num   How many items should be copied
+ * @param  [ in]size  Size of each item, in bytes
+ */
+void synthList_copy(synthList *pList, int dst, int src, int num, int size);
+
+/**
+ * Remove a range of items from the list, moving every item after it back by
+ * the range's length (so the list never keeps any released range)
+ *
+ * @param  [ in]pList The list
+ * @param  [ in]first The range's first item
+ * @param  [ in]num   How many items there are in the range
+ * @param  [ in]size  Size of each item, in bytes
+ */
+void synthList_remove(synthList *pList, int first, int num, int size);
+
+/**
+ * Release whatever memory isn't used by a dynamically alloc'ed list
+ *
+ * Only the last block (or the array, in a contiguous list) may be moved, so
+ * pointers to items close to the end of the list must be retrieved again
+ *
+ * @param  [ in]pList The list
+ * @param  [ in]size  Size of each item, in bytes
+ */
+void synthList_shrink(synthList *pList, int size);
+
+/**
+ * Retrieve how many bytes are alloc'ed by a list
+ *
+ * @param  [ in]pList The list
+ * @param  [ in]size  Size of each item, in bytes
+ * @return            The list's size, in bytes
+ */
+int synthList_getSize(synthList *pList, int size);
+
+/**
+ * Release every item of a dynamically alloc'ed list
+ *
+ * @param  [ in]pList The list
+ */
+void synthList_clear(synthList *pList);
+
+#endif /* __SYNTH_INTERNAL_LIST_H__ */
+
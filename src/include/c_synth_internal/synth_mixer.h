@@ -0,0 +1,57 @@
+/**
+ * @file src/include/c_synth_internal/synth_mixer.h
+ *
+ * Mix rendered tracks into a single buffer
+ */
+#ifndef __SYNTH_INTERNAL_MIXER_H__
+#define __SYNTH_INTERNAL_MIXER_H__
+
+#include <c_synth/synth.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_types.h>
+
+/**
+ * Accumulate a temporary buffer into another buffer
+ * 
+ * Samples that overflow are saturated to the range of the mode
+ * 
+ * @param  [ in]pBuf Buffer that will be joined by the other track
+ * @param  [ in]pTmp Temporary buffer with the last track
+ * @param  [ in]mode Desired mode for the song
+ * @param  [ in]len  The number of samples to be accumulated
+ * @return           Whether any sample overflowed
+ */
+synth_bool synthMixer_accumulate(char *pBuf, char *pTmp, synthBufMode mode,
+        int len);
+
+/**
+ * Accumulate a temporary buffer into a 32 bits bus, which never overflows
+ * 
+ * @param  [ in]pBus Bus that will be joined by the other track (with one value
+ *                   per sample per channel)
+ * @param  [ in]pTmp Temporary buffer with the last track
+ * @param  [ in]mode Mode of the temporary buffer
+ * @param  [ in]len  The number of samples to be accumulated
+ * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthMixer_accumulateBus(int *pBus, char *pTmp, synthBufMode mode,
+        int len);
+
+/**
+ * Convert a bus into the desired mode
+ * 
+ * If any sample doesn't fit the mode's range, every sample is halved as many
+ * times as necessary for all of them to fit
+ * 
+ * @param  [ in]pBuf Buffer that will be filled with the mixed song
+ * @param  [ in]pBus Bus with every track
+ * @param  [ in]mode Desired mode for the song
+ * @param  [ in]len  The number of samples in the bus
+ * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthMixer_convertBus(char *pBuf, int *pBus, synthBufMode mode,
+        int len);
+
+#endif /* __SYNTH_INTERNAL_MIXER_H__ */
+
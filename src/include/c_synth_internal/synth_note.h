@@ -12,6 +12,34 @@
 #include <c_synth_internal/synth_types.h>
 #include <c_synth_internal/synth_volume.h>
 
+/**
+ * Function that synthesizes part of a note, of a given wave, into a buffer of a
+ * given mode
+ * 
+ * @param  [ in]pBuf     Buffer that will be filled with the note
+ * @param  [ in]pNote    The note
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]pPRNG    Pseudo-random number generator used by noises
+ * @param  [ in]track    Position of the note's track within its song
+ * @param  [ in]index    Position of the note within its track
+ * @param  [ in]duration The note's length in samples
+ * @param  [ in]offset   First sample to be rendered
+ * @param  [ in]count    How many samples should be rendered
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+typedef synth_err (*synthNoteKernel)(char *pBuf, synthNote *pNote,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, int track, int index,
+        int duration, int offset, int count);
+
+/**
+ * Build the context's table of phase increments, so any note may be synthesized
+ * without calculating its frequency
+ * 
+ * @param  [ in]pCtx The synthesizer context (with its frequency already set)
+ * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthNote_initPhaseTable(synthCtx *pCtx);
+
 /**
  * Retrieve a new note pointer, so it can be later initialized
  * 
@@ -24,14 +52,15 @@ synth_err synthNote_init(synthNote **ppNote, synthCtx *pCtx);
 /**
  * Retrieve a new note pointer, already initialized as a loop
  * 
- * @param  [out]ppNote   The new note
- * @param  [ in]pCtx     The synthesizer context
- * @param  [ in]repeat   How many times the loop should repeat
- * @param  [ in]position Note to which the song should jump back, on loop
- * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ * The loop itself (i.e., its jump position and repeat count) must have already
+ * been added to the track's loop table, with 'synthTrack_addLoop'
+ * 
+ * @param  [out]ppNote The new note
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]loop   Index of the loop within its track's loop table
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
  */
-synth_err synthNote_initLoop(synthNote **ppNote, synthCtx *pCtx, int repeat,
-        int position);
+synth_err synthNote_initLoop(synthNote **ppNote, synthCtx *pCtx, int loop);
 
 /**
  * Set the note panning
@@ -91,15 +120,24 @@ synth_err synthNote_setNote(synthNote *pNote, synth_note note);
  */
 synth_err synthNote_setDuration(synthNote *pNote, synthCtx *pCtx, int duration);
 
+/**
+ * Set the note's length in samples, as calculated when its track was compiled
+ * 
+ * @param  [ in]pNote   The note
+ * @param  [ in]samples The length, in samples
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthNote_setSamplesDuration(synthNote *pNote, int samples);
+
 /**
  * Set the characteristics of the note's duration
  * 
  * NOTE: This parameter must be set after the duration
  * 
  * All values must be in the range [0, 100]. The attack is campled to the range
- * [0, keyoff] and the release is campled to the range [keyoff, 100]. Although
- * the parameter express the percentage of the note's duration, the value is
- * stored in samples.
+ * [0, keyoff] and the release is campled to the range [keyoff, 100]. The
+ * values are kept as percentages of the note's duration (a byte each) and only
+ * converted to samples as the note is rendered.
  * 
  * @param  [ in]pNote   The note
  * @param  [ in]attack  The percentage of the note duration before it reaches
@@ -138,6 +176,15 @@ synth_bool synthNote_isLoop(synthNote *pNote);
  */
 synth_err synthNote_getDuration(int *pVal, synthNote *pNote);
 
+/**
+ * Retrieve the note's length in samples (cached when its track was compiled)
+ * 
+ * @param  [out]pVal  The length
+ * @param  [ in]pNote The note
+ * @return            SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthNote_getSamplesDuration(int *pVal, synthNote *pNote);
+
 /**
  * Retrieve the panning of the note, where 0 means completely on the left
  * channel and 100 means completely on the right channel
@@ -149,22 +196,42 @@ synth_err synthNote_getDuration(int *pVal, synthNote *pNote);
 synth_err synthNote_getPan(char *pVal, synthNote *pNote);
 
 /**
- * Retrieve the number of times this loop should repeat
+ * Retrieve the index of the loop within its track's loop table
  * 
- * @param  [out]pVal  The repeat count
+ * @param  [out]pVal  The loop's index
  * @param  [ in]pNote The note
  * @return            SYNTH_OK, SYNTH_BAD_PARAM_ERR
  */
-synth_err synthNote_getRepeat(int *pVal, synthNote *pNote);
+synth_err synthNote_getLoop(int *pVal, synthNote *pNote);
 
 /**
- * Retrieve the position, in the track, to which it should jump on loop
+ * Retrieve the scalar kernel that renders a note into the desired mode
  * 
- * @param  [out]pVal  The repeat position
- * @param  [ in]pNote The note
- * @return            SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ * Every wave has a scalar kernel, so this is also the reference against which
+ * the vectorized kernels are checked
+ * 
+ * @param  [out]pKernel The kernel
+ * @param  [ in]pNote   The note
+ * @param  [ in]mode    Desired mode for the wave
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthNote_getScalarKernel(synthNoteKernel *pKernel, synthNote *pNote,
+        synthBufMode mode);
+
+/**
+ * Retrieve the kernel that renders a note into the desired mode
+ * 
+ * This should be done only once per note, so rendering doesn't have to check
+ * for the wave nor for the mode on every sample; Vectorized kernels are
+ * preferred, whenever one was compiled for the note's wave
+ * 
+ * @param  [out]pKernel The kernel
+ * @param  [ in]pNote   The note
+ * @param  [ in]mode    Desired mode for the wave
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR
  */
-synth_err synthNote_getJumpPosition(int *pVal, synthNote *pNote);
+synth_err synthNote_getKernel(synthNoteKernel *pKernel, synthNote *pNote,
+        synthBufMode mode);
 
 /**
  * Render a note into a buffer
@@ -175,13 +242,38 @@ synth_err synthNote_getJumpPosition(int *pVal, synthNote *pNote);
  * @param  [ in]pBuf      Buffer that will be filled with the track
  * @param  [ in]pNote     The note
  * @param  [ in]pCtx      The synthesizer context
- * @param  [ in]mode      Desired mode for the wave
- * @param  [ in]synthFreq Synthesizer's frequency
+ * @param  [ in]pPRNG     Pseudo-random number generator used by noises
+ * @param  [ in]kernel    Kernel for the note's wave and the desired mode
+ * @param  [ in]track     Position of the note's track within its song
+ * @param  [ in]index     Position of the note within its track
  * @param  [ in]duration  The note's length in samples
  * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
  */
 synth_err synthNote_render(char *pBuf, synthNote *pNote, synthCtx *pCtx,
-        synthBufMode mode, int synthFreq, int duration);
+        synthPRNGCtx *pPRNG, synthNoteKernel kernel, int track, int index,
+        int duration);
+
+/**
+ * Render only part of a note into a buffer
+ * 
+ * The first rendered sample (i.e., the 'offset'-th sample of the note) is
+ * placed at the start of the buffer, which must have at least 'count' samples
+ * 
+ * @param  [ in]pBuf      Buffer that will be filled with the note
+ * @param  [ in]pNote     The note
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pPRNG     Pseudo-random number generator used by noises
+ * @param  [ in]kernel    Kernel for the note's wave and the desired mode
+ * @param  [ in]track     Position of the note's track within its song
+ * @param  [ in]index     Position of the note within its track
+ * @param  [ in]duration  The note's length in samples
+ * @param  [ in]offset    First sample to be rendered
+ * @param  [ in]count     How many samples should be rendered
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthNote_renderRange(char *pBuf, synthNote *pNote, synthCtx *pCtx,
+        synthPRNGCtx *pPRNG, synthNoteKernel kernel, int track, int index,
+        int duration, int offset, int count);
 
 #endif /* __SYNTH_NOTE_H__ */
 
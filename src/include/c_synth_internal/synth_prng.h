@@ -38,13 +38,34 @@ synth_err synthPRNG_getUint(unsigned int *pVal, synthPRNGCtx *pCtx);
 synth_err synthPRNG_getDouble(double *pVal, synthPRNGCtx *pCtx);
 
 /**
- * Generate points for a gaussian white noise
+ * Select how noises are generated
  * 
- * @param  [out]pVal The generated noise, in range [-1.0, 1.0]
- * @param  [ in]pCtx The contx
+ * @param  [ in]pCtx The context
+ * @param  [ in]type The noise generator
  * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
  */
-synth_err synthPRNG_getGaussianNoise(double *pVal, synthPRNGCtx *pCtx);
+synth_err synthPRNG_setNoiseType(synthPRNGCtx *pCtx,
+        enum enNoiseWaveType type);
+
+/**
+ * Generate a span of a white noise (gaussian, unless the LFSR was selected)
+ * 
+ * The noise is counter-based: Each value depends only on the context's key,
+ * the stream (i.e., the track and the note within that track) and its
+ * position within the stream. So, any span may be generated independently
+ * (e.g., by another thread or while rendering only part of a note) and still
+ * be exactly the same, regardless of where the song was placed in the context
+ * 
+ * @param  [out]pBuf     The generated noise, in range [-1.0, 1.0]
+ * @param  [ in]num      How many values should be generated
+ * @param  [ in]pCtx     The context
+ * @param  [ in]track    Position of the track within its song
+ * @param  [ in]note     Position of the note within its track
+ * @param  [ in]position Position of the first value within the stream
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthPRNG_getNoise(double *pBuf, int num, synthPRNGCtx *pCtx,
+        unsigned int track, unsigned int note, int position);
 
 #endif /* __SYNTH_PRNG_H__ */
 
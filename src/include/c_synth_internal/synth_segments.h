@@ -0,0 +1,72 @@
+/**
+ * @file src/include/c_synth_internal/synth_segments.h
+ *
+ * Render a song's notes only once, playing its loops back from a list of
+ * segments
+ */
+#ifndef __SYNTH_INTERNAL_SEGMENTS_H__
+#define __SYNTH_INTERNAL_SEGMENTS_H__
+
+#include <c_synth/synth.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_types.h>
+
+/**
+ * Render every note of a song (but only once) and build the segments that play
+ * each of its tracks back
+ *
+ * @param  [out]ppSegments The new segmented song
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]pPRNG      Pseudo-random number generator used by noises
+ * @param  [ in]pCache     Cache of rendered notes (may be NULL)
+ * @param  [ in]handle     Handle of the audio
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                         SYNTH_MEM_ERR
+ */
+synth_err synthSegments_init(synthSegments **ppSegments, synthCtx *pCtx,
+        synthPRNGCtx *pPRNG, synthCache *pCache, int handle,
+        synthBufMode mode);
+
+/**
+ * Place every track back at the start of the song
+ *
+ * @param  [ in]pSegments The segmented song
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthSegments_reset(synthSegments *pSegments);
+
+/**
+ * Release all memory alloc'ed by a segmented song
+ *
+ * @param  [ in]ppSegments The segmented song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthSegments_free(synthSegments **ppSegments);
+
+/**
+ * Retrieve how many bytes are used by a segmented song
+ *
+ * @param  [out]pBytes    The size of the rendered notes and of every segment
+ * @param  [ in]pSegments The segmented song
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthSegments_getSize(int *pBytes, synthSegments *pSegments);
+
+/**
+ * Play the next samples of a segmented song, mixing all of its tracks
+ *
+ * Looping tracks go back to their loop point once they end; Tracks that don't
+ * loop output silence after ending
+ *
+ * @param  [ in]pBuf       Buffer that will be filled with 'numSamples'
+ * @param  [ in]pSegments  The segmented song
+ * @param  [ in]numSamples How many samples should be played
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthSegments_render(char *pBuf, synthSegments *pSegments,
+        int numSamples);
+
+#endif /* __SYNTH_INTERNAL_SEGMENTS_H__ */
+
@@ -0,0 +1,29 @@
+/**
+ * @file src/include/c_synth_internal/synth_simd.h
+ *
+ * Select the instruction set used by vectorized code; Defining SYNTH_NO_SIMD
+ * forces everything to be done by the scalar code
+ *
+ * If any instruction set is available, SYNTH_SIMD is defined, as well as either
+ * SYNTH_SIMD_SSE2 or SYNTH_SIMD_NEON, and its intrinsics are included; NEON is
+ * only used on (little-endian) AArch64, since ARMv7's lacks IEEE division
+ */
+#ifndef __SYNTH_INTERNAL_SIMD_H__
+#define __SYNTH_INTERNAL_SIMD_H__
+
+#if !defined(SYNTH_NO_SIMD)
+#  if defined(__SSE2__) || defined(_M_X64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define SYNTH_SIMD
+#    define SYNTH_SIMD_SSE2
+#    include <emmintrin.h>
+#  elif defined(__aarch64__) && defined(__ARM_NEON) && \
+        !defined(__AARCH64EB__)
+#    define SYNTH_SIMD
+#    define SYNTH_SIMD_NEON
+#    include <arm_neon.h>
+#  endif
+#endif
+
+#endif /* __SYNTH_INTERNAL_SIMD_H__ */
+
@@ -20,6 +20,53 @@
  */
 synth_err synthTrack_init(synthTrack **ppTrack, synthCtx *pCtx);
 
+/**
+ * Add a loop to the track's loop table; Since tracks are parsed one at a time,
+ * it must be the last track of the context
+ * 
+ * Its length is only calculated when the track is compiled (see
+ * 'synthTrack_cacheLengths')
+ * 
+ * @param  [out]pLoop        Index of the loop within the track's loop table
+ * @param  [ in]pTrack       The track
+ * @param  [ in]pCtx         The synthesizer context
+ * @param  [ in]position     Position of the loop note within the track
+ * @param  [ in]jumpPosition Position of the loop's first note
+ * @param  [ in]repeat       How many times the loop's body is played
+ * @return                   SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthTrack_addLoop(int *pLoop, synthTrack *pTrack, synthCtx *pCtx,
+        int position, int jumpPosition, int repeat);
+
+/**
+ * Retrieve the loop (from the track's loop table) of a loop note
+ * 
+ * @param  [out]ppLoop The loop
+ * @param  [ in]pTrack The track
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]pNote  The loop note
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthTrack_getLoop(synthLoop **ppLoop, synthTrack *pTrack,
+        synthCtx *pCtx, synthNote *pNote);
+
+/**
+ * Calculate and cache the length of every note in a track, as well as the
+ * track's length, intro length, loops' lengths and timeline
+ * 
+ * This must be called once, after the track is compiled, since the lengths are
+ * afterward only ever retrieved from the cache (so neither the track is
+ * modified nor the compass is tracked while rendering)
+ * 
+ * @param  [ in]pTrack    The track
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pRenderer Renderer initialized for the track's audio
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR,
+ *                        SYNTH_COMPASS_OVERFLOW, SYNTH_BAD_LOOP_COUNT
+ */
+synth_err synthTrack_cacheLengths(synthTrack *pTrack, synthCtx *pCtx,
+        synthRendererCtx *pRenderer);
+
 /**
  * Retrieve the number of samples in a track
  * 
@@ -50,19 +97,58 @@ synth_err synthTrack_getIntroLength(int *pLen, synthTrack *pTrack,
 synth_bool synthTrack_isLoopable(synthTrack *pTrack);
 
 /**
- * Render a track into a buffer
+ * Render a full track into a buffer
  * 
  * The buffer must be prepared by the caller, and it must have
  * 'synth_getTrackLength' bytes times the number of bytes per samples
  * 
+ * Notes are rendered from the first to the last one; Whenever a loop note is
+ * found, its body (which was just rendered) is copied as many times as
+ * necessary, with its length retrieved from the track's loop table. So the
+ * track is rendered in linear time, regardless of how deeply its loops nest
+ * 
+ * Only 'pPRNG' and 'pCache' are modified, so tracks may be rendered
+ * concurrently
+ * 
  * @param  [ in]pBuf   Buffer that will be filled with the track
  * @param  [ in]pTrack The track
+ * @param  [ in]track  Position of the track within its song (which, along
+ *                     with each note's position, selects the noise)
  * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]pPRNG  Pseudo-random number generator used by noises
+ * @param  [ in]pCache Cache of rendered notes (may be NULL)
  * @param  [ in]mode   Desired mode for the wave
  * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
  */
-synth_err synthTrack_render(char *pBuf, synthTrack *pTrack, synthCtx *pCtx,
+synth_err synthTrack_render(char *pBuf, synthTrack *pTrack, int track,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, synthCache *pCache,
         synthBufMode mode);
 
+/**
+ * Render only a range of a track into a buffer
+ * 
+ * Every note is found on the track's timeline (instead of walking through the
+ * whole track) and the first one is rendered from its middle, if needed.
+ * Samples past the end of the track go back to its loop point, as when the
+ * song is rendered, or are silent if the track doesn't loop
+ * 
+ * Only 'pPRNG' and 'pCache' are modified, so tracks may be rendered
+ * concurrently
+ * 
+ * @param  [ in]pBuf       Buffer that will be filled with 'numSamples'
+ * @param  [ in]pTrack     The track
+ * @param  [ in]track      Position of the track within its song
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]pPRNG      Pseudo-random number generator used by noises
+ * @param  [ in]pCache     Cache of rendered notes (may be NULL)
+ * @param  [ in]mode       Desired mode for the wave
+ * @param  [ in]position   First sample to be rendered
+ * @param  [ in]numSamples How many samples should be rendered
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthTrack_renderRange(char *pBuf, synthTrack *pTrack, int track,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, synthCache *pCache,
+        synthBufMode mode, int position, int numSamples);
+
 #endif /* __SYNTH_TRACK_H__ */
 
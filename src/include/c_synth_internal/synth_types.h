@@ -7,6 +7,9 @@
 #ifndef __SYNTH_INTERNAL_TYPES_H__
 #define __SYNTH_INTERNAL_TYPES_H__
 
+/* Required because of synthBufMode */
+#include <c_synth/synth.h>
+
 /* Required because of a FILE* */
 #include <stdio.h>
 
@@ -24,14 +27,42 @@
 #  define __SYNTHBUFFER_UNION__
      typedef union unSynthBuffer synthBuffer;
 #  endif /* __SYNTHBUFFER_UNION__ */
+#  ifndef __SYNTHCACHE_STRUCT__
+#  define __SYNTHCACHE_STRUCT__
+     typedef struct stSynthCache synthCache;
+#  endif /* __SYNTHCACHE_STRUCT__ */
+#  ifndef __SYNTHCACHEENTRY_STRUCT__
+#  define __SYNTHCACHEENTRY_STRUCT__
+     typedef struct stSynthCacheEntry synthCacheEntry;
+#  endif /* __SYNTHCACHEENTRY_STRUCT__ */
 #  ifndef __SYNTHCTX_STRUCT__
 #  define __SYNTHCTX_STRUCT__
      typedef struct stSynthCtx synthCtx;
 #  endif /* __SYNTHCTX_STRUCT__ */
+#  ifndef __SYNTHCURSOR_STRUCT__
+#  define __SYNTHCURSOR_STRUCT__
+     typedef struct stSynthCursor synthCursor;
+#  endif /* __SYNTHCURSOR_STRUCT__ */
+#  ifndef __SYNTHLEXCLASS_ENUM__
+#  define __SYNTHLEXCLASS_ENUM__
+     typedef enum enSynthLexClass synthLexClass;
+#  endif /* __SYNTHLEXCLASS_ENUM__ */
+#  ifndef __SYNTHLEXSTATE_ENUM__
+#  define __SYNTHLEXSTATE_ENUM__
+     typedef enum enSynthLexState synthLexState;
+#  endif /* __SYNTHLEXSTATE_ENUM__ */
 #  ifndef __SYNTHLEXCTX_STRUCT__
 #  define __SYNTHLEXCTX_STRUCT__
      typedef struct stSynthLexCtx synthLexCtx;
 #  endif /* __SYNTHLEXCTX_STRUCT__ */
+#  ifndef __SYNTHLOOP_STRUCT__
+#  define __SYNTHLOOP_STRUCT__
+     typedef struct stSynthLoop synthLoop;
+#  endif /* __SYNTHLOOP_STRUCT__ */
+#  ifndef __SYNTHLOOPFRAME_STRUCT__
+#  define __SYNTHLOOPFRAME_STRUCT__
+     typedef struct stSynthLoopFrame synthLoopFrame;
+#  endif /* __SYNTHLOOPFRAME_STRUCT__ */
 #  ifndef __SYNTHLIST_STRUCT__
 #  define __SYNTHLIST_STRUCT__
      typedef struct stSynthList synthList;
@@ -44,6 +75,10 @@
 #  define __SYNTHPARSERCTX_STRUCT__
      typedef struct stSynthParserCtx synthParserCtx;
 #  endif /* __SYNTHPARSERCTX_STRUCT__ */
+#  ifndef __SYNTHRANGE_STRUCT__
+#  define __SYNTHRANGE_STRUCT__
+     typedef struct stSynthRange synthRange;
+#  endif /* __SYNTHRANGE_STRUCT__ */
 #  ifndef __SYNTHRENDERERCTX_STRUCT__
 #  define __SYNTHRENDERERCTX_STRUCT__
 typedef struct stSynthRendererCtx synthRendererCtx;
@@ -52,6 +87,22 @@ typedef struct stSynthRendererCtx synthRendererCtx;
 #  define __SYNTHPRNG_STRUCT__
      typedef struct stSynthPRNGCtx synthPRNGCtx;
 #  endif /* __SYNTHPRNG_STRUCTRUCT__ */
+#  ifndef __SYNTHSEGMENT_STRUCT__
+#  define __SYNTHSEGMENT_STRUCT__
+     typedef struct stSynthSegment synthSegment;
+#  endif /* __SYNTHSEGMENT_STRUCT__ */
+#  ifndef __SYNTHSEGMENTS_STRUCT__
+#  define __SYNTHSEGMENTS_STRUCT__
+     typedef struct stSynthSegments synthSegments;
+#  endif /* __SYNTHSEGMENTS_STRUCT__ */
+#  ifndef __SYNTHSEGMENTTRACK_STRUCT__
+#  define __SYNTHSEGMENTTRACK_STRUCT__
+     typedef struct stSynthSegmentTrack synthSegmentTrack;
+#  endif /* __SYNTHSEGMENTTRACK_STRUCT__ */
+#  ifndef __SYNTHSESSION_STRUCT__
+#  define __SYNTHSESSION_STRUCT__
+     typedef struct stSynthSession synthSession;
+#  endif /* __SYNTHSESSION_STRUCT__ */
 #  ifndef __SYNTHSOURCE_UNION__
 #  define __SYNTHSOURCE_UNION__
      typedef union unSynthSource synthSource;
@@ -64,14 +115,26 @@ typedef struct stSynthRendererCtx synthRendererCtx;
 #  define __SYNTHSTRING_STRUCT__
      typedef struct stSynthString synthString;
 #  endif /* __SYNTHSTRING_STRUCT__ */
+#  ifndef __SYNTHTIMELINEENTRY_STRUCT__
+#  define __SYNTHTIMELINEENTRY_STRUCT__
+     typedef struct stSynthTimelineEntry synthTimelineEntry;
+#  endif /* __SYNTHTIMELINEENTRY_STRUCT__ */
 #  ifndef __SYNTHTRACK_STRUCT__
 #  define __SYNTHTRACK_STRUCT__
      typedef struct stSynthTrack synthTrack;
 #  endif /* __SYNTHTRACK_STRUCT__ */
+#  ifndef __SYNTHTRACKCURSOR_STRUCT__
+#  define __SYNTHTRACKCURSOR_STRUCT__
+     typedef struct stSynthTrackCursor synthTrackCursor;
+#  endif /* __SYNTHTRACKCURSOR_STRUCT__ */
 #  ifndef __SYNTHVOLUME_STRUCT__
 #  define __SYNTHVOLUME_STRUCT__
      typedef struct stSynthVolume synthVolume;
 #  endif /* __SYNTHVOLUME_STRUCT__ */
+#  ifndef __SYNTHWORKER_STRUCT__
+#  define __SYNTHWORKER_STRUCT__
+     typedef struct stSynthWorker synthWorker;
+#  endif /* __SYNTHWORKER_STRUCT__ */
 #  ifndef __SYNTHBOOL_ENUM__
 #  define __SYNTHBOOL_ENUM__
      typedef enum enSynthBool synth_bool;
@@ -171,11 +234,17 @@ struct stSynthString {
     int len;
     /** Current position on the string */
     int pos;
-    /** Pointer to the static (and NULL-terminated) string */
+    /**
+     * Pointer to the string (which is only NULL-terminated if it was given by
+     * the user)
+     */
     char *pStr;
 };
 
-/** Define a source for a MML audio, which can either be a file or a string */
+/**
+ * Define a source for a MML audio, which can either be a file or a SDL_RWops;
+ * Strings (and mapped files) need no source, as they are lexed directly
+ */
 union unSynthSource {
 #if defined(USE_SDL2)
     /** SDL's SDL_RWops, so it works on mobile! */
@@ -183,8 +252,6 @@ union unSynthSource {
 #endif
     /** A file */
     FILE *file;
-    /** A static string, with its current position and length */
-    synthString str;
 };
 
 /** Defines all posible input types for the lexer */
@@ -196,6 +263,46 @@ enum enSynthSourceType {
     SST_MAX
 };
 
+/** Classes of characters, as seen by the lexer */
+enum enSynthLexClass {
+    LC_SKIP = 0,  /* Whitespace and everything else that isn't printable */
+    LC_BAD,       /* Printable, but doesn't start any token */
+    LC_SLASH,     /* '/', which starts a comment if followed by another one */
+    LC_TOKEN,     /* Single character token */
+    LC_OCTAVE,    /* '<' or '>' */
+    LC_NOTE,      /* 'a' to 'g' */
+    LC_REST,      /* 'r' */
+    LC_MOD,       /* '+' or '-' */
+    LC_DOT,       /* '.' */
+    LC_DIGIT,     /* '0' to '9' */
+    LC_M,         /* 'M' */
+    LC_L,         /* 'L' */
+    LC_END,       /* End of the stream */
+    LC_MAX
+};
+
+/** States of the lexer while it reads a token */
+enum enSynthLexState {
+    /* States while the token is being read */
+    LS_START = 0, /* Nothing was read */
+    LS_M,         /* Read "M" */
+    LS_MM,        /* Read "MM" */
+    LS_NOTE,      /* Read a note, which may be followed by a modifier */
+    LS_REST,      /* Read a rest */
+    LS_DOTS,      /* Read one or more '.' */
+    LS_NUMBER,    /* Read one or more digits */
+    LS_MAX,
+    /* Final states, reached by consuming the current character */
+    LS_MML = LS_MAX,
+    LS_TOKEN,
+    LS_REL_OCTAVE,
+    LS_MODIFIER,
+    /* Final states, reached without consuming it */
+    LS_ACCEPT,
+    LS_DONE,
+    LS_ERROR
+};
+
 /** Define the context for the lexer */
 struct stSynthLexCtx {
     /** Last read character */
@@ -210,8 +317,17 @@ struct stSynthLexCtx {
     synth_token lastToken;
     /** Integer value gotten when reading a token */
     int ivalue;
-    /** MML's source; either a file descriptor or a string */
+    /** MML's source; either a file descriptor or a SDL_RWops */
     synthSource source;
+    /**
+     * Characters being lexed, with the current position; Either the whole
+     * string (or mapped file), or the last block read from the source
+     */
+    synthString buf;
+    /** Block into which the source is read (only used by unmapped sources) */
+    char *pBlock;
+    /** Whether 'buf' is a file mapped into memory */
+    int isMapped;
 };
 
 /** Define the context for the parser */
@@ -262,7 +378,8 @@ struct stSynthRendererCtx {
 enum enNoiseWaveType {
     NW_NONE = 0,
     NW_BOXMULLER,
-    NW_ZIGGURAT
+    NW_ZIGGURAT,
+    NW_LFSR
 };
 
 /** Struct with the static parameters required by the Box-Muller algorithm */
@@ -271,20 +388,38 @@ struct stBoxMullerParams {
     double z0;
     /** The other point, generated on the previous iteration */
     double z1;
+    /** Base of the stream of the previous iteration */
+    unsigned int base;
+    /** Pair of positions generated on the previous iteration */
+    int pair;
     /** Whether the points where generated on the previous iteration */
     int didGenerate;
 };
 
 /** Struct with the static parameters required by the ziggurat algorithm */
 struct stZigguratParams {
-    /* TODO */
+    /** Unused; The ziggurat's tables are constant (and shared by every
+     * context), so it doesn't keep any state between samples */
     int nil;
 };
 
+/** Struct with the static parameters required by the LFSR noise */
+struct stLFSRParams {
+    /** The shift register's state (never 0) */
+    unsigned int state;
+    /** Base of the stream being generated */
+    unsigned int base;
+    /** Position (in the stream) of the register's next value */
+    int position;
+    /** Whether the register holds a valid state */
+    int isValid;
+};
+
 /** Parameter specific to algorithms used by the PRNG */
 union stPRNGParams {
     struct stBoxMullerParams boxMuller;
     struct stZigguratParams ziggurat;
+    struct stLFSRParams lfsr;
 };
 
 /** Current context used by the pseudo random number generator */
@@ -297,6 +432,8 @@ struct stSynthPRNGCtx {
     unsigned int c;
     /** Latest seed */
     unsigned int seed;
+    /** Key from which every noise is generated (i.e., the initial seed) */
+    unsigned int key;
     /* The current noise wave generator */
     enum enNoiseWaveType type;
     /** Params used by the current generator algorithm */
@@ -313,6 +450,20 @@ union unSynthBuffer {
     synthTrack *pTracks;
     /* Points to an array of volumes */
     synthVolume *pVolumes;
+    /* Points to an array of timeline entries */
+    synthTimelineEntry *pTimeline;
+    /* Points to an array of loops */
+    synthLoop *pLoops;
+    /* Points to the array, regardless of its type */
+    void *pData;
+};
+
+/** A range of consecutive itens in a list */
+struct stSynthRange {
+    /** The range's first item */
+    int first;
+    /** How many itens there are in the range */
+    int num;
 };
 
 /** A generic list of a buffer */
@@ -323,11 +474,76 @@ struct stSynthList {
     int len;
     /** How many itens are currently in use */
     int used;
-    /* TODO Add a map of used items? */
-    /** The actual list of itens */
+    /** Ranges of released itens (before 'used'), sorted by their first item */
+    synthRange *pFree;
+    /** How many ranges were released */
+    int numFree;
+    /** How many ranges fit in 'pFree' */
+    int lenFree;
+    /** log2 of how many itens there are in each block, or 0 if the list is a
+     * single array (in 'buf') */
+    int shift;
+    /** How many blocks fit in 'ppBlocks' */
+    int numBlocks;
+    /** Every block of itens (see 'SYNTH_LIST_ITEM') */
+    void **ppBlocks;
+    /** The actual list of itens, if it isn't stored in blocks */
     synthBuffer buf;
 };
 
+/** A rendered note, kept so it may be copied whenever the note repeats */
+struct stSynthCacheEntry {
+    /** Hash of every field below but 'pData' and 'next' */
+    unsigned int hash;
+    /** Index of the next entry in the same bucket, or -1 */
+    int next;
+    /** Buffer mode in which the note was rendered */
+    synthBufMode mode;
+    /** Length of the note, in samples */
+    int duration;
+    /** The note's wave */
+    synth_wave wave;
+    /** The musical note */
+    synth_note note;
+    /** The note's octave */
+    int octave;
+    /** Index of the note's volume */
+    int volume;
+    /** The note's attack, in samples */
+    int attack;
+    /** The note's keyoff, in samples */
+    int keyoff;
+    /** The note's release, in samples */
+    int release;
+    /** The note's pan */
+    int pan;
+    /** The rendered note */
+    char *pData;
+};
+
+/** Cache of rendered notes, keyed by every parameter that changes the note */
+struct stSynthCache {
+    /** How many bytes of rendered notes may be kept (0 disables the cache) */
+    int maxBytes;
+    /** How many bytes of rendered notes are currently kept */
+    int usedBytes;
+    /** How many notes were copied from the cache */
+    int hits;
+    /** How many notes had to be rendered */
+    int misses;
+    /** Every cached note */
+    synthCacheEntry *pEntries;
+    /** How many entries may be stored without expanding 'pEntries' */
+    int len;
+    /** How many entries are currently in use */
+    int used;
+    /** First entry on each bucket (or -1); Alloc'ed with the first entry */
+    int *pBuckets;
+    /** Cache looked up (but never modified) when a note isn't found on this
+     * one (may be NULL) */
+    synthCache *pShared;
+};
+
 /* Define the main context */
 struct stSynthCtx {
     /**
@@ -335,8 +551,19 @@ struct stSynthCtx {
      * freed) or if it was alloc'ed by the user
      */
     int autoAlloced;
+    /**
+     * Whether a static context's memory was alloc'ed by the library, as a
+     * single block with every list (and, thus, must be freed)
+     */
+    int blockAlloced;
     /** Synthesizer frequency in samples per second */
     int frequency;
+    /**
+     * How much each note's phase advances per sample, indexed by octave (minus
+     * 1) and note; The phase is a 32 bits fixed point number where 2^32 is a
+     * full cycle
+     */
+    unsigned int phaseIncrement[8][N_REST];
     /** List of songs */
     synthList songs;
     /** List of tracks */
@@ -345,18 +572,52 @@ struct stSynthCtx {
     synthList notes;
     /** List of volumes */
     synthList volumes;
+    /**
+     * Open-addressing hash index of the volumes, keyed by their amplitudes;
+     * Each slot holds a volume's index, or -1 if it's empty
+     */
+    int *pVolumeIndex;
+    /** How many slots there are in 'pVolumeIndex' (a power of 2) */
+    int volumeIndexLen;
+    /** Where each note of every track is first played */
+    synthList timeline;
+    /** Every track's loops, in the order they appear in the track */
+    synthList loops;
     /** Lexer context */
     synthLexCtx lexCtx;
     /** Parser context */
     synthParserCtx parserCtx;
     /** Pseudo-random number generator context */
     synthPRNGCtx prngCtx;
-    /** Keep track of whatever is being rendered */
+    /** Keep track of the compass while a song is compiled */
     synthRendererCtx renderCtx;
+    /** How many threads may render a song's tracks (at most 1 is serial) */
+    int numThreads;
+    /** Whether every list is shrunk to fit after a song is compiled */
+    int shrinkToFit;
+    /** Notes already rendered by the context */
+    synthCache noteCache;
+};
+
+/**
+ * Mutable state required to render songs from a synthesizer context, so many
+ * threads may render (each with its own session) from a single context
+ */
+struct stSynthSession {
+    /** The synthesizer context (which isn't modified by the session) */
+    synthCtx *pCtx;
+    /** Pseudo-random number generator context */
+    synthPRNGCtx prngCtx;
+    /** Notes already rendered by the session */
+    synthCache noteCache;
 };
 
 /** Define an audio, which is simply an aggregation of tracks */
 struct stSynthAudio {
+    /** Handle of the song (i.e., its index and generation) */
+    int handle;
+    /** Whether the song was released (and may be reused by another one) */
+    int isFree;
     /**
      * Index to the first track in the synthesizer context; An offset was
      * chosen, in place of a pointer, because the base pointer might change, if
@@ -367,10 +628,31 @@ struct stSynthAudio {
     int tracksIndex;
     /** How many tracks the song has */
     int num;
+    /** First note of the song (every track's notes are contiguous) */
+    int notesIndex;
+    /** How many notes the song has, through all of its tracks */
+    int notesNum;
+    /** First timeline entry of the song */
+    int timelineIndex;
+    /** How many timeline entries the song has */
+    int timelineNum;
+    /** First loop of the song */
+    int loopsIndex;
+    /** How many loops the song has */
+    int loopsNum;
     /** Song's 'speed' in beats-per-minute */
     int bpm;
     /** Song's time signature */
     int timeSignature;
+    /** Cached length of the longest track, in samples */
+    int cachedLength;
+    /** Cached number of samples until the song's loop point */
+    int cachedIntroLength;
+    /**
+     * Cached result of checking whether the song loops nicely (SYNTH_OK,
+     * SYNTH_NOT_LOOPABLE or SYNTH_COMPLEX_LOOPPOINT)
+     */
+    synth_err cachedLoopStatus;
 };
 
 /** Define a track, which is almost simply a sequence of notes */
@@ -391,46 +673,85 @@ struct stSynthTrack {
     int notesIndex;
     /** Number of notes in this track */
     int num;
+    /**
+     * Index to the track's first entry in the context's timeline; There's an
+     * entry for each note, followed by another for the track's end
+     */
+    int timelineIndex;
+    /** Index to the track's first loop in the context's loop table */
+    int loopsIndex;
+    /** Number of loops in the track */
+    int loopsNum;
 };
 
-struct stSynthNote {
+/** Where a note of a track is placed within the track's samples */
+struct stSynthTimelineEntry {
     /**
-     * Value between 0 and 100, where 0 means only left channel and 100 means
-     * only right channel
+     * First sample of the note's first play, from the start of the track; For
+     * loop notes, that's where the loop's body starts being repeated
      */
-    char pan;
-    /** Octave at which the note should play, from 1 to 8 */
-    char octave;
+    int start;
+};
+
+/**
+ * A loop within a track, added as the track is parsed; Its length is only
+ * calculated when the track is compiled
+ */
+struct stSynthLoop {
+    /** Position of the loop note within the track */
+    int position;
+    /** Position of the loop's first note within the track */
+    int jumpPosition;
+    /** How many times the loop's body is played */
+    int repeat;
+    /** Length of a single pass through the loop's body, in samples */
+    int length;
+};
+
+/**
+ * A note, packed into 16 bytes since the notes are the bulk of a compiled song;
+ * Loops only keep an index into their track's loop table (where the jump
+ * position and the repeat count are stored)
+ */
+struct stSynthNote {
     /**
-     * Duration of the note in samples (depends on the sample rate).
-     * If type is N_loop, represent how many times should repeat.
+     * Duration of the note in samples, calculated (considering its position
+     * within the compass) when its track is compiled.
+     * If type is N_loop, it's the loop's index within its track's loop table.
      */
-    int len;
+    int samplesDuration;
     /**
      * Note's duration in binary fixed point notation; It uses 6 bits for the
      * fractional part
      */
-    int duration;
-    /** Cached duration of the note in samples */
-    int samplesDuration;
-    /** Only used if type is N_loop; Represents note to which should jump. */
-    int jumpPosition;
-    /** Time, in samples, until the note reaches its maximum amplitude */
-    int attack;
-    /** After how many samples should the note be muted */
-    int keyoff;
-    /** Time, in samples, until the note halts completely */
-    int release;
-    /** Only used if type is N_loop; how many times has already looped */
-    int numIterations;
-    /** Wave type to be synthesized */
-    synth_wave wave;
-    /** Musical note to be played */
-    synth_note note;
+    unsigned short duration;
     /** Index to either a value between 0x0 and 0xff or a envelop */
-    int volume;
+    unsigned short volume;
+    /** Wave type to be synthesized (a synth_wave) */
+    unsigned char wave;
+    /** Musical note to be played (a synth_note) */
+    unsigned char note;
+    /** Octave at which the note should play, from 1 to 8 */
+    unsigned char octave;
+    /**
+     * Value between 0 and 100, where 0 means only left channel and 100 means
+     * only right channel
+     */
+    unsigned char pan;
+    /** Percentage of the note until it reaches its maximum amplitude */
+    unsigned char attack;
+    /** Percentage of the note after which it's muted */
+    unsigned char keyoff;
+    /** Percentage of the note until it halts completely */
+    unsigned char release;
 };
 
+/**
+ * Fail to compile (with a negative array size) if a field added to the note
+ * makes it grow past 16 bytes
+ */
+typedef char synthNote_isPacked[(sizeof(synthNote) == 16) ? 1 : -1];
+
 /** Define a simple note envelop */
 struct stSynthVolume {
     /** Initial volume */
@@ -439,5 +760,135 @@ struct stSynthVolume {
     int fin;
 };
 
+/** A loop that is currently being played by a track cursor */
+struct stSynthLoopFrame {
+    /** Position of the loop note within the track */
+    int position;
+    /** How many times the loop must still jump back */
+    int remaining;
+};
+
+/** Keep track of where a track is being played */
+struct stSynthTrackCursor {
+    /**
+     * Index of the track within its song (since static contexts may move the
+     * song's tracks when another song is released)
+     */
+    int track;
+    /** Whether the track may go back to its loop point after ending */
+    int canLoop;
+    /** Whether the track ended (and thus, should only output silence) */
+    int isDone;
+    /** Index of the note currently being played, within the track */
+    int note;
+    /** Length of the current note, in samples */
+    int noteLength;
+    /** How many samples of the current note were already rendered */
+    int notePosition;
+    /** How many loops are currently being played */
+    int loopDepth;
+    /** Stack with every loop currently being played */
+    synthLoopFrame *pLoops;
+};
+
+/** Persistent playback position within a song, for rendering it in chunks */
+struct stSynthCursor {
+    /** Handle of the song being played */
+    int handle;
+    /** How many samples were already rendered */
+    int position;
+    /** Number of tracks in the song */
+    int numTracks;
+    /** State of every track in the song */
+    synthTrackCursor *pTracks;
+    /** Length of the temporary buffer, in bytes */
+    int tmpLen;
+    /** Temporary buffer where each track is rendered before being mixed */
+    char *pTmp;
+    /** Pseudo-random number generator used by the song's noises */
+    synthPRNGCtx prngCtx;
+};
+
+/** A span of rendered samples, played some times in a row */
+struct stSynthSegment {
+    /** First sample of the span, within the track's rendered samples */
+    int offset;
+    /** Length of the span, in samples */
+    int len;
+    /** How many times the span is played */
+    int repeat;
+};
+
+/**
+ * A track whose notes were rendered only once, and the sequence of segments
+ * that play it back (so loops are never unrolled)
+ */
+struct stSynthSegmentTrack {
+    /** Every note of the track, rendered in order and only once */
+    char *pData;
+    /** Length of 'pData', in samples */
+    int dataLen;
+    /** Segments that play the track, in order */
+    synthSegment *pSegments;
+    /** How many segments there are */
+    int numSegments;
+    /** How many segments fit in 'pSegments' */
+    int lenSegments;
+    /** Whether the track may go back to its loop point after ending */
+    int canLoop;
+    /** Segment to which the track goes back after ending */
+    int loopSegment;
+    /** Whether the track ended (and thus, should only output silence) */
+    int isDone;
+    /** Segment currently being played */
+    int segment;
+    /** How many times the current segment was already played */
+    int iteration;
+    /** How many samples of the current segment's iteration were played */
+    int position;
+};
+
+/** A song rendered as a list of segments for each of its tracks */
+struct stSynthSegments {
+    /** Handle of the song */
+    int handle;
+    /** Mode in which the song was rendered */
+    synthBufMode mode;
+    /** How many samples were already played */
+    int position;
+    /** Number of tracks in the song */
+    int numTracks;
+    /** Every track in the song */
+    synthSegmentTrack *pTracks;
+};
+
+/** State of a thread rendering (and mixing) some of a song's tracks */
+struct stSynthWorker {
+    /** The synthesizer context (which mustn't be modified by the worker) */
+    synthCtx *pCtx;
+    /** The audio */
+    synthAudio *pAudio;
+    /** PRNG copied for each of the song's tracks (which mustn't be modified
+     * by the worker) */
+    synthPRNGCtx *pPRNG;
+    /** Desired mode for the song */
+    synthBufMode mode;
+    /** First sample of the song mixed by this worker */
+    int start;
+    /** Last sample (exclusive) of the song mixed by this worker */
+    int end;
+    /** This worker's range of the (shared) bus */
+    int *pBus;
+    /** This worker's range of the (shared) temporary buffer */
+    char *pTmp;
+    /** Cache of notes rendered by this worker, which looks up the caller's
+     * cache (or NULL, if the caller's cache is disabled) */
+    synthCache *pCache;
+    /** Storage for 'pCache' */
+    synthCache cache;
+    /** Result of the latest job */
+    synth_err rv;
+};
+
 #endif /* __SYNTH_INTERNAL_TYPES_H__ */
 
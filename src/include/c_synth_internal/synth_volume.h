@@ -4,10 +4,10 @@
  * whenever a new volume is created it can never be deleted; However, if two
  * notes shares the same function, they will point to the same 'volume object'
  * 
- * Volumes are stored in a simple array, since they are only searched and
- * created on compilation time; So, even if lots of volumes are used and they
- * slow down the compilation, there will be no side effects while rendering the
- * song
+ * Volumes are only searched and created on compilation time, through an
+ * open-addressing hash index (keyed by the volume's amplitudes) kept alongside
+ * the list of volumes; So, looking up a volume takes the same time regardless
+ * of how many volumes (and songs) there are in the context
  * 
  * @file src/include/synth_internal/synth_volume.h
  */
@@ -18,6 +18,25 @@
 
 #include <c_synth_internal/synth_types.h>
 
+/**
+ * Retrieve how many slots an index requires, so it's at most half full when
+ * holding every volume
+ * 
+ * @param  [ in]maxVolumes How many volumes may be indexed
+ * @return                 The number of slots (a power of 2)
+ */
+int synthVolume_getIndexLen(int maxVolumes);
+
+/**
+ * Initialize the index of volumes over a previously alloc'ed (or carved) array;
+ * Every volume in the context is indexed
+ * 
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]pIndex The index's slots
+ * @param  [ in]len    How many slots there are (a power of 2)
+ */
+void synthVolume_initIndex(synthCtx *pCtx, int *pIndex, int len);
+
 /**
  * Retrieve a constant volume
  * 
@@ -6,17 +6,32 @@
 #include <c_synth/synth_errors.h>
 
 #include <c_synth_internal/synth_audio.h>
+#include <c_synth_internal/synth_cache.h>
+#include <c_synth_internal/synth_cursor.h>
 #include <c_synth_internal/synth_lexer.h>
+#include <c_synth_internal/synth_list.h>
+#include <c_synth_internal/synth_mixer.h>
+#include <c_synth_internal/synth_note.h>
 #include <c_synth_internal/synth_parser.h>
 #include <c_synth_internal/synth_prng.h>
 #include <c_synth_internal/synth_renderer.h>
+#include <c_synth_internal/synth_segments.h>
 #include <c_synth_internal/synth_types.h>
+#include <c_synth_internal/synth_volume.h>
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
+#if defined(USE_MMAP)
+#  include <fcntl.h>
+#  include <limits.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
 /**
  * Retrieve the total size for a context
  * 
@@ -45,11 +60,23 @@ synth_err synth_getStaticContextSize(int *pSize, int maxSongs, int maxTracks,
 
     /* Retrieve the struct size */
     *pSize = (int)sizeof(synthCtx);
-    /* Increase it for each object used (in a list) */
-    *pSize += (int)(sizeof(synthAudio) * maxSongs);
-    *pSize += (int)(sizeof(synthTrack) * maxTracks);
-    *pSize += (int)(sizeof(synthNote) * maxNotes);
-    *pSize += (int)(sizeof(synthVolume) * maxVolumes);
+    /* Increase it for each object used (in a list); Items released by a song
+     * are removed from the lists, so no range of released items is kept */
+    *pSize += synthList_getStaticSize(maxSongs, sizeof(synthAudio),
+            SYNTH_LIST_SONGS_SHIFT, 0);
+    *pSize += synthList_getStaticSize(maxTracks, sizeof(synthTrack),
+            SYNTH_LIST_TRACKS_SHIFT, 0);
+    *pSize += synthList_getStaticSize(maxNotes, sizeof(synthNote),
+            SYNTH_LIST_NOTES_SHIFT, 0);
+    *pSize += synthList_getStaticSize(maxVolumes, sizeof(synthVolume),
+            SYNTH_LIST_VOLUMES_SHIFT, 0);
+    /* Every note has a timeline entry (and every track, another one for its
+     * end), and at most every note is a loop */
+    *pSize += synthList_getStaticSize(maxNotes + maxTracks,
+            sizeof(synthTimelineEntry), 0, 0);
+    *pSize += synthList_getStaticSize(maxNotes, sizeof(synthLoop), 0, 0);
+    /* Volumes are looked up through a hash index */
+    *pSize += synthVolume_getIndexLen(maxVolumes) * (int)sizeof(int);
 
     rv = SYNTH_OK;
 __err:
@@ -73,10 +100,14 @@ synth_err synth_getContextSize(int *pSize, synthCtx *pCtx) {
     /* Retrieve the struct size */
     *pSize = (int)sizeof(synthCtx);
     /* Increase it for each object used (in a list) */
-    *pSize += (int)(sizeof(synthAudio) * pCtx->songs.len);
-    *pSize += (int)(sizeof(synthTrack) * pCtx->tracks.len);
-    *pSize += (int)(sizeof(synthNote) * pCtx->notes.len);
-    *pSize += (int)(sizeof(synthVolume) * pCtx->volumes.len);
+    *pSize += synthList_getSize(&(pCtx->songs), sizeof(synthAudio));
+    *pSize += synthList_getSize(&(pCtx->tracks), sizeof(synthTrack));
+    *pSize += synthList_getSize(&(pCtx->notes), sizeof(synthNote));
+    *pSize += synthList_getSize(&(pCtx->volumes), sizeof(synthVolume));
+    *pSize += synthList_getSize(&(pCtx->timeline),
+            sizeof(synthTimelineEntry));
+    *pSize += synthList_getSize(&(pCtx->loops), sizeof(synthLoop));
+    *pSize += pCtx->volumeIndexLen * (int)sizeof(int);
 
     /* TODO Ensure no object is missing!! */
 
@@ -95,9 +126,14 @@ __err:
  * version, so the required memory to whatever is desired is calculated, before
  * trying to use this mode;
  * 
+ * Every song, track, note and volume (as well as each track's timeline and
+ * loops) is taken from 'pMem', and compiling a song that would exceed any of
+ * the limits fails with SYNTH_MEM_ERR. Rendered notes aren't cached, since the
+ * cache is dynamically alloc'ed (see 'synth_setNoteCacheSize')
+ * 
  * @param  [out]ppCtx      The new synthesizer context
- * @param  [ in]pMem       'synth_getContextSize' bytes or NULL, if the library
- *                         should alloc the structure however it wants
+ * @param  [ in]pMem       'synth_getStaticContextSize' bytes or NULL, if the
+ *                         library should alloc the structure however it wants
  * @param  [ in]freq       Synthesizer frequency, in samples per seconds
  * @param  [ in]maxSongs   How many songs can be compiled at the same time
  * @param  [ in]maxTracks  How many tracks can be used through all songs
@@ -107,8 +143,88 @@ __err:
  */
 synth_err synth_initStatic(synthCtx **ppCtx, void *pMem, int freq, int maxSongs,
         int maxTracks, int maxNotes, int maxVolumes) {
-    /* TODO Implement the function 'synth_initStatic' */
-    return SYNTH_FUNCTION_NOT_IMPLEMENTED;
+    char *pData;
+    int isAlloced, size;
+    synthCtx *pCtx;
+    synth_err rv;
+
+    /* Initialize this with NULL so it can be cleaned on error */
+    pCtx = 0;
+    isAlloced = 0;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppCtx, SYNTH_BAD_PARAM_ERR);
+
+    /* Retrieve how much memory is required (checking the limits) */
+    rv = synth_getStaticContextSize(&size, maxSongs, maxTracks, maxNotes,
+            maxVolumes);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Alloc every list along with the context, if the user didn't */
+    if (!pMem) {
+        pMem = malloc(size);
+        SYNTH_ASSERT_ERR(pMem, SYNTH_MEM_ERR);
+        isAlloced = 1;
+    }
+    memset(pMem, 0x0, size);
+
+    /* The context is at the start of the block, followed by every list;
+     * Each list is rounded so the next one is aligned (since some start with
+     * their table of blocks) */
+    pCtx = (synthCtx*)pMem;
+    pCtx->blockAlloced = isAlloced;
+    pData = (char*)(pCtx + 1);
+
+#define SYNTH_CARVE_LIST(list, type, num, shift, numFree) \
+    do { \
+        synthList_initStatic(&(pCtx->list), pData, num, sizeof(type), \
+                shift, numFree); \
+        pData += synthList_getStaticSize(num, sizeof(type), shift, numFree); \
+    } while (0)
+
+    SYNTH_CARVE_LIST(songs, synthAudio, maxSongs, SYNTH_LIST_SONGS_SHIFT, 0);
+    SYNTH_CARVE_LIST(tracks, synthTrack, maxTracks, SYNTH_LIST_TRACKS_SHIFT,
+            0);
+    SYNTH_CARVE_LIST(notes, synthNote, maxNotes, SYNTH_LIST_NOTES_SHIFT, 0);
+    SYNTH_CARVE_LIST(volumes, synthVolume, maxVolumes,
+            SYNTH_LIST_VOLUMES_SHIFT, 0);
+    SYNTH_CARVE_LIST(timeline, synthTimelineEntry, maxNotes + maxTracks, 0,
+            0);
+    SYNTH_CARVE_LIST(loops, synthLoop, maxNotes, 0, 0);
+
+#undef SYNTH_CARVE_LIST
+
+    /* The index of volumes is placed after every list */
+    synthVolume_initIndex(pCtx, (int*)pData,
+            synthVolume_getIndexLen(maxVolumes));
+
+    /* Set the synthesizer frequency */
+    pCtx->frequency = freq;
+    /* Render songs on a single thread, by default */
+    pCtx->numThreads = 1;
+    /* Don't cache rendered notes, since the cache is dynamically alloc'ed
+     * (it may still be enabled through 'synth_setNoteCacheSize') */
+    rv = synthCache_init(&(pCtx->noteCache), 0);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    /* Pre-calculate how each note advances per sample at that frequency */
+    rv = synthNote_initPhaseTable(pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    /* Initialize the prng */
+    rv = synthPRNG_init(&(pCtx->prngCtx), (unsigned int)time(0));
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Set the return */
+    *ppCtx = pCtx;
+    rv = SYNTH_OK;
+    /* Make sure the context isn't cleared */
+    pCtx = 0;
+__err:
+    if (pCtx) {
+        /* Free the context (and its memory, if it was alloc'ed here) */
+        synth_free(&pCtx);
+    }
+
+    return rv;
 }
 
 /**
@@ -135,8 +251,21 @@ synth_err synth_init(synthCtx **ppCtx, int freq) {
 
     /* Set it as being dynamically alloc'ed */
     pCtx->autoAlloced = 1;
+    /* Store songs, tracks, notes and volumes in blocks */
+    pCtx->songs.shift = SYNTH_LIST_SONGS_SHIFT;
+    pCtx->tracks.shift = SYNTH_LIST_TRACKS_SHIFT;
+    pCtx->notes.shift = SYNTH_LIST_NOTES_SHIFT;
+    pCtx->volumes.shift = SYNTH_LIST_VOLUMES_SHIFT;
     /* Set the synthesizer frequency */
     pCtx->frequency = freq;
+    /* Render songs on a single thread, by default */
+    pCtx->numThreads = 1;
+    /* Keep the rendered notes, so they may be copied whenever repeated */
+    rv = synthCache_init(&(pCtx->noteCache), SYNTH_DEFAULT_CACHE_SIZE);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    /* Pre-calculate how each note advances per sample at that frequency */
+    rv = synthNote_initPhaseTable(pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
     /* Initialize the prng */
     rv = synthPRNG_init(&(pCtx->prngCtx), (unsigned int)time(0));
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
@@ -173,31 +302,30 @@ synth_err synth_free(synthCtx **ppCtx) {
     /* This must be done either way, since any open file must be manually
      * closed */
     synthLexer_clear(&((*ppCtx)->lexCtx));
+    /* The cached notes are always dynamically alloc'ed */
+    synthCache_clear(&((*ppCtx)->noteCache));
 
     /* Check that it was dynamic alloc'ed */
     if (!((*ppCtx)->autoAlloced)) {
+        /* Every list is within the context's block */
+        if ((*ppCtx)->blockAlloced) {
+            free(*ppCtx);
+        }
         *ppCtx = 0;
         rv = SYNTH_OK;
         goto __err;
     }
 
-    /* Dealloc the struct itself */
-    if ((*ppCtx)->songs.buf.pAudios) {
-        free((*ppCtx)->songs.buf.pAudios);
+    /* Dealloc every list */
+    synthList_clear(&((*ppCtx)->songs));
+    synthList_clear(&((*ppCtx)->tracks));
+    synthList_clear(&((*ppCtx)->notes));
+    synthList_clear(&((*ppCtx)->volumes));
+    synthList_clear(&((*ppCtx)->timeline));
+    synthList_clear(&((*ppCtx)->loops));
+    if ((*ppCtx)->pVolumeIndex) {
+        free((*ppCtx)->pVolumeIndex);
     }
-    if ((*ppCtx)->tracks.buf.pTracks) {
-        free((*ppCtx)->tracks.buf.pTracks);
-    }
-    if ((*ppCtx)->notes.buf.pNotes) {
-        free((*ppCtx)->notes.buf.pNotes);
-    }
-    if ((*ppCtx)->volumes.buf.pVolumes) {
-        free((*ppCtx)->volumes.buf.pVolumes);
-    }
-    (*ppCtx)->songs.buf.pAudios = 0;
-    (*ppCtx)->tracks.buf.pTracks = 0;
-    (*ppCtx)->notes.buf.pNotes = 0;
-    (*ppCtx)->volumes.buf.pVolumes = 0;
 
     /* Finally, dealloc the struct itself */
     free(*ppCtx);
@@ -208,6 +336,25 @@ __err:
     return rv;
 }
 
+/**
+ * Release whatever memory isn't used by the context's lists, if requested (see
+ * 'synth_setShrinkToFit')
+ * 
+ * @param  [ in]pCtx The synthesizer context
+ */
+static void synth_shrinkLists(synthCtx *pCtx) {
+    if (!pCtx->shrinkToFit) {
+        return;
+    }
+
+    synthList_shrink(&(pCtx->songs), sizeof(synthAudio));
+    synthList_shrink(&(pCtx->tracks), sizeof(synthTrack));
+    synthList_shrink(&(pCtx->notes), sizeof(synthNote));
+    synthList_shrink(&(pCtx->volumes), sizeof(synthVolume));
+    synthList_shrink(&(pCtx->timeline), sizeof(synthTimelineEntry));
+    synthList_shrink(&(pCtx->loops), sizeof(synthLoop));
+}
+
 /**
  * Parse a file into a compiled song. The file must have been opened as a
  * SDL_RWops file
@@ -222,7 +369,8 @@ synth_err synth_compileSongFromSDL_RWops(int *pHandle, synthCtx *pCtx,
     synthAudio *pAudio;
     synth_err rv;
 
-    /* TODO Store the previous buffer sizes so we can clean it on error */
+    /* Clean the audio, so it's only released if it was retrieved */
+    pAudio = 0;
 
     /* Sanitize the arguments */
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
@@ -237,12 +385,17 @@ synth_err synth_compileSongFromSDL_RWops(int *pHandle, synthCtx *pCtx,
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     /* Return the newly compiled song */
-    *pHandle = pCtx->songs.used - 1;
-    /* 'Push' the audio into the buffer */
+    *pHandle = pAudio->handle;
+
+    /* Release whatever the lists won't use, if requested (which may move the
+     * audio) */
+    synth_shrinkLists(pCtx);
+
     rv = SYNTH_OK;
 __err:
-    if (rv != SYNTH_OK) {
-        /* TODO Clear the newly used objects */
+    if (rv != SYNTH_OK && pAudio) {
+        /* Release every object used by the song, so they may be reused */
+        synthAudio_discard(pAudio, pCtx);
     }
 
     return rv;
@@ -268,7 +421,8 @@ synth_err synth_compileSongFromFile(int *pHandle, synthCtx *pCtx,
     synthAudio *pAudio;
     synth_err rv;
 
-    /* TODO Store the previous buffer sizes so we can clean it on error */
+    /* Clean the audio, so it's only released if it was retrieved */
+    pAudio = 0;
 
     /* Sanitize the arguments */
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
@@ -293,12 +447,17 @@ synth_err synth_compileSongFromFile(int *pHandle, synthCtx *pCtx,
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     /* Return the newly compiled song */
-    *pHandle = pCtx->songs.used - 1;
-    /* 'Push' the audio into the buffer */
+    *pHandle = pAudio->handle;
+
+    /* Release whatever the lists won't use, if requested (which may move the
+     * audio) */
+    synth_shrinkLists(pCtx);
+
     rv = SYNTH_OK;
 __err:
-    if (rv != SYNTH_OK) {
-        /* TODO Clear the newly used objects */
+    if (rv != SYNTH_OK && pAudio) {
+        /* Release every object used by the song, so they may be reused */
+        synthAudio_discard(pAudio, pCtx);
     }
 
     return rv;
@@ -321,7 +480,8 @@ synth_err synth_compileSongFromString(int *pHandle, synthCtx *pCtx,
     synthAudio *pAudio;
     synth_err rv;
 
-    /* TODO Store the previous buffer sizes so we can clean it on error */
+    /* Clean the audio, so it's only released if it was retrieved */
+    pAudio = 0;
 
     /* Sanitize the arguments */
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
@@ -338,13 +498,260 @@ synth_err synth_compileSongFromString(int *pHandle, synthCtx *pCtx,
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     /* Return the newly compiled song */
-    *pHandle = pCtx->songs.used - 1;
-    /* 'Push' the audio into the buffer */
+    *pHandle = pAudio->handle;
+
+    /* Release whatever the lists won't use, if requested (which may move the
+     * audio) */
+    synth_shrinkLists(pCtx);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK && pAudio) {
+        /* Release every object used by the song, so they may be reused */
+        synthAudio_discard(pAudio, pCtx);
+    }
+
+    return rv;
+}
+
+/**
+ * Release a compiled song, so its notes, tracks and loops may be reused by
+ * songs compiled later; The song's volumes are kept, since those are shared by
+ * every song
+ * 
+ * The handle (as well as any cursor of the song) becomes invalid, and using it
+ * fails with SYNTH_INVALID_INDEX, even after another song reuses its memory
+ * 
+ * On static contexts, every song compiled after it is moved back over its
+ * memory, so the context's whole free space may be used by the next song
+ * 
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]handle Handle of the audio
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                     SYNTH_MEM_ERR
+ */
+synth_err synth_freeSong(synthCtx *pCtx, int handle) {
+    synthAudio *pAudio;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
+    /* Check that the handle is valid */
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = synthAudio_free(pAudio, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Release whatever the lists won't use, if requested */
+    synth_shrinkLists(pCtx);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Save a compiled song into a file, so it may later be loaded (see
+ * 'synth_loadCompiled') without compiling its MML again
+ * 
+ * The file may only be loaded by contexts with the same frequency, but it
+ * doesn't depend on any other song nor on the machine's byte order
+ * 
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]handle    Handle of the audio
+ * @param  [ in]pFilename The file
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                        SYNTH_MEM_ERR, SYNTH_OPEN_FILE_ERR
+ */
+synth_err synth_saveCompiled(synthCtx *pCtx, int handle, char *pFilename) {
+    char *pData;
+    FILE *pFp;
+    int len;
+    synthAudio *pAudio;
+    synth_err rv;
+
+    /* Clean everything, so it's only released if it was retrieved */
+    pData = 0;
+    pFp = 0;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pFilename, SYNTH_BAD_PARAM_ERR);
+    /* Check that the handle is valid */
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = synthAudio_save(&pData, &len, pAudio, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    pFp = fopen(pFilename, "wb");
+    SYNTH_ASSERT_ERR(pFp, SYNTH_OPEN_FILE_ERR);
+    SYNTH_ASSERT_ERR(fwrite(pData, 1, (size_t)len, pFp) == (size_t)len,
+            SYNTH_OPEN_FILE_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    if (pFp) {
+        /* Data may only be written as the file is closed */
+        if (fclose(pFp) != 0 && rv == SYNTH_OK) {
+            rv = SYNTH_OPEN_FILE_ERR;
+        }
+    }
+    if (pData) {
+        free(pData);
+    }
+
+    return rv;
+}
+
+/**
+ * Load a song previously saved by 'synth_saveCompiled' (and already read into
+ * memory); The buffer isn't referenced after the song is loaded
+ * 
+ * @param  [out]pHandle Handle of the loaded song
+ * @param  [ in]pCtx    The synthesizer context
+ * @param  [ in]pData   The saved song
+ * @param  [ in]length  The saved song's length, in bytes
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR,
+ *                      SYNTH_INVALID_COMPILED_SONG
+ */
+synth_err synth_loadCompiledFromMemory(int *pHandle, synthCtx *pCtx,
+        void *pData, int length) {
+    synthAudio *pAudio;
+    synth_err rv;
+
+    /* Clean the audio, so it's only released if it was retrieved */
+    pAudio = 0;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pHandle, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pData, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(length >= 0, SYNTH_BAD_PARAM_ERR);
+
+    /* Retrieve the new audio */
+    rv = synthAudio_init(&pAudio, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    /* Load the song */
+    rv = synthAudio_load(pAudio, pCtx, (char*)pData, length);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Return the newly loaded song */
+    *pHandle = pAudio->handle;
+
+    /* Release whatever the lists won't use, if requested (which may move the
+     * audio) */
+    synth_shrinkLists(pCtx);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK && pAudio) {
+        /* Release every object used by the song, so they may be reused */
+        synthAudio_discard(pAudio, pCtx);
+    }
+
+    return rv;
+}
+
+/**
+ * Load a song previously saved by 'synth_saveCompiled' from a file
+ * 
+ * The file is mapped read-only (if supported by the system) and the song is
+ * loaded straight from the mapping, so nothing is lexed nor parsed
+ * 
+ * @param  [out]pHandle   Handle of the loaded song
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pFilename The file
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR,
+ *                        SYNTH_OPEN_FILE_ERR, SYNTH_INVALID_COMPILED_SONG
+ */
+synth_err synth_loadCompiled(int *pHandle, synthCtx *pCtx, char *pFilename) {
+    void *pData;
+    int len;
+    synth_err rv;
+#if defined(USE_MMAP)
+    struct stat st;
+    int fd;
+
+    /* Clean everything, so it's only released if it was retrieved */
+    pData = 0;
+    len = 0;
+    fd = -1;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pHandle, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pFilename, SYNTH_BAD_PARAM_ERR);
+
+    fd = open(pFilename, O_RDONLY);
+    SYNTH_ASSERT_ERR(fd >= 0, SYNTH_OPEN_FILE_ERR);
+    SYNTH_ASSERT_ERR(fstat(fd, &st) == 0, SYNTH_OPEN_FILE_ERR);
+    SYNTH_ASSERT_ERR(S_ISREG(st.st_mode), SYNTH_OPEN_FILE_ERR);
+    /* Empty files can't be mapped (nor are they a song) */
+    SYNTH_ASSERT_ERR(st.st_size > 0 && st.st_size < INT_MAX,
+            SYNTH_INVALID_COMPILED_SONG);
+
+    pData = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (pData == MAP_FAILED) {
+        pData = 0;
+    }
+    SYNTH_ASSERT_ERR(pData, SYNTH_OPEN_FILE_ERR);
+    len = (int)st.st_size;
+    /* The song is loaded from its start to its end */
+    madvise(pData, (size_t)len, MADV_SEQUENTIAL);
+#else
+    FILE *pFp;
+    long size;
+
+    /* Clean everything, so it's only released if it was retrieved */
+    pData = 0;
+    pFp = 0;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pHandle, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pFilename, SYNTH_BAD_PARAM_ERR);
+
+    /* Read the whole file into memory */
+    pFp = fopen(pFilename, "rb");
+    SYNTH_ASSERT_ERR(pFp, SYNTH_OPEN_FILE_ERR);
+    SYNTH_ASSERT_ERR(fseek(pFp, 0, SEEK_END) == 0, SYNTH_OPEN_FILE_ERR);
+    size = ftell(pFp);
+    SYNTH_ASSERT_ERR(size > 0 && size < 0x7fffffff,
+            SYNTH_INVALID_COMPILED_SONG);
+    SYNTH_ASSERT_ERR(fseek(pFp, 0, SEEK_SET) == 0, SYNTH_OPEN_FILE_ERR);
+    len = (int)size;
+
+    pData = malloc(len);
+    SYNTH_ASSERT_ERR(pData, SYNTH_MEM_ERR);
+    SYNTH_ASSERT_ERR(fread(pData, 1, (size_t)len, pFp) == (size_t)len,
+            SYNTH_OPEN_FILE_ERR);
+#endif
+
+    rv = synth_loadCompiledFromMemory(pHandle, pCtx, pData, len);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
     rv = SYNTH_OK;
 __err:
-    if (rv != SYNTH_OK) {
-        /* TODO Clear the newly used objects */
+#if defined(USE_MMAP)
+    /* The mapping is kept even after the file is closed */
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (pData) {
+        munmap(pData, (size_t)len);
+    }
+#else
+    if (pFp) {
+        fclose(pFp);
     }
+    if (pData) {
+        free(pData);
+    }
+#endif
 
     return rv;
 }
@@ -382,15 +789,17 @@ __err:
  * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX
  */
 synth_err synth_getAudioTrackCount(int *pNum, synthCtx *pCtx, int handle) {
+    synthAudio *pAudio;
     synth_err rv;
 
     /* Sanitize the arguments */
     SYNTH_ASSERT_ERR(pNum, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
     /* Check that the handle is valid */
-    SYNTH_ASSERT_ERR(handle < pCtx->songs.used, SYNTH_INVALID_INDEX);
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    rv = synthAudio_getTrackCount(pNum, &(pCtx->songs.buf.pAudios[handle]));
+    rv = synthAudio_getTrackCount(pNum, pAudio);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
@@ -409,21 +818,17 @@ __err:
  */
 synth_err synth_getTrackLength(int *pLen, synthCtx *pCtx, int handle,
         int track) {
+    synthAudio *pAudio;
     synth_err rv;
 
     /* Sanitize the arguments */
     SYNTH_ASSERT_ERR(pLen, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
     /* Check that the handle is valid */
-    SYNTH_ASSERT_ERR(handle < pCtx->songs.used, SYNTH_INVALID_INDEX);
-
-    /* Setup the renderer so the track length can be calculated */
-    rv = synthRenderer_init(&(pCtx->renderCtx),
-            &(pCtx->songs.buf.pAudios[handle]), pCtx->frequency);
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    rv = synthAudio_getTrackLength(pLen, &(pCtx->songs.buf.pAudios[handle]),
-            pCtx, track);
+    rv = synthAudio_getTrackLength(pLen, pAudio, pCtx, track);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
@@ -442,21 +847,17 @@ __err:
  */
 synth_err synth_getTrackIntroLength(int *pLen, synthCtx *pCtx, int handle,
         int track) {
+    synthAudio *pAudio;
     synth_err rv;
 
     /* Sanitize the arguments */
     SYNTH_ASSERT_ERR(pLen, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
     /* Check that the handle is valid */
-    SYNTH_ASSERT_ERR(handle < pCtx->songs.used, SYNTH_INVALID_INDEX);
-
-    /* Setup the renderer so the track length can be calculated */
-    rv = synthRenderer_init(&(pCtx->renderCtx),
-            &(pCtx->songs.buf.pAudios[handle]), pCtx->frequency);
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    rv = synthAudio_getTrackIntroLength(pLen,
-            &(pCtx->songs.buf.pAudios[handle]), pCtx, track);
+    rv = synthAudio_getTrackIntroLength(pLen, pAudio, pCtx, track);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
@@ -476,16 +877,17 @@ __err:
 synth_err synth_isTrackLoopable(int *pVal, synthCtx *pCtx, int handle,
         int track) {
     synth_bool brv;
+    synthAudio *pAudio;
     synth_err rv;
 
     /* Sanitize the arguments */
     SYNTH_ASSERT_ERR(pVal, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
     /* Check that the handle is valid */
-    SYNTH_ASSERT_ERR(handle < pCtx->songs.used, SYNTH_INVALID_INDEX);
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    brv = synthAudio_isTrackLoopable(&(pCtx->songs.buf.pAudios[handle]), pCtx,
-            track);
+    brv = synthAudio_isTrackLoopable(pAudio, pCtx, track);
     *pVal = (brv == SYNTH_TRUE);
 
     rv = SYNTH_OK;
@@ -494,20 +896,21 @@ __err:
 }
 
 /**
- * Render a track into a buffer
- * 
- * The buffer must be prepared by the caller, and it must have
- * 'synth_getTrackLength' bytes times the number of bytes per samples
+ * Render a track into a buffer, using the supplied rendering state
  * 
  * @param  [ in]pBuf   Buffer that will be filled with the track
  * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]pPRNG  Pseudo-random number generator used by noises
+ * @param  [ in]pCache Cache of rendered notes
  * @param  [ in]handle Handle of the audio
  * @param  [ in]pTrack The track
  * @param  [ in]mode   Desired mode for the wave
  * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
  */
-synth_err synth_renderTrack(char *pBuf, synthCtx *pCtx, int handle, int track,
+static synth_err synth_renderTrackWith(char *pBuf, synthCtx *pCtx,
+        synthPRNGCtx *pPRNG, synthCache *pCache, int handle, int track,
         synthBufMode mode) {
+    synthAudio *pAudio;
     synth_err rv;
 
     /* Sanitize the arguments */
@@ -515,15 +918,40 @@ synth_err synth_renderTrack(char *pBuf, synthCtx *pCtx, int handle, int track,
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR((mode & SYNTH_VALID_MODE_MASK) != 0, SYNTH_BAD_PARAM_ERR);
     /* Check that the handle is valid */
-    SYNTH_ASSERT_ERR(handle < pCtx->songs.used, SYNTH_INVALID_INDEX);
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    /* Setup the renderer so the track length can be calculated */
-    rv = synthRenderer_init(&(pCtx->renderCtx),
-            &(pCtx->songs.buf.pAudios[handle]), pCtx->frequency);
+    rv = synthAudio_renderTrack(pBuf, pAudio, pCtx, pPRNG, pCache, track,
+            mode);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    rv = synthAudio_renderTrack(pBuf, &(pCtx->songs.buf.pAudios[handle]),
-            pCtx, track, mode);
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Render a track into a buffer
+ * 
+ * The buffer must be prepared by the caller, and it must have
+ * 'synth_getTrackLength' bytes times the number of bytes per samples
+ * 
+ * @param  [ in]pBuf   Buffer that will be filled with the track
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]handle Handle of the audio
+ * @param  [ in]pTrack The track
+ * @param  [ in]mode   Desired mode for the wave
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_renderTrack(char *pBuf, synthCtx *pCtx, int handle, int track,
+        synthBufMode mode) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+
+    rv = synth_renderTrackWith(pBuf, pCtx, &(pCtx->prngCtx),
+            &(pCtx->noteCache), handle, track, mode);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
@@ -534,6 +962,8 @@ __err:
 /**
  * Check whether a song can loop nicely in a single iteration
  * 
+ * The verdict is calculated only once, when the song is compiled
+ * 
  * @param  [out]pLen   The length of the track's intro
  * @param  [ in]pCtx   The synthesizer context
  * @param  [ in]handle Handle of the audio
@@ -541,7 +971,6 @@ __err:
  *                     SYNTH_COMPLEX_LOOPPOINT, SYNTH_NOT_LOOPABLE
  */
 synth_err synth_canSongLoop(synthCtx *pCtx, int handle) {
-    int i, maxLen, maxLoopPoint, numTracks;
     synthAudio *pAudio;
     synth_err rv;
 
@@ -549,88 +978,10 @@ synth_err synth_canSongLoop(synthCtx *pCtx, int handle) {
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
     /* Check if the song is valid */
-    SYNTH_ASSERT_ERR(handle < pCtx->songs.used, SYNTH_INVALID_INDEX);
-
-    /* Retrieve the audio */
-    pAudio = &(pCtx->songs.buf.pAudios[handle]);
-
-    /* Setup the renderer so the track length can be calculated */
-    rv = synthRenderer_init(&(pCtx->renderCtx),
-            &(pCtx->songs.buf.pAudios[handle]), pCtx->frequency);
-    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
-    /* Count how many tracks there are */
-    rv = synthAudio_getTrackCount(&numTracks, pAudio);
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    /* Check if at least one of the tracks are loopable */
-    i = 0;
-    while (i < numTracks) {
-        if (synthAudio_isTrackLoopable(pAudio, pCtx, i) == SYNTH_TRUE) {
-            break;
-        }
-
-        i++;
-    }
-    SYNTH_ASSERT_ERR(i < numTracks, SYNTH_NOT_LOOPABLE);
-
-    /* Search the longest length and loop point */
-    i = 0;
-    maxLen = 0;
-    maxLoopPoint = 0;
-    while (i < numTracks) {
-        int len, loopPoint, track;
-
-        track = i;
-        i++;
-
-        /* Move on to the next track if it isn't loop-able */
-        if (synthAudio_isTrackLoopable(pAudio, pCtx, track) == SYNTH_FALSE) {
-            continue;
-        }
-
-        /* Retrieve the current track length and loop point */
-        rv = synthAudio_getTrackLength(&len, pAudio, pCtx, track);
-        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-        rv = synthAudio_getTrackIntroLength(&loopPoint, pAudio, pCtx, track);
-        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
-        /* Check if this new one is greater than the previous */
-        if (len > maxLen) {
-            maxLen = len;
-        }
-        if (loopPoint > maxLoopPoint) {
-            maxLoopPoint = loopPoint;
-        }
-    }
-
-    /* Iterate, again, over every track and check if their limits overlaps
-     * nicelly */
-    i = 0;
-    while (i < numTracks) {
-        int len, loopPoint, track;
-
-        track = i;
-        i++;
-
-        /* Move on to the next track if it isn't loop-able */
-        if (synthAudio_isTrackLoopable(pAudio, pCtx, track) == SYNTH_FALSE) {
-            continue;
-        }
-
-        /* Retrieve the current track length and loop point */
-        rv = synthAudio_getTrackLength(&len, pAudio, pCtx, track);
-        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-        rv = synthAudio_getTrackIntroLength(&loopPoint, pAudio, pCtx, track);
-        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
-        /* Check that this track's lengths are compatible with the song's
-         * lengths */
-        SYNTH_ASSERT_ERR((maxLoopPoint + maxLen - loopPoint) % len == 0,
-                SYNTH_COMPLEX_LOOPPOINT);
-    }
-
-    rv = SYNTH_OK;
+    rv = synthAudio_canLoop(pAudio);
 __err:
     return rv;
 }
@@ -649,7 +1000,6 @@ __err:
  *                     SYNTH_COMPLEX_LOOPPOINT
  */
 synth_err synth_getSongLength(int *pLen, synthCtx *pCtx, int handle) {
-    int i, maxLen, numTracks;
     synthAudio *pAudio;
     synth_err rv;
 
@@ -658,42 +1008,16 @@ synth_err synth_getSongLength(int *pLen, synthCtx *pCtx, int handle) {
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
     /* Check if the song is valid */
-    SYNTH_ASSERT_ERR(handle < pCtx->songs.used, SYNTH_INVALID_INDEX);
-    rv = SYNTH_OK;
-
-    /* Setup the renderer so the track length can be calculated */
-    rv = synthRenderer_init(&(pCtx->renderCtx),
-            &(pCtx->songs.buf.pAudios[handle]), pCtx->frequency);
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     /* Check that either the song doesn't loop or that it's loopable */
-    rv = synth_canSongLoop(pCtx, handle);
+    rv = synthAudio_canLoop(pAudio);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK || rv == SYNTH_NOT_LOOPABLE, rv);
 
-    /* Retrieve the audio */
-    pAudio = &(pCtx->songs.buf.pAudios[handle]);
-
-    /* Count how many tracks there are */
-    rv = synthAudio_getTrackCount(&numTracks, pAudio);
+    rv = synthAudio_getLength(pLen, pAudio);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    /* Retrieve the longets length */
-    i = 0;
-    maxLen = 0;
-    while (i < numTracks) {
-        int len;
-
-        rv = synthAudio_getTrackLength(&len, pAudio, pCtx, i);
-        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
-        if (len > maxLen) {
-            maxLen = len;
-        }
-
-        i++;
-    }
-
-    *pLen = maxLen;
     rv = SYNTH_OK;
 __err:
     return rv;
@@ -713,7 +1037,6 @@ __err:
  *                     SYNTH_COMPLEX_LOOPPOINT, SYNTH_NOT_LOOPABLE
  */
 synth_err synth_getSongIntroLength(int *pLen, synthCtx *pCtx, int handle) {
-    int i, maxLoopPoint, numTracks;
     synthAudio *pAudio;
     synth_err rv;
 
@@ -722,292 +1045,88 @@ synth_err synth_getSongIntroLength(int *pLen, synthCtx *pCtx, int handle) {
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
     /* Check if the song is valid */
-    SYNTH_ASSERT_ERR(handle < pCtx->songs.used, SYNTH_INVALID_INDEX);
-    rv = SYNTH_OK;
-
-    /* Setup the renderer so the track length can be calculated */
-    rv = synthRenderer_init(&(pCtx->renderCtx),
-            &(pCtx->songs.buf.pAudios[handle]), pCtx->frequency);
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    /* Check that either the song doesn't loop or that it's loopable */
-    rv = synth_canSongLoop(pCtx, handle);
+    /* Fails unless the song loops nicely */
+    rv = synthAudio_getIntroLength(pLen, pAudio);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    /* Retrieve the audio */
-    pAudio = &(pCtx->songs.buf.pAudios[handle]);
-
-    /* Count how many tracks there are */
-    rv = synthAudio_getTrackCount(&numTracks, pAudio);
-    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
-    /* Retrieve the longets length */
-    i = 0;
-    maxLoopPoint = 0;
-    while (i < numTracks) {
-        int loopPoint, track;
-
-        track = i;
-        i++;
-
-        /* Move on to the next track if it isn't loop-able */
-        if (synthAudio_isTrackLoopable(pAudio, pCtx, track) == SYNTH_FALSE) {
-            continue;
-        }
-
-        /* Retrieve the current track length and loop point */
-        rv = synthAudio_getTrackIntroLength(&loopPoint, pAudio, pCtx, track);
-        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
-        if (loopPoint > maxLoopPoint) {
-            maxLoopPoint = loopPoint;
-        }
-    }
-
-    *pLen = maxLoopPoint;
     rv = SYNTH_OK;
 __err:
     return rv;
 }
 
+/* TODO */
+
 /**
- * Accumulate a temporary buffer into another buffer
- * 
- * If, at any point, a sample overflow its bit-per-sample, it will drop the
- * least significant bits
+ * Render all of a song's tracks into a buffer, using the supplied rendering
+ * state
  * 
- * @param  [ in]pBuf Buffer that will be joined by the other track
- * @param  [ in]pTmp Temporary buffer with the last track
- * @param  [ in]mode Desired mode for the song
- * @oaram  [ in]len  The number of samples to be accumulated
- * @return           Whether any overflow happened
+ * @param  [ in]pBuf   Buffer that will be filled with the song
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]pPRNG  PRNG copied for each track
+ * @param  [ in]pCache Cache of rendered notes
+ * @param  [ in]handle Handle of the audio
+ * @param  [ in]mode   Desired mode for the song
+ * @param  [ in]pTmp   Temporary buffer that will be filled with each track
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                     SYNTH_COMPLEX_LOOPPOINT, SYNTH_MEM_ERR,
+ *                     SYNTH_THREAD_INIT_FAILED
  */
-static synth_bool synth_accumulateSongTrack(char *pBuf, char *pTmp,
-        synthBufMode mode, int len) {
-    synth_bool rv;
-    int i, j;
-
-    rv = SYNTH_FALSE;
-
-    i = 0;
-    j = 0;
-    while (i < len) {
-        switch (mode) {
-            case SYNTH_1CHAN_U8BITS: {
-                unsigned int dst, src;
-
-                src = pTmp[j] & 0xff;
-                dst = pBuf[j] & 0xff;
-
-                dst += src;
-                while (dst > 0xff) {
-                    dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-
-                pBuf[j] = dst;
-
-                j++;
-            } break;
-            case SYNTH_1CHAN_8BITS: {
-                int dst, src;
-
-                src = pTmp[j] & 0xff;
-                dst = pBuf[j] & 0xff;
-
-                if (src & 0x80) {
-                    src |= 0xffffff00;
-                }
-                if (dst & 0x80) {
-                    dst |= 0xffffff00;
-                }
-
-                dst += src;
-                while (dst > 0xff) {
-                    dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-
-                pBuf[j] = dst;
-
-                j++;
-            } break;
-            case SYNTH_1CHAN_U16BITS: {
-                unsigned int dst, src;
-
-                src = (pTmp[j] & 0xff) | ((pTmp[j + 1] << 8) & 0xff00);
-                dst = (pBuf[j] & 0xff) | ((pBuf[j + 1] << 8) & 0xff00);
-
-                dst += src;
-                while (dst > 0xffff) {
-                    dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-
-                pBuf[j] = dst & 0xff;
-                pBuf[j + 1] = (dst >> 8) & 0xff;
-
-                j += 2;
-            } break;
-            case SYNTH_1CHAN_16BITS: {
-                int dst, src;
-
-                src = (pTmp[j] & 0xff) | ((pTmp[j + 1] << 8) & 0xff00);
-                dst = (pBuf[j] & 0xff) | ((pBuf[j + 1] << 8) & 0xff00);
-
-                if (src & 0x8000) {
-                    src |= 0xffff0000;
-                }
-                if (dst & 0x8000) {
-                    dst |= 0xffff0000;
-                }
-
-                dst += src;
-                while (dst > 0xffff) {
-                    dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-
-                pBuf[j] = dst & 0xff;
-                pBuf[j + 1] = (dst >> 8) & 0xff;
-
-                j += 2;
-            } break;
-            case SYNTH_2CHAN_U8BITS: {
-                unsigned int l_dst, l_src, r_dst, r_src;
-
-                l_src = pTmp[j] & 0xff;
-                r_src = pTmp[j + 1] & 0xff;
-                l_dst = pBuf[j] & 0xff;
-                r_dst = pBuf[j + 1] & 0xff;
-
-                l_dst += l_src;
-                r_dst += r_src;
-                while (l_dst > 0xff) {
-                    l_dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-                while (r_dst > 0xff) {
-                    r_dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-
-                pBuf[j] = l_dst;
-                pBuf[j + 1] = r_dst;
-
-                j += 2;
-            } break;
-            case SYNTH_2CHAN_8BITS: {
-                int l_dst, l_src, r_dst, r_src;
-
-                l_src = pTmp[j] & 0xff;
-                r_src = pTmp[j + 1] & 0xff;
-                l_dst = pBuf[j] & 0xff;
-                r_dst = pBuf[j + 1] & 0xff;
-
-                if (l_src & 0x80) {
-                    l_src |= 0xffffff00;
-                }
-                if (r_src & 0x80) {
-                    r_src |= 0xffffff00;
-                }
-                if (l_dst & 0x80) {
-                    l_dst |= 0xffffff00;
-                }
-                if (r_dst & 0x80) {
-                    r_dst |= 0xffffff00;
-                }
-
-                l_dst += l_src;
-                r_dst += r_src;
-                while (l_dst > 0xff) {
-                    l_dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-                while (r_dst > 0xff) {
-                    r_dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-
-                pBuf[j] = l_dst;
-                pBuf[j + 1] = r_dst;
-
-                j += 2;
-            } break;
-            case SYNTH_2CHAN_U16BITS: {
-                unsigned int l_dst, l_src, r_dst, r_src;
-
-                l_src = (pTmp[j] & 0xff) | ((pTmp[j + 1] << 8) & 0xff00);
-                r_src = (pTmp[j + 2] & 0xff) | ((pTmp[j + 3] << 8) & 0xff00);
-                l_dst = (pBuf[j] & 0xff) | ((pBuf[j + 1] << 8) & 0xff00);
-                r_dst = (pBuf[j + 2] & 0xff) | ((pBuf[j + 3] << 8) & 0xff00);
-
-                l_dst += l_src;
-                r_dst += r_src;
-                while (l_dst > 0xffff) {
-                    l_dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-                while (r_dst > 0xffff) {
-                    r_dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-
-                pBuf[j] = l_dst & 0xff;
-                pBuf[j + 1] = (l_dst >> 8) & 0xff;
-                pBuf[j + 2] = r_dst & 0xff;
-                pBuf[j + 3] = (r_dst >> 8) & 0xff;
-
-                j += 4;
-            } break;
-            case SYNTH_2CHAN_16BITS: {
-                int l_dst, l_src, r_dst, r_src;
-
-                l_src = (pTmp[j] & 0xff) | ((pTmp[j + 1] << 8) & 0xff00);
-                r_src = (pTmp[j + 2] & 0xff) | ((pTmp[j + 3] << 8) & 0xff00);
-                l_dst = (pBuf[j] & 0xff) | ((pBuf[j + 1] << 8) & 0xff00);
-                r_dst = (pBuf[j + 2] & 0xff) | ((pBuf[j + 3] << 8) & 0xff00);
-
-                if (l_src & 0x8000) {
-                    l_src |= 0xffff0000;
-                }
-                if (r_src & 0x8000) {
-                    r_src |= 0xffff0000;
-                }
-                if (l_dst & 0x8000) {
-                    l_dst |= 0xffff0000;
-                }
-                if (r_dst & 0x8000) {
-                    r_dst |= 0xffff0000;
-                }
-
-                l_dst += l_src;
-                r_dst += r_src;
-                while (l_dst > 0xffff) {
-                    l_dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-                while (r_dst > 0xffff) {
-                    r_dst >>= 1;
-                    rv = SYNTH_TRUE;
-                }
-
-                pBuf[j] = l_dst & 0xff;
-                pBuf[j + 1] = (l_dst >> 8) & 0xff;
-                pBuf[j + 2] = r_dst & 0xff;
-                pBuf[j + 3] = (r_dst >> 8) & 0xff;
-
-                j += 4;
-            } break;
-            default : { /* Avoids warnings */ }
-        }
+static synth_err synth_renderSongWith(char *pBuf, synthCtx *pCtx,
+        synthPRNGCtx *pPRNG, synthCache *pCache, int handle, synthBufMode mode,
+        char *pTmp) {
+    int numChannels, maxLen;
+    int *pBus;
+    synthAudio *pAudio;
+    synth_err rv;
+
+    /* Clean the bus, so it's not freed on error */
+    pBus = 0;
 
-        i++;
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR((mode & SYNTH_VALID_MODE_MASK) != 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pTmp, SYNTH_BAD_PARAM_ERR);
+    /* Check that the handle is valid */
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Check that the song either doesn't loop or can loop nicely */
+    rv = synthAudio_canLoop(pAudio);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK || rv == SYNTH_NOT_LOOPABLE, rv);
+    rv = synthAudio_getLength(&maxLen, pAudio);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Alloc a bus wide enough that tracks may be accumulated without ever
+     * overflowing (and only converted to the desired mode once) */
+    numChannels = 1;
+    if (mode & SYNTH_2CHAN) {
+        numChannels = 2;
+    }
+    pBus = (int*)calloc(maxLen * numChannels, sizeof(int));
+    SYNTH_ASSERT_ERR(pBus, SYNTH_MEM_ERR);
+
+    /* Render each track and accumulate it into the bus */
+    rv = synthAudio_mixTracks(pBus, pTmp, pAudio, pCtx, pPRNG, pCache, maxLen,
+            mode);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Convert the mixed song to the desired mode, halving it if necessary */
+    rv = synthMixer_convertBus(pBuf, pBus, mode, maxLen);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    if (pBus) {
+        free(pBus);
     }
 
     return rv;
 }
-/* TODO */
 
 /**
  * Render all of a song's tracks and accumulate 'em in a single buffer
@@ -1026,11 +1145,202 @@ static synth_bool synth_accumulateSongTrack(char *pBuf, char *pTmp,
  * @param  [ in]mode   Desired mode for the song
  * @param  [ in]pTmp   Temporary buffer that will be filled with each track
  * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
- *                     SYNTH_COMPLEX_LOOPPOINT
+ *                     SYNTH_COMPLEX_LOOPPOINT, SYNTH_MEM_ERR,
+ *                     SYNTH_THREAD_INIT_FAILED
  */
 synth_err synth_renderSong(char *pBuf, synthCtx *pCtx, int handle,
         synthBufMode mode, char *pTmp) {
-    int i, numBytes, numTracks, maxLen;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+
+    rv = synth_renderSongWith(pBuf, pCtx, &(pCtx->prngCtx),
+            &(pCtx->noteCache), handle, mode, pTmp);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Set how many threads may be used to render a song's tracks
+ * 
+ * The song is split into ranges, one for each thread (the calling one
+ * included), and each thread mixes its range of every track, so the rendered
+ * song is exactly the same regardless of the number of threads; Only
+ * 'synth_renderSong' is affected
+ * 
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]numThreads Maximum number of threads (1 disables threading)
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR,
+ *                         SYNTH_FUNCTION_NOT_IMPLEMENTED (if the library was
+ *                         built without threads support)
+ */
+synth_err synth_setRenderThreads(synthCtx *pCtx, int numThreads) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(numThreads > 0, SYNTH_BAD_PARAM_ERR);
+#if !defined(USE_PTHREAD)
+    SYNTH_ASSERT_ERR(numThreads == 1, SYNTH_FUNCTION_NOT_IMPLEMENTED);
+#endif
+
+    pCtx->numThreads = numThreads;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Set whether the context's lists are shrunk to fit after each compiled song
+ * 
+ * Songs, tracks, notes and volumes are alloc'ed in blocks, so some of those
+ * (as well as part of the timeline and loops) may be left unused after a song
+ * is compiled; Shrinking releases them, at the cost of re-alloc'ing the last
+ * block when the next song is compiled. Static contexts are never shrunk
+ * 
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]doShrink 1 to shrink the lists, 0 to keep them (the default)
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_setShrinkToFit(synthCtx *pCtx, int doShrink) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+
+    pCtx->shrinkToFit = doShrink;
+    if (doShrink) {
+        /* Release whatever was left by the previous songs */
+        synth_shrinkLists(pCtx);
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Alloc a new cursor, so a song may be rendered in chunks
+ * 
+ * The cursor keeps track of where each of the song's tracks stopped, so the
+ * song may be continually rendered (e.g., from an audio callback) without
+ * buffering it completely
+ * 
+ * @param  [out]ppCursor The new cursor
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]handle   Handle of the audio
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                       SYNTH_MEM_ERR
+ */
+synth_err synth_initCursor(synthCursor **ppCursor, synthCtx *pCtx, int handle) {
+    synthAudio *pAudio;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppCursor, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
+    /* Check that the handle is valid */
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = synthCursor_init(ppCursor, pCtx, &(pCtx->prngCtx), handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Place a cursor back at the start of its song
+ * 
+ * @param  [ in]pCursor The cursor
+ * @param  [ in]pCtx    The synthesizer context
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX
+ */
+synth_err synth_resetCursor(synthCursor *pCursor, synthCtx *pCtx) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCursor, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+
+    rv = synthCursor_reset(pCursor, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Release a cursor
+ * 
+ * @param  [ in]ppCursor The cursor
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_freeCursor(synthCursor **ppCursor) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppCursor, SYNTH_BAD_PARAM_ERR);
+
+    rv = synthCursor_free(ppCursor);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve how many samples were rendered through a cursor
+ * 
+ * @param  [out]pPos    The cursor's position, in samples
+ * @param  [ in]pCursor The cursor
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_getCursorPosition(int *pPos, synthCursor *pCursor) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pPos, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCursor, SYNTH_BAD_PARAM_ERR);
+
+    *pPos = pCursor->position;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Render the next chunk of a song, starting wherever the cursor stopped
+ * 
+ * Tracks that loop go back to their loop point as soon as they end, while the
+ * other ones output silence; Therefore, the song may be played indefinitely.
+ * Since the song's peak can't be known beforehand, any overflowing sample is
+ * clamped to the mode's range
+ * 
+ * @param  [ in]pBuf       Buffer that will be filled with the chunk; It must
+ *                         have 'numSamples' times the number of bytes per
+ *                         samples
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]handle     Handle of the audio
+ * @param  [ in]pCursor    Cursor initialized for the same audio
+ * @param  [ in]numSamples How many samples should be rendered
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                         SYNTH_MEM_ERR
+ */
+synth_err synth_renderSongChunk(char *pBuf, synthCtx *pCtx, int handle,
+        synthCursor *pCursor, int numSamples, synthBufMode mode) {
     synthAudio *pAudio;
     synth_err rv;
 
@@ -1038,22 +1348,57 @@ synth_err synth_renderSong(char *pBuf, synthCtx *pCtx, int handle,
     SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCursor, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(numSamples >= 0, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR((mode & SYNTH_VALID_MODE_MASK) != 0, SYNTH_BAD_PARAM_ERR);
-    SYNTH_ASSERT_ERR(pTmp, SYNTH_BAD_PARAM_ERR);
-    /* Check that the handle is valid */
-    SYNTH_ASSERT_ERR(handle < pCtx->songs.used, SYNTH_INVALID_INDEX);
+    /* Check that the handle is valid and matches the cursor's one */
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    SYNTH_ASSERT_ERR(handle == pCursor->handle, SYNTH_BAD_PARAM_ERR);
 
-    /* Setup the renderer so the track length can be calculated */
-    rv = synthRenderer_init(&(pCtx->renderCtx),
-            &(pCtx->songs.buf.pAudios[handle]), pCtx->frequency);
+    rv = synthCursor_render(pBuf, pCursor, pCtx, numSamples, mode);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    /* Check that the song either doesn't loop or can loop nicely */
-    rv = synth_canSongLoop(pCtx, handle);
-    SYNTH_ASSERT_ERR(rv == SYNTH_OK || rv == SYNTH_NOT_LOOPABLE, rv);
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
 
-    /* Retrieve the audio */
-    pAudio = &(pCtx->songs.buf.pAudios[handle]);
+/**
+ * Render a range of a song, using the supplied rendering state
+ * 
+ * @param  [ in]pBuf        Buffer that will be filled with the range
+ * @param  [ in]pCtx        The synthesizer context
+ * @param  [ in]pPRNG       PRNG copied for each track
+ * @param  [ in]pCache      Cache of rendered notes
+ * @param  [ in]handle      Handle of the audio
+ * @param  [ in]startSample First sample to be rendered
+ * @param  [ in]numSamples  How many samples should be rendered
+ * @param  [ in]mode        Desired mode for the song
+ * @return                  SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                          SYNTH_MEM_ERR
+ */
+static synth_err synth_renderSongRangeWith(char *pBuf, synthCtx *pCtx,
+        synthPRNGCtx *pPRNG, synthCache *pCache, int handle, int startSample,
+        int numSamples, synthBufMode mode) {
+    char *pTmp;
+    int numBytes;
+    synthAudio *pAudio;
+    synth_err rv;
+
+    /* Clean the temporary buffer, so it's not freed on error */
+    pTmp = 0;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(startSample >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(numSamples >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR((mode & SYNTH_VALID_MODE_MASK) != 0, SYNTH_BAD_PARAM_ERR);
+    /* Check that the handle is valid */
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     /* Calculate the number of bytes per samples */
     numBytes = 1;
@@ -1064,100 +1409,533 @@ synth_err synth_renderSong(char *pBuf, synthCtx *pCtx, int handle,
         numBytes *= 2;
     }
 
-    rv = synth_getSongLength(&maxLen, pCtx, handle);
+    /* Alloc a buffer where each track is rendered before being mixed ('+1' so
+     * nothing is ever alloc'ed with 0 bytes) */
+    pTmp = (char*)malloc(numSamples * numBytes + 1);
+    SYNTH_ASSERT_ERR(pTmp, SYNTH_MEM_ERR);
+
+    rv = synthAudio_renderRange(pBuf, pTmp, pAudio, pCtx, pPRNG, pCache,
+            startSample, numSamples, mode);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    /* Clear the output buffer so every track can be accumulated into it */
-    memset(pBuf, 0x0, maxLen * numBytes);
+    rv = SYNTH_OK;
+__err:
+    if (pTmp) {
+        free(pTmp);
+    }
+
+    return rv;
+}
+
+/**
+ * Render a range of a song, starting at any of its samples
+ * 
+ * Only the requested samples are rendered: the note under 'startSample' is
+ * found on each track's timeline (built when the song is compiled), so seeking
+ * doesn't depend on how far into the song the range is. Tracks that loop go
+ * back to their loop point as soon as they end, while the other ones output
+ * silence; Therefore, the range may be anywhere after the song's start. Every
+ * track matches the one rendered by 'synth_renderTrack' but, since the song's
+ * peak isn't known, any overflowing sample is clamped to the mode's range (as
+ * in 'synth_renderSongChunk')
+ * 
+ * @param  [ in]pBuf        Buffer that will be filled with the range; It must
+ *                          have 'numSamples' times the number of bytes per
+ *                          samples
+ * @param  [ in]pCtx        The synthesizer context
+ * @param  [ in]handle      Handle of the audio
+ * @param  [ in]startSample First sample to be rendered
+ * @param  [ in]numSamples  How many samples should be rendered
+ * @param  [ in]mode        Desired mode for the song
+ * @return                  SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                          SYNTH_MEM_ERR
+ */
+synth_err synth_renderSongRange(char *pBuf, synthCtx *pCtx, int handle,
+        int startSample, int numSamples, synthBufMode mode) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
 
-    /* Count how many tracks there are */
-    rv = synthAudio_getTrackCount(&numTracks, pAudio);
+    rv = synth_renderSongRangeWith(pBuf, pCtx, &(pCtx->prngCtx),
+            &(pCtx->noteCache), handle, startSample, numSamples, mode);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    /* Render each track and accumulated it into the output */
-    i = 0;
-    while (i < numTracks) {
-        int didOverflow, len;
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Select how noise waves are generated
+ * 
+ * Every song rendered afterward (as well as every session and cursor created
+ * afterward) uses the selected generator
+ * 
+ * @param  [ in]pCtx The synthesizer context
+ * @param  [ in]mode The noise generator
+ * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_setNoiseMode(synthCtx *pCtx, synthNoiseMode mode) {
+    synth_err rv;
 
-        didOverflow = 0;
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(mode == SYNTH_NOISE_GAUSSIAN || mode == SYNTH_NOISE_LFSR,
+            SYNTH_BAD_PARAM_ERR);
 
-        /* Render the track into the temporary buffer */
-        rv = synthAudio_renderTrack(pTmp, pAudio, pCtx, i, mode);
-        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    if (mode == SYNTH_NOISE_LFSR) {
+        rv = synthPRNG_setNoiseType(&(pCtx->prngCtx), NW_LFSR);
+    }
+    else {
+        rv = synthPRNG_setNoiseType(&(pCtx->prngCtx), NW_ZIGGURAT);
+    }
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-        /* Accumulate the track into the buffers start */
-        rv = synthAudio_getTrackLength(&len, pAudio, pCtx, i);
-        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-        if (synth_accumulateSongTrack(pBuf, pTmp, mode, len) == SYNTH_TRUE) {
-            didOverflow = 1;
-        }
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
 
-        /* Check whether the track loops */
-        if (synthAudio_isTrackLoopable(pAudio, pCtx, i) == SYNTH_TRUE) {
-            char *pDst, *pSrc;
-            int loopPoint, tmpLen;
-
-            /* Retrieve the current track length and loop point */
-            rv = synthAudio_getTrackIntroLength(&loopPoint, pAudio, pCtx, i);
-            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
-            /* Advance the buffer the number of bytes that were accumulated */
-            pDst = pBuf + len * numBytes;
-
-            /* Update the source to place it at the start of the loop */
-            pSrc = pTmp + loopPoint * numBytes;
-
-            /* Loop until the new track accumulated over the complete track */
-            tmpLen = maxLen - len;
-            len -= loopPoint;
-            while (tmpLen > 0) {
-                if (synth_accumulateSongTrack(pDst, pSrc, mode, len) ==
-                        SYNTH_TRUE) {
-                    didOverflow = 1;
-                }
-
-                pDst += len * numBytes;
-                tmpLen -= len;
-            }
-        }
+/**
+ * Set the seed from which every noise is generated
+ * 
+ * Noises only depend on this seed and on their position within the song (and
+ * not on the order in which songs, tracks or chunks are rendered), so a song
+ * rendered with the same seed always sounds the same; By default, contexts are
+ * seeded with the current time
+ * 
+ * @param  [ in]pCtx The synthesizer context
+ * @param  [ in]seed The seed
+ * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_setNoiseSeed(synthCtx *pCtx, unsigned int seed) {
+    enum enNoiseWaveType type;
+    synth_err rv;
 
-        /* If the track did overflow at any point, halve all of it */
-        if (didOverflow) {
-            int i;
-
-            i = 0;
-            while (i < maxLen * numBytes) {
-
-                /* Halve the lower byte */
-                pBuf[i] >>= 1;
-                /* Check if an underflow may happen */
-                if (mode & SYNTH_16BITS) {
-                    /* Set the highest bit, if an underflow will happen */
-                    pBuf[i] |= (pBuf[i + 1] & 1) << 8;
-                    /* Halve the higher byte */
-                    pBuf[i + 1] >>= 1;
-
-                    /* If the number was signed and negative, set its bit */
-                    if ((mode & SYNTH_SIGNED) && (pBuf[i + 1] & 0x40)) {
-                        pBuf[i + 1] |= 0x80;
-                    }
-                    i += 2;
-                }
-                else {
-                    /* If the number was signed and negative, set its bit */
-                    if ((mode & SYNTH_SIGNED) && (pBuf[i] & 0x40)) {
-                        pBuf[i] |= 0x80;
-                    }
-                    i++;
-                }
-            }
-        }
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
 
-        i++;
+    /* Reseed the PRNG, keeping the noise generator */
+    type = pCtx->prngCtx.type;
+    rv = synthPRNG_init(&(pCtx->prngCtx), seed);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    rv = synthPRNG_setNoiseType(&(pCtx->prngCtx), type);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Alloc a new rendering session for a synthesizer context
+ * 
+ * A session holds all the state that is modified while rendering, so many
+ * threads may render songs from the same context concurrently (as long as each
+ * uses its own session and no song is compiled meanwhile); Only
+ * 'synth_renderTrackSession', 'synth_renderSongSession',
+ * 'synth_renderSongRangeSession', 'synth_initCursorSession' and the functions
+ * that retrieve a song's attributes (e.g., 'synth_getSongLength') may be used
+ * concurrently
+ * 
+ * The session has its own cache of rendered notes, with the same size as the
+ * context's one (see 'synth_setNoteCacheSize'), and uses the context's noise
+ * generator (see 'synth_setNoiseMode')
+ * 
+ * @param  [out]ppSession The new session
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]seed      Seed for the session's pseudo-random number generator
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synth_initSession(synthSession **ppSession, synthCtx *pCtx,
+        unsigned int seed) {
+    synthSession *pSession;
+    synth_err rv;
+
+    /* Initialize this with NULL so it can be cleaned on error */
+    pSession = 0;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppSession, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+
+    pSession = (synthSession*)malloc(sizeof(synthSession));
+    SYNTH_ASSERT_ERR(pSession, SYNTH_MEM_ERR);
+    memset(pSession, 0x0, sizeof(synthSession));
+
+    pSession->pCtx = pCtx;
+    rv = synthPRNG_init(&(pSession->prngCtx), seed);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    rv = synthPRNG_setNoiseType(&(pSession->prngCtx), pCtx->prngCtx.type);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    rv = synthCache_init(&(pSession->noteCache), pCtx->noteCache.maxBytes);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    *ppSession = pSession;
+    pSession = 0;
+    rv = SYNTH_OK;
+__err:
+    if (pSession) {
+        free(pSession);
     }
 
+    return rv;
+}
+
+/**
+ * Release a rendering session
+ * 
+ * @param  [ in]ppSession The session
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_freeSession(synthSession **ppSession) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppSession, SYNTH_BAD_PARAM_ERR);
+
+    if (*ppSession) {
+        synthCache_clear(&((*ppSession)->noteCache));
+        free(*ppSession);
+        *ppSession = 0;
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Render a track into a buffer, modifying only the session
+ * 
+ * See 'synth_renderTrack'
+ * 
+ * @param  [ in]pBuf     Buffer that will be filled with the track
+ * @param  [ in]pSession The rendering session
+ * @param  [ in]handle   Handle of the audio
+ * @param  [ in]track    The track
+ * @param  [ in]mode     Desired mode for the wave
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX
+ */
+synth_err synth_renderTrackSession(char *pBuf, synthSession *pSession,
+        int handle, int track, synthBufMode mode) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pSession, SYNTH_BAD_PARAM_ERR);
+
+    rv = synth_renderTrackWith(pBuf, pSession->pCtx, &(pSession->prngCtx),
+            &(pSession->noteCache), handle, track, mode);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
     rv = SYNTH_OK;
 __err:
     return rv;
 }
 
+/**
+ * Render all of a song's tracks into a buffer, modifying only the session
+ * 
+ * See 'synth_renderSong'
+ * 
+ * @param  [ in]pBuf     Buffer that will be filled with the song
+ * @param  [ in]pSession The rendering session
+ * @param  [ in]handle   Handle of the audio
+ * @param  [ in]mode     Desired mode for the song
+ * @param  [ in]pTmp     Temporary buffer that will be filled with each track
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                       SYNTH_COMPLEX_LOOPPOINT, SYNTH_MEM_ERR,
+ *                       SYNTH_THREAD_INIT_FAILED
+ */
+synth_err synth_renderSongSession(char *pBuf, synthSession *pSession,
+        int handle, synthBufMode mode, char *pTmp) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pSession, SYNTH_BAD_PARAM_ERR);
+
+    rv = synth_renderSongWith(pBuf, pSession->pCtx, &(pSession->prngCtx),
+            &(pSession->noteCache), handle, mode, pTmp);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Alloc a new cursor, copying the session's PRNG (so the cursor renders the
+ * same noises as the session)
+ * 
+ * The cursor may then be rendered with 'synth_renderSongChunk', which only
+ * modifies the cursor
+ * 
+ * @param  [out]ppCursor The new cursor
+ * @param  [ in]pSession The rendering session
+ * @param  [ in]handle   Handle of the audio
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                       SYNTH_MEM_ERR
+ */
+synth_err synth_initCursorSession(synthCursor **ppCursor,
+        synthSession *pSession, int handle) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppCursor, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pSession, SYNTH_BAD_PARAM_ERR);
+
+    rv = synthCursor_init(ppCursor, pSession->pCtx, &(pSession->prngCtx),
+            handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Render a range of a song, modifying only the session
+ * 
+ * See 'synth_renderSongRange'
+ * 
+ * @param  [ in]pBuf        Buffer that will be filled with the range
+ * @param  [ in]pSession    The rendering session
+ * @param  [ in]handle      Handle of the audio
+ * @param  [ in]startSample First sample to be rendered
+ * @param  [ in]numSamples  How many samples should be rendered
+ * @param  [ in]mode        Desired mode for the song
+ * @return                  SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                          SYNTH_MEM_ERR
+ */
+synth_err synth_renderSongRangeSession(char *pBuf, synthSession *pSession,
+        int handle, int startSample, int numSamples, synthBufMode mode) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pSession, SYNTH_BAD_PARAM_ERR);
+
+    rv = synth_renderSongRangeWith(pBuf, pSession->pCtx,
+            &(pSession->prngCtx), &(pSession->noteCache), handle, startSample,
+            numSamples, mode);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Set how many bytes of rendered notes may be kept by the context
+ * 
+ * Whenever a note is rendered again (with the same wave, pitch, length, volume,
+ * envelope and pan) it's simply copied from this cache; Noises are never
+ * cached. Changing the size releases every cached note
+ * 
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]maxBytes Size of the cache (0 disables it)
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_setNoteCacheSize(synthCtx *pCtx, int maxBytes) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(maxBytes >= 0, SYNTH_BAD_PARAM_ERR);
+
+    synthCache_clear(&(pCtx->noteCache));
+    pCtx->noteCache.maxBytes = maxBytes;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve how effective the context's cache of rendered notes has been
+ * 
+ * @param  [out]pHits   How many notes were copied from the cache
+ * @param  [out]pMisses How many (non-noise) notes had to be rendered
+ * @param  [out]pBytes  How many bytes are currently used by the cache
+ * @param  [ in]pCtx    The synthesizer context
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_getNoteCacheStats(int *pHits, int *pMisses, int *pBytes,
+        synthCtx *pCtx) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pHits, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pMisses, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pBytes, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+
+    *pHits = pCtx->noteCache.hits;
+    *pMisses = pCtx->noteCache.misses;
+    *pBytes = pCtx->noteCache.usedBytes;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve how effective a session's cache of rendered notes has been
+ * 
+ * @param  [out]pHits    How many notes were copied from the cache
+ * @param  [out]pMisses  How many (non-noise) notes had to be rendered
+ * @param  [out]pBytes   How many bytes are currently used by the cache
+ * @param  [ in]pSession The rendering session
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_getSessionNoteCacheStats(int *pHits, int *pMisses,
+        int *pBytes, synthSession *pSession) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pHits, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pMisses, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pBytes, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pSession, SYNTH_BAD_PARAM_ERR);
+
+    *pHits = pSession->noteCache.hits;
+    *pMisses = pSession->noteCache.misses;
+    *pBytes = pSession->noteCache.usedBytes;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+
+/**
+ * Render every note of a song only once, so it may be played back from a list
+ * of segments
+ * 
+ * Repeated loops reference the samples rendered for their first iteration,
+ * instead of copying them, so the song takes only as much memory as its unique
+ * notes. Playback behaves just like a cursor (i.e., looping tracks go back to
+ * their loop point and overflowing samples are clamped)
+ * 
+ * @param  [out]ppSegments The new segmented song
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]handle     Handle of the audio
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                         SYNTH_MEM_ERR
+ */
+synth_err synth_initSegments(synthSegments **ppSegments, synthCtx *pCtx,
+        int handle, synthBufMode mode) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+
+    rv = synthSegments_init(ppSegments, pCtx, &(pCtx->prngCtx),
+            &(pCtx->noteCache), handle, mode);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Render every note of a song only once, modifying only the session
+ * 
+ * @param  [out]ppSegments The new segmented song
+ * @param  [ in]pSession   The rendering session
+ * @param  [ in]handle     Handle of the audio
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                         SYNTH_MEM_ERR
+ */
+synth_err synth_initSegmentsSession(synthSegments **ppSegments,
+        synthSession *pSession, int handle, synthBufMode mode) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pSession, SYNTH_BAD_PARAM_ERR);
+
+    rv = synthSegments_init(ppSegments, pSession->pCtx, &(pSession->prngCtx),
+            &(pSession->noteCache), handle, mode);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Play the next samples of a segmented song
+ * 
+ * @param  [ in]pBuf       Buffer that will be filled with the samples; It must
+ *                         have 'numSamples' times the number of bytes per
+ *                         samples (in the mode used by the segmented song)
+ * @param  [ in]pSegments  The segmented song
+ * @param  [ in]numSamples How many samples should be played
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_renderSegments(char *pBuf, synthSegments *pSegments,
+        int numSamples) {
+    synth_err rv;
+
+    rv = synthSegments_render(pBuf, pSegments, numSamples);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Place a segmented song back at its start
+ * 
+ * @param  [ in]pSegments The segmented song
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_resetSegments(synthSegments *pSegments) {
+    synth_err rv;
+
+    rv = synthSegments_reset(pSegments);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve how many bytes are used by a segmented song
+ * 
+ * @param  [out]pBytes    Size of the rendered notes and of the segments
+ * @param  [ in]pSegments The segmented song
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_getSegmentsSize(int *pBytes, synthSegments *pSegments) {
+    synth_err rv;
+
+    rv = synthSegments_getSize(pBytes, pSegments);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Release a segmented song
+ * 
+ * @param  [ in]ppSegments The segmented song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synth_freeSegments(synthSegments **ppSegments) {
+    synth_err rv;
+
+    rv = synthSegments_free(ppSegments);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
@@ -6,55 +6,514 @@
 #include <c_synth/synth_errors.h>
 
 #include <c_synth_internal/synth_audio.h>
+#include <c_synth_internal/synth_cache.h>
 #include <c_synth_internal/synth_lexer.h>
+#include <c_synth_internal/synth_list.h>
+#include <c_synth_internal/synth_mixer.h>
+#include <c_synth_internal/synth_note.h>
 #include <c_synth_internal/synth_parser.h>
+#include <c_synth_internal/synth_prng.h>
 #include <c_synth_internal/synth_renderer.h>
 #include <c_synth_internal/synth_types.h>
 #include <c_synth_internal/synth_track.h>
+#include <c_synth_internal/synth_volume.h>
 
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(USE_PTHREAD)
+#  include <pthread.h>
+#endif
+
+/*
+ * A compiled song is saved as a header followed by the song's volumes, tracks,
+ * notes and loops; Every value is stored in little endian and every index is
+ * relative to the song itself, so the song may be loaded anywhere in any
+ * context (as long as it has the same frequency)
+ *
+ * Nothing derived from the notes (their lengths in samples, the timelines, the
+ * loops' lengths nor the song's lengths) is saved; Those are calculated again
+ * when the song is loaded, exactly as after it's compiled
+ */
+
+/** Identifies a compiled song ("CSYN", read as a little endian integer) */
+#define SYNTHAUDIO_MAGIC 0x4e595343
+/** Version of the compiled songs; Must be increased whenever they change */
+#define SYNTHAUDIO_VERSION 2
+/** Size of the header, in bytes */
+#define SYNTHAUDIO_HEADER_SIZE (9 * 4)
+/** Size of each saved volume, in bytes */
+#define SYNTHAUDIO_VOLUME_SIZE (2 * 4)
+/** Size of each saved track, in bytes */
+#define SYNTHAUDIO_TRACK_SIZE (3 * 4)
+/** Size of each saved note, in bytes */
+#define SYNTHAUDIO_NOTE_SIZE 16
+/** Size of each saved loop, in bytes */
+#define SYNTHAUDIO_LOOP_SIZE (3 * 4)
+
+/**
+ * Calculate and cache the lengths of a song, as well as whether it may loop
+ * nicely in a single iteration; The lengths of every track must have already
+ * been cached
+ * 
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ */
+static void synthAudio_cacheSongLengths(synthAudio *pAudio, synthCtx *pCtx) {
+    int i, maxLen, maxLoopLen, maxLoopPoint;
+
+    /* Search the longest length (of every track and of the loopable ones) and
+     * loop point */
+    i = 0;
+    maxLen = 0;
+    maxLoopLen = 0;
+    maxLoopPoint = -1;
+    while (i < pAudio->num) {
+        synthTrack *pTrack;
+
+        pTrack = SYNTH_TRACK(pCtx, pAudio->tracksIndex + i);
+        i++;
+
+        if (pTrack->cachedLength > maxLen) {
+            maxLen = pTrack->cachedLength;
+        }
+
+        /* Move on to the next track if it isn't loop-able */
+        if (synthTrack_isLoopable(pTrack) == SYNTH_FALSE) {
+            continue;
+        }
+
+        if (pTrack->cachedLength > maxLoopLen) {
+            maxLoopLen = pTrack->cachedLength;
+        }
+        if (pTrack->cachedLoopPoint > maxLoopPoint) {
+            maxLoopPoint = pTrack->cachedLoopPoint;
+        }
+    }
+
+    pAudio->cachedLength = maxLen;
+    pAudio->cachedIntroLength = 0;
+    /* No loop point was found, so there's no loopable track */
+    if (maxLoopPoint == -1) {
+        pAudio->cachedLoopStatus = SYNTH_NOT_LOOPABLE;
+        return;
+    }
+    pAudio->cachedIntroLength = maxLoopPoint;
+
+    /* Iterate, again, over every track and check if their limits overlaps
+     * nicelly */
+    pAudio->cachedLoopStatus = SYNTH_OK;
+    i = 0;
+    while (i < pAudio->num) {
+        synthTrack *pTrack;
+
+        pTrack = SYNTH_TRACK(pCtx, pAudio->tracksIndex + i);
+        i++;
+
+        /* Move on to the next track if it isn't loop-able */
+        if (synthTrack_isLoopable(pTrack) == SYNTH_FALSE) {
+            continue;
+        }
+
+        /* Check that this track's lengths are compatible with the song's
+         * lengths (an empty track never is) */
+        if (pTrack->cachedLength <= 0 ||
+                (maxLoopPoint + maxLoopLen - pTrack->cachedLoopPoint) %
+                pTrack->cachedLength != 0) {
+            pAudio->cachedLoopStatus = SYNTH_COMPLEX_LOOPPOINT;
+            return;
+        }
+    }
+}
+
+/**
+ * Calculate and cache the length of every track in a just compiled audio, as
+ * well as the song's lengths
+ * 
+ * This is the only time the lengths are calculated, so retrieving them later
+ * doesn't modify anything
+ * 
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+static synth_err synthAudio_cacheLengths(synthAudio *pAudio, synthCtx *pCtx) {
+    int i;
+    synth_err rv;
+
+    /* Setup the renderer so the tracks lengths can be calculated */
+    rv = synthRenderer_init(&(pCtx->renderCtx), pAudio, pCtx->frequency);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    i = 0;
+    while (i < pAudio->num) {
+        rv = synthTrack_cacheLengths(
+                SYNTH_TRACK(pCtx, pAudio->tracksIndex + i), pCtx,
+                &(pCtx->renderCtx));
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        i++;
+    }
+
+    synthAudio_cacheSongLengths(pAudio, pCtx);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Clear an audio before compiling a song into it, keeping its handle and
+ * restoring the default BPM and time signature; The song is compiled at the
+ * end of every list, so that's where its items start
+ * 
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ */
+static void synthAudio_clear(synthAudio *pAudio, synthCtx *pCtx) {
+    int handle;
+
+    handle = pAudio->handle;
+    memset(pAudio, 0x0, sizeof(synthAudio));
+    pAudio->handle = handle;
+
+    pAudio->tracksIndex = pCtx->tracks.used;
+    pAudio->notesIndex = pCtx->notes.used;
+    pAudio->timelineIndex = pCtx->timeline.used;
+    pAudio->loopsIndex = pCtx->loops.used;
+
+    /* Set the default BPM */
+    pAudio->bpm = 60;
+    /* Set the time signature to a whole note ('brevissima'); This should work
+     * for any simple time signature (1/4, 2/4, 4/4 etc) */
+    pAudio->timeSignature = 1 << 6;
+}
+
+/**
+ * Store how many items (of each list) were used by a just compiled audio; Since
+ * the song was compiled at the end of every list, that's everything after its
+ * first items
+ * 
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ */
+static void synthAudio_countItems(synthAudio *pAudio, synthCtx *pCtx) {
+    pAudio->num = pCtx->tracks.used - pAudio->tracksIndex;
+    pAudio->notesNum = pCtx->notes.used - pAudio->notesIndex;
+    pAudio->timelineNum = pCtx->timeline.used - pAudio->timelineIndex;
+    pAudio->loopsNum = pCtx->loops.used - pAudio->loopsIndex;
+}
+
+/**
+ * Move a range of items of a just compiled audio into the first range released
+ * by a previous song that fits it, if any
+ * 
+ * @param  [out]pDelta How much the items were moved (0 if they weren't)
+ * @param  [ in]pList  The list
+ * @param  [ in]first  The audio's first item on the list
+ * @param  [ in]num    How many items the audio uses
+ * @param  [ in]size   Size of each item, in bytes
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+static synth_err synthAudio_relocateItems(int *pDelta, synthList *pList,
+        int first, int num, int size) {
+    int dst;
+    synth_err rv;
+
+    *pDelta = 0;
+    if (num == 0 || pList->numFree == 0) {
+        rv = SYNTH_OK;
+        goto __err;
+    }
+
+    rv = synthList_acquire(&dst, pList, num);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    if (dst != -1) {
+        /* Copy the items and give their previous range back to the list */
+        synthList_copy(pList, dst, first, num, size);
+        rv = synthList_release(pList, first, num);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        *pDelta = dst - first;
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Move every item of a just compiled audio into ranges released by previous
+ * songs, so the lists don't keep growing while songs are loaded and released
+ * 
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+static synth_err synthAudio_relocate(synthAudio *pAudio, synthCtx *pCtx) {
+    int delta, i;
+    synth_err rv;
+
+    rv = synthAudio_relocateItems(&delta, &(pCtx->tracks),
+            pAudio->tracksIndex, pAudio->num, sizeof(synthTrack));
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    pAudio->tracksIndex += delta;
+
+    /* Every other list is referenced by the tracks, so those must be updated
+     * as well */
+    rv = synthAudio_relocateItems(&delta, &(pCtx->notes), pAudio->notesIndex,
+            pAudio->notesNum, sizeof(synthNote));
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    i = 0;
+    while (delta != 0 && i < pAudio->num) {
+        SYNTH_TRACK(pCtx, pAudio->tracksIndex + i)->notesIndex += delta;
+        i++;
+    }
+    pAudio->notesIndex += delta;
+
+    rv = synthAudio_relocateItems(&delta, &(pCtx->timeline),
+            pAudio->timelineIndex, pAudio->timelineNum,
+            sizeof(synthTimelineEntry));
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    i = 0;
+    while (delta != 0 && i < pAudio->num) {
+        SYNTH_TRACK(pCtx, pAudio->tracksIndex + i)->timelineIndex += delta;
+        i++;
+    }
+    pAudio->timelineIndex += delta;
+
+    rv = synthAudio_relocateItems(&delta, &(pCtx->loops), pAudio->loopsIndex,
+            pAudio->loopsNum, sizeof(synthLoop));
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    i = 0;
+    while (delta != 0 && i < pAudio->num) {
+        SYNTH_TRACK(pCtx, pAudio->tracksIndex + i)->loopsIndex += delta;
+        i++;
+    }
+    pAudio->loopsIndex += delta;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
 /**
- * Initialize a new audio, so a song can be compiled into it
+ * Initialize a new audio, so a song can be compiled into it; Songs released by
+ * 'synthAudio_free' are reused before expanding the list
  * 
  * @param  [out]pAudio Object that will be filled with the compiled song
  * @param  [ in]pCtx   The synthesizer context
  * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
  */
 synth_err synthAudio_init(synthAudio **ppAudio, synthCtx *pCtx) {
+    int i;
     synth_err rv;
 
     /* Sanitize the arguments */
     SYNTH_ASSERT_ERR(ppAudio, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
-    /* Make sure there's enough space for another song */
-    SYNTH_ASSERT_ERR(pCtx->songs.max == 0 || pCtx->songs.used < pCtx->songs.max,
-            SYNTH_MEM_ERR);
-
-    /* Retrieve the audio to be used */
-    if (pCtx->songs.used >= pCtx->songs.len) {
-        /* 'Double' the current buffer; Note that this will never be called if
-         * the context was pre-alloc'ed, since 'max' will be set; The '+1' is
-         * for the first audio, in which len will be 0 */
-        pCtx->songs.buf.pAudios = (synthAudio*)realloc(pCtx->songs.buf.pAudios,
-                (1 + pCtx->songs.len * 2) * sizeof(synthAudio));
-        SYNTH_ASSERT_ERR(pCtx->songs.buf.pAudios, SYNTH_MEM_ERR);
-        /* Clear only the new part of the buffer */
-        memset(&(pCtx->songs.buf.pAudios[pCtx->songs.used]), 0x0,
-                (1 + pCtx->songs.len) * sizeof(synthAudio));
-        /* Actually increase the buffer length */
-        pCtx->songs.len += 1 + pCtx->songs.len;
+
+    /* Look for a released song */
+    i = 0;
+    while (i < pCtx->songs.used && !SYNTH_AUDIO(pCtx, i)->isFree) {
+        i++;
     }
 
-    /* Set the default BPM */
-    pCtx->songs.buf.pAudios[pCtx->songs.used].bpm = 60;
-    /* Set the time signature to a whole note ('brevissima'); This should work
-     * for any simple time signature (1/4, 2/4, 4/4 etc) */
-    pCtx->songs.buf.pAudios[pCtx->songs.used].timeSignature = 1 << 6;
+    if (i < pCtx->songs.used) {
+        *ppAudio = SYNTH_AUDIO(pCtx, i);
+        (*ppAudio)->isFree = 0;
+    }
+    else {
+        /* Retrieve the audio to be used (expanding the list as necessary); Its
+         * handle is simply its index, as it was never released */
+        SYNTH_ASSERT_ERR(i <= SYNTHAUDIO_INDEX_MASK, SYNTH_MEM_ERR);
+        rv = synthList_append((void**)ppAudio, &(pCtx->songs),
+                sizeof(synthAudio));
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        (*ppAudio)->handle = i;
+    }
+    synthAudio_clear(*ppAudio, pCtx);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve a compiled song from its handle
+ * 
+ * @param  [out]ppAudio The audio
+ * @param  [ in]pCtx    The synthesizer context
+ * @param  [ in]handle  Handle of the audio
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX
+ */
+synth_err synthAudio_getFromHandle(synthAudio **ppAudio, synthCtx *pCtx,
+        int handle) {
+    int index;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppAudio, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
+
+    /* Check that the song exists and that the handle isn't from a song
+     * previously released (which would have a different generation) */
+    index = handle & SYNTHAUDIO_INDEX_MASK;
+    SYNTH_ASSERT_ERR(index < pCtx->songs.used, SYNTH_INVALID_INDEX);
+    *ppAudio = SYNTH_AUDIO(pCtx, index);
+    SYNTH_ASSERT_ERR(!(*ppAudio)->isFree && (*ppAudio)->handle == handle,
+            SYNTH_INVALID_INDEX);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Remove every item of a song from a static context's lists, moving the items
+ * of every song compiled after it back; Static lists have no room to compile a
+ * song past their end, so released ranges would never be reused
+ * 
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ */
+static void synthAudio_removeItems(synthAudio *pAudio, synthCtx *pCtx) {
+    int i;
+
+    synthList_remove(&(pCtx->tracks), pAudio->tracksIndex, pAudio->num,
+            sizeof(synthTrack));
+    synthList_remove(&(pCtx->notes), pAudio->notesIndex, pAudio->notesNum,
+            sizeof(synthNote));
+    synthList_remove(&(pCtx->timeline), pAudio->timelineIndex,
+            pAudio->timelineNum, sizeof(synthTimelineEntry));
+    synthList_remove(&(pCtx->loops), pAudio->loopsIndex, pAudio->loopsNum,
+            sizeof(synthLoop));
+
+    /* Update the songs (and their tracks) whose items were moved */
+    i = 0;
+    while (i < pCtx->songs.used) {
+        synthAudio *pOther;
+        int j;
+
+        pOther = SYNTH_AUDIO(pCtx, i);
+        i++;
+
+        if (pOther == pAudio || pOther->isFree) {
+            continue;
+        }
+
+        if (pOther->tracksIndex > pAudio->tracksIndex) {
+            pOther->tracksIndex -= pAudio->num;
+        }
+
+        j = 0;
+        while (j < pOther->num) {
+            synthTrack *pTrack;
+
+            pTrack = SYNTH_TRACK(pCtx, pOther->tracksIndex + j);
+            if (pOther->notesIndex > pAudio->notesIndex) {
+                pTrack->notesIndex -= pAudio->notesNum;
+            }
+            if (pOther->timelineIndex > pAudio->timelineIndex) {
+                pTrack->timelineIndex -= pAudio->timelineNum;
+            }
+            if (pOther->loopsIndex > pAudio->loopsIndex) {
+                pTrack->loopsIndex -= pAudio->loopsNum;
+            }
+            j++;
+        }
+
+        if (pOther->notesIndex > pAudio->notesIndex) {
+            pOther->notesIndex -= pAudio->notesNum;
+        }
+        if (pOther->timelineIndex > pAudio->timelineIndex) {
+            pOther->timelineIndex -= pAudio->timelineNum;
+        }
+        if (pOther->loopsIndex > pAudio->loopsIndex) {
+            pOther->loopsIndex -= pAudio->loopsNum;
+        }
+    }
+}
+
+/**
+ * Release a song, so both the audio and every item used by it (but its
+ * volumes, which are shared by every song) may be reused by another one; Any
+ * handle to the song is invalidated
+ * 
+ * On static contexts, the items of every song compiled after it are moved
+ * back, so the released memory is always at the end of the lists
+ * 
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthAudio_free(synthAudio *pAudio, synthCtx *pCtx) {
+    int generation;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(!pAudio->isFree, SYNTH_BAD_PARAM_ERR);
+
+    if (pCtx->tracks.max != 0) {
+        /* A static context's items are compacted, instead */
+        synthAudio_removeItems(pAudio, pCtx);
+    }
+    else {
+        rv = synthList_release(&(pCtx->tracks), pAudio->tracksIndex,
+                pAudio->num);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        rv = synthList_release(&(pCtx->notes), pAudio->notesIndex,
+                pAudio->notesNum);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        rv = synthList_release(&(pCtx->timeline), pAudio->timelineIndex,
+                pAudio->timelineNum);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        rv = synthList_release(&(pCtx->loops), pAudio->loopsIndex,
+                pAudio->loopsNum);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    }
+
+    /* Bump the handle's generation, so it no longer matches the song */
+    generation = ((pAudio->handle >> SYNTHAUDIO_INDEX_BITS) + 1) &
+            SYNTHAUDIO_GENERATION_MASK;
+    pAudio->handle = (generation << SYNTHAUDIO_INDEX_BITS) |
+            (pAudio->handle & SYNTHAUDIO_INDEX_MASK);
+
+    pAudio->num = 0;
+    pAudio->notesNum = 0;
+    pAudio->timelineNum = 0;
+    pAudio->loopsNum = 0;
+    pAudio->isFree = 1;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Release an audio whose song failed to compile, along with every item that
+ * was already used by it
+ * 
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthAudio_discard(synthAudio *pAudio, synthCtx *pCtx) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+
+    /* The song was being compiled at the end of every list */
+    synthAudio_countItems(pAudio, pCtx);
+    rv = synthAudio_free(pAudio, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    *ppAudio = &(pCtx->songs.buf.pAudios[pCtx->songs.used]);
-    pCtx->songs.used++;
     rv = SYNTH_OK;
 __err:
     return rv;
@@ -78,7 +537,7 @@ synth_err synthAudio_compileSDL_RWops(synthAudio *pAudio, synthCtx *pCtx,
     SYNTH_ASSERT_ERR(pFile, SYNTH_BAD_PARAM_ERR);
 
     /* Clear the audio */
-    memset(pAudio, 0x0, sizeof(synthAudio));
+    synthAudio_clear(pAudio, pCtx);
 
     /* Init parser */
     rv = synthLexer_initFromSDL_RWops(&(pCtx->lexCtx), pFile);
@@ -89,6 +548,13 @@ synth_err synthAudio_compileSDL_RWops(synthAudio *pAudio, synthCtx *pCtx,
     /* Parse the audio */
     rv = synthParser_getAudio(&(pCtx->parserCtx), pCtx, pAudio);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    rv = synthAudio_cacheLengths(pAudio, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Move the song into ranges released by previous songs */
+    synthAudio_countItems(pAudio, pCtx);
+    rv = synthAudio_relocate(pAudio, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
 __err:
@@ -96,83 +562,607 @@ __err:
     synthLexer_clear(&(pCtx->lexCtx));
 
     return rv;
-#else
-    return SYNTH_FUNCTION_NOT_IMPLEMENTED;
-#endif
+#else
+    return SYNTH_FUNCTION_NOT_IMPLEMENTED;
+#endif
+}
+
+/**
+ * Compile a MML audio file into an object
+ * 
+ * @param  [ in]pAudio    Object that will be filled with the compiled song
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pFilename File with the song's MML
+ */
+synth_err synthAudio_compileFile(synthAudio *pAudio, synthCtx *pCtx,
+        char *pFilename) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pFilename, SYNTH_BAD_PARAM_ERR);
+    /* The file is checked for existance before, so no need to do it again */
+
+    /* Clear the audio */
+    synthAudio_clear(pAudio, pCtx);
+
+    /* Init parser */
+    rv = synthLexer_initFromFile(&(pCtx->lexCtx), pFilename);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    rv = synthParser_init(&(pCtx->parserCtx), pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Parse the audio */
+    rv = synthParser_getAudio(&(pCtx->parserCtx), pCtx, pAudio);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    rv = synthAudio_cacheLengths(pAudio, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Move the song into ranges released by previous songs */
+    synthAudio_countItems(pAudio, pCtx);
+    rv = synthAudio_relocate(pAudio, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    /* Clear the lexer, so any open file is closed */
+    synthLexer_clear(&(pCtx->lexCtx));
+
+    return rv;
+}
+
+/**
+ * Compile a MML audio string into a object
+ * 
+ * @param  [ in]pAudio  Object that will be filled with the compiled song
+ * @param  [ in]pCtx    The synthesizer context
+ * @param  [ in]pString The MML song
+ * @param  [ in]len     The MML song's length
+ */
+synth_err synthAudio_compileString(synthAudio *pAudio, synthCtx *pCtx,
+        char *pString, int len) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pString, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(len > 0, SYNTH_BAD_PARAM_ERR);
+
+    /* Clear the audio */
+    synthAudio_clear(pAudio, pCtx);
+
+    /* Init parser */
+    rv = synthLexer_initFromString(&(pCtx->lexCtx), pString, len);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    rv = synthParser_init(&(pCtx->parserCtx), pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Parse the audio */
+    rv = synthParser_getAudio(&(pCtx->parserCtx), pCtx, pAudio);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    rv = synthAudio_cacheLengths(pAudio, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Move the song into ranges released by previous songs */
+    synthAudio_countItems(pAudio, pCtx);
+    rv = synthAudio_relocate(pAudio, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Write an integer into a compiled song, in little endian
+ * 
+ * @param  [ in]ppData Where the integer is written; Advanced past it
+ * @param  [ in]val    The integer
+ */
+static void synthAudio_writeInt(unsigned char **ppData, int val) {
+    unsigned char *pData;
+
+    pData = *ppData;
+    pData[0] = (unsigned char)(val & 0xff);
+    pData[1] = (unsigned char)((val >> 8) & 0xff);
+    pData[2] = (unsigned char)((val >> 16) & 0xff);
+    pData[3] = (unsigned char)((val >> 24) & 0xff);
+    *ppData += 4;
+}
+
+/**
+ * Write a 16 bits integer into a compiled song, in little endian
+ * 
+ * @param  [ in]ppData Where the integer is written; Advanced past it
+ * @param  [ in]val    The integer
+ */
+static void synthAudio_writeShort(unsigned char **ppData, int val) {
+    unsigned char *pData;
+
+    pData = *ppData;
+    pData[0] = (unsigned char)(val & 0xff);
+    pData[1] = (unsigned char)((val >> 8) & 0xff);
+    *ppData += 2;
+}
+
+/**
+ * Read an integer from a compiled song, stored in little endian
+ * 
+ * @param  [ in]ppData Where the integer is read from; Advanced past it
+ * @return             The integer
+ */
+static int synthAudio_readInt(unsigned char **ppData) {
+    unsigned char *pData;
+
+    pData = *ppData;
+    *ppData += 4;
+
+    return (int)((unsigned int)pData[0] | ((unsigned int)pData[1] << 8) |
+            ((unsigned int)pData[2] << 16) | ((unsigned int)pData[3] << 24));
+}
+
+/**
+ * Read a 16 bits integer from a compiled song, stored in little endian
+ * 
+ * @param  [ in]ppData Where the integer is read from; Advanced past it
+ * @return             The integer
+ */
+static int synthAudio_readShort(unsigned char **ppData) {
+    unsigned char *pData;
+
+    pData = *ppData;
+    *ppData += 2;
+
+    return (int)pData[0] | ((int)pData[1] << 8);
+}
+
+/**
+ * Save a compiled song into a newly alloc'ed buffer, which may later be loaded
+ * (by 'synthAudio_load') without compiling the song again
+ * 
+ * Only the volumes used by the song are saved, and every note references those
+ * by its position among them
+ * 
+ * @param  [out]ppData The saved song; Must be freed by the caller
+ * @param  [out]pLen   The saved song's length, in bytes
+ * @param  [ in]pAudio The audio
+ * @param  [ in]pCtx   The synthesizer context
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthAudio_save(char **ppData, int *pLen, synthAudio *pAudio,
+        synthCtx *pCtx) {
+    int *pVolumes, i, len, numVolumes;
+    unsigned char *pData;
+    synth_err rv;
+
+    pVolumes = 0;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppData, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pLen, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+
+    *ppData = 0;
+
+    /* Mark every volume used by the song (loops don't have a volume) and
+     * number them in the order they are found on the context */
+    if (pCtx->volumes.used > 0) {
+        pVolumes = (int*)malloc(pCtx->volumes.used * sizeof(int));
+        SYNTH_ASSERT_ERR(pVolumes, SYNTH_MEM_ERR);
+        memset(pVolumes, 0xff, pCtx->volumes.used * sizeof(int));
+    }
+
+    i = 0;
+    while (i < pAudio->notesNum) {
+        synthNote *pNote;
+
+        pNote = SYNTH_NOTE(pCtx, pAudio->notesIndex + i);
+        if (synthNote_isLoop(pNote) != SYNTH_TRUE) {
+            pVolumes[pNote->volume] = 0;
+        }
+        i++;
+    }
+
+    numVolumes = 0;
+    i = 0;
+    while (i < pCtx->volumes.used) {
+        if (pVolumes[i] != -1) {
+            pVolumes[i] = numVolumes;
+            numVolumes++;
+        }
+        i++;
+    }
+
+    len = SYNTHAUDIO_HEADER_SIZE + numVolumes * SYNTHAUDIO_VOLUME_SIZE +
+            pAudio->num * SYNTHAUDIO_TRACK_SIZE +
+            pAudio->notesNum * SYNTHAUDIO_NOTE_SIZE +
+            pAudio->loopsNum * SYNTHAUDIO_LOOP_SIZE;
+    *ppData = (char*)malloc(len);
+    SYNTH_ASSERT_ERR(*ppData, SYNTH_MEM_ERR);
+    pData = (unsigned char*)(*ppData);
+
+    synthAudio_writeInt(&pData, SYNTHAUDIO_MAGIC);
+    synthAudio_writeInt(&pData, SYNTHAUDIO_VERSION);
+    synthAudio_writeInt(&pData, pCtx->frequency);
+    synthAudio_writeInt(&pData, pAudio->bpm);
+    synthAudio_writeInt(&pData, pAudio->timeSignature);
+    synthAudio_writeInt(&pData, numVolumes);
+    synthAudio_writeInt(&pData, pAudio->num);
+    synthAudio_writeInt(&pData, pAudio->notesNum);
+    synthAudio_writeInt(&pData, pAudio->loopsNum);
+
+    i = 0;
+    while (i < pCtx->volumes.used) {
+        if (pVolumes[i] != -1) {
+            synthVolume *pVolume;
+
+            pVolume = SYNTH_VOLUME(pCtx, i);
+            synthAudio_writeInt(&pData, pVolume->ini);
+            synthAudio_writeInt(&pData, pVolume->fin);
+        }
+        i++;
+    }
+
+    /* Tracks are compiled one after the other, so each one's notes and loops
+     * follow the previous track's */
+    i = 0;
+    while (i < pAudio->num) {
+        synthTrack *pTrack;
+
+        pTrack = SYNTH_TRACK(pCtx, pAudio->tracksIndex + i);
+        synthAudio_writeInt(&pData, pTrack->loopPoint);
+        synthAudio_writeInt(&pData, pTrack->num);
+        synthAudio_writeInt(&pData, pTrack->loopsNum);
+        i++;
+    }
+
+    /* Loops keep their index into the track's loop table instead of a
+     * length, and every other note its volume */
+    i = 0;
+    while (i < pAudio->notesNum) {
+        synthNote *pNote;
+
+        pNote = SYNTH_NOTE(pCtx, pAudio->notesIndex + i);
+        if (synthNote_isLoop(pNote) != SYNTH_TRUE) {
+            synthAudio_writeInt(&pData, 0);
+            synthAudio_writeShort(&pData, pNote->duration);
+            synthAudio_writeShort(&pData, pVolumes[pNote->volume]);
+        }
+        else {
+            synthAudio_writeInt(&pData, pNote->samplesDuration);
+            synthAudio_writeShort(&pData, pNote->duration);
+            synthAudio_writeShort(&pData, 0);
+        }
+        pData[0] = pNote->wave;
+        pData[1] = pNote->note;
+        pData[2] = pNote->octave;
+        pData[3] = pNote->pan;
+        pData[4] = pNote->attack;
+        pData[5] = pNote->keyoff;
+        pData[6] = pNote->release;
+        pData[7] = 0;
+        pData += 8;
+        i++;
+    }
+
+    i = 0;
+    while (i < pAudio->loopsNum) {
+        synthLoop *pLoop;
+
+        pLoop = &(pCtx->loops.buf.pLoops[pAudio->loopsIndex + i]);
+        synthAudio_writeInt(&pData, pLoop->position);
+        synthAudio_writeInt(&pData, pLoop->jumpPosition);
+        synthAudio_writeInt(&pData, pLoop->repeat);
+        i++;
+    }
+
+    *pLen = len;
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK && ppData && *ppData) {
+        free(*ppData);
+        *ppData = 0;
+    }
+    if (pVolumes) {
+        free(pVolumes);
+    }
+
+    return rv;
+}
+
+/**
+ * Load a note saved by 'synthAudio_save', retrieving its volume from the
+ * context (as volumes are shared by every song)
+ * 
+ * @param  [ in]ppData     The saved note; Advanced past it
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]pVolumes   The song's saved volumes
+ * @param  [ in]numVolumes How many volumes were saved
+ * @return                 SYNTH_OK, SYNTH_MEM_ERR, SYNTH_INVALID_COMPILED_SONG
+ */
+static synth_err synthAudio_loadNote(unsigned char **ppData, synthCtx *pCtx,
+        unsigned char *pVolumes, int numVolumes) {
+    synthNote *pNote;
+    unsigned char *pData;
+    int volume;
+    synth_err rv;
+
+    rv = synthList_append((void**)&pNote, &(pCtx->notes), sizeof(synthNote));
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    pNote->samplesDuration = synthAudio_readInt(ppData);
+    pNote->duration = (unsigned short)synthAudio_readShort(ppData);
+    volume = synthAudio_readShort(ppData);
+    pData = *ppData;
+    pNote->wave = pData[0];
+    pNote->note = pData[1];
+    pNote->octave = pData[2];
+    pNote->pan = pData[3];
+    pNote->attack = pData[4];
+    pNote->keyoff = pData[5];
+    pNote->release = pData[6];
+    *ppData += 8;
+
+    /* Loops only keep their index into the track's loop table (checked
+     * along with their track); Every other note's length is calculated only
+     * after the whole song is loaded */
+    if (synthNote_isLoop(pNote) == SYNTH_TRUE) {
+        rv = SYNTH_OK;
+        goto __err;
+    }
+    pNote->samplesDuration = 0;
+
+    /* Check that the note may be rendered */
+    SYNTH_ASSERT_ERR(pNote->wave < SYNTH_MAX_WAVE,
+            SYNTH_INVALID_COMPILED_SONG);
+    SYNTH_ASSERT_ERR(pNote->note < N_LOOP, SYNTH_INVALID_COMPILED_SONG);
+    SYNTH_ASSERT_ERR(pNote->note == N_REST ||
+            (pNote->octave >= 1 && pNote->octave <= 8),
+            SYNTH_INVALID_COMPILED_SONG);
+    SYNTH_ASSERT_ERR(pNote->pan <= 100 && pNote->attack <= 100 &&
+            pNote->keyoff <= 100 && pNote->release <= 100,
+            SYNTH_INVALID_COMPILED_SONG);
+    SYNTH_ASSERT_ERR(volume < numVolumes, SYNTH_INVALID_COMPILED_SONG);
+
+    /* Retrieve the volume (already as 16 bits values) from the context */
+    do {
+        int fin, ini;
+
+        pData = pVolumes + volume * SYNTHAUDIO_VOLUME_SIZE;
+        ini = synthAudio_readInt(&pData);
+        fin = synthAudio_readInt(&pData);
+        SYNTH_ASSERT_ERR(ini >= 0 && ini <= (128 << 8) && (ini & 0xff) == 0,
+                SYNTH_INVALID_COMPILED_SONG);
+        SYNTH_ASSERT_ERR(fin >= 0 && fin <= (128 << 8) && (fin & 0xff) == 0,
+                SYNTH_INVALID_COMPILED_SONG);
+
+        rv = synthVolume_getLinear(&volume, pCtx, ini >> 8, fin >> 8);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        /* The volume only fails to fit the note if the context's volumes
+         * are corrupted, which isn't a lack of memory */
+        rv = synthNote_setVolume(pNote, volume);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, SYNTH_INVALID_COMPILED_SONG);
+    } while (0);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
 }
 
 /**
- * Compile a MML audio file into an object
+ * Check that every loop of a loaded track is within the track and that each
+ * one is referenced, in order, by the loop note at its position; Since those
+ * are exactly the tracks that may be compiled, the track's lengths may then be
+ * calculated (and it may be rendered) as if it were just compiled
  * 
- * @param  [ in]pAudio    Object that will be filled with the compiled song
- * @param  [ in]pCtx      The synthesizer context
- * @param  [ in]pFilename File with the song's MML
+ * @param  [ in]pTrack The track
+ * @param  [ in]pCtx   The synthesizer context
+ * @return             SYNTH_OK, SYNTH_INVALID_COMPILED_SONG
  */
-synth_err synthAudio_compileFile(synthAudio *pAudio, synthCtx *pCtx,
-        char *pFilename) {
+static synth_err synthAudio_checkLoops(synthTrack *pTrack, synthCtx *pCtx) {
+    int i, numLoops;
     synth_err rv;
 
-    /* Sanitize the arguments */
-    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
-    SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
-    SYNTH_ASSERT_ERR(pFilename, SYNTH_BAD_PARAM_ERR);
-    /* The file is checked for existance before, so no need to do it again */
+    numLoops = 0;
+    i = 0;
+    while (i < pTrack->num) {
+        synthNote *pNote;
 
-    /* Clear the audio */
-    memset(pAudio, 0x0, sizeof(synthAudio));
+        pNote = SYNTH_NOTE(pCtx, pTrack->notesIndex + i);
+        if (synthNote_isLoop(pNote) == SYNTH_TRUE) {
+            synthLoop *pLoop;
+            int loop;
 
-    /* Init parser */
-    rv = synthLexer_initFromFile(&(pCtx->lexCtx), pFilename);
-    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-    rv = synthParser_init(&(pCtx->parserCtx), pCtx);
-    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            rv = synthNote_getLoop(&loop, pNote);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, SYNTH_INVALID_COMPILED_SONG);
+            SYNTH_ASSERT_ERR(loop == numLoops && loop < pTrack->loopsNum,
+                    SYNTH_INVALID_COMPILED_SONG);
 
-    /* Parse the audio */
-    rv = synthParser_getAudio(&(pCtx->parserCtx), pCtx, pAudio);
-    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            /* The loop must jump back to a note of its own track */
+            pLoop = &(pCtx->loops.buf.pLoops[pTrack->loopsIndex + loop]);
+            SYNTH_ASSERT_ERR(pLoop->position == i &&
+                    pLoop->jumpPosition >= 0 && pLoop->jumpPosition <= i,
+                    SYNTH_INVALID_COMPILED_SONG);
+
+            numLoops++;
+        }
+        i++;
+    }
+    SYNTH_ASSERT_ERR(numLoops == pTrack->loopsNum, SYNTH_INVALID_COMPILED_SONG);
 
     rv = SYNTH_OK;
 __err:
-    /* Clear the lexer, so any open file is closed */
-    synthLexer_clear(&(pCtx->lexCtx));
-
     return rv;
 }
 
 /**
- * Compile a MML audio string into a object
+ * Load a song saved by 'synthAudio_save' into an audio, without compiling it
+ * again; Everything is loaded at the end of every list and then moved into
+ * ranges released by previous songs, just like a compiled song
  * 
- * @param  [ in]pAudio  Object that will be filled with the compiled song
- * @param  [ in]pCtx    The synthesizer context
- * @param  [ in]pString The MML song
- * @param  [ in]len     The MML song's length
+ * Only the notes and loops are loaded; Every length (as well as the timelines
+ * and whether the song loops) is then calculated by the same code that runs
+ * after a song is compiled, so a corrupted song can't make rendering go past
+ * its buffers
+ * 
+ * @param  [ in]pAudio Object that will be filled with the loaded song
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]pData  The saved song
+ * @param  [ in]len    The saved song's length, in bytes
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR,
+ *                     SYNTH_INVALID_COMPILED_SONG
  */
-synth_err synthAudio_compileString(synthAudio *pAudio, synthCtx *pCtx,
-        char *pString, int len) {
+synth_err synthAudio_load(synthAudio *pAudio, synthCtx *pCtx, char *pData,
+        int len) {
+    int bpm, i, loopsIndex, notesIndex, numLoops, numNotes, numTracks,
+            numVolumes, timeSignature;
+    unsigned char *pCur, *pVolumes;
     synth_err rv;
 
     /* Sanitize the arguments */
-    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
-    SYNTH_ASSERT_ERR(pString, SYNTH_BAD_PARAM_ERR);
-    SYNTH_ASSERT_ERR(len > 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pData, SYNTH_BAD_PARAM_ERR);
 
     /* Clear the audio */
-    memset(pAudio, 0x0, sizeof(synthAudio));
+    synthAudio_clear(pAudio, pCtx);
 
-    /* Init parser */
-    rv = synthLexer_initFromString(&(pCtx->lexCtx), pString, len);
-    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-    rv = synthParser_init(&(pCtx->parserCtx), pCtx);
+    /* Check that it's a song saved by this version, at the same frequency
+     * (so it sounds exactly as it did when it was saved) */
+    SYNTH_ASSERT_ERR(len >= SYNTHAUDIO_HEADER_SIZE,
+            SYNTH_INVALID_COMPILED_SONG);
+    pCur = (unsigned char*)pData;
+    SYNTH_ASSERT_ERR(synthAudio_readInt(&pCur) == SYNTHAUDIO_MAGIC,
+            SYNTH_INVALID_COMPILED_SONG);
+    SYNTH_ASSERT_ERR(synthAudio_readInt(&pCur) == SYNTHAUDIO_VERSION,
+            SYNTH_INVALID_COMPILED_SONG);
+    SYNTH_ASSERT_ERR(synthAudio_readInt(&pCur) == pCtx->frequency,
+            SYNTH_INVALID_COMPILED_SONG);
+
+    bpm = synthAudio_readInt(&pCur);
+    timeSignature = synthAudio_readInt(&pCur);
+    numVolumes = synthAudio_readInt(&pCur);
+    numTracks = synthAudio_readInt(&pCur);
+    numNotes = synthAudio_readInt(&pCur);
+    numLoops = synthAudio_readInt(&pCur);
+
+    /* The BPM divides the frequency, and notes may be at most as long as a
+     * compass (so none of their lengths is ever negative) */
+    SYNTH_ASSERT_ERR(bpm > 0, SYNTH_INVALID_COMPILED_SONG);
+    SYNTH_ASSERT_ERR(timeSignature > 0 && timeSignature <= (1 << 6),
+            SYNTH_INVALID_COMPILED_SONG);
+
+    /* Check that the song has exactly as many bytes as its items require
+     * (without overflowing) */
+    len -= SYNTHAUDIO_HEADER_SIZE;
+    SYNTH_ASSERT_ERR(numVolumes >= 0 &&
+            numVolumes <= len / SYNTHAUDIO_VOLUME_SIZE,
+            SYNTH_INVALID_COMPILED_SONG);
+    len -= numVolumes * SYNTHAUDIO_VOLUME_SIZE;
+    SYNTH_ASSERT_ERR(numTracks > 0 && numTracks <= len / SYNTHAUDIO_TRACK_SIZE,
+            SYNTH_INVALID_COMPILED_SONG);
+    len -= numTracks * SYNTHAUDIO_TRACK_SIZE;
+    SYNTH_ASSERT_ERR(numNotes >= 0 && numNotes <= len / SYNTHAUDIO_NOTE_SIZE,
+            SYNTH_INVALID_COMPILED_SONG);
+    len -= numNotes * SYNTHAUDIO_NOTE_SIZE;
+    SYNTH_ASSERT_ERR(numLoops >= 0 && numLoops == len / SYNTHAUDIO_LOOP_SIZE &&
+            len % SYNTHAUDIO_LOOP_SIZE == 0, SYNTH_INVALID_COMPILED_SONG);
+
+    pAudio->bpm = bpm;
+    pAudio->timeSignature = timeSignature;
+
+    /* Volumes are only retrieved (from the context) as the notes are loaded */
+    pVolumes = pCur;
+    pCur += numVolumes * SYNTHAUDIO_VOLUME_SIZE;
+
+    /* Each track's notes and loops follow the previous track's, so no two
+     * tracks ever share an item */
+    notesIndex = 0;
+    loopsIndex = 0;
+    i = 0;
+    while (i < numTracks) {
+        synthTrack *pTrack;
+
+        rv = synthList_append((void**)&pTrack, &(pCtx->tracks),
+                sizeof(synthTrack));
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        pTrack->loopPoint = synthAudio_readInt(&pCur);
+        pTrack->num = synthAudio_readInt(&pCur);
+        pTrack->loopsNum = synthAudio_readInt(&pCur);
+
+        SYNTH_ASSERT_ERR(pTrack->num >= 0 &&
+                pTrack->num <= numNotes - notesIndex,
+                SYNTH_INVALID_COMPILED_SONG);
+        SYNTH_ASSERT_ERR(pTrack->loopsNum >= 0 &&
+                pTrack->loopsNum <= numLoops - loopsIndex,
+                SYNTH_INVALID_COMPILED_SONG);
+        SYNTH_ASSERT_ERR(pTrack->loopPoint >= -1 &&
+                pTrack->loopPoint < pTrack->num, SYNTH_INVALID_COMPILED_SONG);
+
+        pTrack->notesIndex = pAudio->notesIndex + notesIndex;
+        pTrack->loopsIndex = pAudio->loopsIndex + loopsIndex;
+        notesIndex += pTrack->num;
+        loopsIndex += pTrack->loopsNum;
+        i++;
+    }
+    SYNTH_ASSERT_ERR(notesIndex == numNotes && loopsIndex == numLoops,
+            SYNTH_INVALID_COMPILED_SONG);
+    pAudio->num = numTracks;
+
+    i = 0;
+    while (i < numNotes) {
+        rv = synthAudio_loadNote(&pCur, pCtx, pVolumes, numVolumes);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        i++;
+    }
+
+    do {
+        synthLoop *pLoops;
+
+        rv = synthList_appendArray((void**)&pLoops, &(pCtx->loops), numLoops,
+                sizeof(synthLoop));
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        i = 0;
+        while (i < numLoops) {
+            pLoops[i].position = synthAudio_readInt(&pCur);
+            pLoops[i].jumpPosition = synthAudio_readInt(&pCur);
+            pLoops[i].repeat = synthAudio_readInt(&pCur);
+            pLoops[i].length = 0;
+
+            SYNTH_ASSERT_ERR(pLoops[i].repeat > 0,
+                    SYNTH_INVALID_COMPILED_SONG);
+            i++;
+        }
+    } while (0);
+
+    i = 0;
+    while (i < numTracks) {
+        rv = synthAudio_checkLoops(SYNTH_TRACK(pCtx, pAudio->tracksIndex + i),
+                pCtx);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        i++;
+    }
+
+    /* Calculate every length just like a compiled song's (which fails if
+     * any of them would overflow) */
+    rv = synthAudio_cacheLengths(pAudio, pCtx);
+    if (rv == SYNTH_COMPASS_OVERFLOW || rv == SYNTH_BAD_LOOP_COUNT) {
+        rv = SYNTH_INVALID_COMPILED_SONG;
+    }
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    /* Parse the audio */
-    rv = synthParser_getAudio(&(pCtx->parserCtx), pCtx, pAudio);
+    /* Move the song into ranges released by previous songs */
+    synthAudio_countItems(pAudio, pCtx);
+    rv = synthAudio_relocate(pAudio, pCtx);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
 __err:
-
     return rv;
 }
 
@@ -239,6 +1229,72 @@ __err:
     return rv;
 }
 
+/**
+ * Retrieve the length, in samples, of the longest track in a song
+ * 
+ * @param  [out]pLen   The length of the song
+ * @param  [ in]pAudio The audio
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthAudio_getLength(int *pLen, synthAudio *pAudio) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pLen, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
+
+    /* Retrieve the cached length */
+    *pLen = pAudio->cachedLength;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve the number of samples until a song's loop point
+ * 
+ * @param  [out]pLen   The length of the song's intro
+ * @param  [ in]pAudio The audio
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_COMPLEX_LOOPPOINT,
+ *                     SYNTH_NOT_LOOPABLE
+ */
+synth_err synthAudio_getIntroLength(int *pLen, synthAudio *pAudio) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pLen, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
+    /* The song must loop nicely */
+    SYNTH_ASSERT_ERR(pAudio->cachedLoopStatus == SYNTH_OK,
+            pAudio->cachedLoopStatus);
+
+    /* Retrieve the cached value */
+    *pLen = pAudio->cachedIntroLength;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Check whether a song can loop nicely in a single iteration
+ * 
+ * @param  [ in]pAudio The audio
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_COMPLEX_LOOPPOINT,
+ *                     SYNTH_NOT_LOOPABLE
+ */
+synth_err synthAudio_canLoop(synthAudio *pAudio) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
+
+    rv = pAudio->cachedLoopStatus;
+__err:
+    return rv;
+}
+
 /**
  * Retrieve the number of samples in a track
  * 
@@ -258,12 +1314,8 @@ synth_err synthAudio_getTrackLength(int *pLen, synthAudio *pAudio,
     /* Check that the track is valid */
     SYNTH_ASSERT_ERR(track < pAudio->num, SYNTH_INVALID_INDEX);
 
-    /* Make sure the renderer is at a compass start */
-    rv = synthRenderer_resetPosition(&(pCtx->renderCtx));
-    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
     rv = synthTrack_getLength(pLen,
-            &(pCtx->tracks.buf.pTracks[pAudio->tracksIndex + track]), pCtx);
+            SYNTH_TRACK(pCtx, pAudio->tracksIndex + track), pCtx);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
@@ -290,12 +1342,8 @@ synth_err synthAudio_getTrackIntroLength(int *pLen, synthAudio *pAudio,
     /* Check that the track is valid */
     SYNTH_ASSERT_ERR(track < pAudio->num, SYNTH_INVALID_INDEX);
 
-    /* Make sure the renderer is at a compass start */
-    rv = synthRenderer_resetPosition(&(pCtx->renderCtx));
-    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
     rv = synthTrack_getIntroLength(pLen,
-            &(pCtx->tracks.buf.pTracks[pAudio->tracksIndex + track]), pCtx);
+            SYNTH_TRACK(pCtx, pAudio->tracksIndex + track), pCtx);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
@@ -315,7 +1363,7 @@ synth_bool synthAudio_isTrackLoopable(synthAudio *pAudio, synthCtx *pCtx,
         int track) {
     if (pAudio && track < pAudio->num) {
         return synthTrack_isLoopable(
-                &(pCtx->tracks.buf.pTracks[pAudio->tracksIndex + track]));
+                SYNTH_TRACK(pCtx, pAudio->tracksIndex + track));
     }
     return SYNTH_FALSE;
 }
@@ -326,15 +1374,21 @@ synth_bool synthAudio_isTrackLoopable(synthAudio *pAudio, synthCtx *pCtx,
  * The buffer must be prepared by the caller, and it must have
  * 'synth_getTrackLength' bytes times the number of bytes per samples
  * 
+ * Only 'pPRNG' and 'pCache' are modified, so tracks may be rendered
+ * concurrently
+ * 
  * @param  [ in]pBuf   Buffer that will be filled with the track
  * @param  [ in]pAudio The audio
  * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]pPRNG  Pseudo-random number generator used by noises
+ * @param  [ in]pCache Cache of rendered notes (may be NULL)
  * @param  [ in]pTrack The track
  * @param  [ in]mode   Desired mode for the wave
  * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
  */
 synth_err synthAudio_renderTrack(char *pBuf, synthAudio *pAudio, synthCtx *pCtx,
-        int track, synthBufMode mode) {
+        synthPRNGCtx *pPRNG, synthCache *pCache, int track,
+        synthBufMode mode) {
     synth_err rv;
 
     /* Sanitize the arguments */
@@ -344,17 +1398,432 @@ synth_err synthAudio_renderTrack(char *pBuf, synthAudio *pAudio, synthCtx *pCtx,
     /* Check that the track is valid */
     SYNTH_ASSERT_ERR(track < pAudio->num, SYNTH_INVALID_INDEX);
 
-    /* Make sure the renderer is at a compass start */
-    rv = synthRenderer_resetPosition(&(pCtx->renderCtx));
+    rv = synthTrack_render(pBuf,
+            SYNTH_TRACK(pCtx, pAudio->tracksIndex + track), track, pCtx,
+            pPRNG, pCache, mode);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    rv = synthTrack_render(pBuf,
-            &(pCtx->tracks.buf.pTracks[pAudio->tracksIndex + track]), pCtx,
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Render a track and accumulate it into a bus, repeating its loop until the
+ * end of the song
+ * 
+ * Only 'pPRNG' and 'pCache' are modified, so tracks may be mixed concurrently
+ * 
+ * @param  [ in]pBus    Bus with the length of the whole song
+ * @param  [ in]pTmp    Temporary buffer where the track is rendered
+ * @param  [ in]pAudio  The audio
+ * @param  [ in]pCtx    The synthesizer context
+ * @param  [ in]pPRNG   Pseudo-random number generator used by noises
+ * @param  [ in]pCache  Cache of rendered notes (may be NULL)
+ * @param  [ in]track   The track
+ * @param  [ in]songLen Length of the song, in samples
+ * @param  [ in]mode    Desired mode for the song
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+static synth_err synthAudio_mixTrack(int *pBus, char *pTmp, synthAudio *pAudio,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, synthCache *pCache, int track,
+        int songLen, synthBufMode mode) {
+    int len, numBytes, numChannels;
+    synthTrack *pTrack;
+    synth_err rv;
+
+    /* Calculate the number of bytes per samples */
+    numChannels = 1;
+    if (mode & SYNTH_2CHAN) {
+        numChannels = 2;
+    }
+    numBytes = numChannels;
+    if (mode & SYNTH_16BITS) {
+        numBytes *= 2;
+    }
+
+    pTrack = SYNTH_TRACK(pCtx, pAudio->tracksIndex + track);
+
+    /* Render the track into the temporary buffer */
+    rv = synthAudio_renderTrack(pTmp, pAudio, pCtx, pPRNG, pCache, track,
             mode);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
+    /* Accumulate the track into the bus' start */
+    rv = synthTrack_getLength(&len, pTrack, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    rv = synthMixer_accumulateBus(pBus, pTmp, mode, len);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Check whether the track loops */
+    if (synthTrack_isLoopable(pTrack) == SYNTH_TRUE) {
+        char *pSrc;
+        int *pDst;
+        int loopPoint, tmpLen;
+
+        /* Retrieve the current track loop point */
+        rv = synthTrack_getIntroLength(&loopPoint, pTrack, pCtx);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        /* Advance the bus the number of samples that were accumulated */
+        pDst = pBus + len * numChannels;
+
+        /* Update the source to place it at the start of the loop */
+        pSrc = pTmp + loopPoint * numBytes;
+
+        /* Loop until the new track accumulated over the complete track */
+        tmpLen = songLen - len;
+        len -= loopPoint;
+        while (tmpLen > 0 && len > 0) {
+            int count;
+
+            count = len;
+            if (count > tmpLen) {
+                count = tmpLen;
+            }
+
+            rv = synthMixer_accumulateBus(pDst, pSrc, mode, count);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+            pDst += count * numChannels;
+            tmpLen -= count;
+        }
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+#if defined(USE_PTHREAD)
+/**
+ * Render the worker's range of every track and accumulate it into the
+ * worker's range of the bus
+ * 
+ * @param  [ in]pArg The worker
+ * @return           Always NULL (the result is stored on the worker)
+ */
+static void* synthAudio_runWorker(void *pArg) {
+    synthWorker *pWorker;
+    int numTracks, track;
+
+    pWorker = (synthWorker*)pArg;
+
+    numTracks = pWorker->pAudio->num;
+    track = 0;
+    while (track < numTracks) {
+        synthPRNGCtx prngCtx;
+        synthTrack *pTrack;
+        int count, len;
+
+        pTrack = SYNTH_TRACK(pWorker->pCtx,
+                pWorker->pAudio->tracksIndex + track);
+
+        /* Tracks that don't loop are silent past their end */
+        count = pWorker->end - pWorker->start;
+        if (synthTrack_isLoopable(pTrack) != SYNTH_TRUE) {
+            pWorker->rv = synthTrack_getLength(&len, pTrack, pWorker->pCtx);
+            if (pWorker->rv != SYNTH_OK) {
+                break;
+            }
+            if (count > len - pWorker->start) {
+                count = len - pWorker->start;
+            }
+        }
+
+        if (count > 0) {
+            /* Each track gets its own copy, since noise generators keep some
+             * state between values */
+            prngCtx = *(pWorker->pPRNG);
+
+            pWorker->rv = synthTrack_renderRange(pWorker->pTmp, pTrack, track,
+                    pWorker->pCtx, &prngCtx, pWorker->pCache, pWorker->mode,
+                    pWorker->start, count);
+            if (pWorker->rv != SYNTH_OK) {
+                break;
+            }
+            pWorker->rv = synthMixer_accumulateBus(pWorker->pBus,
+                    pWorker->pTmp, pWorker->mode, count);
+            if (pWorker->rv != SYNTH_OK) {
+                break;
+            }
+        }
+
+        track++;
+    }
+
+    return 0;
+}
+
+/**
+ * Run a job on every worker, using the calling thread as the first one
+ * 
+ * @param  [ in]pWorkers   The workers
+ * @param  [ in]numWorkers Number of workers
+ * @param  [ in]pThreads   Handle of every thread (but the first)
+ * @param  [ in]job        The job
+ * @return                 SYNTH_OK, SYNTH_THREAD_INIT_FAILED or whatever the
+ *                         job failed with
+ */
+static synth_err synthAudio_runJob(synthWorker *pWorkers, int numWorkers,
+        pthread_t *pThreads, void* (*job)(void*)) {
+    int i, numStarted;
+    synth_err rv;
+
+    /* Start every other thread */
+    rv = SYNTH_OK;
+    numStarted = 1;
+    while (numStarted < numWorkers) {
+        if (pthread_create(&(pThreads[numStarted]), 0, job,
+                &(pWorkers[numStarted])) != 0) {
+            rv = SYNTH_THREAD_INIT_FAILED;
+            break;
+        }
+        numStarted++;
+    }
+
+    /* Do the first worker's job on this thread and wait for the others */
+    job(&(pWorkers[0]));
+
+    i = 1;
+    while (i < numStarted) {
+        pthread_join(pThreads[i], 0);
+        i++;
+    }
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Check that every job succeeded */
+    i = 0;
+    while (i < numStarted) {
+        SYNTH_ASSERT_ERR(pWorkers[i].rv == SYNTH_OK, pWorkers[i].rv);
+        i++;
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+#endif /* USE_PTHREAD */
+
+/**
+ * Render every track of an audio and accumulate them into a bus
+ * 
+ * If the context allows it (see 'synth_setRenderThreads'), the song is split
+ * into as many ranges as there are threads, and each thread renders its range
+ * of every track (from the tracks' timelines) into its range of 'pTmp' and
+ * 'pBus'. Noises are counter-based (and each track uses its own copy of
+ * 'pPRNG'), so the result doesn't depend on the number of threads
+ * 
+ * Each thread only stores notes into its own cache, which looks up 'pCache'
+ * and may keep an equal share of what's left of it. Those are merged into
+ * 'pCache' once every thread is done
+ * 
+ * @param  [ in]pBus    Bus with the length of the whole song (cleared)
+ * @param  [ in]pTmp    Temporary buffer where tracks are rendered, with the
+ *                      length of the longest track
+ * @param  [ in]pAudio  The audio
+ * @param  [ in]pCtx    The synthesizer context
+ * @param  [ in]pPRNG   PRNG copied for each track (left unmodified)
+ * @param  [ in]pCache  Cache of rendered notes (may be NULL)
+ * @param  [ in]songLen Length of the song, in samples
+ * @param  [ in]mode    Desired mode for the song
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR,
+ *                      SYNTH_THREAD_INIT_FAILED
+ */
+synth_err synthAudio_mixTracks(int *pBus, char *pTmp, synthAudio *pAudio,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, synthCache *pCache, int songLen,
+        synthBufMode mode) {
+    int i, numWorkers;
+#if defined(USE_PTHREAD)
+    pthread_t *pThreads;
+    synthWorker *pWorkers;
+#endif
+    synth_err rv;
+
+#if defined(USE_PTHREAD)
+    /* Clean everything, so it's not freed on error */
+    pThreads = 0;
+    pWorkers = 0;
+#endif
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBus, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pTmp, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pPRNG, SYNTH_BAD_PARAM_ERR);
+
+    numWorkers = pCtx->numThreads;
+    if (numWorkers > songLen) {
+        numWorkers = songLen;
+    }
+
+    if (numWorkers <= 1) {
+        /* Simply render every track on this thread */
+        i = 0;
+        while (i < pAudio->num) {
+            synthPRNGCtx prngCtx;
+
+            prngCtx = *pPRNG;
+
+            rv = synthAudio_mixTrack(pBus, pTmp, pAudio, pCtx, &prngCtx,
+                    pCache, i, songLen, mode);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+            i++;
+        }
+    }
+    else {
+#if defined(USE_PTHREAD)
+        int cacheShare, numBytes, numChannels;
+
+        numChannels = 1;
+        if (mode & SYNTH_2CHAN) {
+            numChannels = 2;
+        }
+        numBytes = numChannels;
+        if (mode & SYNTH_16BITS) {
+            numBytes *= 2;
+        }
+
+        /* Split whatever is left of the cache among the workers, so they
+         * never keep more than it could */
+        cacheShare = 0;
+        if (pCache && pCache->maxBytes > 0) {
+            cacheShare = (pCache->maxBytes - pCache->usedBytes) / numWorkers;
+        }
+
+        pThreads = (pthread_t*)malloc(numWorkers * sizeof(pthread_t));
+        SYNTH_ASSERT_ERR(pThreads, SYNTH_MEM_ERR);
+        pWorkers = (synthWorker*)calloc(numWorkers, sizeof(synthWorker));
+        SYNTH_ASSERT_ERR(pWorkers, SYNTH_MEM_ERR);
+
+        /* Give each worker its own range of the song (and of the buffers) */
+        i = 0;
+        while (i < numWorkers) {
+            synthWorker *pWorker;
+
+            pWorker = &(pWorkers[i]);
+
+            pWorker->pCtx = pCtx;
+            pWorker->pAudio = pAudio;
+            pWorker->pPRNG = pPRNG;
+            pWorker->mode = mode;
+            pWorker->start = (int)((long long)songLen * i / numWorkers);
+            pWorker->end = (int)((long long)songLen * (i + 1) / numWorkers);
+            pWorker->pBus = pBus + pWorker->start * numChannels;
+            pWorker->pTmp = pTmp + pWorker->start * numBytes;
+
+            if (pCache && pCache->maxBytes > 0) {
+                rv = synthCache_init(&(pWorker->cache), cacheShare);
+                SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+                pWorker->cache.pShared = pCache;
+                pWorker->pCache = &(pWorker->cache);
+            }
+
+            i++;
+        }
+
+        rv = synthAudio_runJob(pWorkers, numWorkers, pThreads,
+                synthAudio_runWorker);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        /* Keep the notes rendered by every worker (in order, so the cache
+         * doesn't depend on how the threads were scheduled) */
+        if (pCache) {
+            i = 0;
+            while (i < numWorkers) {
+                synthCache_merge(pCache, &(pWorkers[i].cache));
+                i++;
+            }
+        }
+#else
+        SYNTH_ASSERT_ERR(0, SYNTH_FUNCTION_NOT_IMPLEMENTED);
+#endif
+    }
+
     rv = SYNTH_OK;
 __err:
+#if defined(USE_PTHREAD)
+    if (pWorkers) {
+        i = 0;
+        while (i < numWorkers) {
+            synthCache_clear(&(pWorkers[i].cache));
+            i++;
+        }
+        free(pWorkers);
+    }
+    if (pThreads) {
+        free(pThreads);
+    }
+#endif
+
     return rv;
 }
 
+/**
+ * Render a range of every track of an audio and mix them into a buffer
+ * 
+ * Each track is rendered from its timeline (see 'synthTrack_renderRange'), so
+ * the range may start anywhere in the song without rendering what comes before
+ * it. Since the song's peak isn't known, overflowing samples are clamped to
+ * the mode's range (as when the song is rendered in chunks)
+ * 
+ * @param  [ in]pBuf       Buffer that will be filled with 'numSamples'
+ * @param  [ in]pTmp       Temporary buffer with 'numSamples', where each track
+ *                         is rendered
+ * @param  [ in]pAudio     The audio
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]pPRNG      PRNG copied for each track (left unmodified)
+ * @param  [ in]pCache     Cache of rendered notes (may be NULL)
+ * @param  [ in]position   First sample to be rendered
+ * @param  [ in]numSamples How many samples should be rendered
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthAudio_renderRange(char *pBuf, char *pTmp, synthAudio *pAudio,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, synthCache *pCache, int position,
+        int numSamples, synthBufMode mode) {
+    int i, numBytes;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pTmp, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pAudio, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pPRNG, SYNTH_BAD_PARAM_ERR);
+
+    /* Calculate the number of bytes per samples */
+    numBytes = 1;
+    if (mode & SYNTH_16BITS) {
+        numBytes = 2;
+    }
+    if (mode & SYNTH_2CHAN) {
+        numBytes *= 2;
+    }
+
+    /* Clear the output buffer so every track can be accumulated into it */
+    memset(pBuf, 0x0, numSamples * numBytes);
+
+    i = 0;
+    while (i < pAudio->num) {
+        synthPRNGCtx prngCtx;
+
+        /* Use the same PRNG as if the whole song were rendered */
+        prngCtx = *pPRNG;
+
+        rv = synthTrack_renderRange(pTmp,
+                SYNTH_TRACK(pCtx, pAudio->tracksIndex + i), i, pCtx,
+                &prngCtx, pCache, mode, position, numSamples);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        synthMixer_accumulate(pBuf, pTmp, mode, numSamples);
+
+        i++;
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
@@ -0,0 +1,388 @@
+/**
+ * @file src/synth_cache.c
+ *
+ * Cache of rendered notes, so repeated notes are copied instead of synthesized
+ *
+ * Songs repeat the same notes (with the same duration, volume, envelope and
+ * pan) over and over, so every non-noise note is kept (up to the cache's
+ * size) as soon as it's rendered. Entries are never evicted; Once the cache is
+ * full, new notes are simply rendered.
+ * 
+ * Threads that render a single song each keep their own cache, which looks up
+ * the song's (shared) cache but never modifies it. Those are later merged into
+ * the shared one, so both the memory used and the notes kept are the same as
+ * if the song were rendered on a single thread.
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_cache.h>
+#include <c_synth_internal/synth_note.h>
+#include <c_synth_internal/synth_types.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/** Number of buckets in the cache's hash table (must be a power of 2) */
+#define SYNTHCACHE_BUCKETS 256
+
+/** Accumulate a value into a FNV-1a hash */
+#define SYNTHCACHE_HASH(hash, val) \
+  do { \
+    (hash) ^= (unsigned int)(val); \
+    (hash) *= 16777619u; \
+  } while (0)
+
+/**
+ * Initialize an empty cache
+ *
+ * @param  [ in]pCache   The cache
+ * @param  [ in]maxBytes How many bytes of rendered notes may be kept (0
+ *                       disables the cache)
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthCache_init(synthCache *pCache, int maxBytes) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCache, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(maxBytes >= 0, SYNTH_BAD_PARAM_ERR);
+
+    memset(pCache, 0x0, sizeof(synthCache));
+    pCache->maxBytes = maxBytes;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Release every cached note (but keep the cache's size and statistics)
+ *
+ * @param  [ in]pCache The cache
+ */
+void synthCache_clear(synthCache *pCache) {
+    int i;
+
+    if (!pCache) {
+        return;
+    }
+
+    i = 0;
+    while (i < pCache->used) {
+        free(pCache->pEntries[i].pData);
+        i++;
+    }
+    if (pCache->pEntries) {
+        free(pCache->pEntries);
+    }
+    if (pCache->pBuckets) {
+        free(pCache->pBuckets);
+    }
+
+    pCache->pEntries = 0;
+    pCache->pBuckets = 0;
+    pCache->len = 0;
+    pCache->used = 0;
+    pCache->usedBytes = 0;
+}
+
+/**
+ * Fill an entry's key with a note's parameters
+ *
+ * @param  [ in]pEntry   The entry
+ * @param  [ in]pNote    The note
+ * @param  [ in]mode     Mode in which the note is rendered
+ * @param  [ in]duration The note's length in samples
+ */
+static void synthCache_setKey(synthCacheEntry *pEntry, synthNote *pNote,
+        synthBufMode mode, int duration) {
+    unsigned int hash;
+
+    pEntry->mode = mode;
+    pEntry->duration = duration;
+    pEntry->wave = pNote->wave;
+    pEntry->note = pNote->note;
+    pEntry->octave = pNote->octave;
+    pEntry->volume = pNote->volume;
+    pEntry->attack = pNote->attack;
+    pEntry->keyoff = pNote->keyoff;
+    pEntry->release = pNote->release;
+    pEntry->pan = pNote->pan;
+
+    hash = 2166136261u;
+    SYNTHCACHE_HASH(hash, pEntry->mode);
+    SYNTHCACHE_HASH(hash, pEntry->duration);
+    SYNTHCACHE_HASH(hash, pEntry->wave);
+    SYNTHCACHE_HASH(hash, pEntry->note);
+    SYNTHCACHE_HASH(hash, pEntry->octave);
+    SYNTHCACHE_HASH(hash, pEntry->volume);
+    SYNTHCACHE_HASH(hash, pEntry->attack);
+    SYNTHCACHE_HASH(hash, pEntry->keyoff);
+    SYNTHCACHE_HASH(hash, pEntry->release);
+    SYNTHCACHE_HASH(hash, pEntry->pan);
+    pEntry->hash = hash;
+}
+
+/**
+ * Check whether two entries have the same key
+ *
+ * @param  [ in]pA An entry
+ * @param  [ in]pB Another entry
+ * @return         SYNTH_TRUE, SYNTH_FALSE
+ */
+static synth_bool synthCache_isSameKey(synthCacheEntry *pA,
+        synthCacheEntry *pB) {
+    if (pA->hash == pB->hash && pA->mode == pB->mode &&
+            pA->duration == pB->duration && pA->wave == pB->wave &&
+            pA->note == pB->note && pA->octave == pB->octave &&
+            pA->volume == pB->volume && pA->attack == pB->attack &&
+            pA->keyoff == pB->keyoff && pA->release == pB->release &&
+            pA->pan == pB->pan) {
+        return SYNTH_TRUE;
+    }
+    return SYNTH_FALSE;
+}
+
+/**
+ * Calculate the length of a rendered note, in bytes
+ * 
+ * @param  [ in]mode     Mode in which the note is rendered
+ * @param  [ in]duration The note's length in samples
+ * @return               The note's length in bytes
+ */
+static int synthCache_getBytes(synthBufMode mode, int duration) {
+    int bytes;
+
+    bytes = duration;
+    if (mode & SYNTH_16BITS) {
+        bytes *= 2;
+    }
+    if (mode & SYNTH_2CHAN) {
+        bytes *= 2;
+    }
+
+    return bytes;
+}
+
+/**
+ * Look for a note in the cache
+ * 
+ * @param  [ in]pCache The cache
+ * @param  [ in]pKey   Entry with the note's key
+ * @return             The note's entry or NULL, if it isn't cached
+ */
+static synthCacheEntry* synthCache_find(synthCache *pCache,
+        synthCacheEntry *pKey) {
+    int i;
+
+    i = -1;
+    if (pCache->pBuckets) {
+        i = pCache->pBuckets[pKey->hash & (SYNTHCACHE_BUCKETS - 1)];
+    }
+    while (i != -1) {
+        if (synthCache_isSameKey(&(pCache->pEntries[i]), pKey) ==
+                SYNTH_TRUE) {
+            return &(pCache->pEntries[i]);
+        }
+        i = pCache->pEntries[i].next;
+    }
+
+    return 0;
+}
+
+/**
+ * Store a rendered note into the cache, which takes ownership of its data
+ * 
+ * The cache is an optimization, so failing to alloc memory simply leaves the
+ * note out of it
+ * 
+ * @param  [ in]pCache The cache
+ * @param  [ in]pKey   Entry with the note's key
+ * @param  [ in]pData  The rendered note (alloc'ed with malloc)
+ * @param  [ in]bytes  Length of the rendered note, in bytes
+ * @return             SYNTH_TRUE if the note was stored, SYNTH_FALSE if it must
+ *                     be freed by the caller
+ */
+static synth_bool synthCache_link(synthCache *pCache, synthCacheEntry *pKey,
+        char *pData, int bytes) {
+    synthCacheEntry *pEntry;
+    int bucket;
+
+    /* Alloc the hash table along with the first entry */
+    if (!pCache->pBuckets) {
+        pCache->pBuckets = (int*)malloc(SYNTHCACHE_BUCKETS * sizeof(int));
+        if (!pCache->pBuckets) {
+            return SYNTH_FALSE;
+        }
+        memset(pCache->pBuckets, 0xff, SYNTHCACHE_BUCKETS * sizeof(int));
+    }
+
+    /* Expand the array as necessary */
+    if (pCache->used >= pCache->len) {
+        synthCacheEntry *pEntries;
+
+        pEntries = (synthCacheEntry*)realloc(pCache->pEntries,
+                (1 + pCache->len * 2) * sizeof(synthCacheEntry));
+        if (!pEntries) {
+            return SYNTH_FALSE;
+        }
+        pCache->pEntries = pEntries;
+        pCache->len += 1 + pCache->len;
+    }
+
+    pEntry = &(pCache->pEntries[pCache->used]);
+    *pEntry = *pKey;
+    pEntry->pData = pData;
+
+    /* Link it into its bucket */
+    bucket = pEntry->hash & (SYNTHCACHE_BUCKETS - 1);
+    pEntry->next = pCache->pBuckets[bucket];
+    pCache->pBuckets[bucket] = pCache->used;
+
+    pCache->used++;
+    pCache->usedBytes += bytes;
+
+    return SYNTH_TRUE;
+}
+
+/**
+ * Store a just rendered note into the cache
+ * 
+ * The cache is an optimization, so failing to alloc memory simply leaves the
+ * note out of it
+ * 
+ * @param  [ in]pCache The cache
+ * @param  [ in]pKey   Entry with the note's key
+ * @param  [ in]pBuf   The rendered note
+ * @param  [ in]bytes  Length of the rendered note, in bytes
+ */
+static void synthCache_insert(synthCache *pCache, synthCacheEntry *pKey,
+        char *pBuf, int bytes) {
+    char *pData;
+
+    pData = (char*)malloc(bytes);
+    if (!pData) {
+        return;
+    }
+    memcpy(pData, pBuf, bytes);
+
+    if (synthCache_link(pCache, pKey, pData, bytes) != SYNTH_TRUE) {
+        free(pData);
+    }
+}
+
+/**
+ * Move every note of a cache into another one (as long as it fits and it isn't
+ * already there) and account its statistics into the other
+ * 
+ * The source cache is left empty (but keeps its size and statistics)
+ * 
+ * @param  [ in]pDst The cache that receives the notes
+ * @param  [ in]pSrc The cache whose notes are moved
+ */
+void synthCache_merge(synthCache *pDst, synthCache *pSrc) {
+    int i;
+
+    if (!pDst || !pSrc) {
+        return;
+    }
+
+    i = 0;
+    while (i < pSrc->used) {
+        synthCacheEntry *pEntry;
+        int bytes;
+
+        pEntry = &(pSrc->pEntries[i]);
+        bytes = synthCache_getBytes(pEntry->mode, pEntry->duration);
+
+        if (pDst->usedBytes + bytes > pDst->maxBytes ||
+                synthCache_find(pDst, pEntry) ||
+                synthCache_link(pDst, pEntry, pEntry->pData, bytes) !=
+                SYNTH_TRUE) {
+            free(pEntry->pData);
+        }
+        /* Either way, the data no longer belongs to the source */
+        pEntry->pData = 0;
+
+        i++;
+    }
+    pSrc->used = 0;
+
+    pDst->hits += pSrc->hits;
+    pDst->misses += pSrc->misses;
+
+    synthCache_clear(pSrc);
+}
+
+/**
+ * Render a note into a buffer, copying it from the cache if it was already
+ * rendered with the same parameters
+ *
+ * Noises are never cached, since they depend on the PRNG
+ *
+ * @param  [ in]pBuf     Buffer that will be filled with the note
+ * @param  [ in]pCache   The cache (may be NULL, to always render the note)
+ * @param  [ in]pNote    The note
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]pPRNG    Pseudo-random number generator used by noises
+ * @param  [ in]track    Position of the note's track within its song
+ * @param  [ in]index    Position of the note within its track
+ * @param  [ in]mode     Desired mode for the wave
+ * @param  [ in]duration The note's length in samples
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthCache_render(char *pBuf, synthCache *pCache, synthNote *pNote,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, int track, int index,
+        synthBufMode mode, int duration) {
+    synthCacheEntry key, *pEntry;
+    synthNoteKernel kernel;
+    int bytes, isCacheable;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pNote, SYNTH_BAD_PARAM_ERR);
+
+    bytes = synthCache_getBytes(mode, duration);
+
+    /* Look for the note (on this cache and, then, on the shared one), if it
+     * may actually be cached */
+    isCacheable = (pCache && (pCache->maxBytes > 0 || pCache->pShared) &&
+            (pNote->wave < W_NOISE || pNote->note == N_REST));
+    pEntry = 0;
+    if (isCacheable) {
+        synthCache_setKey(&key, pNote, mode, duration);
+
+        pEntry = synthCache_find(pCache, &key);
+        if (!pEntry && pCache->pShared) {
+            pEntry = synthCache_find(pCache->pShared, &key);
+        }
+    }
+
+    if (pEntry) {
+        memcpy(pBuf, pEntry->pData, bytes);
+        pCache->hits++;
+    }
+    else {
+        /* Select how the note will be synthesized and render it */
+        rv = synthNote_getKernel(&kernel, pNote, mode);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        rv = synthNote_render(pBuf, pNote, pCtx, pPRNG, kernel, track, index,
+                duration);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        if (isCacheable) {
+            pCache->misses++;
+            if (pCache->usedBytes + bytes <= pCache->maxBytes) {
+                synthCache_insert(pCache, &key, pBuf, bytes);
+            }
+        }
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
@@ -0,0 +1,397 @@
+/**
+ * Persistent playback position within a song, so it may be rendered in chunks
+ *
+ * @file src/synth_cursor.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_audio.h>
+#include <c_synth_internal/synth_cursor.h>
+#include <c_synth_internal/synth_list.h>
+#include <c_synth_internal/synth_mixer.h>
+#include <c_synth_internal/synth_note.h>
+#include <c_synth_internal/synth_prng.h>
+#include <c_synth_internal/synth_track.h>
+#include <c_synth_internal/synth_types.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Search the next note that should be played by a track cursor
+ *
+ * Any loop on the way is resolved, either by jumping back to its start or by
+ * skipping over it; If the track ends, it either goes back to its loop point or
+ * is marked as done. The first note checked is the current one.
+ *
+ * @param  [ in]pTrackCursor The track cursor
+ * @param  [ in]pAudio       The cursor's audio
+ * @param  [ in]pCtx         The synthesizer context
+ * @return                   SYNTH_OK, SYNTH_BAD_PARAM_ERR, ...
+ */
+static synth_err synthCursor_fetchNote(synthTrackCursor *pTrackCursor,
+        synthAudio *pAudio, synthCtx *pCtx) {
+    synthNote *pNote;
+    synthTrack *pTrack;
+    synth_err rv;
+
+    pTrack = SYNTH_TRACK(pCtx, pAudio->tracksIndex + pTrackCursor->track);
+
+    pNote = 0;
+    while (!pTrackCursor->isDone) {
+        synthLoop *pLoop;
+        synthLoopFrame *pFrame;
+        int jumpPosition, repeatCount;
+
+        /* Check whether the track ended */
+        if (pTrackCursor->note >= pTrack->num) {
+            if (pTrackCursor->canLoop) {
+                /* The loop point is always at a compass' start, outside any
+                 * loop */
+                pTrackCursor->note = pTrack->loopPoint;
+                pTrackCursor->loopDepth = 0;
+            }
+            else {
+                pTrackCursor->isDone = 1;
+            }
+            continue;
+        }
+
+        /* Stop as soon as a common note is found */
+        pNote = SYNTH_NOTE(pCtx, pTrack->notesIndex + pTrackCursor->note);
+        if (synthNote_isLoop(pNote) == SYNTH_FALSE) {
+            break;
+        }
+
+        rv = synthTrack_getLoop(&pLoop, pTrack, pCtx, pNote);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        repeatCount = pLoop->repeat;
+        jumpPosition = pLoop->jumpPosition;
+
+        /* Since loop notes are placed after the looped sequence, the innermost
+         * loop will always be the one reached */
+        pFrame = 0;
+        if (pTrackCursor->loopDepth > 0) {
+            pFrame = &(pTrackCursor->pLoops[pTrackCursor->loopDepth - 1]);
+            if (pFrame->position != pTrackCursor->note) {
+                pFrame = 0;
+            }
+        }
+
+        if (pFrame) {
+            /* Finished another iteration of the current loop */
+            pFrame->remaining--;
+            if (pFrame->remaining > 0) {
+                pTrackCursor->note = jumpPosition;
+            }
+            else {
+                pTrackCursor->loopDepth--;
+                pTrackCursor->note++;
+            }
+        }
+        else if (repeatCount > 1) {
+            /* Just finished the first iteration of a new loop */
+            pFrame = &(pTrackCursor->pLoops[pTrackCursor->loopDepth]);
+            pFrame->position = pTrackCursor->note;
+            pFrame->remaining = repeatCount - 1;
+            pTrackCursor->loopDepth++;
+
+            pTrackCursor->note = jumpPosition;
+        }
+        else {
+            pTrackCursor->note++;
+        }
+    }
+
+    /* Retrieve the note's duration in samples (cached on compilation) */
+    pTrackCursor->noteLength = 0;
+    pTrackCursor->notePosition = 0;
+    if (!pTrackCursor->isDone) {
+        rv = synthNote_getSamplesDuration(&(pTrackCursor->noteLength), pNote);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Alloc a new cursor, placed at the start of a song
+ *
+ * The cursor has its own copy of 'pPRNG', so rendering it doesn't modify
+ * anything but the cursor itself (and its noises match the complete song's)
+ *
+ * @param  [out]ppCursor The new cursor
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]pPRNG    PRNG copied into the cursor
+ * @param  [ in]handle   Handle of the audio
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                       SYNTH_MEM_ERR
+ */
+synth_err synthCursor_init(synthCursor **ppCursor, synthCtx *pCtx,
+        synthPRNGCtx *pPRNG, int handle) {
+    int i, numLoops, size;
+    synthAudio *pAudio;
+    synthCursor *pCursor;
+    synthLoopFrame *pLoops;
+    synth_err rv;
+
+    pCursor = 0;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppCursor, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pPRNG, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
+    /* Check that the handle is valid */
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Count how many loops there are, so every track has enough space to
+     * stack all of its loops */
+    numLoops = 0;
+    i = 0;
+    while (i < pAudio->num) {
+        numLoops += SYNTH_TRACK(pCtx, pAudio->tracksIndex + i)->loopsNum;
+        i++;
+    }
+
+    /* Alloc the cursor, the tracks and the loops in a single block */
+    size = sizeof(synthCursor) + sizeof(synthTrackCursor) * pAudio->num +
+            sizeof(synthLoopFrame) * numLoops;
+    pCursor = (synthCursor*)malloc(size);
+    SYNTH_ASSERT_ERR(pCursor, SYNTH_MEM_ERR);
+    memset(pCursor, 0x0, size);
+
+    pCursor->handle = handle;
+    pCursor->numTracks = pAudio->num;
+    pCursor->pTracks = (synthTrackCursor*)(pCursor + 1);
+    pLoops = (synthLoopFrame*)(pCursor->pTracks + pAudio->num);
+
+    /* Copy the PRNG, so the cursor renders the same noises as the song */
+    pCursor->prngCtx = *pPRNG;
+
+    i = 0;
+    while (i < pAudio->num) {
+        synthTrackCursor *pTrackCursor;
+        synthTrack *pTrack;
+
+        pTrackCursor = &(pCursor->pTracks[i]);
+        pTrack = SYNTH_TRACK(pCtx, pAudio->tracksIndex + i);
+
+        pTrackCursor->track = i;
+        pTrackCursor->pLoops = pLoops;
+
+        /* Only loop if there's actually something to be looped */
+        if (synthTrack_isLoopable(pTrack) == SYNTH_TRUE) {
+            int intro, len;
+
+            rv = synthAudio_getTrackLength(&len, pAudio, pCtx, i);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            rv = synthAudio_getTrackIntroLength(&intro, pAudio, pCtx, i);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+            pTrackCursor->canLoop = (len > intro);
+        }
+
+        /* Reserve this track's loops */
+        pLoops += pTrack->loopsNum;
+
+        i++;
+    }
+
+    /* Place every track at its first note */
+    rv = synthCursor_reset(pCursor, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    *ppCursor = pCursor;
+    pCursor = 0;
+    rv = SYNTH_OK;
+__err:
+    if (pCursor) {
+        synthCursor_free(&pCursor);
+    }
+
+    return rv;
+}
+
+/**
+ * Place the cursor back at the start of its song
+ *
+ * @param  [ in]pCursor The cursor
+ * @param  [ in]pCtx    The synthesizer context
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX
+ */
+synth_err synthCursor_reset(synthCursor *pCursor, synthCtx *pCtx) {
+    int i;
+    synthAudio *pAudio;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCursor, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    /* Check that the song wasn't released */
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, pCursor->handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    pCursor->position = 0;
+
+    i = 0;
+    while (i < pCursor->numTracks) {
+        synthTrackCursor *pTrackCursor;
+
+        pTrackCursor = &(pCursor->pTracks[i]);
+
+        pTrackCursor->isDone = 0;
+        pTrackCursor->note = 0;
+        pTrackCursor->loopDepth = 0;
+
+        rv = synthCursor_fetchNote(pTrackCursor, pAudio, pCtx);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        i++;
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Release all memory alloc'ed by a cursor
+ *
+ * @param  [ in]ppCursor The cursor
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthCursor_free(synthCursor **ppCursor) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppCursor, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(*ppCursor, SYNTH_BAD_PARAM_ERR);
+
+    if ((*ppCursor)->pTmp) {
+        free((*ppCursor)->pTmp);
+    }
+    /* The tracks and loops were alloc'ed with the cursor itself */
+    free(*ppCursor);
+    *ppCursor = 0;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Render the next samples of the cursor's song, advancing the cursor
+ *
+ * Every track is rendered from wherever it stopped on the previous call and
+ * looping tracks go back to their loop point once they end; Tracks that don't
+ * loop output silence after ending
+ *
+ * @param  [ in]pBuf       Buffer that will be filled with 'numSamples'
+ * @param  [ in]pCursor    The cursor
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]numSamples How many samples should be rendered
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                         SYNTH_MEM_ERR
+ */
+synth_err synthCursor_render(char *pBuf, synthCursor *pCursor, synthCtx *pCtx,
+        int numSamples, synthBufMode mode) {
+    int i, numBytes;
+    synthAudio *pAudio;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCursor, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(numSamples >= 0, SYNTH_BAD_PARAM_ERR);
+    /* Retrieve the song, whose tracks may have been moved since the cursor was
+     * initialized */
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, pCursor->handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Calculate the number of bytes per samples */
+    numBytes = 1;
+    if (mode & SYNTH_16BITS) {
+        numBytes = 2;
+    }
+    if (mode & SYNTH_2CHAN) {
+        numBytes *= 2;
+    }
+
+    /* Expand the temporary buffer as necessary */
+    if (pCursor->tmpLen < numSamples * numBytes) {
+        char *pTmp;
+
+        pTmp = (char*)realloc(pCursor->pTmp, numSamples * numBytes);
+        SYNTH_ASSERT_ERR(pTmp, SYNTH_MEM_ERR);
+
+        pCursor->pTmp = pTmp;
+        pCursor->tmpLen = numSamples * numBytes;
+    }
+
+    /* Clear the output buffer so every track can be accumulated into it */
+    memset(pBuf, 0x0, numSamples * numBytes);
+
+    i = 0;
+    while (i < pCursor->numTracks) {
+        synthTrackCursor *pTrackCursor;
+        synthTrack *pTrack;
+        int len;
+
+        pTrackCursor = &(pCursor->pTracks[i]);
+        pTrack = SYNTH_TRACK(pCtx, pAudio->tracksIndex + pTrackCursor->track);
+
+        /* Render as many notes as necessary to fill the chunk */
+        len = 0;
+        while (len < numSamples && !pTrackCursor->isDone) {
+            synthNote *pNote;
+            synthNoteKernel kernel;
+            int count;
+
+            pNote = SYNTH_NOTE(pCtx, pTrack->notesIndex + pTrackCursor->note);
+
+            /* Render either the rest of the note or the rest of the chunk */
+            count = pTrackCursor->noteLength - pTrackCursor->notePosition;
+            if (count > numSamples - len) {
+                count = numSamples - len;
+            }
+
+            rv = synthNote_getKernel(&kernel, pNote, mode);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            rv = synthNote_renderRange(pCursor->pTmp + len * numBytes, pNote,
+                    pCtx, &(pCursor->prngCtx), kernel, i, pTrackCursor->note,
+                    pTrackCursor->noteLength, pTrackCursor->notePosition,
+                    count);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+            len += count;
+            pTrackCursor->notePosition += count;
+
+            /* Move to the next note, if this one was completely rendered */
+            if (pTrackCursor->notePosition >= pTrackCursor->noteLength) {
+                pTrackCursor->note++;
+
+                rv = synthCursor_fetchNote(pTrackCursor, pAudio, pCtx);
+                SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            }
+        }
+
+        synthMixer_accumulate(pBuf, pCursor->pTmp, mode, len);
+
+        i++;
+    }
+
+    pCursor->position += numSamples;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
@@ -8,12 +8,25 @@
 #include <c_synth_internal/synth_types.h>
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #if defined(USE_SDL2)
 #  include <SDL2/SDL_rwops.h>
 #endif
 
+#if defined(USE_MMAP)
+#  include <fcntl.h>
+#  include <limits.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+/** How many bytes are read at once from files (that weren't mapped) and
+ * SDL_RWops */
+#define SYNTH_LEXER_BLOCK_SIZE (64 * 1024)
+
 static char *__synthLexer_tokenString[TK_MAX + 1] = {
     "mml",
     "set bpm",
@@ -41,6 +54,216 @@ static char *__synthLexer_tokenString[TK_MAX + 1] = {
     "unknown token"
 };
 
+/** Eight consecutive characters that are skipped */
+#define SYNTHLEXER_SKIP_8 \
+    LC_SKIP, LC_SKIP, LC_SKIP, LC_SKIP, LC_SKIP, LC_SKIP, LC_SKIP, LC_SKIP
+/** Eight consecutive characters without a value */
+#define SYNTHLEXER_ZERO_8 0, 0, 0, 0, 0, 0, 0, 0
+
+/** Class of every character */
+static const unsigned char __synthLexer_charClass[256] = {
+    /* 0x00 - 0x1f: Control characters (including whitespace) */
+    SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8,
+    /* ' ' '!' '"' '#' '$' '%' '&' '\'' */
+    LC_SKIP, LC_BAD, LC_BAD, LC_BAD, LC_TOKEN, LC_BAD, LC_BAD, LC_BAD,
+    /* '(' ')' '*' '+' ',' '-' '.' '/' */
+    LC_TOKEN, LC_TOKEN, LC_BAD, LC_MOD, LC_TOKEN, LC_MOD, LC_DOT, LC_SLASH,
+    /* '0' '1' '2' '3' '4' '5' '6' '7' */
+    LC_DIGIT, LC_DIGIT, LC_DIGIT, LC_DIGIT, LC_DIGIT, LC_DIGIT, LC_DIGIT,
+    LC_DIGIT,
+    /* '8' '9' ':' ';' '<' '=' '>' '?' */
+    LC_DIGIT, LC_DIGIT, LC_BAD, LC_TOKEN, LC_OCTAVE, LC_BAD, LC_OCTAVE, LC_BAD,
+    /* '@' 'A' 'B' 'C' 'D' 'E' 'F' 'G' */
+    LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_BAD,
+    /* 'H' 'I' 'J' 'K' 'L' 'M' 'N' 'O' */
+    LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_L, LC_M, LC_BAD, LC_BAD,
+    /* 'P' 'Q' 'R' 'S' 'T' 'U' 'V' 'W' */
+    LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_BAD,
+    /* 'X' 'Y' 'Z' '[' '\\' ']' '^' '_' */
+    LC_BAD, LC_BAD, LC_BAD, LC_TOKEN, LC_BAD, LC_TOKEN, LC_TOKEN, LC_BAD,
+    /* '`' 'a' 'b' 'c' 'd' 'e' 'f' 'g' */
+    LC_BAD, LC_NOTE, LC_NOTE, LC_NOTE, LC_NOTE, LC_NOTE, LC_NOTE, LC_NOTE,
+    /* 'h' 'i' 'j' 'k' 'l' 'm' 'n' 'o' */
+    LC_TOKEN, LC_BAD, LC_BAD, LC_TOKEN, LC_TOKEN, LC_BAD, LC_BAD, LC_TOKEN,
+    /* 'p' 'q' 'r' 's' 't' 'u' 'v' 'w' */
+    LC_TOKEN, LC_TOKEN, LC_REST, LC_BAD, LC_TOKEN, LC_BAD, LC_TOKEN, LC_TOKEN,
+    /* 'x' 'y' 'z' '{' '|' '}' '~' DEL */
+    LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_BAD, LC_SKIP, LC_SKIP,
+    /* 0x80 - 0xff: Everything else */
+    SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8,
+    SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8,
+    SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8,
+    SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8, SYNTHLEXER_SKIP_8
+};
+
+/**
+ * Value of every (ASCII) character that starts a token: The token itself, for
+ * single character tokens, the note, for notes, how much the note or octave
+ * changes, for modifiers and '<'/'>', or the digit
+ */
+static const signed char __synthLexer_charValue[128] = {
+    /* 0x00 - 0x1f: Control characters (including whitespace) */
+    SYNTHLEXER_ZERO_8, SYNTHLEXER_ZERO_8, SYNTHLEXER_ZERO_8, SYNTHLEXER_ZERO_8,
+    /* ' ' '!' '"' '#' '$' '%' '&' '\'' */
+    0, 0, 0, 0, T_SET_LOOPPOINT, 0, 0, 0,
+    /* '(' ')' '*' '+' ',' '-' '.' '/' */
+    T_OPEN_BRACKET, T_CLOSE_BRACKET, 0, 1, T_COMMA, -1, 0, 0,
+    /* '0' '1' '2' '3' '4' '5' '6' '7' */
+    0, 1, 2, 3, 4, 5, 6, 7,
+    /* '8' '9' ':' ';' '<' '=' '>' '?' */
+    8, 9, 0, T_END_OF_TRACK, 1, 0, -1, 0,
+    /* '@' 'A' 'B' 'C' 'D' 'E' 'F' 'G' */
+    0, 0, 0, 0, 0, 0, 0, 0,
+    /* 'H' 'I' 'J' 'K' 'L' 'M' 'N' 'O' */
+    0, 0, 0, 0, 0, 0, 0, 0,
+    /* 'P' 'Q' 'R' 'S' 'T' 'U' 'V' 'W' */
+    0, 0, 0, 0, 0, 0, 0, 0,
+    /* 'X' 'Y' 'Z' '[' '\\' ']' '^' '_' */
+    0, 0, 0, T_SET_LOOP_START, 0, T_SET_LOOP_END, T_EXTEND, 0,
+    /* '`' 'a' 'b' 'c' 'd' 'e' 'f' 'g' */
+    0, N_A, N_B, N_C, N_D, N_E, N_F, N_G,
+    /* 'h' 'i' 'j' 'k' 'l' 'm' 'n' 'o' */
+    T_SET_RELEASE, 0, 0, T_SET_ATTACK, T_SET_DURATION, 0, 0, T_SET_OCTAVE,
+    /* 'p' 'q' 'r' 's' 't' 'u' 'v' 'w' */
+    T_SET_PAN, T_SET_KEYOFF, N_REST, 0, T_SET_BPM, 0, T_SET_VOLUME, T_SET_WAVE,
+    /* 'x' 'y' 'z' '{' '|' '}' '~' DEL */
+    0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/**
+ * Next state of the lexer, given its current state (the row) and the class of
+ * the current character (the column); Whitespace and comments are skipped
+ * before each character is looked up, except while reading "MML"
+ */
+static const unsigned char __synthLexer_transition[LS_MAX][LC_MAX] = {
+    /* SKIP, BAD, SLASH, TOKEN, OCTAVE, NOTE, REST, MOD, DOT, DIGIT, M, L,
+     * END */
+    /* LS_START */
+    {LS_ERROR, LS_ERROR, LS_ERROR, LS_TOKEN, LS_REL_OCTAVE, LS_NOTE, LS_REST,
+     LS_ERROR, LS_DOTS, LS_NUMBER, LS_M, LS_ERROR, LS_DONE},
+    /* LS_M */
+    {LS_ERROR, LS_ERROR, LS_ERROR, LS_ERROR, LS_ERROR, LS_ERROR, LS_ERROR,
+     LS_ERROR, LS_ERROR, LS_ERROR, LS_MM, LS_ERROR, LS_ERROR},
+    /* LS_MM */
+    {LS_ERROR, LS_ERROR, LS_ERROR, LS_ERROR, LS_ERROR, LS_ERROR, LS_ERROR,
+     LS_ERROR, LS_ERROR, LS_ERROR, LS_ERROR, LS_MML, LS_ERROR},
+    /* LS_NOTE */
+    {LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT,
+     LS_ACCEPT, LS_MODIFIER, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT,
+     LS_ACCEPT},
+    /* LS_REST (rests can't be modified) */
+    {LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT,
+     LS_ACCEPT, LS_ERROR, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT,
+     LS_ACCEPT},
+    /* LS_DOTS */
+    {LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT,
+     LS_ACCEPT, LS_ACCEPT, LS_DOTS, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT,
+     LS_ACCEPT},
+    /* LS_NUMBER */
+    {LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_ACCEPT,
+     LS_ACCEPT, LS_ACCEPT, LS_ACCEPT, LS_NUMBER, LS_ACCEPT, LS_ACCEPT,
+     LS_ACCEPT}
+};
+
+/** Token accepted on each state, once a character that doesn't belong to the
+ * token is found */
+static const unsigned char __synthLexer_stateToken[LS_MAX] = {
+    TK_MAX,     /* LS_START */
+    TK_MAX,     /* LS_M */
+    TK_MAX,     /* LS_MM */
+    T_NOTE,     /* LS_NOTE */
+    T_NOTE,     /* LS_REST */
+    T_DURATION, /* LS_DOTS */
+    T_NUMBER    /* LS_NUMBER */
+};
+
+/**
+ * Alloc the block into which the lexer's source is read
+ * 
+ * @param  [ in]pCtx The lexer context
+ * @return           SYNTH_OK, SYNTH_MEM_ERR
+ */
+static synth_err synthLexer_initBlock(synthLexCtx *pCtx) {
+    synth_err rv;
+
+    pCtx->pBlock = (char*)malloc(SYNTH_LEXER_BLOCK_SIZE);
+    SYNTH_ASSERT_ERR(pCtx->pBlock, SYNTH_MEM_ERR);
+
+    /* Nothing was read yet */
+    pCtx->buf.pStr = pCtx->pBlock;
+    pCtx->buf.len = 0;
+    pCtx->buf.pos = 0;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+#if defined(USE_MMAP)
+/**
+ * Map a whole file into memory, so it's lexed just like a string
+ * 
+ * @param  [ in]pCtx      The lexer context
+ * @param  [ in]pFilename The file
+ * @return                SYNTH_OK, SYNTH_OPEN_FILE_ERR
+ */
+static synth_err synthLexer_mapFile(synthLexCtx *pCtx, char *pFilename) {
+    struct stat st;
+    void *pData;
+    int fd;
+    synth_err rv;
+
+    fd = open(pFilename, O_RDONLY);
+    SYNTH_ASSERT_ERR(fd >= 0, SYNTH_OPEN_FILE_ERR);
+
+    /* Only regular files may be mapped, and empty ones can't */
+    SYNTH_ASSERT_ERR(fstat(fd, &st) == 0, SYNTH_OPEN_FILE_ERR);
+    SYNTH_ASSERT_ERR(S_ISREG(st.st_mode), SYNTH_OPEN_FILE_ERR);
+    SYNTH_ASSERT_ERR(st.st_size > 0 && st.st_size < INT_MAX,
+            SYNTH_OPEN_FILE_ERR);
+
+    pData = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    SYNTH_ASSERT_ERR(pData != MAP_FAILED, SYNTH_OPEN_FILE_ERR);
+    /* The file is lexed from its start to its end */
+    madvise(pData, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    pCtx->buf.pStr = (char*)pData;
+    pCtx->buf.len = (int)st.st_size;
+    pCtx->buf.pos = 0;
+    pCtx->isMapped = 1;
+
+    rv = SYNTH_OK;
+__err:
+    /* The mapping is kept even after the file is closed */
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    return rv;
+}
+#endif
+
+/**
+ * Open a file, to be read in blocks
+ * 
+ * @param  [ in]pCtx      The lexer context
+ * @param  [ in]pFilename The file
+ * @return                SYNTH_OK, SYNTH_OPEN_FILE_ERR, SYNTH_MEM_ERR
+ */
+static synth_err synthLexer_openFile(synthLexCtx *pCtx, char *pFilename) {
+    synth_err rv;
+
+    pCtx->source.file = fopen(pFilename, "rt");
+    SYNTH_ASSERT_ERR(pCtx->source.file, SYNTH_OPEN_FILE_ERR);
+
+    rv = synthLexer_initBlock(pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
 /**
  * Initialize the lexer, reading tokens from a SDL_RWops
  * 
@@ -49,7 +272,8 @@ static char *__synthLexer_tokenString[TK_MAX + 1] = {
  * 
  * @param  [ in]pCtx  The lexer context, to be initialized
  * @param  [ in]pFile The file
- * @return            SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_OPEN_FILE_ERR
+ * @return            SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_OPEN_FILE_ERR,
+ *                    SYNTH_MEM_ERR
  */
 synth_err synthLexer_initFromSDL_RWops(synthLexCtx *pCtx, void *pFile) {
 #if defined(USE_SDL2)
@@ -66,6 +290,9 @@ synth_err synthLexer_initFromSDL_RWops(synthLexCtx *pCtx, void *pFile) {
     pCtx->source.sdl = (SDL_RWops*)pFile;
     pCtx->type = SST_SDL;
 
+    rv = synthLexer_initBlock(pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
     rv = SYNTH_OK;
 __err:
     return rv;
@@ -82,7 +309,8 @@ __err:
  * 
  * @param  [ in]pCtx      The lexer context, to be initialized
  * @param  [ in]pFilename The file
- * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_OPEN_FILE_ERR
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_OPEN_FILE_ERR,
+ *                        SYNTH_MEM_ERR
  */
 synth_err synthLexer_initFromFile(synthLexCtx *pCtx, char *pFilename) {
     synth_err rv;
@@ -95,10 +323,18 @@ synth_err synthLexer_initFromFile(synthLexCtx *pCtx, char *pFilename) {
     rv = synthLexer_clear(pCtx);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
     /* Store its source (i.e., a file) */
-    pCtx->source.file = fopen(pFilename, "rt");
-    SYNTH_ASSERT_ERR(pCtx->source.file, SYNTH_OPEN_FILE_ERR);
-
     pCtx->type = SST_FILE;
+#if defined(USE_MMAP)
+    /* Map it into memory, if possible, or read it in blocks (e.g., if it's
+     * empty) */
+    rv = synthLexer_mapFile(pCtx, pFilename);
+    if (rv != SYNTH_OK) {
+        rv = synthLexer_openFile(pCtx, pFilename);
+    }
+#else
+    rv = synthLexer_openFile(pCtx, pFilename);
+#endif
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
 __err:
@@ -130,9 +366,9 @@ synth_err synthLexer_initFromString(synthLexCtx *pCtx, char *pString, int len) {
     rv = synthLexer_clear(pCtx);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
     /* Store its source (i.e., a string) */
-    pCtx->source.str.pStr = pString;
-    pCtx->source.str.len = len;
-    pCtx->source.str.pos = 0;
+    pCtx->buf.pStr = pString;
+    pCtx->buf.len = len;
+    pCtx->buf.pos = 0;
 
     pCtx->type = SST_STR;
 
@@ -160,6 +396,16 @@ synth_err synthLexer_clear(synthLexCtx *pCtx) {
     if (pCtx->type == SST_FILE && pCtx->source.file) {
         fclose(pCtx->source.file);
     }
+#if defined(USE_MMAP)
+    /* Unmap the file, if it was mapped */
+    if (pCtx->isMapped) {
+        munmap(pCtx->buf.pStr, (size_t)pCtx->buf.len);
+    }
+#endif
+    /* Release the block into which the source was read */
+    if (pCtx->pBlock) {
+        free(pCtx->pBlock);
+    }
     /* If it's a string, it'll be cleaned on the memset */
 
     /* Clear everything (except for everything related to an error ) */
@@ -167,6 +413,9 @@ synth_err synthLexer_clear(synthLexCtx *pCtx) {
     pCtx->ivalue = 0;
     pCtx->lastToken = 0;
     memset(&(pCtx->source), 0x0, sizeof(synthSource));
+    memset(&(pCtx->buf), 0x0, sizeof(synthString));
+    pCtx->pBlock = 0;
+    pCtx->isMapped = 0;
 
     rv = SYNTH_OK;
 __err:
@@ -308,157 +557,67 @@ __err:
 }
 
 /**
- * Read the character on the current position.
+ * Read the next block of a file (or SDL_RWops) into the lexer's buffer; Since
+ * the lexer never goes back, the previous block may simply be overwritten
  * 
  * Since this function is static, and it's has already been sanitized on the
  * previous 'public' call, there's no need to do it again here
  * 
- * @param  [out]pChar The character that was read
- * @param  [ in]pCtx  The context
- * @return            SYNTH_OK, SYNTH_EOF, SYNTH_EOS
+ * @param  [ in]pCtx The context
+ * @return           SYNTH_OK, SYNTH_EOF, SYNTH_EOS, SYNTH_INTERNAL_ERR
  */
-static synth_err synthLexer_getRawChar(char *pChar, synthLexCtx *pCtx) {
+static synth_err synthLexer_readBlock(synthLexCtx *pCtx) {
     synth_err rv;
-    int tmp;
+    int num;
 
-    /* Set the return to '\0', in case the end of the stream is reached */
-    *pChar = '\0';
+    /* Strings and mapped files are already completely in memory */
+    SYNTH_ASSERT_ERR(pCtx->type != SST_STR, SYNTH_EOS);
+    SYNTH_ASSERT_ERR(pCtx->type == SST_FILE || pCtx->type == SST_SDL,
+            SYNTH_INTERNAL_ERR);
+    SYNTH_ASSERT_ERR(pCtx->pBlock, SYNTH_EOF);
 
+    num = 0;
     if (pCtx->type == SST_FILE) {
-        /* Read a character from the file */
-        tmp = fgetc(pCtx->source.file);
-        SYNTH_ASSERT_ERR(tmp != EOF, SYNTH_EOF);
+        num = (int)fread(pCtx->pBlock, 1, SYNTH_LEXER_BLOCK_SIZE,
+                pCtx->source.file);
     }
 #if defined(USE_SDL2)
     else if (pCtx->type == SST_SDL) {
-        /* Since SDL2 doesn't return EOF when reading a char, manually check for
-         * the EOF */
-        SYNTH_ASSERT_ERR(SDL_RWtell(pCtx->source.sdl) <
-                SDL_RWsize(pCtx->source.sdl), SYNTH_EOF);
-        /* Read the actual char */
-        tmp = SDL_ReadU8(pCtx->source.sdl);
-        SYNTH_ASSERT_ERR(tmp != 0, SYNTH_INTERNAL_ERR);
+        num = (int)SDL_RWread(pCtx->source.sdl, pCtx->pBlock, 1,
+                SYNTH_LEXER_BLOCK_SIZE);
     }
 #endif
-    else if (pCtx->type == SST_STR) {
-        /* Get the current character and increase the position */
-        SYNTH_ASSERT_ERR(pCtx->source.str.pos < pCtx->source.str.len,
-                SYNTH_EOS);
-        tmp = pCtx->source.str.pStr[pCtx->source.str.pos];
-        pCtx->source.str.pos++;
-    }
-    else {
-        SYNTH_ASSERT_ERR(0, SYNTH_INTERNAL_ERR);
-    }
 
-    /* Return the read character */
-    *pChar = (char)tmp;
+    pCtx->buf.pos = 0;
+    pCtx->buf.len = num;
+    SYNTH_ASSERT_ERR(num > 0, SYNTH_EOF);
+
     rv = SYNTH_OK;
 __err:
     return rv;
 }
 
 /**
- * Read the character on the current position. Commentaries, whitespace and
- * similars are already ignored
+ * Retrieve the character on the current position, without consuming it
  * 
  * Since this function is static, and it's has already been sanitized on the
  * previous 'public' call, there's no need to do it again here
  * 
- * @param  [out]pChar The character that was read
+ * @param  [out]pChar The character (as an unsigned value)
  * @param  [ in]pCtx  The context
  * @return            SYNTH_OK, SYNTH_EOF, SYNTH_EOS
  */
-static synth_err synthLexer_getChar(char *pChar, synthLexCtx *pCtx) {
+static synth_err synthLexer_peekChar(int *pChar, synthLexCtx *pCtx) {
     synth_err rv;
-    char tmp;
-    int isComment;
 
-    isComment = 0;
-    /* Read as many characters until the next valid one is found */
-    while (1) {
-        rv = synthLexer_getRawChar(&tmp, pCtx);
+    /* Every source is lexed from memory; Files and SDL_RWops are read in
+     * blocks, as they are consumed */
+    if (pCtx->buf.pos >= pCtx->buf.len) {
+        rv = synthLexer_readBlock(pCtx);
         SYNTH_ASSERT(rv == SYNTH_OK);
-
-        /* Store the character that has been just read */
-        pCtx->lastChar = tmp;
-        /* Update the current position on the source */
-        if (tmp != '\n' && tmp != '\r') {
-            pCtx->linePos++;
-        }
-        else if (tmp == '\n') {
-            pCtx->linePos = 0;
-            pCtx->line++;
-        }
-
-        if (isComment <= 1) {
-            /* Add 1 to each consecutive '/', so it will be 2 on when a comment
-             * starts */
-            if (tmp == '/') {
-                isComment++;
-            }
-            else {
-                isComment = 0;
-
-                /* If it's a valid printable non-whitespace character, stop */
-                if (tmp >= '!' && tmp <= '}') {
-                    break;
-                }
-            }
-        }
-        else if (isComment == 2 && tmp == '\n') {
-            /* If it's a comment, stop as soon as a new-line is found */
-            isComment = 0;
-        }
     }
 
-    /* Return the read character */
-    *pChar = (char)tmp;
-    rv = SYNTH_OK;
-__err:
-    return rv;
-}
-
-/**
- * 'Return' the last character to the 'stream'
- * 
- * Note that the character isn't actually returned, the position is simply
- * rewinded to the previous one
- * 
- * Since this function is static, and it's has already been sanitized on the
- * previous 'public' call, there's no need to do it again here
- * 
- * @param [ in]pCtx The context
- * @param [ in]c    The character that was previously read
- * @return          SYNTH_OK, SYNTH_INTERNAL_ERR
- */
-static synth_err synthLexer_ungetChar(synthLexCtx *pCtx, char c) {
-    synth_err rv;
-
-    if (pCtx->type == SST_FILE) {
-        int tmp;
-
-        /* Return the character to the file */
-        tmp = ungetc((int)c, pCtx->source.file);
-        SYNTH_ASSERT_ERR(tmp != EOF, SYNTH_INTERNAL_ERR);
-    }
-#if defined(USE_SDL2)
-    else if (pCtx->type == SST_SDL) {
-        /* Move backward 1 byte */
-        SDL_RWseek(pCtx->source.sdl, -1, SEEK_CUR);
-    }
-#endif
-    else if (pCtx->type == SST_STR) {
-        /* Or simply decrement the position */
-        SYNTH_ASSERT_ERR(pCtx->source.str.pos > 0, SYNTH_INTERNAL_ERR);
-        pCtx->source.str.pos--;
-    }
-    else {
-        SYNTH_ASSERT_ERR(0, SYNTH_INTERNAL_ERR);
-    }
-    /* Update the current position in the file */
-    pCtx->linePos--;
-    /* TODO Check if the new position also returned to the previous line */
+    *pChar = (unsigned char)pCtx->buf.pStr[pCtx->buf.pos];
 
     rv = SYNTH_OK;
 __err:
@@ -466,465 +625,148 @@ __err:
 }
 
 /**
- * Check if the current character is a single char token and set its value
+ * Consume the character on the current position (which must have just been
+ * retrieved), updating the current position on the source
  * 
- * Instead of returning one of the error codes, this function simply return
- * 'true' or 'false'
- * 
- * @param  [ in]func     The name of the function
- * @param  [ in]expected The expected character
- * @param  [ in]token    The gotten token, on success
- * @return               SYNTH_TRUE, SYNTH_FALSE
+ * @param  [ in]pCtx The context
+ * @param  [ in]c    The character
  */
-#define SYNTHLEXER_ISTOKEN(func, expected, token) \
-  static synth_bool func(synthLexCtx *pCtx) { \
-    synth_bool rv; \
-    synth_err srv; \
-    char c; \
-\
-    /* Read the current character */ \
-    srv = synthLexer_getChar(&c, pCtx); \
-    SYNTH_ASSERT_ERR(srv == SYNTH_OK, SYNTH_FALSE); \
-\
-    /* Check if it's what was expected */ \
-    if (c != expected) { \
-        synthLexer_ungetChar(pCtx, c); \
-        rv = SYNTH_FALSE; \
-    } \
-    else { \
-        rv = SYNTH_TRUE; \
-        pCtx->lastToken = token; \
-    } \
-\
-__err: \
-    return rv; \
-  }
-
-SYNTHLEXER_ISTOKEN(synthLexer_isSetBPM,       't', T_SET_BPM)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetDuration,  'l', T_SET_DURATION)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetOctave,    'o', T_SET_OCTAVE)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetLoopPoint, '$', T_SET_LOOPPOINT)
-SYNTHLEXER_ISTOKEN(synthLexer_isEndOfTrack,   ';', T_END_OF_TRACK)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetVolume,    'v', T_SET_VOLUME)
-SYNTHLEXER_ISTOKEN(synthLexer_isOpenBracket,  '(', T_OPEN_BRACKET)
-SYNTHLEXER_ISTOKEN(synthLexer_isCloseBracket, ')', T_CLOSE_BRACKET)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetAttack,    'k', T_SET_ATTACK)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetKeyoff,    'q', T_SET_KEYOFF)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetRelease,   'h', T_SET_RELEASE)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetPan,       'p', T_SET_PAN)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetLoopStart, '[', T_SET_LOOP_START)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetLoopEnd,   ']', T_SET_LOOP_END)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetWave,      'w', T_SET_WAVE)
-SYNTHLEXER_ISTOKEN(synthLexer_isSetComma,     ',', T_COMMA)
-SYNTHLEXER_ISTOKEN(synthLexer_isExtend,       '^', T_EXTEND)
+static void synthLexer_consumeChar(synthLexCtx *pCtx, int c) {
+    pCtx->buf.pos++;
 
-/**
- * Check if the current stream is a valid MML (i.e., if it starts with "MML")
- * 
- * The stream isn't checked to be at its start
- * 
- * @param  [ in]pCtx The contex
- * @return           SYNTH_TRUE, SYNTH_FALSE
- */
-static synth_bool synthLexer_isMML(synthLexCtx *pCtx) {
-    synth_bool rv;
-    synth_err srv;
-    char c;
-    char target[] = "MML";
-    int i;
-
-    i = 0;
-
-    /* Find the first valid (not blank, comment etc) */
-    srv = synthLexer_getChar(&c, pCtx);
-    SYNTH_ASSERT_ERR(srv == SYNTH_OK, SYNTH_FALSE);
-    /* Return it to the stream */
-    srv = synthLexer_ungetChar(pCtx, c);
-    SYNTH_ASSERT_ERR(srv == SYNTH_OK, SYNTH_FALSE);
-
-    while (i < sizeof(target) - 1) {
-        /* Get the current character, without ignoring blank and whatnot */
-        srv = synthLexer_getRawChar(&c, pCtx);
-        SYNTH_ASSERT_ERR(srv == SYNTH_OK, SYNTH_FALSE);
-
-        /* Check that it's of the expected pattern */
-        SYNTH_ASSERT_ERR(c == target[i], SYNTH_FALSE);
-
-        /* Go to the next char */
-        i++;
+    /* Update the current position on the source */
+    if (c != '\n' && c != '\r') {
+        pCtx->linePos++;
     }
-
-    pCtx->lastToken = T_MML;
-    rv = SYNTH_TRUE;
-__err:
-    if (rv != SYNTH_TRUE && ((srv != SYNTH_EOF && srv != SYNTH_EOS) || i > 0)) {
-        /* On error, return the last char (that didn't belong to the pattern */
-        synthLexer_ungetChar(pCtx, c);
-
-        /* Then, return everything that belonged partially to the pattern */
-        while (i > 0) {
-            i--;
-            synthLexer_ungetChar(pCtx, target[i]);
-        }
+    else if (c == '\n') {
+        pCtx->linePos = 0;
+        pCtx->line++;
     }
-
-    return rv;
 }
 
 /**
- * Check if the current octave should be increased or decreased, through the
- * character '<' and '>', repectively
+ * Skip whitespace, non-printable characters and comments (which go from a
+ * "//" to the end of the line); A single '/' is also skipped
  * 
- * @param  [ in]pCtx The contex
- * @return           SYNTH_TRUE, SYNTH_FALSE
+ * @param  [ in]pCtx The context
  */
-static synth_bool synthLexer_isSetRelOctave(synthLexCtx *pCtx) {
-    synth_bool rv;
-    synth_err srv;
-    char c;
-
-    /* Get the current character */
-    srv = synthLexer_getChar(&c, pCtx);
-    SYNTH_ASSERT_ERR(srv == SYNTH_OK, SYNTH_FALSE);
-
-    if (c == '<') {
-        /* Check if the octave should be increased */
-        pCtx->ivalue = 1;
-        rv = SYNTH_TRUE;
-        pCtx->lastToken = T_SET_REL_OCTAVE;
-    }
-    else if (c == '>') {
-        /* Check if the octave should be decreased */
-        pCtx->ivalue = -1;
-        rv = SYNTH_TRUE;
-        pCtx->lastToken = T_SET_REL_OCTAVE;
-    }
-    else {
-        /* Return the character to the source */
-        synthLexer_ungetChar(pCtx, c);
-        rv = SYNTH_FALSE;
-    }
+static void synthLexer_skip(synthLexCtx *pCtx) {
+    int c, isComment;
 
-__err:
-    return rv;
-}
+    isComment = 0;
+    while (synthLexer_peekChar(&c, pCtx) == SYNTH_OK) {
+        if (isComment) {
+            /* Comments stop as soon as a new-line is found */
+            isComment = (c != '\n');
+        }
+        else if (__synthLexer_charClass[c] == LC_SLASH) {
+            synthLexer_consumeChar(pCtx, c);
 
-/**
- * Check if there's a note on the current position on the source and read it
- * 
- * @param  [ in]pCtx The contex
- * @return           SYNTH_TRUE, SYNTH_FALSE
- */
-static synth_bool synthLexer_isNote(synthLexCtx *pCtx) {
-    synth_bool rv;
-    synth_err srv;
-    char note;
-    char mod;
-
-    /* Set these to 0 so we know which has to be returned to the stream, on
-     * error */
-    note = 0;
-    mod = 0;
-
-    /* Get the current character */
-    srv = synthLexer_getChar(&note, pCtx);
-    /* It's OK to reach the end of the stream, if the note is the last char */
-    SYNTH_ASSERT_ERR(srv == SYNTH_OK || srv == SYNTH_EOF || srv == SYNTH_EOS
-        , SYNTH_FALSE);
-
-    /* Check if it's a valid note (and which) */
-    switch (note) {
-        case 'c': pCtx->ivalue = N_C; break;
-        case 'd': pCtx->ivalue = N_D; break;
-        case 'e': pCtx->ivalue = N_E; break;
-        case 'f': pCtx->ivalue = N_F; break;
-        case 'g': pCtx->ivalue = N_G; break;
-        case 'a': pCtx->ivalue = N_A; break;
-        case 'b': pCtx->ivalue = N_B; break;
-        case 'r': pCtx->ivalue = N_REST; break;
-        default:
-            /* Something that isn't a note was read */
-            SYNTH_ASSERT_ERR(0, SYNTH_FALSE);
-    }
-    
-    /* Try to read a modifier ('+' or '-') */
-    srv = synthLexer_getChar(&mod, pCtx);
-    /* Again, it's OK to reach the end of the stream, if the note is the last
-     * char, no matter wheter there's a modifier or not */
-    SYNTH_ASSERT_ERR(srv == SYNTH_OK || srv == SYNTH_EOF || srv == SYNTH_EOS
-        , SYNTH_FALSE);
-
-    /* Check if the read character is a modifier, and that note isn't a rest */
-    if (mod == '+') {
-        SYNTH_ASSERT_ERR(pCtx->ivalue != N_REST, SYNTH_FALSE);
-        pCtx->ivalue++;
-    }
-    else if (mod == '-') {
-        SYNTH_ASSERT_ERR(pCtx->ivalue != N_REST, SYNTH_FALSE);
-        pCtx->ivalue--;
-    }
-    else if (srv != SYNTH_EOF && srv != SYNTH_EOS) {
-        /* A note is valid even without the modifier, so simply return the char,
-         * but if it's 0, the the end of the stream was reached, and there's
-         * nothing to 'unread' */
-        synthLexer_ungetChar(pCtx, mod);
-    }
-    
-    pCtx->lastToken = T_NOTE;
-    rv = SYNTH_TRUE;
-__err:
-    /* Make sure to return any read character to the stream, if it wasn't a
-     * note */
-    if (rv == SYNTH_FALSE) {
-        if (mod != 0) {
-            synthLexer_ungetChar(pCtx, mod);
+            /* Only start a comment if the next character is also a '/' */
+            if (synthLexer_peekChar(&c, pCtx) != SYNTH_OK || c != '/') {
+                continue;
+            }
+            isComment = 1;
         }
-        if (note != 0) {
-            synthLexer_ungetChar(pCtx, note);
+        else if (__synthLexer_charClass[c] != LC_SKIP) {
+            break;
         }
-    }
 
-    return rv;
+        synthLexer_consumeChar(pCtx, c);
+    }
 }
 
 /**
- * Check if the current token is a "dot duration", i.e., a fraction of the
- * current note's duration
+ * Get the next token on the context and its value (if any)
  * 
- * @param  [ in]pCtx The contex
- * @return           SYNTH_TRUE, SYNTH_FALSE
+ * Tokens are read in a single pass, by a DFA (see '__synthLexer_transition')
+ * over the class of each character, so no character is ever read twice
+ * 
+ * @param  [ in]pCtx The context
+ * return            SYNTH_OK, SYNTH_INVALID_TOKEN
  */
-static synth_bool synthLexer_isDotDuration(synthLexCtx *pCtx) {
-    synth_bool rv;
-    synth_err srv;
-    char c;
-
-    /* Clean the current value so we can return as many characters as were
-     * read, on error */
-    pCtx->ivalue = 0;
-    c = '\0'; /* Avoids valgrind warning */
+synth_err synthLexer_getToken(synthLexCtx *pCtx) {
+    synthLexClass charClass;
+    synthLexState next, state;
+    synth_err rv;
+    int c;
 
-    /* Get the current character */
-    srv = synthLexer_getChar(&c, pCtx);
-    /* It's OK to reach the end of the stream, if the '.' is the last char */
-    SYNTH_ASSERT_ERR(srv == SYNTH_OK || srv == SYNTH_EOF || srv == SYNTH_EOS,
-        SYNTH_FALSE);
-    SYNTH_ASSERT_ERR(c == '.', SYNTH_FALSE);
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
 
-    /* Read as many '.' as there are on the stream, adding half the duration
-     * each time */
+    pCtx->ivalue = 0;
+    state = LS_START;
     while (1) {
-        /* Stop at the first non '.' */
-        if (c != '.') {
-            break;
+        /* "MML" must be written without anything in between */
+        if (state != LS_M && state != LS_MM) {
+            synthLexer_skip(pCtx);
         }
 
-        /* Add a new byte to the value, to represent another "half time" */
-        pCtx->ivalue = (pCtx->ivalue << 1) | 1;
-
-        /* Read the next character before looping */
-        srv = synthLexer_getChar(&c, pCtx);
-        SYNTH_ASSERT_ERR(srv == SYNTH_OK || srv == SYNTH_EOF ||
-            srv == SYNTH_EOS, SYNTH_FALSE);
-
-        /* Also stop if the source finished */
-        if (srv == SYNTH_EOF || srv == SYNTH_EOS) {
-            break;
-        }
-    }
-    
-    pCtx->lastToken = T_DURATION;
-    rv = SYNTH_TRUE;
-    /* Return that last non-dot char */
-    if (srv != SYNTH_EOF && srv != SYNTH_EOS) {
-        synthLexer_ungetChar(pCtx, c);
-    }
-__err:
-    /* If the funtion failed, return every invalid char */
-    if (rv != SYNTH_TRUE && srv != SYNTH_EOF && srv != SYNTH_EOS) {
-        /* Return the last invalid char read */
-        synthLexer_ungetChar(pCtx, c);
-        /* Now, return any '.' that was read */
-        while (pCtx->ivalue > 0) {
-            c = '.';
-            pCtx->ivalue >>= 1;
-
-            synthLexer_ungetChar(pCtx, c);
+        c = 0;
+        charClass = LC_END;
+        if (synthLexer_peekChar(&c, pCtx) == SYNTH_OK) {
+            charClass = (synthLexClass)__synthLexer_charClass[c];
+            /* Store the character that has been just read */
+            pCtx->lastChar = (char)c;
         }
-    }
 
-    return rv;
-}
-
-/**
- * Check if there's a number on the stream and read it
- * 
- * @param  [ in]pCtx The contex
- * @return           SYNTH_TRUE, SYNTH_FALSE
- */
-static synth_bool synthLexer_isNumber(synthLexCtx *pCtx) {
-    synth_bool rv;
-    synth_err srv;
-    char c;
-
-    /* Clean the current value so we can return as many characters as were
-     * read, on error */
-    pCtx->ivalue = 0;
-    c = '\0'; /* Avoids valgrind warning */
-    
-    /* Get the current character */
-    srv = synthLexer_getChar(&c, pCtx);
-    /* It's OK to reach the end of the stream, if a digit is the last char */
-    SYNTH_ASSERT_ERR(srv == SYNTH_OK || srv == SYNTH_EOF || srv == SYNTH_EOS,
-        SYNTH_FALSE);
-    SYNTH_ASSERT_ERR(c >= '0' && c <= '9', SYNTH_FALSE);
-    
-    /* Get the integer part */
-    while (1) {
-        /* Stop on the first non-digit found */
-        if (c < '0' || c > '9') {
+        next = (synthLexState)__synthLexer_transition[state][charClass];
+        if (next == LS_ACCEPT) {
+            /* The current character doesn't belong to the token */
+            pCtx->lastToken = (synth_token)__synthLexer_stateToken[state];
             break;
         }
-
-        /* Accumulate the last gotten char */
-        pCtx->ivalue = pCtx->ivalue * 10 + (int)(c - '0');
-
-        /* Read the next one */
-        srv = synthLexer_getChar(&c, pCtx);
-        SYNTH_ASSERT_ERR(srv == SYNTH_OK || srv == SYNTH_EOF || srv == SYNTH_EOS
-            , SYNTH_FALSE);
-
-        /* Also stop if the source finished */
-        if (srv == SYNTH_EOF || srv == SYNTH_EOS) {
+        else if (next == LS_DONE) {
+            pCtx->lastToken = T_DONE;
             break;
         }
-    }
-
-    pCtx->lastToken = T_NUMBER;
-    rv = SYNTH_TRUE;
-    /* Return that last non-digit char */
-    if (srv != SYNTH_EOF && srv != SYNTH_EOS) {
-        synthLexer_ungetChar(pCtx, c);
-    }
-__err:
-    /* If the funtion failed, return every invalid char */
-    if (rv != SYNTH_TRUE && srv != SYNTH_EOF && srv != SYNTH_EOS) {
-        /* Return the last invalid char read */
-        synthLexer_ungetChar(pCtx, c);
-        /* Now, return any digit that was read */
-        while (pCtx->ivalue > 0) {
-            c = (pCtx->ivalue % 10) + '0';
-            pCtx->ivalue /= 10;
-            
-            synthLexer_ungetChar(pCtx, c);
+        else if (next == LS_ERROR) {
+            SYNTH_ASSERT_ERR(0, SYNTH_INVALID_TOKEN);
         }
-    }
 
-    return rv;
-}
-
-/**
- * Check if there are any more characters in the 'stream' or not
- * 
- * @param  [ in]pCtx The contex
- * @return           SYNTH_TRUE, SYNTH_FALSE
- */
-static synth_bool synthLexer_didFinish(synthLexCtx *pCtx) {
-    if (pCtx->type == SST_FILE) {
-        /* If the stream is a file, first check for the EOF flag */
-        if (feof(pCtx->source.file) != 0) {
-            pCtx->lastToken = T_DONE;
-            return SYNTH_TRUE;
-        }
-        else {
-            char c;
-
-            /* Otherwise, try to read a character to make sure there's nothing
-             * else on the stream */
-            if (synthLexer_getChar(&c, pCtx) == SYNTH_EOF) {
-                pCtx->lastToken = T_DONE;
-                return SYNTH_TRUE;
-            }
-            else {
-                /* On error, return the character to the stream */
-                synthLexer_ungetChar(pCtx, c);
-                return SYNTH_FALSE;
+        synthLexer_consumeChar(pCtx, c);
+
+        /* Accumulate the token's value */
+        switch (next) {
+            case LS_NOTE:
+            case LS_REST: {
+                pCtx->ivalue = __synthLexer_charValue[c];
+            } break;
+            case LS_DOTS: {
+                /* Add a new bit to the value, to represent another "half
+                 * time" */
+                pCtx->ivalue = (pCtx->ivalue << 1) | 1;
+            } break;
+            case LS_NUMBER: {
+                pCtx->ivalue = pCtx->ivalue * 10 + __synthLexer_charValue[c];
+            } break;
+            case LS_MML: {
+                pCtx->lastToken = T_MML;
+            } break;
+            case LS_TOKEN: {
+                pCtx->lastToken = (synth_token)__synthLexer_charValue[c];
+            } break;
+            case LS_REL_OCTAVE: {
+                pCtx->ivalue = __synthLexer_charValue[c];
+                pCtx->lastToken = T_SET_REL_OCTAVE;
+            } break;
+            case LS_MODIFIER: {
+                pCtx->ivalue += __synthLexer_charValue[c];
+                pCtx->lastToken = T_NOTE;
+            } break;
+            default: {
+                /* Nothing to be accumulated */
             }
         }
-    }
-#if defined(USE_SDL2)
-    else if (pCtx->type == SST_SDL) {
-        /* Simply compare the current position to the file's size */
-        if (SDL_RWsize(pCtx->source.sdl) == SDL_RWtell(pCtx->source.sdl)) {
-            pCtx->lastToken = T_DONE;
-            return SYNTH_TRUE;
-        }
-        else {
-            return SYNTH_FALSE;
-        }
-    }
-#endif
-    else if (pCtx->type == SST_STR) {
-        /* If the stream is a string, simply check it's length and, then, if its
-         * NULL terminator was found */
-        if (pCtx->source.str.pos >= pCtx->source.str.len ||
-                (pCtx->source.str.pos == pCtx->source.str.len - 1 &&
-                pCtx->source.str.pStr[pCtx->source.str.pos] == '\0')) {
-            pCtx->lastToken = T_DONE;
-            return SYNTH_TRUE;
-        }
-        else {
-            return SYNTH_FALSE;
-        }
-    }
-    else {
-        return SYNTH_INTERNAL_ERR;
-    }
-}
-
-/**
- * Get the next token on the context and its value (if any)
- * 
- * @param  [ in]pCtx The context
- * return            SYNTH_OK, SYNTH_INVALID_TOKEN
- */
-synth_err synthLexer_getToken(synthLexCtx *pCtx) {
-    synth_err rv;
-
-    /* Sanitize the arguments */
-    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
 
-    /* Check if a valid token, and which, was found */
-    if (synthLexer_isMML(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetBPM(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetDuration(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetOctave(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetRelOctave(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetLoopPoint(pCtx) == SYNTH_TRUE ||
-            synthLexer_isEndOfTrack(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetVolume(pCtx) == SYNTH_TRUE ||
-            synthLexer_isOpenBracket(pCtx) == SYNTH_TRUE ||
-            synthLexer_isCloseBracket(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetAttack(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetKeyoff(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetRelease(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetPan(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetLoopStart(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetLoopEnd(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetWave(pCtx) == SYNTH_TRUE ||
-            synthLexer_isNote(pCtx) == SYNTH_TRUE ||
-            synthLexer_isDotDuration(pCtx) == SYNTH_TRUE ||
-            synthLexer_isNumber(pCtx) == SYNTH_TRUE ||
-            synthLexer_isSetComma(pCtx) == SYNTH_TRUE ||
-            synthLexer_isExtend(pCtx) == SYNTH_TRUE ||
-            synthLexer_didFinish(pCtx) == SYNTH_TRUE) {
-        rv = SYNTH_OK;
-    }
-    else {
-        rv = SYNTH_INVALID_TOKEN;
+        /* Every other state is final */
+        if (next >= LS_MAX) {
+            break;
+        }
+        state = next;
     }
 
+    rv = SYNTH_OK;
 __err:
     return rv;
 }
-
@@ -0,0 +1,516 @@
+/**
+ * @file src/synth_list.c
+ *
+ * Lists of items kept by the context
+ *
+ * Songs, tracks, notes and volumes are stored in blocks of '1 << shift' items
+ * each, pointed by 'ppBlocks'; Expanding a list simply allocs another block,
+ * so its items are never copied (as it would happen when 'doubling' an array)
+ * and the list never requires much more memory than its items. The timeline
+ * and loops are searched as contiguous arrays, so 'shift' is 0 for those and
+ * they are kept in 'buf'.
+ *
+ * Items of released songs are kept as sorted ranges (merged with their
+ * neighbours), so newer songs may reuse them; A range that reaches the end of
+ * the list is simply given back to it (i.e., 'used' is decreased). Static
+ * lists can't hold a new song past their end, so their released items are
+ * removed instead (moving the following ones back).
+ */
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_list.h>
+#include <c_synth_internal/synth_types.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Calculate how many blocks are required by a number of items
+ *
+ * @param  [ in]num   How many items there are
+ * @param  [ in]shift log2 of the list's block size
+ */
+#define SYNTHLIST_NUM_BLOCKS(num, shift) \
+    (((num) + (1 << (shift)) - 1) >> (shift))
+
+/** Round a size up, so whatever follows it is aligned to a pointer */
+#define SYNTHLIST_ALIGN(size) \
+    (((size) + (int)sizeof(void*) - 1) & ~((int)sizeof(void*) - 1))
+
+/**
+ * Calculate how many bytes a list carved from a static context requires
+ *
+ * @param  [ in]num     How many items the list may hold
+ * @param  [ in]size    Size of each item, in bytes
+ * @param  [ in]shift   log2 of the list's block size (0 for a contiguous list)
+ * @param  [ in]numFree How many ranges of released items may be kept
+ * @return              The list's size, rounded so the next one is aligned
+ */
+int synthList_getStaticSize(int num, int size, int shift, int numFree) {
+    int bytes;
+
+    bytes = num * size + numFree * (int)sizeof(synthRange);
+    if (shift > 0) {
+        /* The table of blocks is placed before the items */
+        bytes += SYNTHLIST_NUM_BLOCKS(num, shift) * (int)sizeof(void*);
+    }
+
+    return SYNTHLIST_ALIGN(bytes);
+}
+
+/**
+ * Initialize a list over memory previously carved from a static context; The
+ * list is never expanded (nor shrunk)
+ *
+ * @param  [ in]pList   The list
+ * @param  [ in]pData   'synthList_getStaticSize' bytes
+ * @param  [ in]num     How many items the list may hold
+ * @param  [ in]size    Size of each item, in bytes
+ * @param  [ in]shift   log2 of the list's block size (0 for a contiguous list)
+ * @param  [ in]numFree How many ranges of released items may be kept
+ */
+void synthList_initStatic(synthList *pList, char *pData, int num, int size,
+        int shift, int numFree) {
+    pList->max = num;
+    pList->len = num;
+    pList->used = 0;
+    pList->shift = shift;
+
+    /* The table of blocks must be placed first, as it's made of pointers */
+    if (shift > 0) {
+        pList->numBlocks = SYNTHLIST_NUM_BLOCKS(num, shift);
+        pList->ppBlocks = (void**)pData;
+        pData += pList->numBlocks * sizeof(void*);
+    }
+
+    pList->numFree = 0;
+    pList->lenFree = numFree;
+    pList->pFree = (synthRange*)pData;
+    pData += numFree * sizeof(synthRange);
+
+    if (shift > 0) {
+        int i;
+
+        /* Point every block to its part of the (contiguous) items */
+        i = 0;
+        while (i < pList->numBlocks) {
+            pList->ppBlocks[i] = pData + ((i * size) << shift);
+            i++;
+        }
+    }
+    else {
+        pList->buf.pData = pData;
+    }
+}
+
+/**
+ * Retrieve a new (cleared) item from a list stored in blocks, alloc'ing
+ * another block as necessary
+ *
+ * @param  [out]ppItem The new item
+ * @param  [ in]pList  The list
+ * @param  [ in]size   Size of each item, in bytes
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthList_append(void **ppItem, synthList *pList, int size) {
+    int block, offset;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppItem, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pList, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pList->shift > 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(size > 0, SYNTH_BAD_PARAM_ERR);
+    /* Make sure there's enough space for another item */
+    SYNTH_ASSERT_ERR(pList->max == 0 || pList->used < pList->max,
+            SYNTH_MEM_ERR);
+
+    block = pList->used >> pList->shift;
+    offset = pList->used & ((1 << pList->shift) - 1);
+
+    /* Expand the list as necessary; Note that this will never be called if
+     * the context was pre-alloc'ed, since 'len' will be set to 'max' */
+    if (pList->used >= pList->len) {
+        char *pBlock;
+
+        if (offset == 0) {
+            /* 'Double' the table of blocks, which is only made of pointers;
+             * The '+1' is for the first block, in which numBlocks will be 0 */
+            if (block >= pList->numBlocks) {
+                void **ppBlocks;
+
+                ppBlocks = (void**)realloc(pList->ppBlocks,
+                        (1 + pList->numBlocks * 2) * sizeof(void*));
+                SYNTH_ASSERT_ERR(ppBlocks, SYNTH_MEM_ERR);
+
+                pList->ppBlocks = ppBlocks;
+                pList->numBlocks += 1 + pList->numBlocks;
+            }
+
+            pBlock = (char*)malloc(size << pList->shift);
+            SYNTH_ASSERT_ERR(pBlock, SYNTH_MEM_ERR);
+        }
+        else {
+            /* The last block was shrunk to fit, so expand it back */
+            pBlock = (char*)realloc(pList->ppBlocks[block],
+                    size << pList->shift);
+            SYNTH_ASSERT_ERR(pBlock, SYNTH_MEM_ERR);
+        }
+
+        pList->ppBlocks[block] = pBlock;
+        pList->len = (block + 1) << pList->shift;
+    }
+
+    /* Clear the item, as it may have been released by a previous song */
+    *ppItem = (char*)pList->ppBlocks[block] + offset * size;
+    memset(*ppItem, 0x0, size);
+    pList->used++;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve many new (uninitialized) consecutive items from a contiguous list,
+ * expanding it as necessary
+ *
+ * @param  [out]ppItems The first new item
+ * @param  [ in]pList   The list
+ * @param  [ in]num     How many items are required
+ * @param  [ in]size    Size of each item, in bytes
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthList_appendArray(void **ppItems, synthList *pList, int num,
+        int size) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppItems, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pList, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pList->shift == 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(num >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(size > 0, SYNTH_BAD_PARAM_ERR);
+    /* Make sure there's enough space for the items */
+    SYNTH_ASSERT_ERR(pList->max == 0 || num <= pList->max - pList->used,
+            SYNTH_MEM_ERR);
+
+    /* 'Double' the array, or expand it to fit every item if that's not
+     * enough; Again, this is never called if the context was pre-alloc'ed */
+    if (pList->used + num > pList->len) {
+        void *pData;
+        int len;
+
+        len = 1 + pList->len * 2;
+        if (len < pList->used + num) {
+            len = pList->used + num;
+        }
+
+        pData = realloc(pList->buf.pData, len * size);
+        SYNTH_ASSERT_ERR(pData, SYNTH_MEM_ERR);
+
+        pList->buf.pData = pData;
+        pList->len = len;
+    }
+
+    *ppItems = (char*)pList->buf.pData + pList->used * size;
+    pList->used += num;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve a pointer to any item of a list
+ *
+ * @param  [ in]pList The list
+ * @param  [ in]i     Index of the item
+ * @param  [ in]size  Size of each item, in bytes
+ * @return            The item
+ */
+static char* synthList_getItem(synthList *pList, int i, int size) {
+    if (pList->shift > 0) {
+        return (char*)pList->ppBlocks[i >> pList->shift] +
+                (i & ((1 << pList->shift) - 1)) * size;
+    }
+    return (char*)pList->buf.pData + i * size;
+}
+
+/**
+ * Release a range of items, so they may be reused by 'synthList_acquire'; If
+ * the range reaches the end of the list, it's simply given back to the list
+ *
+ * @param  [ in]pList The list
+ * @param  [ in]first The range's first item
+ * @param  [ in]num   How many items there are in the range
+ * @return            SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+synth_err synthList_release(synthList *pList, int first, int num) {
+    int i;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pList, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(first >= 0 && num >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(first + num <= pList->used, SYNTH_BAD_PARAM_ERR);
+
+    if (num == 0) {
+        rv = SYNTH_OK;
+        goto __err;
+    }
+
+    if (first + num == pList->used) {
+        /* Give the range back to the list, along with the last released
+         * range if it now reaches the end of the list */
+        pList->used = first;
+        i = pList->numFree - 1;
+        if (i >= 0 && pList->pFree[i].first + pList->pFree[i].num ==
+                pList->used) {
+            pList->used = pList->pFree[i].first;
+            pList->numFree--;
+        }
+
+        rv = SYNTH_OK;
+        goto __err;
+    }
+
+    /* Find where the range should be placed */
+    i = 0;
+    while (i < pList->numFree && pList->pFree[i].first < first) {
+        i++;
+    }
+
+    if (i > 0 && pList->pFree[i - 1].first + pList->pFree[i - 1].num ==
+            first) {
+        /* Simply expand the previous range */
+        i--;
+        pList->pFree[i].num += num;
+    }
+    else {
+        /* Expand the table of ranges as necessary; Static lists have their
+         * released items removed instead (see 'synthList_remove') */
+        if (pList->numFree >= pList->lenFree) {
+            synthRange *pFree;
+
+            SYNTH_ASSERT_ERR(pList->max == 0, SYNTH_MEM_ERR);
+
+            pFree = (synthRange*)realloc(pList->pFree,
+                    (1 + pList->lenFree * 2) * sizeof(synthRange));
+            SYNTH_ASSERT_ERR(pFree, SYNTH_MEM_ERR);
+
+            pList->pFree = pFree;
+            pList->lenFree += 1 + pList->lenFree;
+        }
+
+        memmove(&(pList->pFree[i + 1]), &(pList->pFree[i]),
+                (pList->numFree - i) * sizeof(synthRange));
+        pList->pFree[i].first = first;
+        pList->pFree[i].num = num;
+        pList->numFree++;
+    }
+
+    /* Merge it with the following range, if they are now contiguous */
+    if (i + 1 < pList->numFree && pList->pFree[i].first +
+            pList->pFree[i].num == pList->pFree[i + 1].first) {
+        pList->pFree[i].num += pList->pFree[i + 1].num;
+        pList->numFree--;
+        memmove(&(pList->pFree[i + 1]), &(pList->pFree[i + 2]),
+                (pList->numFree - i - 1) * sizeof(synthRange));
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Take the first released range (see 'synthList_release') that fits the
+ * requested number of items
+ *
+ * @param  [out]pFirst The first item taken, or -1 if no range fits
+ * @param  [ in]pList  The list
+ * @param  [ in]num    How many items are required
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthList_acquire(int *pFirst, synthList *pList, int num) {
+    int i;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pFirst, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pList, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(num > 0, SYNTH_BAD_PARAM_ERR);
+
+    *pFirst = -1;
+    i = 0;
+    while (i < pList->numFree && pList->pFree[i].num < num) {
+        i++;
+    }
+
+    if (i < pList->numFree) {
+        /* Take the start of the range, removing it if it's fully used */
+        *pFirst = pList->pFree[i].first;
+        pList->pFree[i].first += num;
+        pList->pFree[i].num -= num;
+        if (pList->pFree[i].num == 0) {
+            pList->numFree--;
+            memmove(&(pList->pFree[i]), &(pList->pFree[i + 1]),
+                    (pList->numFree - i) * sizeof(synthRange));
+        }
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Copy a range of items to another (non-overlapping) position in the list
+ *
+ * @param  [ in]pList The list
+ * @param  [ in]dst   First item of the destination
+ * @param  [ in]src   First item of the source
+ * @param  [ in]num   How many items should be copied
+ * @param  [ in]size  Size of each item, in bytes
+ */
+void synthList_copy(synthList *pList, int dst, int src, int num, int size) {
+    int i;
+
+    i = 0;
+    while (i < num) {
+        memcpy(synthList_getItem(pList, dst + i, size),
+                synthList_getItem(pList, src + i, size), size);
+        i++;
+    }
+}
+
+/**
+ * Remove a range of items from the list, moving every item after it back by
+ * the range's length (so the list never keeps any released range)
+ *
+ * @param  [ in]pList The list
+ * @param  [ in]first The range's first item
+ * @param  [ in]num   How many items there are in the range
+ * @param  [ in]size  Size of each item, in bytes
+ */
+void synthList_remove(synthList *pList, int first, int num, int size) {
+    int i;
+
+    /* Items are moved from the first to the last, so each one is copied
+     * before it's overwritten */
+    i = first + num;
+    while (i < pList->used) {
+        memcpy(synthList_getItem(pList, i - num, size),
+                synthList_getItem(pList, i, size), size);
+        i++;
+    }
+    pList->used -= num;
+}
+
+/**
+ * Release whatever memory isn't used by a dynamically alloc'ed list
+ *
+ * Only the last block (or the array, in a contiguous list) may be moved, so
+ * pointers to items close to the end of the list must be retrieved again
+ *
+ * @param  [ in]pList The list
+ * @param  [ in]size  Size of each item, in bytes
+ */
+void synthList_shrink(synthList *pList, int size) {
+    if (pList->max != 0 || pList->len <= pList->used) {
+        /* Either a static list or there's nothing to release */
+        return;
+    }
+
+    if (pList->shift > 0) {
+        int last, num;
+
+        /* Release every block after the last one in use */
+        num = SYNTHLIST_NUM_BLOCKS(pList->len, pList->shift);
+        last = SYNTHLIST_NUM_BLOCKS(pList->used, pList->shift);
+        while (num > last) {
+            num--;
+            free(pList->ppBlocks[num]);
+            pList->ppBlocks[num] = 0;
+        }
+        pList->len = last << pList->shift;
+
+        /* Shrink the last block to fit its items; If it fails, the block is
+         * simply kept as is */
+        if (last > 0 && pList->len > pList->used) {
+            void *pBlock;
+
+            pBlock = realloc(pList->ppBlocks[last - 1],
+                    (pList->used - ((last - 1) << pList->shift)) * size);
+            if (pBlock) {
+                pList->ppBlocks[last - 1] = pBlock;
+                pList->len = pList->used;
+            }
+        }
+    }
+    else if (pList->used == 0) {
+        free(pList->buf.pData);
+        pList->buf.pData = 0;
+        pList->len = 0;
+    }
+    else {
+        void *pData;
+
+        pData = realloc(pList->buf.pData, pList->used * size);
+        if (pData) {
+            pList->buf.pData = pData;
+            pList->len = pList->used;
+        }
+    }
+}
+
+/**
+ * Retrieve how many bytes are alloc'ed by a list
+ *
+ * @param  [ in]pList The list
+ * @param  [ in]size  Size of each item, in bytes
+ * @return            The list's size, in bytes
+ */
+int synthList_getSize(synthList *pList, int size) {
+    return pList->len * size + pList->numBlocks * (int)sizeof(void*) +
+            pList->lenFree * (int)sizeof(synthRange);
+}
+
+/**
+ * Release every item of a dynamically alloc'ed list
+ *
+ * @param  [ in]pList The list
+ */
+void synthList_clear(synthList *pList) {
+    if (pList->shift > 0) {
+        int num;
+
+        num = SYNTHLIST_NUM_BLOCKS(pList->len, pList->shift);
+        while (num > 0) {
+            num--;
+            free(pList->ppBlocks[num]);
+        }
+        if (pList->ppBlocks) {
+            free(pList->ppBlocks);
+        }
+        pList->ppBlocks = 0;
+        pList->numBlocks = 0;
+    }
+    else if (pList->buf.pData) {
+        free(pList->buf.pData);
+        pList->buf.pData = 0;
+    }
+
+    if (pList->pFree) {
+        free(pList->pFree);
+    }
+    pList->pFree = 0;
+    pList->numFree = 0;
+    pList->lenFree = 0;
+
+    pList->len = 0;
+    pList->used = 0;
+}
+
@@ -0,0 +1,353 @@
+/**
+ * @file src/synth_mixer.c
+ *
+ * Mix rendered tracks into a single buffer
+ *
+ * Samples are added as native 8 or 16 bits lanes (as many as possible at a
+ * time, if any SIMD instruction set is available) and saturated to the mode's
+ * range
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_mixer.h>
+#include <c_synth_internal/synth_simd.h>
+#include <c_synth_internal/synth_types.h>
+
+#if defined(SYNTH_SIMD_SSE2)
+typedef __m128i synthMixerVec;
+
+#  define SYNTHMIXER_LOAD(p)     _mm_loadu_si128((__m128i*)(p))
+#  define SYNTHMIXER_STORE(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#  define SYNTHMIXER_ZERO()      _mm_setzero_si128()
+#  define SYNTHMIXER_OR(a, b)    _mm_or_si128(a, b)
+#  define SYNTHMIXER_XOR(a, b)   _mm_xor_si128(a, b)
+#  define SYNTHMIXER_ADD8(a, b)  _mm_add_epi8(a, b)
+#  define SYNTHMIXER_ADD16(a, b) _mm_add_epi16(a, b)
+#  define SYNTHMIXER_ADDS_U8(a, b)  _mm_adds_epu8(a, b)
+#  define SYNTHMIXER_ADDS_S8(a, b)  _mm_adds_epi8(a, b)
+#  define SYNTHMIXER_ADDS_U16(a, b) _mm_adds_epu16(a, b)
+#  define SYNTHMIXER_ADDS_S16(a, b) _mm_adds_epi16(a, b)
+/* Check whether any bit is set */
+#  define SYNTHMIXER_ANY(v) \
+    (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xffff)
+#elif defined(SYNTH_SIMD_NEON)
+typedef uint8x16_t synthMixerVec;
+
+#  define SYNTHMIXER_LOAD(p)     vld1q_u8((uint8_t*)(p))
+#  define SYNTHMIXER_STORE(p, v) vst1q_u8((uint8_t*)(p), v)
+#  define SYNTHMIXER_ZERO()      vdupq_n_u8(0)
+#  define SYNTHMIXER_OR(a, b)    vorrq_u8(a, b)
+#  define SYNTHMIXER_XOR(a, b)   veorq_u8(a, b)
+#  define SYNTHMIXER_ADD8(a, b)  vaddq_u8(a, b)
+#  define SYNTHMIXER_ADD16(a, b) \
+    vreinterpretq_u8_u16(vaddq_u16(vreinterpretq_u16_u8(a), \
+            vreinterpretq_u16_u8(b)))
+#  define SYNTHMIXER_ADDS_U8(a, b) vqaddq_u8(a, b)
+#  define SYNTHMIXER_ADDS_S8(a, b) \
+    vreinterpretq_u8_s8(vqaddq_s8(vreinterpretq_s8_u8(a), \
+            vreinterpretq_s8_u8(b)))
+#  define SYNTHMIXER_ADDS_U16(a, b) \
+    vreinterpretq_u8_u16(vqaddq_u16(vreinterpretq_u16_u8(a), \
+            vreinterpretq_u16_u8(b)))
+#  define SYNTHMIXER_ADDS_S16(a, b) \
+    vreinterpretq_u8_s16(vqaddq_s16(vreinterpretq_s16_u8(a), \
+            vreinterpretq_s16_u8(b)))
+/* Check whether any bit is set */
+#  define SYNTHMIXER_ANY(v) (vmaxvq_u8(v) != 0)
+#endif
+
+#if defined(SYNTH_SIMD)
+/**
+ * Accumulate 16 bytes at a time, until less than that is left; Lanes that
+ * saturated differ from the wrapped sum, so those differences are kept and
+ * only checked once, after everything was accumulated
+ * 
+ * @param  [ in]adds Saturating addition for the lanes
+ * @param  [ in]add  Wrapping addition for the lanes
+ */
+#  define SYNTHMIXER_ACCUMULATE(adds, add) \
+    { \
+        synthMixerVec vOverflow; \
+        \
+        vOverflow = SYNTHMIXER_ZERO(); \
+        while (i + 16 <= numBytes) { \
+            synthMixerVec vDst, vSrc, vSum; \
+            \
+            vDst = SYNTHMIXER_LOAD(pBuf + i); \
+            vSrc = SYNTHMIXER_LOAD(pTmp + i); \
+            vSum = adds(vDst, vSrc); \
+            vOverflow = SYNTHMIXER_OR(vOverflow, \
+                    SYNTHMIXER_XOR(vSum, add(vDst, vSrc))); \
+            SYNTHMIXER_STORE(pBuf + i, vSum); \
+            \
+            i += 16; \
+        } \
+        if (SYNTHMIXER_ANY(vOverflow)) { \
+            didOverflow = SYNTH_TRUE; \
+        } \
+    }
+#endif
+
+/**
+ * Accumulate a temporary buffer into another buffer
+ * 
+ * Samples that overflow are saturated to the range of the mode
+ * 
+ * @param  [ in]pBuf Buffer that will be joined by the other track
+ * @param  [ in]pTmp Temporary buffer with the last track
+ * @param  [ in]mode Desired mode for the song
+ * @param  [ in]len  The number of samples to be accumulated
+ * @return           Whether any sample overflowed
+ */
+synth_bool synthMixer_accumulate(char *pBuf, char *pTmp, synthBufMode mode,
+        int len) {
+    int i, max, min, numBytes;
+    synth_bool didOverflow;
+
+    /* Calculate the number of bytes to be accumulated */
+    numBytes = len;
+    if (mode & SYNTH_16BITS) {
+        numBytes *= 2;
+    }
+    if (mode & SYNTH_2CHAN) {
+        numBytes *= 2;
+    }
+
+    didOverflow = SYNTH_FALSE;
+    i = 0;
+
+#if defined(SYNTH_SIMD)
+    /* Both channels are interleaved and mixed independently, so only the
+     * width and the signedness matter */
+    if ((mode & SYNTH_16BITS) && (mode & SYNTH_SIGNED)) {
+        SYNTHMIXER_ACCUMULATE(SYNTHMIXER_ADDS_S16, SYNTHMIXER_ADD16)
+    }
+    else if (mode & SYNTH_16BITS) {
+        SYNTHMIXER_ACCUMULATE(SYNTHMIXER_ADDS_U16, SYNTHMIXER_ADD16)
+    }
+    else if (mode & SYNTH_SIGNED) {
+        SYNTHMIXER_ACCUMULATE(SYNTHMIXER_ADDS_S8, SYNTHMIXER_ADD8)
+    }
+    else {
+        SYNTHMIXER_ACCUMULATE(SYNTHMIXER_ADDS_U8, SYNTHMIXER_ADD8)
+    }
+#endif
+
+    /* Retrieve the range of a sample */
+    if (mode & SYNTH_16BITS) {
+        max = 0xffff;
+        min = 0;
+        if (mode & SYNTH_SIGNED) {
+            max = 0x7fff;
+            min = -0x8000;
+        }
+    }
+    else {
+        max = 0xff;
+        min = 0;
+        if (mode & SYNTH_SIGNED) {
+            max = 0x7f;
+            min = -0x80;
+        }
+    }
+
+    /* Accumulate whatever is left, one sample at a time */
+    while (i < numBytes) {
+        int dst, src;
+
+        if (mode & SYNTH_16BITS) {
+            src = (pTmp[i] & 0xff) | ((pTmp[i + 1] & 0xff) << 8);
+            dst = (pBuf[i] & 0xff) | ((pBuf[i + 1] & 0xff) << 8);
+
+            if ((mode & SYNTH_SIGNED) && (src & 0x8000)) {
+                src -= 0x10000;
+            }
+            if ((mode & SYNTH_SIGNED) && (dst & 0x8000)) {
+                dst -= 0x10000;
+            }
+        }
+        else {
+            src = pTmp[i] & 0xff;
+            dst = pBuf[i] & 0xff;
+
+            if ((mode & SYNTH_SIGNED) && (src & 0x80)) {
+                src -= 0x100;
+            }
+            if ((mode & SYNTH_SIGNED) && (dst & 0x80)) {
+                dst -= 0x100;
+            }
+        }
+
+        dst += src;
+        if (dst > max) {
+            dst = max;
+            didOverflow = SYNTH_TRUE;
+        }
+        else if (dst < min) {
+            dst = min;
+            didOverflow = SYNTH_TRUE;
+        }
+
+        if (mode & SYNTH_16BITS) {
+            pBuf[i] = dst & 0xff;
+            pBuf[i + 1] = (dst >> 8) & 0xff;
+            i += 2;
+        }
+        else {
+            pBuf[i] = dst & 0xff;
+            i++;
+        }
+    }
+
+    return didOverflow;
+}
+
+/**
+ * Accumulate a temporary buffer into a 32 bits bus, which never overflows
+ * 
+ * @param  [ in]pBus Bus that will be joined by the other track (with one value
+ *                   per sample per channel)
+ * @param  [ in]pTmp Temporary buffer with the last track
+ * @param  [ in]mode Mode of the temporary buffer
+ * @param  [ in]len  The number of samples to be accumulated
+ * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthMixer_accumulateBus(int *pBus, char *pTmp, synthBufMode mode,
+        int len) {
+    int i;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBus, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pTmp, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(len >= 0, SYNTH_BAD_PARAM_ERR);
+
+    /* Both channels are interleaved and accumulated independently */
+    if (mode & SYNTH_2CHAN) {
+        len *= 2;
+    }
+
+    /* Select the conversion outside of the loop, so it may be vectorized */
+    i = 0;
+    if ((mode & SYNTH_16BITS) && (mode & SYNTH_SIGNED)) {
+        while (i < len) {
+            pBus[i] += (short)((pTmp[i * 2] & 0xff) |
+                    ((pTmp[i * 2 + 1] & 0xff) << 8));
+            i++;
+        }
+    }
+    else if (mode & SYNTH_16BITS) {
+        while (i < len) {
+            pBus[i] += (pTmp[i * 2] & 0xff) | ((pTmp[i * 2 + 1] & 0xff) << 8);
+            i++;
+        }
+    }
+    else if (mode & SYNTH_SIGNED) {
+        while (i < len) {
+            pBus[i] += (signed char)pTmp[i];
+            i++;
+        }
+    }
+    else {
+        while (i < len) {
+            pBus[i] += (unsigned char)pTmp[i];
+            i++;
+        }
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Convert a bus into the desired mode
+ * 
+ * If any sample doesn't fit the mode's range, every sample is halved as many
+ * times as necessary for all of them to fit
+ * 
+ * @param  [ in]pBuf Buffer that will be filled with the mixed song
+ * @param  [ in]pBus Bus with every track
+ * @param  [ in]mode Desired mode for the song
+ * @param  [ in]len  The number of samples in the bus
+ * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthMixer_convertBus(char *pBuf, int *pBus, synthBufMode mode,
+        int len) {
+    int i, hi, lo, max, min, shift;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pBus, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(len >= 0, SYNTH_BAD_PARAM_ERR);
+
+    if (mode & SYNTH_2CHAN) {
+        len *= 2;
+    }
+
+    /* Retrieve the range of a sample */
+    if (mode & SYNTH_16BITS) {
+        max = 0xffff;
+        min = 0;
+        if (mode & SYNTH_SIGNED) {
+            max = 0x7fff;
+            min = -0x8000;
+        }
+    }
+    else {
+        max = 0xff;
+        min = 0;
+        if (mode & SYNTH_SIGNED) {
+            max = 0x7f;
+            min = -0x80;
+        }
+    }
+
+    /* Find the song's peaks */
+    hi = 0;
+    lo = 0;
+    i = 0;
+    while (i < len) {
+        if (pBus[i] > hi) {
+            hi = pBus[i];
+        }
+        if (pBus[i] < lo) {
+            lo = pBus[i];
+        }
+        i++;
+    }
+
+    /* Find the least the song must be halved to fit the mode */
+    shift = 0;
+    while ((hi >> shift) > max || (lo >> shift) < min) {
+        shift++;
+    }
+
+    /* Convert every sample */
+    i = 0;
+    if (mode & SYNTH_16BITS) {
+        while (i < len) {
+            int amp;
+
+            amp = pBus[i] >> shift;
+
+            pBuf[i * 2] = amp & 0xff;
+            pBuf[i * 2 + 1] = (amp >> 8) & 0xff;
+            i++;
+        }
+    }
+    else {
+        while (i < len) {
+            pBuf[i] = (pBus[i] >> shift) & 0xff;
+            i++;
+        }
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
@@ -5,8 +5,10 @@
 #include <c_synth/synth_assert.h>
 #include <c_synth/synth_errors.h>
 
+#include <c_synth_internal/synth_list.h>
 #include <c_synth_internal/synth_note.h>
 #include <c_synth_internal/synth_prng.h>
+#include <c_synth_internal/synth_simd.h>
 #include <c_synth_internal/synth_types.h>
 #include <c_synth_internal/synth_volume.h>
 
@@ -34,6 +36,52 @@ static int __synthNote_frequency[] = {
 /*  C   9 */ 8372
 };
 
+/**
+ * Build the context's table of phase increments, so any note may be synthesized
+ * without calculating its frequency
+ * 
+ * @param  [ in]pCtx The synthesizer context (with its frequency already set)
+ * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthNote_initPhaseTable(synthCtx *pCtx) {
+    int note, octave;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx->frequency > 0, SYNTH_BAD_PARAM_ERR);
+
+    octave = 1;
+    while (octave <= 8) {
+        note = N_CB;
+        while (note < N_REST) {
+            double increment;
+
+            /* Calculate the note frequency (e.g., A4 = 440Hz) and how much of a
+             * cycle it advances each sample */
+            increment = __synthNote_frequency[note] /
+                    (double)(1 << (9 - octave));
+            increment = increment / pCtx->frequency * 4294967296.0;
+
+            /* Notes above the synthesizer's frequency simply alias */
+            if (increment > 4294967295.0) {
+                increment = 4294967295.0;
+            }
+
+            pCtx->phaseIncrement[octave - 1][note] =
+                    (unsigned int)(increment + 0.5);
+
+            note++;
+        }
+
+        octave++;
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
 /**
  * Retrieve a new note pointer, so it can be later initialized
  * 
@@ -47,26 +95,10 @@ synth_err synthNote_init(synthNote **ppNote, synthCtx *pCtx) {
     /* Sanitize the arguments */
     SYNTH_ASSERT_ERR(ppNote, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
-    /* Make sure there's enough space for another note */
-    SYNTH_ASSERT_ERR(pCtx->notes.max == 0 || pCtx->notes.used < pCtx->notes.max,
-            SYNTH_MEM_ERR);
-
-    /* Retrieve the note to be used */
-    if (pCtx->notes.used >= pCtx->notes.len) {
-        /* 'Double' the current buffer; Note that this will never be called if
-         * the context was pre-alloc'ed, since 'max' will be set; The '+1' is
-         * for the first note, in which len will be 0 */
-        pCtx->notes.buf.pNotes = (synthNote*)realloc(pCtx->notes.buf.pNotes,
-                (1 + pCtx->notes.len * 2) * sizeof(synthNote));
-        SYNTH_ASSERT_ERR(pCtx->notes.buf.pNotes, SYNTH_MEM_ERR);
-        /* Clear only the new part of the buffer */
-        memset(&(pCtx->notes.buf.pNotes[pCtx->notes.used]), 0x0,
-                (1 + pCtx->notes.len) * sizeof(synthNote));
-        /* Actually increase the buffer length */
-        pCtx->notes.len += 1 + pCtx->notes.len;
-    }
-    (*ppNote) = &(pCtx->notes.buf.pNotes[pCtx->notes.used]);
-    pCtx->notes.used++;
+
+    /* Retrieve the note to be used (expanding the list as necessary) */
+    rv = synthList_append((void**)ppNote, &(pCtx->notes), sizeof(synthNote));
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     /* Initialize the note's default parameters */
     synthNote_setPan(*ppNote, 50);
@@ -77,9 +109,6 @@ synth_err synthNote_init(synthNote **ppNote, synthCtx *pCtx) {
     synthNote_setKeyoff(*ppNote, 0, 75, 0);
     synthNote_setVolume(*ppNote, 0);
 
-    (*ppNote)->numIterations = 0;
-    (*ppNote)->jumpPosition = 0;
-
     rv = SYNTH_OK;
 __err:
     return rv;
@@ -88,19 +117,21 @@ __err:
 /**
  * Retrieve a new note pointer, already initialized as a loop
  * 
- * @param  [out]ppNote   The new note
- * @param  [ in]pCtx     The synthesizer context
- * @param  [ in]repeat   How many times the loop should repeat
- * @param  [ in]position Note to which the song should jump back, on loop
- * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ * The loop itself (i.e., its jump position and repeat count) must have already
+ * been added to the track's loop table, with 'synthTrack_addLoop'
+ * 
+ * @param  [out]ppNote The new note
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]loop   Index of the loop within its track's loop table
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
  */
-synth_err synthNote_initLoop(synthNote **ppNote, synthCtx *pCtx, int repeat,
-        int position) {
+synth_err synthNote_initLoop(synthNote **ppNote, synthCtx *pCtx, int loop) {
     synth_err rv;
 
     /* Sanitize the arguments */
     SYNTH_ASSERT_ERR(ppNote, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(loop >= 0, SYNTH_BAD_PARAM_ERR);
 
     /* Retrieve a new note 'object' */
     rv = synthNote_init(ppNote, pCtx);
@@ -108,8 +139,7 @@ synth_err synthNote_initLoop(synthNote **ppNote, synthCtx *pCtx, int repeat,
 
     /* Set the note's parameters */
     (*ppNote)->note = N_LOOP;
-    (*ppNote)->len = repeat;
-    (*ppNote)->jumpPosition = position;
+    (*ppNote)->samplesDuration = loop;
 
     rv = SYNTH_OK;
 __err:
@@ -220,7 +250,7 @@ synth_err synthNote_setDuration(synthNote *pNote, synthCtx *pCtx,
     bit = 6;
     while (duration != 0) {
         if (duration & 1) {
-            pNote->duration |= 1 << bit;
+            pNote->duration |= (unsigned short)(1 << bit);
         }
 
         duration >>= 1;
@@ -232,15 +262,37 @@ __err:
     return rv;
 }
 
+/**
+ * Set the note's length in samples, as calculated when its track was compiled
+ * 
+ * @param  [ in]pNote   The note
+ * @param  [ in]samples The length, in samples
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthNote_setSamplesDuration(synthNote *pNote, int samples) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pNote, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pNote->note != N_LOOP, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(samples >= 0, SYNTH_BAD_PARAM_ERR);
+
+    pNote->samplesDuration = samples;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
 /**
  * Set the characteristics of the note's duration
  * 
  * NOTE: This parameter must be set after the duration
  * 
  * All values must be in the range [0, 100]. The attack is campled to the range
- * [0, keyoff] and the release is campled to the range [keyoff, 100]. Although
- * the parameter express the percentage of the note's duration, the value is
- * stored in samples.
+ * [0, keyoff] and the release is campled to the range [keyoff, 100]. The
+ * values are kept as percentages of the note's duration (a byte each) and only
+ * converted to samples as the note is rendered.
  * 
  * @param  [ in]pNote  The note
  * @param  [ in]attack  The percentage of the note duration before it reaches
@@ -295,9 +347,12 @@ synth_err synthNote_setVolume(synthNote *pNote, int volume) {
 
     /* Sanitize the arguments */
     SYNTH_ASSERT_ERR(pNote, SYNTH_BAD_PARAM_ERR);
+    /* There are at most 129 * 129 distinct volumes, so the index always fits
+     * on the note's 16 bits */
+    SYNTH_ASSERT_ERR(volume >= 0 && volume <= 0xffff, SYNTH_BAD_PARAM_ERR);
 
     /* Store the volume */
-    pNote->volume = volume;
+    pNote->volume = (unsigned short)volume;
 
     rv = SYNTH_OK;
 __err:
@@ -355,6 +410,15 @@ __err: \
  */
 SYNTHNOTE_GETTER(synthNote_getDuration, int, duration, 0)
 
+/**
+ * Retrieve the note's length in samples (cached when its track was compiled)
+ * 
+ * @param  [out]pVal  The length
+ * @param  [ in]pNote The note
+ * @return            SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+SYNTHNOTE_GETTER(synthNote_getSamplesDuration, int, samplesDuration, 0)
+
 /**
  * Retrieve the panning of the note, where 0 means completely on the left
  * channel and 100 means completely on the right channel
@@ -366,312 +430,916 @@ SYNTHNOTE_GETTER(synthNote_getDuration, int, duration, 0)
 SYNTHNOTE_GETTER(synthNote_getPan, char, pan, 0)
 
 /**
- * Retrieve the number of times this loop should repeat
+ * Retrieve the index of the loop within its track's loop table
  * 
- * @param  [out]pVal  The repeat count
+ * @param  [out]pVal  The loop's index
  * @param  [ in]pNote The note
  * @return            SYNTH_OK, SYNTH_BAD_PARAM_ERR
  */
-SYNTHNOTE_GETTER(synthNote_getRepeat, int, len, 1)
+SYNTHNOTE_GETTER(synthNote_getLoop, int, samplesDuration, 1)
 
 /**
- * Retrieve the position, in the track, to which it should jump on loop
+ * Calculate the amplitude of a rectangular wave, given the cycle's percentage
+ * (perc) and its duty cycle
  * 
- * @param  [out]pVal  The repeat position
- * @param  [ in]pNote The note
- * @return            SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ * @param  [ in]duty Percentage of the cycle that is set high
+ * @param  [ in]MODE Desired mode for the wave (a constant)
  */
-SYNTHNOTE_GETTER(synthNote_getJumpPosition, int, jumpPosition, 1)
+#define SYNTHNOTE_WAVE_RECT(duty, MODE) \
+    if (perc < duty) { \
+        waveAmp = 1.0f; \
+    } \
+    else if ((MODE) & SYNTH_SIGNED) { \
+        waveAmp = -1.0f; \
+    } \
+    else { \
+        waveAmp = 0.0f; \
+    }
 
 /**
- * Render a note into a buffer
+ * Calculate the amplitude of a triangular wave with its positive peak at 0.25%
+ * samples and its negative peak at 0.75% samples (or, if unsigned, with its
+ * only peak at 0.5%); Triangle waves are made a little louder
  * 
- * The buffer must have at least 'synthNote_getDuration' bytes time the number
- * of bytes required by the mode
+ * @param  [ in]MODE Desired mode for the wave (a constant)
+ */
+#define SYNTHNOTE_WAVE_TRIANGLE(MODE) \
+    if ((MODE) & SYNTH_SIGNED) { \
+        if (perc < 0.25f) { \
+            waveAmp = 4.0f * perc; \
+        } \
+        else if (perc < 0.5f) { \
+            waveAmp = 4.0f * (0.5f - perc); \
+        } \
+        else if (perc < 0.75f) { \
+            waveAmp = -4.0f * (perc - 0.5f); \
+        } \
+        else { \
+            waveAmp = -4.0f * (1.0f - perc); \
+        } \
+    } \
+    else { \
+        if (perc < 0.5f) { \
+            waveAmp = 2.0f * perc; \
+        } \
+        else { \
+            waveAmp = 2.0f * (1.0f - perc); \
+        } \
+    } \
+    waveAmp *= 1.125;
+
+/** How many pseudo-random values are generated at once by noise kernels */
+#define SYNTHNOTE_NOISE_BATCH 64
+
+/**
+ * Retrieve the next pseudo-random value into 'noise'; Values are generated in
+ * batches (but never more than the samples left, 'last - i'), from the stream
+ * of the note (i.e., its track and its position within that track) at the
+ * sample's position
+ */
+#define SYNTHNOTE_GET_NOISE() \
+    if (noiseIndex >= noiseCount) { \
+        noiseCount = last - i; \
+        if (noiseCount > SYNTHNOTE_NOISE_BATCH) { \
+            noiseCount = SYNTHNOTE_NOISE_BATCH; \
+        } \
+        rv = synthPRNG_getNoise(pNoise, noiseCount, pPRNG, \
+                (unsigned int)track, (unsigned int)index, i); \
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv); \
+        noiseIndex = 0; \
+    } \
+    noise = pNoise[noiseIndex]; \
+    noiseIndex++;
+
+/**
+ * Replace a rectangular wave by a noise, clamped to a different range on each
+ * of the wave's levels
  * 
- * @param  [ in]pBuf      Buffer that will be filled with the track
- * @param  [ in]pNote     The note
- * @param  [ in]pCtx      The synthesizer context
- * @param  [ in]mode      Desired mode for the wave
- * @param  [ in]synthFreq Synthesizer's frequency
- * @param  [ in]duration  The note's length in samples
- * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ * @param  [ in]high Scale of the noise when the wave is high
+ * @param  [ in]low  Scale of the noise when the wave is low
  */
-synth_err synthNote_render(char *pBuf, synthNote *pNote, synthCtx *pCtx,
-        synthBufMode mode, int synthFreq, int duration) {
-    float attack, keyoff, release;
-    int i, noteFreq, numBytes, spc;
-    synthVolume *pVolume;
-    synth_err rv;
+#define SYNTHNOTE_NOISE_RECT(high, low) \
+    SYNTHNOTE_GET_NOISE() \
+    if (waveAmp > 0.0f) { \
+        waveAmp = (float)(noise * high); \
+    } \
+    else { \
+        waveAmp = (float)(noise * low); \
+    }
 
-    /* Sanitize the arguments */
-    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
-    SYNTH_ASSERT_ERR(pNote, SYNTH_BAD_PARAM_ERR);
+/* Calculate the amplitude of each wave; These use the cycle's percentage
+ * (perc) and set the amplitude (waveAmp) in the range [-1.0f, 1.0f], so it can
+ * correctly be downsampled for 8 and 16 bits amplitudes (as well as signed and
+ * unsigned) */
+#define SYNTHNOTE_WAVE_square(MODE) SYNTHNOTE_WAVE_RECT(0.5f, MODE)
+#define SYNTHNOTE_WAVE_pulse12_5(MODE) SYNTHNOTE_WAVE_RECT(0.125f, MODE)
+#define SYNTHNOTE_WAVE_pulse25(MODE) SYNTHNOTE_WAVE_RECT(0.25f, MODE)
+#define SYNTHNOTE_WAVE_pulse75(MODE) SYNTHNOTE_WAVE_RECT(0.75f, MODE)
+#define SYNTHNOTE_WAVE_triangle(MODE) SYNTHNOTE_WAVE_TRIANGLE(MODE)
+#define SYNTHNOTE_WAVE_noise(MODE) \
+    (void)perc; \
+    SYNTHNOTE_GET_NOISE() \
+    waveAmp = (float)(noise * 2.0);
+#define SYNTHNOTE_WAVE_noiseSquare(MODE) \
+    SYNTHNOTE_WAVE_RECT(0.5f, MODE) \
+    SYNTHNOTE_NOISE_RECT(4.0, 0.25)
+#define SYNTHNOTE_WAVE_noise12_5(MODE) \
+    SYNTHNOTE_WAVE_RECT(0.125f, MODE) \
+    SYNTHNOTE_NOISE_RECT(4.0, 0.25)
+#define SYNTHNOTE_WAVE_noise25(MODE) \
+    SYNTHNOTE_WAVE_RECT(0.25f, MODE) \
+    SYNTHNOTE_NOISE_RECT(6.0, 1.5)
+#define SYNTHNOTE_WAVE_noise75(MODE) \
+    SYNTHNOTE_WAVE_RECT(0.75f, MODE) \
+    SYNTHNOTE_NOISE_RECT(4.0, 0.25)
+#define SYNTHNOTE_WAVE_noiseTriangle(MODE) \
+    SYNTHNOTE_WAVE_TRIANGLE(MODE) \
+    SYNTHNOTE_GET_NOISE() \
+    waveAmp = (float)(waveAmp * 0.75 + noise * waveAmp * 4.0 * 0.25);
+
+/* Convert the amplitude to each mode's format and store it at the buffer; 'amp'
+ * is the note's volume (in 16 bits) and 'j' is the sample's actual index */
+#define SYNTHNOTE_STORE_8BITS \
+    pBuf[j] = (amp >> 8) * waveAmp;
+#define SYNTHNOTE_STORE_16BITS \
+    { \
+        int amp16; \
+        \
+        amp16 = amp * waveAmp; \
+        \
+        pBuf[j] = amp16 & 0xff; \
+        pBuf[j + 1] = (amp16 >> 8) & 0xff; \
+    }
+#define SYNTHNOTE_STORE_2CHAN_8BITS \
+    { \
+        char lAmp8, rAmp8; \
+        \
+        lAmp8 = (amp >> 8) * waveAmp * lPan; \
+        rAmp8 = (amp >> 8) * waveAmp * rPan; \
+        \
+        pBuf[j] = lAmp8 & 0xff; \
+        pBuf[j + 1] = rAmp8 & 0xff; \
+    }
+#define SYNTHNOTE_STORE_2CHAN_16BITS \
+    { \
+        int lAmp16, rAmp16; \
+        \
+        lAmp16 = amp * waveAmp * lPan; \
+        rAmp16 = amp * waveAmp * rPan; \
+        \
+        pBuf[j] = lAmp16 & 0xff; \
+        pBuf[j + 1] = (lAmp16 >> 8) & 0xff; \
+        pBuf[j + 2] = rAmp16 & 0xff; \
+        pBuf[j + 3] = (rAmp16 >> 8) & 0xff; \
+    }
+
+/* Number of bytes per sample on each mode */
+#define SYNTHNOTE_BYTES_8BITS 1
+#define SYNTHNOTE_BYTES_16BITS 2
+#define SYNTHNOTE_BYTES_2CHAN_8BITS 2
+#define SYNTHNOTE_BYTES_2CHAN_16BITS 4
+
+/**
+ * List every wave, in the same order as they are declared on 'synth_wave'
+ * 
+ * @param  [ in]X Macro called as X(name)
+ */
+#define SYNTHNOTE_WAVES(X) \
+    X(square) \
+    X(pulse12_5) \
+    X(pulse25) \
+    X(pulse75) \
+    X(triangle) \
+    X(noise) \
+    X(noiseSquare) \
+    X(noise12_5) \
+    X(noise25) \
+    X(noise75) \
+    X(noiseTriangle)
+
+/**
+ * List every mode, in the order returned by 'synthNote_getModeIndex'
+ * 
+ * @param  [ in]X    Macro called as X(prefix, name, format, mode)
+ * @param  [ in]pref Prefix forwarded to X (e.g., the wave's name)
+ */
+#define SYNTHNOTE_MODES(X, pref) \
+    X(pref, u8_1chan, 8BITS, SYNTH_1CHAN_U8BITS) \
+    X(pref, u16_1chan, 16BITS, SYNTH_1CHAN_U16BITS) \
+    X(pref, u8_2chan, 2CHAN_8BITS, SYNTH_2CHAN_U8BITS) \
+    X(pref, u16_2chan, 2CHAN_16BITS, SYNTH_2CHAN_U16BITS) \
+    X(pref, s8_1chan, 8BITS, SYNTH_1CHAN_8BITS) \
+    X(pref, s16_1chan, 16BITS, SYNTH_1CHAN_16BITS) \
+    X(pref, s8_2chan, 2CHAN_8BITS, SYNTH_2CHAN_8BITS) \
+    X(pref, s16_2chan, 2CHAN_16BITS, SYNTH_2CHAN_16BITS)
 
-    /* Retrieve the note's volume */
-    pVolume = &(pCtx->volumes.buf.pVolumes[pNote->volume]);
+/**
+ * Retrieve the index of a mode within 'SYNTHNOTE_MODES'
+ * 
+ * @param  [ in]mode The mode
+ * @return           The mode's index
+ */
+static int synthNote_getModeIndex(synthBufMode mode) {
+    int index;
 
-    /* Calculate the number of bytes per samples */
-    numBytes = 1;
+    index = 0;
     if (mode & SYNTH_16BITS) {
-        numBytes = 2;
+        index |= 1;
     }
     if (mode & SYNTH_2CHAN) {
-        numBytes *= 2;
+        index |= 2;
+    }
+    if (mode & SYNTH_SIGNED) {
+        index |= 4;
     }
 
-    /* Clear the note */
-    memset(pBuf, 0x0, duration * numBytes);
-    /* If it's a rest, simply return (since it was already cleared */
-    if (pNote->note == N_REST) {
-        rv = SYNTH_OK;
-        goto __err;
+    return index;
+}
+
+/**
+ * Define a kernel that synthesizes a single wave into a single mode; Both are
+ * known at compile time, so the inner loop doesn't have to check for either
+ * 
+ * @param  [ in]wave   The wave's name
+ * @param  [ in]name   The mode's name
+ * @param  [ in]format The mode's format
+ * @param  [ in]MODE   The mode
+ */
+#define SYNTHNOTE_DEFINE_KERNEL(wave, name, format, MODE) \
+static synth_err synthNote_kernel_##wave##_##name(char *pBuf, \
+        synthNote *pNote, synthCtx *pCtx, synthPRNGCtx *pPRNG, int track, \
+        int index, int duration, int offset, int count) { \
+    double pNoise[SYNTHNOTE_NOISE_BATCH]; \
+    float attack, keyoff, lPan, release, rPan; \
+    int i, j, last, noiseCount, noiseIndex, volFin, volIni; \
+    unsigned int increment, phase; \
+    synthVolume *pVolume; \
+    synth_err rv; \
+    \
+    /* Sanitize the arguments */ \
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR); \
+    SYNTH_ASSERT_ERR(pNote, SYNTH_BAD_PARAM_ERR); \
+    \
+    /* Clear the note, so the silence after the key is released is ready */ \
+    memset(pBuf, 0x0, count * SYNTHNOTE_BYTES_##format); \
+    \
+    /* Retrieve the note's volume */ \
+    pVolume = SYNTH_VOLUME(pCtx, pNote->volume); \
+    volIni = pVolume->ini; \
+    volFin = pVolume->fin; \
+    \
+    /* Retrieve how much the phase advances per sample and place it at the \
+     * first rendered sample (overflowing simply wraps to a new cycle) */ \
+    increment = pCtx->phaseIncrement[pNote->octave - 1][pNote->note]; \
+    phase = increment * (unsigned int)offset; \
+    \
+    /* Calculate the note envelope in samples */ \
+    attack = duration * pNote->attack / 100.0f; \
+    keyoff = duration * pNote->keyoff / 100.0f; \
+    release = duration * pNote->release / 100.0f; \
+    \
+    /* Calculate the panning on both channels, 0 means left only and 100 \
+     * means right only */ \
+    lPan = (100 - pNote->pan) / 100.0f; \
+    rPan = pNote->pan / 100.0f; \
+    /* Mono modes and non-noise waves don't use every variable */ \
+    (void)lPan; \
+    (void)rPan; \
+    \
+    /* Find the last synthesized sample (i.e., the smallest of the range's end \
+     * and the first sample after the release), so noise kernels don't \
+     * generate more values than required */ \
+    last = offset + count; \
+    if (last > release) { \
+        last = (int)release; \
+        if (last < release) { \
+            last++; \
+        } \
+    } \
+    noiseCount = 0; \
+    noiseIndex = 0; \
+    /* Only noise kernels use the batch (and the note's stream) */ \
+    (void)last; \
+    (void)noiseCount; \
+    (void)noiseIndex; \
+    (void)pNoise; \
+    (void)track; \
+    (void)index; \
+    \
+    i = offset; \
+    j = 0; \
+    while (i < release && i < offset + count) { \
+        double noise; \
+        float clampAmp, perc, waveAmp; \
+        int amp, volPerc; \
+        \
+        /* Calculate the percentage of the note into the current cycle; Only \
+         * the 24 most significant bits are used, so it's exactly \
+         * represented */ \
+        perc = (phase >> 8) * (1.0f / (1 << 24)); \
+        \
+        /* Retrieve the current amplitude */ \
+        volPerc = i / (float)duration * 1024; \
+        amp = (((volIni * (1024 - volPerc)) + (volFin * volPerc)) >> 10) & \
+                0xffff; \
+        \
+        /* Defines the value that encapsulates the note */ \
+        if (i < attack) { \
+            clampAmp = i / attack; \
+        } \
+        else if (i > keyoff) { \
+            clampAmp = 1.0f - (i - keyoff) / (release - keyoff); \
+        } \
+        else { \
+            clampAmp = 1.0f; \
+        } \
+        \
+        SYNTHNOTE_WAVE_##wave(MODE) \
+        (void)noise; \
+        \
+        /* "Fix" the note amplitude */ \
+        waveAmp *= clampAmp; \
+        \
+        SYNTHNOTE_STORE_##format \
+        \
+        i++; \
+        j += SYNTHNOTE_BYTES_##format; \
+        phase += increment; \
+    } \
+    \
+    rv = SYNTH_OK; \
+__err: \
+    return rv; \
+}
+
+/**
+ * Define a kernel that renders a rest (i.e., simply clears the buffer)
+ * 
+ * @param  [ in]pref   Unused
+ * @param  [ in]name   The mode's name
+ * @param  [ in]format The mode's format
+ * @param  [ in]MODE   The mode
+ */
+#define SYNTHNOTE_DEFINE_REST(pref, name, format, MODE) \
+static synth_err synthNote_kernel_rest_##name(char *pBuf, synthNote *pNote, \
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, int track, int index, \
+        int duration, int offset, int count) { \
+    synth_err rv; \
+    \
+    /* Sanitize the arguments */ \
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR); \
+    \
+    memset(pBuf, 0x0, count * SYNTHNOTE_BYTES_##format); \
+    \
+    rv = SYNTH_OK; \
+__err: \
+    return rv; \
+}
+
+/** Define the kernels for every mode of a wave */
+#define SYNTHNOTE_DEFINE_WAVE(wave) \
+    SYNTHNOTE_MODES(SYNTHNOTE_DEFINE_KERNEL, wave)
+
+SYNTHNOTE_WAVES(SYNTHNOTE_DEFINE_WAVE)
+SYNTHNOTE_MODES(SYNTHNOTE_DEFINE_REST, rest)
+
+/** Name a single kernel, as an entry of a table */
+#define SYNTHNOTE_KERNEL_NAME(wave, name, format, MODE) \
+    synthNote_kernel_##wave##_##name,
+
+/** List the kernels for every mode of a wave, as a row of a table */
+#define SYNTHNOTE_KERNEL_ROW(wave) \
+    { SYNTHNOTE_MODES(SYNTHNOTE_KERNEL_NAME, wave) },
+
+/** Kernels for every wave, indexed by wave and then by mode */
+static synthNoteKernel __synthNote_kernels[SYNTH_MAX_WAVE][8] = {
+    SYNTHNOTE_WAVES(SYNTHNOTE_KERNEL_ROW)
+};
+
+/** Kernels for rests, indexed by mode */
+static synthNoteKernel __synthNote_restKernels[8] = {
+    SYNTHNOTE_MODES(SYNTHNOTE_KERNEL_NAME, rest)
+};
+
+#if defined(SYNTH_SIMD)
+/* Vector types and operations used by the vectorized kernels; Every operation
+ * works on 4 lanes and matches, bit for bit, its scalar counterpart */
+#  if defined(SYNTH_SIMD_SSE2)
+typedef __m128  synthVecF;
+typedef __m128i synthVecI;
+typedef __m128  synthVecM;
+
+#    define SYNTHVEC_SETF(v)       _mm_set1_ps(v)
+#    define SYNTHVEC_SETI(v)       _mm_set1_epi32(v)
+#    define SYNTHVEC_SEQI()        _mm_setr_epi32(0, 1, 2, 3)
+#    define SYNTHVEC_ADDF(a, b)    _mm_add_ps(a, b)
+#    define SYNTHVEC_SUBF(a, b)    _mm_sub_ps(a, b)
+#    define SYNTHVEC_MULF(a, b)    _mm_mul_ps(a, b)
+#    define SYNTHVEC_DIVF(a, b)    _mm_div_ps(a, b)
+#    define SYNTHVEC_LTF(a, b)     _mm_cmplt_ps(a, b)
+#    define SYNTHVEC_GTF(a, b)     _mm_cmpgt_ps(a, b)
+#    define SYNTHVEC_SELF(m, a, b) \
+        _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#    define SYNTHVEC_ADDI(a, b)    _mm_add_epi32(a, b)
+#    define SYNTHVEC_SUBI(a, b)    _mm_sub_epi32(a, b)
+#    define SYNTHVEC_MULI(a, b)    synthVec_mulI(a, b)
+#    define SYNTHVEC_ANDI(a, b)    _mm_and_si128(a, b)
+#    define SYNTHVEC_SRAI(a, n)    _mm_srai_epi32(a, n)
+#    define SYNTHVEC_SRLI(a, n)    _mm_srli_epi32(a, n)
+#    define SYNTHVEC_ITOF(a)       _mm_cvtepi32_ps(a)
+#    define SYNTHVEC_FTOI(a)       _mm_cvttps_epi32(a)
+#    define SYNTHVEC_ZIPLO(a, b)   _mm_unpacklo_epi32(a, b)
+#    define SYNTHVEC_ZIPHI(a, b)   _mm_unpackhi_epi32(a, b)
+
+/**
+ * Multiply every lane, keeping only the lower 32 bits (SSE2 lacks pmulld)
+ * 
+ * @param  [ in]a The first operand
+ * @param  [ in]b The second operand
+ * @return        The product
+ */
+static synthVecI synthVec_mulI(synthVecI a, synthVecI b) {
+    synthVecI even, odd;
+
+    even = _mm_mul_epu32(a, b);
+    odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+/**
+ * Store the lower byte of every lane of both vectors (i.e., 8 bytes)
+ * 
+ * @param  [ in]pBuf The buffer
+ * @param  [ in]a    The first 4 values
+ * @param  [ in]b    The last 4 values
+ */
+static void synthVec_store8(char *pBuf, synthVecI a, synthVecI b) {
+    synthVecI mask, packed;
+
+    /* Clear the higher bits, so packing doesn't saturate */
+    mask = _mm_set1_epi32(0xff);
+    packed = _mm_packs_epi32(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+    packed = _mm_packus_epi16(packed, packed);
+
+    _mm_storel_epi64((__m128i*)pBuf, packed);
+}
+
+/**
+ * Store the lower 16 bits of every lane of both vectors (i.e., 16 bytes), in
+ * little-endian
+ * 
+ * @param  [ in]pBuf The buffer
+ * @param  [ in]a    The first 4 values
+ * @param  [ in]b    The last 4 values
+ */
+static void synthVec_store16(char *pBuf, synthVecI a, synthVecI b) {
+    /* Sign-extend the lower bits, so packing doesn't saturate */
+    a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+    b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+
+    _mm_storeu_si128((__m128i*)pBuf, _mm_packs_epi32(a, b));
+}
+#  elif defined(SYNTH_SIMD_NEON)
+typedef float32x4_t synthVecF;
+typedef int32x4_t   synthVecI;
+typedef uint32x4_t  synthVecM;
+
+/** Lanes' indices, to be loaded by SYNTHVEC_SEQI */
+static const int32_t __synthVec_seq[4] = {0, 1, 2, 3};
+
+#    define SYNTHVEC_SETF(v)       vdupq_n_f32(v)
+#    define SYNTHVEC_SETI(v)       vdupq_n_s32(v)
+#    define SYNTHVEC_SEQI()        vld1q_s32(__synthVec_seq)
+#    define SYNTHVEC_ADDF(a, b)    vaddq_f32(a, b)
+#    define SYNTHVEC_SUBF(a, b)    vsubq_f32(a, b)
+#    define SYNTHVEC_MULF(a, b)    vmulq_f32(a, b)
+#    define SYNTHVEC_DIVF(a, b)    vdivq_f32(a, b)
+#    define SYNTHVEC_LTF(a, b)     vcltq_f32(a, b)
+#    define SYNTHVEC_GTF(a, b)     vcgtq_f32(a, b)
+#    define SYNTHVEC_SELF(m, a, b) vbslq_f32(m, a, b)
+#    define SYNTHVEC_ADDI(a, b)    vaddq_s32(a, b)
+#    define SYNTHVEC_SUBI(a, b)    vsubq_s32(a, b)
+#    define SYNTHVEC_MULI(a, b)    vmulq_s32(a, b)
+#    define SYNTHVEC_ANDI(a, b)    vandq_s32(a, b)
+#    define SYNTHVEC_SRAI(a, n)    vshrq_n_s32(a, n)
+#    define SYNTHVEC_SRLI(a, n) \
+        vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a), n))
+#    define SYNTHVEC_ITOF(a)       vcvtq_f32_s32(a)
+#    define SYNTHVEC_FTOI(a)       vcvtq_s32_f32(a)
+#    define SYNTHVEC_ZIPLO(a, b)   vzip1q_s32(a, b)
+#    define SYNTHVEC_ZIPHI(a, b)   vzip2q_s32(a, b)
+
+/**
+ * Store the lower byte of every lane of both vectors (i.e., 8 bytes)
+ * 
+ * @param  [ in]pBuf The buffer
+ * @param  [ in]a    The first 4 values
+ * @param  [ in]b    The last 4 values
+ */
+static void synthVec_store8(char *pBuf, synthVecI a, synthVecI b) {
+    vst1_s8((int8_t*)pBuf, vmovn_s16(vcombine_s16(vmovn_s32(a),
+            vmovn_s32(b))));
+}
+
+/**
+ * Store the lower 16 bits of every lane of both vectors (i.e., 16 bytes), in
+ * little-endian
+ * 
+ * @param  [ in]pBuf The buffer
+ * @param  [ in]a    The first 4 values
+ * @param  [ in]b    The last 4 values
+ */
+static void synthVec_store16(char *pBuf, synthVecI a, synthVecI b) {
+    vst1q_s16((int16_t*)pBuf, vcombine_s16(vmovn_s32(a), vmovn_s32(b)));
+}
+#  endif
+
+/**
+ * Calculate the amplitude of a rectangular wave on 4 lanes, given the cycle's
+ * percentage (vPerc) and its duty cycle
+ * 
+ * @param  [ in]duty Percentage of the cycle that is set high
+ */
+#  define SYNTHNOTE_SIMD_WAVE_RECT(duty) \
+    vWave = SYNTHVEC_SELF(SYNTHVEC_LTF(vPerc, SYNTHVEC_SETF(duty)), vOne, \
+            vLow);
+
+/**
+ * Calculate the amplitude of a triangular wave on 4 lanes; See
+ * SYNTHNOTE_WAVE_TRIANGLE
+ * 
+ * @param  [ in]MODE Desired mode for the wave (a constant)
+ */
+#  define SYNTHNOTE_SIMD_WAVE_TRIANGLE(MODE) \
+    if ((MODE) & SYNTH_SIGNED) { \
+        vWave = SYNTHVEC_SELF( \
+                SYNTHVEC_LTF(vPerc, SYNTHVEC_SETF(0.25f)), \
+                SYNTHVEC_MULF(SYNTHVEC_SETF(4.0f), vPerc), \
+                SYNTHVEC_SELF( \
+                        SYNTHVEC_LTF(vPerc, SYNTHVEC_SETF(0.5f)), \
+                        SYNTHVEC_MULF(SYNTHVEC_SETF(4.0f), \
+                                SYNTHVEC_SUBF(SYNTHVEC_SETF(0.5f), vPerc)), \
+                        SYNTHVEC_SELF( \
+                                SYNTHVEC_LTF(vPerc, SYNTHVEC_SETF(0.75f)), \
+                                SYNTHVEC_MULF(SYNTHVEC_SETF(-4.0f), \
+                                        SYNTHVEC_SUBF(vPerc, \
+                                                SYNTHVEC_SETF(0.5f))), \
+                                SYNTHVEC_MULF(SYNTHVEC_SETF(-4.0f), \
+                                        SYNTHVEC_SUBF(vOne, vPerc))))); \
+    } \
+    else { \
+        vWave = SYNTHVEC_SELF( \
+                SYNTHVEC_LTF(vPerc, SYNTHVEC_SETF(0.5f)), \
+                SYNTHVEC_MULF(SYNTHVEC_SETF(2.0f), vPerc), \
+                SYNTHVEC_MULF(SYNTHVEC_SETF(2.0f), \
+                        SYNTHVEC_SUBF(vOne, vPerc))); \
+    } \
+    vWave = SYNTHVEC_MULF(vWave, SYNTHVEC_SETF(1.125f));
+
+#  define SYNTHNOTE_SIMD_WAVE_square(MODE) SYNTHNOTE_SIMD_WAVE_RECT(0.5f)
+#  define SYNTHNOTE_SIMD_WAVE_pulse12_5(MODE) SYNTHNOTE_SIMD_WAVE_RECT(0.125f)
+#  define SYNTHNOTE_SIMD_WAVE_pulse25(MODE) SYNTHNOTE_SIMD_WAVE_RECT(0.25f)
+#  define SYNTHNOTE_SIMD_WAVE_pulse75(MODE) SYNTHNOTE_SIMD_WAVE_RECT(0.75f)
+#  define SYNTHNOTE_SIMD_WAVE_triangle(MODE) SYNTHNOTE_SIMD_WAVE_TRIANGLE(MODE)
+
+/**
+ * Synthesize 4 samples of a wave, calculating their volume (vAmp) and
+ * their enveloped amplitude (vWave)
+ * 
+ * @param  [ in]wave The wave's name
+ * @param  [ in]MODE The mode
+ * @param  [ in]vIdx Index of each sample within the note
+ * @param  [ in]vPos Phase of each sample
+ */
+#  define SYNTHNOTE_SIMD_LANES(wave, MODE, vIdx, vPos) \
+    { \
+        synthVecF vClamp, vI, vPerc; \
+        synthVecI vVolPerc; \
+        \
+        vI = SYNTHVEC_ITOF(vIdx); \
+        vPerc = SYNTHVEC_MULF(SYNTHVEC_ITOF(SYNTHVEC_SRLI(vPos, 8)), \
+                SYNTHVEC_SETF(1.0f / (1 << 24))); \
+        \
+        vVolPerc = SYNTHVEC_FTOI(SYNTHVEC_MULF(SYNTHVEC_DIVF(vI, \
+                vDuration), SYNTHVEC_SETF(1024.0f))); \
+        vAmp = SYNTHVEC_ANDI(SYNTHVEC_SRAI(SYNTHVEC_ADDI( \
+                SYNTHVEC_MULI(vVolIni, \
+                        SYNTHVEC_SUBI(SYNTHVEC_SETI(1024), vVolPerc)), \
+                SYNTHVEC_MULI(vVolFin, vVolPerc)), 10), \
+                SYNTHVEC_SETI(0xffff)); \
+        \
+        vClamp = SYNTHVEC_SELF(SYNTHVEC_LTF(vI, vAttack), \
+                SYNTHVEC_DIVF(vI, vAttack), \
+                SYNTHVEC_SELF(SYNTHVEC_GTF(vI, vKeyoff), \
+                        SYNTHVEC_SUBF(vOne, SYNTHVEC_DIVF( \
+                                SYNTHVEC_SUBF(vI, vKeyoff), vFade)), \
+                        vOne)); \
+        \
+        SYNTHNOTE_SIMD_WAVE_##wave(MODE) \
+        vWave = SYNTHVEC_MULF(vWave, vClamp); \
     }
 
-    /* Calculate the note frequency (or "cycle"). E.g., A4 = 440Hz */
-    noteFreq = __synthNote_frequency[pNote->note] >> (9 - pNote->octave);
-    /* Calculate how many 'samples-per-cycle' there are for the Note's note */
-    spc = synthFreq / noteFreq;
-
-    /* Calculate the note asdasd in samples */
-    attack = duration * pNote->attack / 100.0f;
-    keyoff = duration * pNote->keyoff / 100.0f;
-    release = duration * pNote->release / 100.0f;
-
-    /* Synthesize the note audio */
-    i = 0;
-    while (i < release) {
-        char pan;
-        int amp, j;
-        float clampAmp, perc, waveAmp;
-
-        /* TODO Rewrite this loop without using floats */
-
-        /* Calculate the percentage of the note into the current cycle */
-        perc = ((float)(i % spc)) / spc;
-
-        /* Retrieve the current amplitude */
-        rv = synthVolume_getAmplitude(&amp, pVolume, i / (float)duration *
-                1024);
-        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
-        /* Defines the value that encapsulates the note */
-        if (i < attack) {
-            /* Varies the value from 0.0f -> 1.0f */
-            clampAmp = i / attack;
-        }
-        else if (i > keyoff) {
-            /* Varies the value from 1.0f -> 0.0f */
-            clampAmp = 1.0f - (i - keyoff) / (release - keyoff);
-        }
-        else {
-            clampAmp = 1.0f;
-        }
+/* Convert 8 samples to each mode's format and store them at the buffer; 'vAmpA'
+ * and 'vWaveA' hold the first 4 samples and 'vAmpB' and 'vWaveB' the last 4 */
+#  define SYNTHNOTE_SIMD_STORE_8BITS \
+    synthVec_store8(pBuf + j, \
+            SYNTHVEC_FTOI(SYNTHVEC_MULF(SYNTHVEC_ITOF( \
+                    SYNTHVEC_SRAI(vAmpA, 8)), vWaveA)), \
+            SYNTHVEC_FTOI(SYNTHVEC_MULF(SYNTHVEC_ITOF( \
+                    SYNTHVEC_SRAI(vAmpB, 8)), vWaveB)));
+#  define SYNTHNOTE_SIMD_STORE_16BITS \
+    synthVec_store16(pBuf + j, \
+            SYNTHVEC_FTOI(SYNTHVEC_MULF(SYNTHVEC_ITOF(vAmpA), vWaveA)), \
+            SYNTHVEC_FTOI(SYNTHVEC_MULF(SYNTHVEC_ITOF(vAmpB), vWaveB)));
+#  define SYNTHNOTE_SIMD_STORE_STEREO(store, shift, bytes) \
+    { \
+        synthVecF vA, vB; \
+        synthVecI vLA, vLB, vRA, vRB; \
+        \
+        vA = SYNTHVEC_MULF(SYNTHVEC_ITOF(SYNTHVEC_SRAI(vAmpA, shift)), \
+                vWaveA); \
+        vB = SYNTHVEC_MULF(SYNTHVEC_ITOF(SYNTHVEC_SRAI(vAmpB, shift)), \
+                vWaveB); \
+        vLA = SYNTHVEC_FTOI(SYNTHVEC_MULF(vA, vLPan)); \
+        vRA = SYNTHVEC_FTOI(SYNTHVEC_MULF(vA, vRPan)); \
+        vLB = SYNTHVEC_FTOI(SYNTHVEC_MULF(vB, vLPan)); \
+        vRB = SYNTHVEC_FTOI(SYNTHVEC_MULF(vB, vRPan)); \
+        \
+        store(pBuf + j, SYNTHVEC_ZIPLO(vLA, vRA), SYNTHVEC_ZIPHI(vLA, vRA)); \
+        store(pBuf + j + bytes, SYNTHVEC_ZIPLO(vLB, vRB), \
+                SYNTHVEC_ZIPHI(vLB, vRB)); \
+    }
+#  define SYNTHNOTE_SIMD_STORE_2CHAN_8BITS \
+    SYNTHNOTE_SIMD_STORE_STEREO(synthVec_store8, 8, 8)
+#  define SYNTHNOTE_SIMD_STORE_2CHAN_16BITS \
+    SYNTHNOTE_SIMD_STORE_STEREO(synthVec_store16, 0, 16)
 
-        /* Retrieve the note panning (in case it uses 2 channels) */
-        rv = synthNote_getPan(&pan, pNote);
-        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
-        /* Calculate the sample's actual index */
-        j = i * numBytes;
-
-        /* Retrieve the sample's amplitude, according to the note's wave form.
-         * This amplitude is calculated in the range [-1.0f, 1.0f], so it can
-         * correctly be downsampled for 8 and 16 bits amplitudes (as well as
-         * signed and unsigned) */
-        switch (pNote->wave) {
-            case W_NOISE_SQUARE:
-            case W_SQUARE: {
-                /* 50% duty cycle */
-                if (perc < 0.5f) {
-                    waveAmp = 1.0f;
-                }
-                else {
-                    if (mode & SYNTH_SIGNED) {
-                        waveAmp = -1.0f;
-                    }
-                    else {
-                        waveAmp = 0.0f;
-                    }
-                }
-            } break;
-            case W_NOISE_12_5:
-            case W_PULSE_12_5: {
-                /* 12.5% duty cycle */
-                if (perc < 0.125f) {
-                    waveAmp = 1.0f;
-                }
-                else {
-                    if (mode & SYNTH_SIGNED) {
-                        waveAmp = -1.0f;
-                    }
-                    else {
-                        waveAmp = 0.0f;
-                    }
-                }
-            } break;
-            case W_NOISE_25:
-            case W_PULSE_25: {
-                /* 25% duty cycle */
-                if (perc < 0.25f) {
-                    waveAmp = 1.0f;
-                }
-                else {
-                    if (mode & SYNTH_SIGNED) {
-                        waveAmp = -1.0f;
-                    }
-                    else {
-                        waveAmp = 0.0f;
-                    }
-                }
-            } break;
-            case W_NOISE_75:
-            case W_PULSE_75: {
-                /* 75% duty cycle */
-                if (perc < 0.75f) {
-                    waveAmp = 1.0f;
-                }
-                else {
-                    if (mode & SYNTH_SIGNED) {
-                        waveAmp = -1.0f;
-                    }
-                    else {
-                        waveAmp = 0.0f;
-                    }
-                }
-            } break;
-            case W_NOISE_TRIANGLE:
-            case W_TRIANGLE: {
-                /* Convert the percentage into a triangular wave with its
-                 * positive peak at 0.25% samples and its negative peak at 0.75%
-                 * samples */
-                if (mode & SYNTH_SIGNED) {
-                    if (perc < 0.25f) {
-                        waveAmp = 4.0f * perc;
-                    }
-                    else if (perc < 0.5f) {
-                        waveAmp = 4.0f * (0.5f - perc);
-                    }
-                    else if (perc < 0.75f) {
-                        waveAmp = -4.0f * (perc - 0.5f);
-                    }
-                    else {
-                        waveAmp = -4.0f * (1.0f - perc);
-                    }
-                }
-                else {
-                    if (perc < 0.5f) {
-                        waveAmp = 2.0f * perc;
-                    }
-                    else {
-                        waveAmp = 2.0f * (1.0f - perc);
-                    }
-                }
-                /* Make triangle waves a little louder */
-                waveAmp *= 1.125;
-            } break;
-            case W_NOISE: {
-                /* Simply set the amplitude to 1.0f, so it may be multiplied by
-                 * the pseudo-random value later */
-                waveAmp = 1.0f;
-            } break;
-            default: { waveAmp = 0.0f; }
-        }
+/**
+ * List every wave that has a vectorized kernel, in the same order as they are
+ * declared on 'synth_wave'
+ * 
+ * @param  [ in]X Macro called as X(name)
+ */
+#  define SYNTHNOTE_SIMD_WAVES(X) \
+    X(square) \
+    X(pulse12_5) \
+    X(pulse25) \
+    X(pulse75) \
+    X(triangle)
+
+/** Number of waves listed on SYNTHNOTE_SIMD_WAVES */
+#  define SYNTHNOTE_SIMD_NUM_WAVES (W_TRIANGLE + 1)
+
+/**
+ * Define a kernel that synthesizes a single wave into a single mode, 8 samples
+ * at a time; Whatever doesn't fill a whole iteration (as well as the silence
+ * after the note is released) is left to the scalar kernel
+ * 
+ * @param  [ in]wave   The wave's name
+ * @param  [ in]name   The mode's name
+ * @param  [ in]format The mode's format
+ * @param  [ in]MODE   The mode
+ */
+#  define SYNTHNOTE_DEFINE_SIMD_KERNEL(wave, name, format, MODE) \
+static synth_err synthNote_simdKernel_##wave##_##name(char *pBuf, \
+        synthNote *pNote, synthCtx *pCtx, synthPRNGCtx *pPRNG, int track, \
+        int index, int duration, int offset, int count) { \
+    float attack, keyoff, release; \
+    int i, j; \
+    unsigned int increment, phase; \
+    synthVecF vAttack, vDuration, vFade, vKeyoff, vLPan, vLow, vOne, vRPan; \
+    synthVecI vPhaseStep, vSeq, vVolFin, vVolIni; \
+    synthVolume *pVolume; \
+    synth_err rv; \
+    \
+    /* Sanitize the arguments */ \
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR); \
+    SYNTH_ASSERT_ERR(pNote, SYNTH_BAD_PARAM_ERR); \
+    \
+    /* Set up everything exactly as the scalar kernel does */ \
+    pVolume = SYNTH_VOLUME(pCtx, pNote->volume); \
+    vVolIni = SYNTHVEC_SETI(pVolume->ini); \
+    vVolFin = SYNTHVEC_SETI(pVolume->fin); \
+    \
+    increment = pCtx->phaseIncrement[pNote->octave - 1][pNote->note]; \
+    phase = increment * (unsigned int)offset; \
+    \
+    attack = duration * pNote->attack / 100.0f; \
+    keyoff = duration * pNote->keyoff / 100.0f; \
+    release = duration * pNote->release / 100.0f; \
+    \
+    vAttack = SYNTHVEC_SETF(attack); \
+    vDuration = SYNTHVEC_SETF((float)duration); \
+    vFade = SYNTHVEC_SETF(release - keyoff); \
+    vKeyoff = SYNTHVEC_SETF(keyoff); \
+    vLPan = SYNTHVEC_SETF((100 - pNote->pan) / 100.0f); \
+    vRPan = SYNTHVEC_SETF(pNote->pan / 100.0f); \
+    vOne = SYNTHVEC_SETF(1.0f); \
+    if ((MODE) & SYNTH_SIGNED) { \
+        vLow = SYNTHVEC_SETF(-1.0f); \
+    } \
+    else { \
+        vLow = SYNTHVEC_SETF(0.0f); \
+    } \
+    /* Mono modes and triangle waves don't use every variable */ \
+    (void)vLow; \
+    (void)vLPan; \
+    (void)vRPan; \
+    \
+    vSeq = SYNTHVEC_SEQI(); \
+    vPhaseStep = SYNTHVEC_MULI(vSeq, SYNTHVEC_SETI((int)increment)); \
+    \
+    i = offset; \
+    j = 0; \
+    /* Every sample on an iteration must be before the release */ \
+    while (i + 8 <= offset + count && i + 7 < release) { \
+        synthVecF vWave, vWaveA, vWaveB; \
+        synthVecI vAmp, vAmpA, vAmpB, vIdx, vPos; \
+        \
+        vIdx = SYNTHVEC_ADDI(SYNTHVEC_SETI(i), vSeq); \
+        vPos = SYNTHVEC_ADDI(SYNTHVEC_SETI((int)phase), vPhaseStep); \
+        SYNTHNOTE_SIMD_LANES(wave, MODE, vIdx, vPos) \
+        vAmpA = vAmp; \
+        vWaveA = vWave; \
+        \
+        vIdx = SYNTHVEC_ADDI(SYNTHVEC_SETI(i + 4), vSeq); \
+        vPos = SYNTHVEC_ADDI(SYNTHVEC_SETI((int)(phase + increment * 4)), \
+                vPhaseStep); \
+        SYNTHNOTE_SIMD_LANES(wave, MODE, vIdx, vPos) \
+        vAmpB = vAmp; \
+        vWaveB = vWave; \
+        \
+        SYNTHNOTE_SIMD_STORE_##format \
+        \
+        i += 8; \
+        j += 8 * SYNTHNOTE_BYTES_##format; \
+        phase += increment * 8; \
+    } \
+    \
+    /* Render whatever is left (and clear the rest of the buffer) */ \
+    rv = synthNote_kernel_##wave##_##name(pBuf + j, pNote, pCtx, pPRNG, \
+            track, index, duration, i, offset + count - i); \
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv); \
+    \
+    rv = SYNTH_OK; \
+__err: \
+    return rv; \
+}
 
-        if (pNote->wave >= W_NOISE && pNote->wave <= W_NOISE_TRIANGLE) {
-            double noise;
+/** Define the vectorized kernels for every mode of a wave */
+#  define SYNTHNOTE_DEFINE_SIMD_WAVE(wave) \
+    SYNTHNOTE_MODES(SYNTHNOTE_DEFINE_SIMD_KERNEL, wave)
 
-            rv = synthPRNG_getGaussianNoise(&noise, &(pCtx->prngCtx));
-            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+SYNTHNOTE_SIMD_WAVES(SYNTHNOTE_DEFINE_SIMD_WAVE)
 
-            if (pNote->wave == W_NOISE) {
-                /* For simple noises, simply export random values */
-                waveAmp = (float)(noise * 2.0);
-            }
-            else if (pNote->wave == W_NOISE_TRIANGLE) {
-                waveAmp = (float)(waveAmp * 0.75 + noise * waveAmp * 4.0 * 0.25);
-            }
-            else if (pNote->wave == W_NOISE_25) {
-                if (waveAmp > 0.0f) {
-                    waveAmp = (float)(noise * 6.0);
-                }
-                else {
-                    waveAmp = (float)(noise * 1.5);
-                }
-            }
-            else {
-                /* If it's a simple rectangular wave, clamp the value to the
-                 * desired range */
-                if (waveAmp > 0.0f) {
-                    waveAmp = (float)(noise * 4.0);
-                }
-                else {
-                    waveAmp = (float)(noise * 0.25);
-                }
-            }
-        }
+/** Name a single vectorized kernel, as an entry of a table */
+#  define SYNTHNOTE_SIMD_KERNEL_NAME(wave, name, format, MODE) \
+    synthNote_simdKernel_##wave##_##name,
 
-        /* "Fix" the note amplitude */
-        waveAmp *= clampAmp;
-
-        /* Convert the amplitude to the desired format and store it at the
-         * buffer */
-        switch (mode) {
-            case SYNTH_1CHAN_U8BITS:
-            case SYNTH_1CHAN_8BITS: {
-                /* Simply store the calculated value; The amplitude is
-                 * lessened to only 8 bits */
-                pBuf[j] = (amp >> 8) * waveAmp;
-            } break;
-            case SYNTH_1CHAN_U16BITS:
-            case SYNTH_1CHAN_16BITS: {
-                int amp16;
-
-                /* Simply store the calculated value */
-                amp16 = amp  * waveAmp;
-
-                /* Simply store the calculated value; Storing the lower bits on
-                 * byte 0 and the higher ones on bit 1 */
-                pBuf[j] = amp16 & 0xff;
-                pBuf[j + 1] = (amp16 >> 8) & 0xff;
-            } break;
-            case SYNTH_2CHAN_U8BITS:
-            case SYNTH_2CHAN_8BITS: {
-                char lAmp8, rAmp8;
-
-                /* Calculate the amplitude on both channels, 0 means left only
-                 * and 100 means right only */
-                lAmp8 = (amp >> 8) * waveAmp * ((100 - pan) / 100.0f);
-                rAmp8 = (amp >> 8) * waveAmp * (pan / 100.0f);
-
-                pBuf[j] = lAmp8 & 0xff;
-                pBuf[j + 1] = rAmp8 & 0xff;
-            } break;
-            case SYNTH_2CHAN_U16BITS:
-            case SYNTH_2CHAN_16BITS: {
-                int lAmp16, rAmp16;
-
-                /* Calculate the amplitude on both channels, 0 means left only
-                 * and 100 means right only */
-                lAmp16 = amp  * waveAmp * ((100 - pan) / 100.0f);
-                rAmp16 = amp  * waveAmp * (pan / 100.0f);
-
-                /* Store the left channel on bytes 0 (low) and 1 (high) and the
-                 * right one on 2 (low) and 3 (high) */
-                pBuf[j] = lAmp16 & 0xff;
-                pBuf[j + 1] = (lAmp16 >> 8) & 0xff;
-                pBuf[j + 2] = rAmp16 & 0xff;
-                pBuf[j + 3] = (rAmp16 >> 8) & 0xff;
-            } break;
-            default : { /* Avoids warnings */ }
-        }
+/** List the vectorized kernels for every mode of a wave, as a row of a table */
+#  define SYNTHNOTE_SIMD_KERNEL_ROW(wave) \
+    { SYNTHNOTE_MODES(SYNTHNOTE_SIMD_KERNEL_NAME, wave) },
+
+/** Vectorized kernels, indexed by wave and then by mode */
+static synthNoteKernel __synthNote_simdKernels[SYNTHNOTE_SIMD_NUM_WAVES][8] = {
+    SYNTHNOTE_SIMD_WAVES(SYNTHNOTE_SIMD_KERNEL_ROW)
+};
+#endif /* SYNTH_SIMD */
 
-        /* Increase, since we are looping through the samples (and not through
-         * the bytes) */
-        i++;
+/**
+ * Retrieve the scalar kernel that renders a note into the desired mode
+ * 
+ * Every wave has a scalar kernel, so this is also the reference against which
+ * the vectorized kernels are checked
+ * 
+ * @param  [out]pKernel The kernel
+ * @param  [ in]pNote   The note
+ * @param  [ in]mode    Desired mode for the wave
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthNote_getScalarKernel(synthNoteKernel *pKernel, synthNote *pNote,
+        synthBufMode mode) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pKernel, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pNote, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pNote->wave >= 0 && pNote->wave < SYNTH_MAX_WAVE,
+            SYNTH_BAD_PARAM_ERR);
+
+    if (pNote->note == N_REST) {
+        *pKernel = __synthNote_restKernels[synthNote_getModeIndex(mode)];
+    }
+    else {
+        *pKernel = __synthNote_kernels[pNote->wave]
+                [synthNote_getModeIndex(mode)];
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve the kernel that renders a note into the desired mode
+ * 
+ * This should be done only once per note, so rendering doesn't have to check
+ * for the wave nor for the mode on every sample; Vectorized kernels are
+ * preferred, whenever one was compiled for the note's wave
+ * 
+ * @param  [out]pKernel The kernel
+ * @param  [ in]pNote   The note
+ * @param  [ in]mode    Desired mode for the wave
+ * @return              SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthNote_getKernel(synthNoteKernel *pKernel, synthNote *pNote,
+        synthBufMode mode) {
+    synth_err rv;
+
+    rv = synthNote_getScalarKernel(pKernel, pNote, mode);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+#if defined(SYNTH_SIMD)
+    if (pNote->note != N_REST && pNote->wave < SYNTHNOTE_SIMD_NUM_WAVES) {
+        *pKernel = __synthNote_simdKernels[pNote->wave]
+                [synthNote_getModeIndex(mode)];
     }
-    /* The silence (after the key was released) was already cleared, so simply
-     * return */
+#endif
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Render a note into a buffer
+ * 
+ * The buffer must have at least 'synthNote_getDuration' bytes time the number
+ * of bytes required by the mode
+ * 
+ * @param  [ in]pBuf      Buffer that will be filled with the track
+ * @param  [ in]pNote     The note
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pPRNG     Pseudo-random number generator used by noises
+ * @param  [ in]kernel    Kernel for the note's wave and the desired mode
+ * @param  [ in]track     Position of the note's track within its song
+ * @param  [ in]index     Position of the note within its track
+ * @param  [ in]duration  The note's length in samples
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthNote_render(char *pBuf, synthNote *pNote, synthCtx *pCtx,
+        synthPRNGCtx *pPRNG, synthNoteKernel kernel, int track, int index,
+        int duration) {
+    synth_err rv;
+
+    /* Simply render the whole note */
+    rv = synthNote_renderRange(pBuf, pNote, pCtx, pPRNG, kernel, track, index,
+            duration, 0, duration);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Render only part of a note into a buffer
+ * 
+ * The first rendered sample (i.e., the 'offset'-th sample of the note) is
+ * placed at the start of the buffer, which must have at least 'count' samples
+ * 
+ * @param  [ in]pBuf      Buffer that will be filled with the note
+ * @param  [ in]pNote     The note
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pPRNG     Pseudo-random number generator used by noises
+ * @param  [ in]kernel    Kernel for the note's wave and the desired mode
+ * @param  [ in]track     Position of the note's track within its song
+ * @param  [ in]index     Position of the note within its track
+ * @param  [ in]duration  The note's length in samples
+ * @param  [ in]offset    First sample to be rendered
+ * @param  [ in]count     How many samples should be rendered
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthNote_renderRange(char *pBuf, synthNote *pNote, synthCtx *pCtx,
+        synthPRNGCtx *pPRNG, synthNoteKernel kernel, int track, int index,
+        int duration, int offset, int count) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pNote, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pPRNG, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(kernel, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(offset >= 0 && count >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(offset + count <= duration, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(track >= 0 && index >= 0, SYNTH_BAD_PARAM_ERR);
+
+    rv = kernel(pBuf, pNote, pCtx, pPRNG, track, index, duration, offset,
+            count);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
 __err:
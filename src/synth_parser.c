@@ -5,6 +5,7 @@
 #include <c_synth/synth_errors.h>
 
 #include <c_synth_internal/synth_lexer.h>
+#include <c_synth_internal/synth_list.h>
 #include <c_synth_internal/synth_note.h>
 #include <c_synth_internal/synth_parser.h>
 #include <c_synth_internal/synth_track.h>
@@ -199,6 +200,9 @@ synth_err synthParser_getErrorString(char **ppError, synthParserCtx *pParser,
             case SYNTH_BAD_LOOP_POINT: {
                 pError = "Loop point didn't sync with compass start";
             } break;
+            case SYNTH_BAD_LOOP_COUNT: {
+                pError = "Loop is repeated too many times";
+            } break;
             default: {
                 pError = "Unkown error";
             }
@@ -779,9 +783,10 @@ static synth_err synthParser_sequence(int *pNumNotes, synthParserCtx *pParser,
  */
 synth_err synthParser_loop(int *pNumNotes, synthParserCtx *pParser,
         synthCtx *pCtx) {
-    int count, loopPosition;
+    int count, loop, loopPosition, numLoops;
     synth_err rv;
     synthNote *pNote;
+    synthTrack *pTrack;
     synth_token token;
 
     /* We're sure to have this token, but... */
@@ -795,6 +800,9 @@ synth_err synthParser_loop(int *pNumNotes, synthParserCtx *pParser,
     /* Store the current position in track (so the loop position can be set
      * later on */
     loopPosition = *pNumNotes;
+    /* Tracks are parsed one at a time, so it's always the last one */
+    pTrack = SYNTH_TRACK(pCtx, pCtx->tracks.used - 1);
+    numLoops = pTrack->loopsNum;
 
     /* Read the next token */
     rv = synthLexer_getToken(&(pCtx->lexCtx));
@@ -829,8 +837,25 @@ synth_err synthParser_loop(int *pNumNotes, synthParserCtx *pParser,
         SYNTH_ASSERT(rv == SYNTH_OK);
     }
 
-    /* Add a 'loop note' to the track */
-    rv = synthNote_initLoop(&pNote, pCtx, count, loopPosition);
+    /* A loop played 0 times is skipped, so its body (and any loop within it)
+     * is simply dropped; Those were the last items appended to the lists.
+     * Modifiers within it still apply to the notes that follow it */
+    if (count == 0) {
+        pCtx->notes.used -= *pNumNotes - loopPosition;
+        *pNumNotes = loopPosition;
+        pCtx->loops.used -= pTrack->loopsNum - numLoops;
+        pTrack->loopsNum = numLoops;
+
+        rv = SYNTH_OK;
+        goto __err;
+    }
+
+    /* Add the loop to the track's loop table and a 'loop note' to the
+     * track */
+    rv = synthTrack_addLoop(&loop, pTrack, pCtx, *pNumNotes, loopPosition,
+            count);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synthNote_initLoop(&pNote, pCtx, loop);
     SYNTH_ASSERT(rv == SYNTH_OK);
 
     /* Increase the number of notes in the track */
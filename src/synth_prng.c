@@ -13,10 +13,144 @@
 #include <float.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #define TAU 2.0 * 3.1415926535897
 
+/** Increment between consecutive counters of a noise stream (2^32 / phi) */
+#define SYNTHPRNG_GAMMA 0x9e3779b9u
+/** Increment between the extra values required by a single noise sample */
+#define SYNTHPRNG_SUBGAMMA 0x632be5abu
+
+/** Number of layers in the ziggurat */
+#define SYNTHPRNG_ZIGGURAT_LAYERS 128
+/** Start of the ziggurat's tail (i.e., the rightmost layer's edge) */
+#define SYNTHPRNG_ZIGGURAT_R 3.442619855899
+
+/* Tables for the ziggurat method (Marsaglia & Tsang, 2000), with 128 layers;
+ * They were generated offline from the published setup ('zigset'):
+ *   - K: Threshold (scaled by 2^31) below which a sample surely is within the
+ *        layer (i.e., it's under the next layer's edge)
+ *   - W: Width of each layer, divided by 2^31
+ *   - F: Value of the gaussian (without normalization) at the layer's edge */
+static const unsigned int __synthPRNG_zigguratK[SYNTHPRNG_ZIGGURAT_LAYERS] = {
+    0x76ad2212u, 0x00000000u, 0x600f1b53u, 0x6ce447a6u, 0x725b46a2u, 0x7560051du,
+    0x774921ebu, 0x789a25bdu, 0x799045c3u, 0x7a4bce5du, 0x7adf629fu, 0x7b5682a6u,
+    0x7bb8a8c6u, 0x7c0ae722u, 0x7c50cce7u, 0x7c8cec5bu, 0x7cc12cd6u, 0x7ceefed2u,
+    0x7d177e0bu, 0x7d3b8883u, 0x7d5bce6cu, 0x7d78dd64u, 0x7d932886u, 0x7dab0e57u,
+    0x7dc0dd30u, 0x7dd4d688u, 0x7de73185u, 0x7df81ceau, 0x7e07c0a3u, 0x7e163efau,
+    0x7e23b587u, 0x7e303dfdu, 0x7e3beec2u, 0x7e46db77u, 0x7e51155du, 0x7e5aabb3u,
+    0x7e63abf7u, 0x7e6c222cu, 0x7e741906u, 0x7e7b9a18u, 0x7e82adfau, 0x7e895c63u,
+    0x7e8fac4bu, 0x7e95a3fbu, 0x7e9b4924u, 0x7ea0a0efu, 0x7ea5b00du, 0x7eaa7ac3u,
+    0x7eaf04f3u, 0x7eb3522au, 0x7eb765a5u, 0x7ebb4259u, 0x7ebeeafdu, 0x7ec2620au,
+    0x7ec5a9c4u, 0x7ec8c441u, 0x7ecbb365u, 0x7ece78edu, 0x7ed11671u, 0x7ed38d62u,
+    0x7ed5df12u, 0x7ed80cb4u, 0x7eda175cu, 0x7edc0005u, 0x7eddc78eu, 0x7edf6ebfu,
+    0x7ee0f647u, 0x7ee25ebeu, 0x7ee3a8a9u, 0x7ee4d473u, 0x7ee5e276u, 0x7ee6d2f5u,
+    0x7ee7a620u, 0x7ee85c10u, 0x7ee8f4cdu, 0x7ee97047u, 0x7ee9ce59u, 0x7eea0ecau,
+    0x7eea3147u, 0x7eea3568u, 0x7eea1aabu, 0x7ee9e071u, 0x7ee98602u, 0x7ee90a88u,
+    0x7ee86d08u, 0x7ee7ac6au, 0x7ee6c769u, 0x7ee5bc9cu, 0x7ee48a67u, 0x7ee32efcu,
+    0x7ee1a857u, 0x7edff42fu, 0x7ede0ffau, 0x7edbf8d9u, 0x7ed9ab94u, 0x7ed7248du,
+    0x7ed45faeu, 0x7ed1585cu, 0x7ece095fu, 0x7eca6ccbu, 0x7ec67be2u, 0x7ec22eeeu,
+    0x7ebd7d1au, 0x7eb85c35u, 0x7eb2c075u, 0x7eac9c20u, 0x7ea5df27u, 0x7e9e769fu,
+    0x7e964c16u, 0x7e8d44bau, 0x7e834033u, 0x7e781728u, 0x7e6b9933u, 0x7e5d8a1au,
+    0x7e4d9dedu, 0x7e3b737au, 0x7e268c2fu, 0x7e0e3ff5u, 0x7df1aa5du, 0x7dcf8c72u,
+    0x7da61a1eu, 0x7d72a0fbu, 0x7d30e097u, 0x7cd9b4abu, 0x7c600f1au, 0x7ba90bdcu,
+    0x7a722176u, 0x77d664e5u
+};
+
+static const double __synthPRNG_zigguratW[SYNTHPRNG_ZIGGURAT_LAYERS] = {
+    1.72904052154279803e-09, 1.26809284470027624e-10, 1.68975177731845509e-10,
+    1.98626884424790514e-10, 2.22324317924999546e-10, 2.42449361254489314e-10,
+    2.60161319006320644e-10, 2.76119887117039560e-10, 2.90739628177159793e-10,
+    3.04299704143765964e-10, 3.16997952139542731e-10, 3.28980205271130644e-10,
+    3.40357381218340638e-10, 3.51216022136647078e-10, 3.61625099505651700e-10,
+    3.71640576349597848e-10, 3.81308564311059794e-10, 3.90667568099488216e-10,
+    3.99750118699769123e-10, 4.08583986159844032e-10, 4.17193096401606540e-10,
+    4.25598235345926265e-10, 4.33817597392551055e-10, 4.41867218125288580e-10,
+    4.49761319626658175e-10, 4.57512588945882866e-10, 4.65132404814000981e-10,
+    4.72631023848117565e-10, 4.80017734723256701e-10, 4.87300986779874826e-10,
+    4.94488498053897294e-10, 5.01587346611961584e-10, 5.08604048242455986e-10,
+    5.15544622919539002e-10, 5.22414651970631553e-10, 5.29219327500630530e-10,
+    5.35963495331288974e-10, 5.42651692482061890e-10, 5.49288180034602135e-10,
+    5.55876972076077333e-10, 5.62421861298358841e-10, 5.68926441734655008e-10,
+    5.75394129037560270e-10, 5.81828178639089787e-10, 5.88231702081216994e-10,
+    5.94607681762499562e-10, 6.00958984310830221e-10, 6.07288372762788474e-10,
+    6.13598517705413548e-10, 6.19892007515592164e-10, 6.26171357814942937e-10,
+    6.32439020243540189e-10, 6.38697390643573640e-10, 6.44948816733738330e-10,
+    6.51195605346469821e-10, 6.57440029292859926e-10, 6.63684333913987547e-10,
+    6.69930743372330230e-10, 6.76181466732744392e-10, 6.82438703879113705e-10,
+    6.88704651310073293e-10, 6.94981507855166703e-10, 7.01271480351315471e-10,
+    7.07576789318556019e-10, 7.13899674673584899e-10, 7.20242401519748568e-10,
+    7.26607266052704741e-10, 7.32996601622086399e-10, 7.39412784991122834e-10,
+    7.45858242838353913e-10, 7.52335458548348845e-10, 7.58846979341765247e-10,
+    7.65395423799226317e-10, 7.71983489838440037e-10, 7.78613963209838099e-10,
+    7.85289726582899747e-10, 7.92013769303409782e-10, 7.98789197911353591e-10,
+    8.05619247520216980e-10, 8.12507294171396808e-10, 8.19456868292574514e-10,
+    8.26471669406662453e-10, 8.33555582258784499e-10, 8.40712694553299097e-10,
+    8.47947316521837156e-10, 8.55264002577609389e-10, 8.62667575351936329e-10,
+    8.70163152457442440e-10, 8.77756176380328383e-10, 8.85452447973727756e-10,
+    8.93258164108036948e-10, 9.01179960135660528e-10, 9.09224957951138100e-10,
+    9.17400820578600523e-10, 9.25715814404012599e-10, 9.34178880398847206e-10,
+    9.42799715966631439e-10, 9.51588869399888273e-10, 9.60557849383125278e-10,
+    9.69719252545394397e-10, 9.79086912790890083e-10, 9.88676077068772438e-10,
+    9.98503613453542511e-10, 1.00858825899144725e-09, 1.01895091686213816e-09,
+    1.02961501520066681e-09, 1.04060694369998736e-09, 1.05195658927280388e-09,
+    1.06369799919308711e-09, 1.07587021016458189e-09, 1.08851829606072827e-09,
+    1.10169470781350443e-09, 1.11546100955971631e-09, 1.12989016134932163e-09,
+    1.14506957000672374e-09, 1.16110524260223476e-09, 1.17812756094561306e-09,
+    1.19629950538507559e-09, 1.21582869832955645e-09, 1.23698562908049658e-09,
+    1.26013233006085248e-09, 1.28576968442051525e-09, 1.31462018496771830e-09,
+    1.34778395622108548e-09, 1.38706353150670429e-09, 1.43574031918163799e-09,
+    1.50086590302229932e-09, 1.60309479380911226e-09
+};
+
+static const double __synthPRNG_zigguratF[SYNTHPRNG_ZIGGURAT_LAYERS] = {
+    1.00000000000000000e+00, 9.63599693127086154e-01, 9.36282681685059570e-01,
+    9.13043647971740202e-01, 8.92281650784026104e-01, 8.73243048910069541e-01,
+    8.55500607869450591e-01, 8.38783605295989609e-01, 8.22907211381408987e-01,
+    8.07738294682960545e-01, 7.93177011771305063e-01, 7.79146085929687704e-01,
+    7.65584173897704501e-01, 7.52441559174611418e-01, 7.39677243672647311e-01,
+    7.27256918344184822e-01, 7.15151507410498599e-01, 7.03336099016158123e-01,
+    6.91789143436675080e-01, 6.80491840997334063e-01, 6.69427667348890365e-01,
+    6.58582000050088046e-01, 6.47941821110222471e-01, 6.37495477335042304e-01,
+    6.27232485249927252e-01, 6.17143370818880932e-01, 6.07219536625120293e-01,
+    5.97453150944516675e-01, 5.87837054434706574e-01, 5.78364681119763135e-01,
+    5.69029991067950935e-01, 5.59827412704086869e-01, 5.50751793114604538e-01,
+    5.41798355025425504e-01, 5.32962659383836135e-01, 5.24240572672984073e-01,
+    5.15628238244001835e-01, 5.07122051075568958e-01, 4.98718635470979499e-01,
+    4.90414825283844114e-01, 4.82207646329485207e-01, 4.74094300693016946e-01,
+    4.66072152689456121e-01, 4.58138716267872059e-01, 4.50291643682039222e-01,
+    4.42528715275468443e-01, 4.34847830249990908e-01, 4.27246998304996073e-01,
+    4.19724332049574378e-01, 4.12278040102661003e-01, 4.04906420807222944e-01,
+    3.97607856493873313e-01, 3.90380808237314580e-01, 3.83223811055901198e-01,
+    3.76135469510562592e-01, 3.69114453664472209e-01, 3.62159495369317574e-01,
+    3.55269384847917091e-01, 3.48442967546326587e-01, 3.41679141231550410e-01,
+    3.34976853313589173e-01, 3.28335098372850298e-01, 3.21752915875984924e-01,
+    3.15229388065010885e-01, 3.08763638006181118e-01, 3.02354827786483538e-01,
+    2.96002156846932984e-01, 2.89704860442959844e-01, 2.83462208223232981e-01,
+    2.77273502919188120e-01, 2.71138079138384613e-01, 2.65055302255589209e-01,
+    2.59024567396204830e-01, 2.53045298507325767e-01, 2.47116947512321411e-01,
+    2.41238993545439817e-01, 2.35410942263479084e-01, 2.29632325232116130e-01,
+    2.23902699385008425e-01, 2.18221646554305398e-01, 2.12588773071730297e-01,
+    2.07003709439926520e-01, 2.01466110074313670e-01, 1.95975653116277737e-01,
+    1.90532040319137147e-01, 1.85134997008992191e-01, 1.79784272123295452e-01,
+    1.74479638330789499e-01, 1.69220892237365000e-01, 1.64007854683420384e-01,
+    1.58840371139479297e-01, 1.53718312208181662e-01, 1.48641574242342256e-01,
+    1.43610080090627756e-01, 1.38623779984594603e-01, 1.33682652583439365e-01,
+    1.28786706195943207e-01, 1.23935980202867821e-01, 1.19130546707650831e-01,
+    1.14370512448866007e-01, 1.09656021014840274e-01, 1.04987255409421318e-01,
+    1.00364441028655868e-01, 9.57878491217314387e-02, 9.12578008268302571e-02,
+    8.67746718947801782e-02, 8.23388982422356558e-02, 7.79509825139733936e-02,
+    7.36115018841134033e-02, 6.93211173935779079e-02, 6.50805852130680734e-02,
+    6.08907703480404058e-02, 5.67526634810498476e-02, 5.26674019030510115e-02,
+    4.86362958598678050e-02, 4.46608622004914246e-02, 4.07428680744441746e-02,
+    3.68843887866562026e-02, 3.30878861462257506e-02, 2.93563174400068502e-02,
+    2.56932919359342711e-02, 2.21033046159270982e-02, 1.85921027370112880e-02,
+    1.51672980105465680e-02, 1.18394786578848617e-02, 8.62448441285988514e-03,
+    5.54899522077134492e-03, 2.66962908388092279e-03
+};
+
 /**
  * Advance the internal context to the next pseudo-random number
  * 
@@ -44,8 +178,12 @@ synth_err synthPRNG_init(synthPRNGCtx *pCtx, unsigned int seed) {
     pCtx->c = 0x3c6ef35f;
     pCtx->seed = seed;
 
-    /* Set the noise type to Box-Muller */
-    pCtx->type = NW_BOXMULLER;
+    /* Noises are keyed by the seed, so they don't depend on the PRNG state */
+    pCtx->key = seed;
+    memset(&(pCtx->noiseParams), 0x0, sizeof(union stPRNGParams));
+
+    /* Set the noise type to the ziggurat (which is faster than Box-Muller) */
+    pCtx->type = NW_ZIGGURAT;
 
     /* Advance the internal state because... why not? */
     synthPRNG_iterate(pCtx);
@@ -122,45 +260,301 @@ __err:
 }
 
 /**
- * Generate points for a gaussian white noise
+ * Scramble a 32 bits value (Chris Wellons' "lowbias32" mixer); Every bit of the
+ * input affects every bit of the output
  * 
- * @param  [out]pVal The generated noise, in range [-1.0, 1.0]
- * @param  [ in]pCtx The contx
- * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ * @param  [ in]x The value
+ * @return        The scrambled value
  */
-synth_err synthPRNG_getGaussianNoise(double *pVal, synthPRNGCtx *pCtx) {
-    synth_err rv;
+static unsigned int synthPRNG_mix(unsigned int x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+
+    return x;
+}
 
-    /* Sanitize the arguments */
-    SYNTH_ASSERT_ERR(pVal, SYNTH_BAD_PARAM_ERR);
-    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+/**
+ * Calculate the base of a noise stream, from which each of its values is
+ * generated; The track is scrambled before the note is added, so swapping
+ * both selects another stream
+ * 
+ * @param  [ in]pCtx  The context
+ * @param  [ in]track The stream's track
+ * @param  [ in]note  The stream's note, within its track
+ * @return            The stream's base
+ */
+static unsigned int synthPRNG_getStreamBase(synthPRNGCtx *pCtx,
+        unsigned int track, unsigned int note) {
+    return synthPRNG_mix(pCtx->key ^ synthPRNG_mix(synthPRNG_mix(track +
+            SYNTHPRNG_GAMMA) + note));
+}
 
-    if (pCtx->type == NW_BOXMULLER) {
-        struct stBoxMullerParams  *pParams;
+/**
+ * Generate the random value at a given position of a stream; Just like
+ * SplitMix, the counter is advanced by a constant and scrambled, so any value
+ * may be generated directly
+ * 
+ * @param  [ in]base    The stream's base
+ * @param  [ in]counter The value's position in the stream
+ * @return              The generated value
+ */
+static unsigned int synthPRNG_getCounter(unsigned int base,
+        unsigned int counter) {
+    return synthPRNG_mix(base + counter * SYNTHPRNG_GAMMA);
+}
 
-        pParams = &(pCtx->noiseParams.boxMuller);
+/**
+ * Convert a random value into the range (0.0, 1.0), so its logarithm may be
+ * safely taken
+ * 
+ * @param  [ in]val The random value
+ * @return          The converted value
+ */
+static double synthPRNG_toOpenDouble(unsigned int val) {
+    return ((double)val + 0.5) / 4294967296.0;
+}
 
-        if (pParams->didGenerate) {
-            *pVal = pParams->z1;
-            pParams->didGenerate = 0;
+/**
+ * Generate a normally distributed value with the ziggurat method
+ * 
+ * Almost every sample (~99%) only requires a single random value, a
+ * multiplication and a comparison; Only samples that fall on a layer's edge or
+ * on the tail use 'exp' or 'log' (and extra random values, derived from the
+ * first one)
+ * 
+ * @param  [ in]draw Random value for the sample
+ * @return           The generated value (with unit variance)
+ */
+static double synthPRNG_getZiggurat(unsigned int draw) {
+    unsigned int state;
+
+    state = draw;
+    while (1) {
+        unsigned int mag;
+        double x;
+        int i, hz;
+
+        /* As in the original method, the layer is selected by the least
+         * significant bits */
+        i = draw & (SYNTHPRNG_ZIGGURAT_LAYERS - 1);
+        hz = (int)draw;
+
+        /* Avoid 'abs', as it would overflow on INT_MIN */
+        mag = (hz < 0) ? 0u - (unsigned int)hz : (unsigned int)hz;
+        x = hz * __synthPRNG_zigguratW[i];
+
+        if (mag < __synthPRNG_zigguratK[i]) {
+            /* Inside the layer's rectangle */
+            return x;
         }
-        else {
-            double u1, u2;
+        else if (i == 0) {
+            double y;
 
+            /* Sample from the tail */
             do {
-                synthPRNG_getDouble(&u1, pCtx);
-                synthPRNG_getDouble(&u2, pCtx);
-            } while (u1 <= DBL_MIN);
+                state += SYNTHPRNG_SUBGAMMA;
+                x = -log(synthPRNG_toOpenDouble(synthPRNG_mix(state))) /
+                        SYNTHPRNG_ZIGGURAT_R;
+                state += SYNTHPRNG_SUBGAMMA;
+                y = -log(synthPRNG_toOpenDouble(synthPRNG_mix(state)));
+            } while (y + y < x * x);
+
+            if (hz > 0) {
+                return SYNTHPRNG_ZIGGURAT_R + x;
+            }
+            return -SYNTHPRNG_ZIGGURAT_R - x;
+        }
+
+        state += SYNTHPRNG_SUBGAMMA;
+        if (__synthPRNG_zigguratF[i] +
+                synthPRNG_toOpenDouble(synthPRNG_mix(state)) *
+                (__synthPRNG_zigguratF[i - 1] - __synthPRNG_zigguratF[i]) <
+                exp(-0.5 * x * x)) {
+            /* Between the rectangle and the curve, but under the latter */
+            return x;
+        }
 
-            pParams->z0 = sqrt(-2.0 * log(u1)) * cos(TAU * u2);
-            pParams->z1 = sqrt(-2.0 * log(u1)) * sin(TAU * u2);
+        /* Otherwise, reject it and try again */
+        state += SYNTHPRNG_SUBGAMMA;
+        draw = synthPRNG_mix(state);
+    }
+}
+
+/**
+ * Generate a normally distributed value with the Box-Muller transform
+ * 
+ * Each pair of positions shares its random values, so the last pair is kept
+ * and the transform is calculated only once for both
+ * 
+ * @param  [ in]pCtx     The context
+ * @param  [ in]base     The stream's base
+ * @param  [ in]position The value's position in the stream
+ * @return               The generated value (with unit variance)
+ */
+static double synthPRNG_getBoxMuller(synthPRNGCtx *pCtx, unsigned int base,
+        int position) {
+    struct stBoxMullerParams *pParams;
+
+    pParams = &(pCtx->noiseParams.boxMuller);
+
+    if (!pParams->didGenerate || pParams->base != base ||
+            pParams->pair != position / 2) {
+        unsigned int draw;
+        double u1, u2;
+
+        draw = synthPRNG_getCounter(base, (unsigned int)(position / 2));
+        u1 = synthPRNG_toOpenDouble(draw);
+        u2 = synthPRNG_toOpenDouble(synthPRNG_mix(draw + SYNTHPRNG_SUBGAMMA));
+
+        pParams->z0 = sqrt(-2.0 * log(u1)) * cos(TAU * u2);
+        pParams->z1 = sqrt(-2.0 * log(u1)) * sin(TAU * u2);
+        pParams->base = base;
+        pParams->pair = position / 2;
+        pParams->didGenerate = 1;
+    }
+
+    if (position % 2 == 0) {
+        return pParams->z0;
+    }
+    return pParams->z1;
+}
 
-            *pVal = pParams->z0;
-            pParams->didGenerate = 1;
+/**
+ * Generate a uniformly distributed value with a (xorshift) linear-feedback
+ * shift register
+ * 
+ * The register is reseeded (from the stream) every 256 values, so any position
+ * may be reached by advancing it less than 256 times; Sequential positions
+ * simply advance the kept register
+ * 
+ * The value has the same RMS as the gaussian noise (after it's converted to
+ * the noise's range), so both sound just as loud
+ * 
+ * @param  [ in]pCtx     The context (must be using the LFSR)
+ * @param  [ in]base     The stream's base
+ * @param  [ in]position The value's position in the stream
+ * @return               The generated value, in range [-0.2585, 0.2585]
+ */
+static double synthPRNG_getLFSR(synthPRNGCtx *pCtx, unsigned int base,
+        int position) {
+    struct stLFSRParams *pParams;
+    unsigned int state;
+
+    pParams = &(pCtx->noiseParams.lfsr);
+
+    if (!pParams->isValid || pParams->base != base ||
+            pParams->position != position || position % 256 == 0) {
+        int i;
+
+        /* The register must never be 0, otherwise it would stay at 0 */
+        pParams->state = synthPRNG_getCounter(base,
+                (unsigned int)(position / 256)) | 1;
+        pParams->base = base;
+        pParams->isValid = 1;
+
+        i = position % 256;
+        while (i > 0) {
+            state = pParams->state;
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            pParams->state = state;
+            i--;
         }
+    }
+
+    state = pParams->state;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    pParams->state = state;
+    pParams->position = position + 1;
+
+    /* A uniform distribution in [-A, A] has RMS A / sqrt(3); So, to match the
+     * gaussian's (1 / 6.7), A = sqrt(3) / 6.7 */
+    return (int)state * (0.2585 / 2147483648.0);
+}
+
+/**
+ * Select how noises are generated
+ * 
+ * @param  [ in]pCtx The context
+ * @param  [ in]type The noise generator
+ * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthPRNG_setNoiseType(synthPRNGCtx *pCtx,
+        enum enNoiseWaveType type) {
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(type == NW_BOXMULLER || type == NW_ZIGGURAT ||
+            type == NW_LFSR, SYNTH_BAD_PARAM_ERR);
 
-        /* Convert it to the desired range */
-        *pVal = (*pVal) / 6.7;
+    pCtx->type = type;
+    memset(&(pCtx->noiseParams), 0x0, sizeof(union stPRNGParams));
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Generate a span of a white noise (gaussian, unless the LFSR was selected)
+ * 
+ * The noise is counter-based: Each value depends only on the context's key,
+ * the stream (i.e., the track and the note within that track) and its
+ * position within the stream. So, any span may be generated independently
+ * (e.g., by another thread or while rendering only part of a note) and still
+ * be exactly the same, regardless of where the song was placed in the context
+ * 
+ * @param  [out]pBuf     The generated noise, in range [-1.0, 1.0]
+ * @param  [ in]num      How many values should be generated
+ * @param  [ in]pCtx     The context
+ * @param  [ in]track    Position of the track within its song
+ * @param  [ in]note     Position of the note within its track
+ * @param  [ in]position Position of the first value within the stream
+ * @return               SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthPRNG_getNoise(double *pBuf, int num, synthPRNGCtx *pCtx,
+        unsigned int track, unsigned int note, int position) {
+    unsigned int base;
+    int i;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(num >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx->isInit, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(position >= 0, SYNTH_BAD_PARAM_ERR);
+
+    base = synthPRNG_getStreamBase(pCtx, track, note);
+
+    i = 0;
+    if (pCtx->type == NW_ZIGGURAT) {
+        while (i < num) {
+            /* Convert it to the desired range */
+            pBuf[i] = synthPRNG_getZiggurat(synthPRNG_getCounter(base,
+                    (unsigned int)(position + i))) / 6.7;
+            i++;
+        }
+    }
+    else if (pCtx->type == NW_BOXMULLER) {
+        while (i < num) {
+            /* Convert it to the desired range */
+            pBuf[i] = synthPRNG_getBoxMuller(pCtx, base, position + i) / 6.7;
+            i++;
+        }
+    }
+    else if (pCtx->type == NW_LFSR) {
+        while (i < num) {
+            pBuf[i] = synthPRNG_getLFSR(pCtx, base, position + i);
+            i++;
+        }
     }
     else {
         SYNTH_ASSERT_ERR(0, SYNTH_FUNCTION_NOT_IMPLEMENTED);
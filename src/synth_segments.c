@@ -0,0 +1,522 @@
+/**
+ * @file src/synth_segments.c
+ *
+ * Render a song's notes only once, playing its loops back from a list of
+ * segments
+ *
+ * Every track is rendered as its sequence of notes (each one exactly once, in
+ * order) and a list of segments, each one a span of those samples and how many
+ * times it's repeated. Loops whose body is a single segment simply multiply its
+ * repetitions, while other loops repeat the body's segments (but never its
+ * samples). So, a song takes as much memory as its unique material, instead of
+ * its unrolled length.
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_audio.h>
+#include <c_synth_internal/synth_cache.h>
+#include <c_synth_internal/synth_list.h>
+#include <c_synth_internal/synth_mixer.h>
+#include <c_synth_internal/synth_note.h>
+#include <c_synth_internal/synth_segments.h>
+#include <c_synth_internal/synth_track.h>
+#include <c_synth_internal/synth_types.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Append a segment to a track, expanding the list as necessary
+ *
+ * @param  [ in]pSegTrack The track
+ * @param  [ in]offset    First sample of the segment
+ * @param  [ in]len       Length of the segment, in samples
+ * @param  [ in]repeat    How many times the segment is played
+ * @return                SYNTH_OK, SYNTH_MEM_ERR
+ */
+static synth_err synthSegments_append(synthSegmentTrack *pSegTrack, int offset,
+        int len, int repeat) {
+    synthSegment *pSegment;
+    synth_err rv;
+
+    if (pSegTrack->numSegments >= pSegTrack->lenSegments) {
+        synthSegment *pSegments;
+
+        pSegments = (synthSegment*)realloc(pSegTrack->pSegments,
+                (1 + pSegTrack->lenSegments * 2) * sizeof(synthSegment));
+        SYNTH_ASSERT_ERR(pSegments, SYNTH_MEM_ERR);
+
+        pSegTrack->pSegments = pSegments;
+        pSegTrack->lenSegments += 1 + pSegTrack->lenSegments;
+    }
+
+    pSegment = &(pSegTrack->pSegments[pSegTrack->numSegments]);
+    pSegment->offset = offset;
+    pSegment->len = len;
+    pSegment->repeat = repeat;
+    pSegTrack->numSegments++;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Render every note of a track and build the segments that play it back
+ *
+ * @param  [ in]pSegTrack The segmented track
+ * @param  [ in]pTrack    The track
+ * @param  [ in]track     Position of the track within its song
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pPRNG     Pseudo-random number generator used by noises
+ * @param  [ in]pCache    Cache of rendered notes (may be NULL)
+ * @param  [ in]mode      Desired mode for the song
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
+ */
+static synth_err synthSegments_initTrack(synthSegmentTrack *pSegTrack,
+        synthTrack *pTrack, int track, synthCtx *pCtx, synthPRNGCtx *pPRNG,
+        synthCache *pCache, synthBufMode mode) {
+    char *pIsTarget;
+    int *pFirstSegment;
+    int i, canMerge, numBytes, pos;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pIsTarget = 0;
+    pFirstSegment = 0;
+
+    /* Calculate the number of bytes per samples */
+    numBytes = 1;
+    if (mode & SYNTH_16BITS) {
+        numBytes = 2;
+    }
+    if (mode & SYNTH_2CHAN) {
+        numBytes *= 2;
+    }
+
+    /* '+1' so nothing is ever alloc'ed with 0 bytes */
+    pFirstSegment = (int*)malloc((pTrack->num + 1) * sizeof(int));
+    SYNTH_ASSERT_ERR(pFirstSegment, SYNTH_MEM_ERR);
+    pIsTarget = (char*)calloc(pTrack->num + 1, sizeof(char));
+    SYNTH_ASSERT_ERR(pIsTarget, SYNTH_MEM_ERR);
+
+    /* Mark every note that starts a loop (or where the track loops back to),
+     * since those must start a new segment */
+    i = 0;
+    while (i < pTrack->num) {
+        synthNote *pNote;
+
+        pNote = SYNTH_NOTE(pCtx, pTrack->notesIndex + i);
+        if (synthNote_isLoop(pNote) == SYNTH_TRUE) {
+            synthLoop *pLoop;
+
+            rv = synthTrack_getLoop(&pLoop, pTrack, pCtx, pNote);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            pIsTarget[pLoop->jumpPosition] = 1;
+        }
+        i++;
+    }
+    if (synthTrack_isLoopable(pTrack) == SYNTH_TRUE) {
+        pIsTarget[pTrack->loopPoint] = 1;
+    }
+
+    /* Every note's length was already cached when the track was compiled */
+    pSegTrack->dataLen = 0;
+    i = 0;
+    while (i < pTrack->num) {
+        synthNote *pNote;
+
+        pNote = SYNTH_NOTE(pCtx, pTrack->notesIndex + i);
+        if (synthNote_isLoop(pNote) != SYNTH_TRUE) {
+            int duration;
+
+            rv = synthNote_getSamplesDuration(&duration, pNote);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            pSegTrack->dataLen += duration;
+        }
+        i++;
+    }
+
+    pSegTrack->pData = (char*)malloc(pSegTrack->dataLen * numBytes + 1);
+    SYNTH_ASSERT_ERR(pSegTrack->pData, SYNTH_MEM_ERR);
+
+    /* Render each note (in order) and build the segments */
+    canMerge = 0;
+    pos = 0;
+    i = 0;
+    while (i < pTrack->num) {
+        synthNote *pNote;
+
+        pNote = SYNTH_NOTE(pCtx, pTrack->notesIndex + i);
+        pFirstSegment[i] = pSegTrack->numSegments;
+
+        if (synthNote_isLoop(pNote) == SYNTH_TRUE) {
+            synthLoop *pLoop;
+            int count, first, jumpPosition, repeatCount;
+
+            rv = synthTrack_getLoop(&pLoop, pTrack, pCtx, pNote);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            repeatCount = pLoop->repeat;
+            jumpPosition = pLoop->jumpPosition;
+
+            /* The loop's body was already played once */
+            first = pFirstSegment[jumpPosition];
+            count = pSegTrack->numSegments - first;
+            if (count == 1) {
+                pSegTrack->pSegments[first].repeat *= repeatCount;
+            }
+            else if (count > 1) {
+                int j;
+
+                j = 1;
+                while (j < repeatCount) {
+                    int k;
+
+                    k = 0;
+                    while (k < count) {
+                        synthSegment *pSegment;
+
+                        pSegment = &(pSegTrack->pSegments[first + k]);
+                        rv = synthSegments_append(pSegTrack, pSegment->offset,
+                                pSegment->len, pSegment->repeat);
+                        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+                        k++;
+                    }
+                    j++;
+                }
+            }
+
+            /* Whatever comes after the loop must be in another segment */
+            canMerge = 0;
+        }
+        else {
+            synthSegment *pLast;
+            int duration;
+
+            rv = synthNote_getSamplesDuration(&duration, pNote);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+            rv = synthCache_render(pSegTrack->pData + pos * numBytes, pCache,
+                    pNote, pCtx, pPRNG, track, i, mode, duration);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+            /* Extend the previous segment, if it's right before this note */
+            pLast = 0;
+            if (canMerge && !pIsTarget[i]) {
+                pLast = &(pSegTrack->pSegments[pSegTrack->numSegments - 1]);
+            }
+            if (pLast && pLast->repeat == 1 &&
+                    pLast->offset + pLast->len == pos) {
+                pLast->len += duration;
+            }
+            else {
+                rv = synthSegments_append(pSegTrack, pos, duration, 1);
+                SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            }
+
+            canMerge = 1;
+            pos += duration;
+        }
+
+        i++;
+    }
+
+    /* Only loop if there's actually something to be looped */
+    pSegTrack->canLoop = 0;
+    if (synthTrack_isLoopable(pTrack) == SYNTH_TRUE &&
+            pTrack->loopPoint < pTrack->num) {
+        int intro, len;
+
+        rv = synthTrack_getLength(&len, pTrack, pCtx);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        rv = synthTrack_getIntroLength(&intro, pTrack, pCtx);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        pSegTrack->canLoop = (len > intro);
+        pSegTrack->loopSegment = pFirstSegment[pTrack->loopPoint];
+    }
+
+    rv = SYNTH_OK;
+__err:
+    if (pFirstSegment) {
+        free(pFirstSegment);
+    }
+    if (pIsTarget) {
+        free(pIsTarget);
+    }
+
+    return rv;
+}
+
+/**
+ * Render every note of a song (but only once) and build the segments that play
+ * each of its tracks back
+ *
+ * @param  [out]ppSegments The new segmented song
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]pPRNG      Pseudo-random number generator used by noises
+ * @param  [ in]pCache     Cache of rendered notes (may be NULL)
+ * @param  [ in]handle     Handle of the audio
+ * @param  [ in]mode       Desired mode for the song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_INVALID_INDEX,
+ *                         SYNTH_MEM_ERR
+ */
+synth_err synthSegments_init(synthSegments **ppSegments, synthCtx *pCtx,
+        synthPRNGCtx *pPRNG, synthCache *pCache, int handle,
+        synthBufMode mode) {
+    int i;
+    synthAudio *pAudio;
+    synthSegments *pSegments;
+    synth_err rv;
+
+    /* Clean the segments, so it's not freed on error */
+    pSegments = 0;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppSegments, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pPRNG, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(handle >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR((mode & SYNTH_VALID_MODE_MASK) != 0, SYNTH_BAD_PARAM_ERR);
+    /* Check that the handle is valid */
+    rv = synthAudio_getFromHandle(&pAudio, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Alloc the song and its tracks in a single block */
+    pSegments = (synthSegments*)calloc(1, sizeof(synthSegments) +
+            sizeof(synthSegmentTrack) * pAudio->num);
+    SYNTH_ASSERT_ERR(pSegments, SYNTH_MEM_ERR);
+
+    pSegments->handle = handle;
+    pSegments->mode = mode;
+    pSegments->numTracks = pAudio->num;
+    pSegments->pTracks = (synthSegmentTrack*)(pSegments + 1);
+
+    i = 0;
+    while (i < pAudio->num) {
+        rv = synthSegments_initTrack(&(pSegments->pTracks[i]),
+                SYNTH_TRACK(pCtx, pAudio->tracksIndex + i), i, pCtx,
+                pPRNG, pCache, mode);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        i++;
+    }
+
+    rv = synthSegments_reset(pSegments);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    *ppSegments = pSegments;
+    pSegments = 0;
+    rv = SYNTH_OK;
+__err:
+    if (pSegments) {
+        synthSegments_free(&pSegments);
+    }
+
+    return rv;
+}
+
+/**
+ * Place every track back at the start of the song
+ *
+ * @param  [ in]pSegments The segmented song
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthSegments_reset(synthSegments *pSegments) {
+    int i;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pSegments, SYNTH_BAD_PARAM_ERR);
+
+    i = 0;
+    while (i < pSegments->numTracks) {
+        synthSegmentTrack *pSegTrack;
+
+        pSegTrack = &(pSegments->pTracks[i]);
+        pSegTrack->segment = 0;
+        pSegTrack->iteration = 0;
+        pSegTrack->position = 0;
+        pSegTrack->isDone = (pSegTrack->numSegments == 0);
+
+        i++;
+    }
+    pSegments->position = 0;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Release all memory alloc'ed by a segmented song
+ *
+ * @param  [ in]ppSegments The segmented song
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthSegments_free(synthSegments **ppSegments) {
+    int i;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppSegments, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(*ppSegments, SYNTH_BAD_PARAM_ERR);
+
+    i = 0;
+    while (i < (*ppSegments)->numTracks) {
+        synthSegmentTrack *pSegTrack;
+
+        pSegTrack = &((*ppSegments)->pTracks[i]);
+        if (pSegTrack->pData) {
+            free(pSegTrack->pData);
+        }
+        if (pSegTrack->pSegments) {
+            free(pSegTrack->pSegments);
+        }
+
+        i++;
+    }
+
+    /* The tracks were alloc'ed with the song itself */
+    free(*ppSegments);
+    *ppSegments = 0;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve how many bytes are used by a segmented song
+ *
+ * @param  [out]pBytes    The size of the rendered notes and of every segment
+ * @param  [ in]pSegments The segmented song
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthSegments_getSize(int *pBytes, synthSegments *pSegments) {
+    int i, numBytes, size;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBytes, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pSegments, SYNTH_BAD_PARAM_ERR);
+
+    /* Calculate the number of bytes per samples */
+    numBytes = 1;
+    if (pSegments->mode & SYNTH_16BITS) {
+        numBytes = 2;
+    }
+    if (pSegments->mode & SYNTH_2CHAN) {
+        numBytes *= 2;
+    }
+
+    size = sizeof(synthSegments) +
+            sizeof(synthSegmentTrack) * pSegments->numTracks;
+    i = 0;
+    while (i < pSegments->numTracks) {
+        synthSegmentTrack *pSegTrack;
+
+        pSegTrack = &(pSegments->pTracks[i]);
+        size += pSegTrack->dataLen * numBytes;
+        size += pSegTrack->lenSegments * sizeof(synthSegment);
+
+        i++;
+    }
+
+    *pBytes = size;
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Play the next samples of a segmented song, mixing all of its tracks
+ *
+ * Looping tracks go back to their loop point once they end; Tracks that don't
+ * loop output silence after ending
+ *
+ * @param  [ in]pBuf       Buffer that will be filled with 'numSamples'
+ * @param  [ in]pSegments  The segmented song
+ * @param  [ in]numSamples How many samples should be played
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthSegments_render(char *pBuf, synthSegments *pSegments,
+        int numSamples) {
+    int i, numBytes;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pSegments, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(numSamples >= 0, SYNTH_BAD_PARAM_ERR);
+
+    /* Calculate the number of bytes per samples */
+    numBytes = 1;
+    if (pSegments->mode & SYNTH_16BITS) {
+        numBytes = 2;
+    }
+    if (pSegments->mode & SYNTH_2CHAN) {
+        numBytes *= 2;
+    }
+
+    /* Clear the output buffer so every track can be accumulated into it */
+    memset(pBuf, 0x0, numSamples * numBytes);
+
+    i = 0;
+    while (i < pSegments->numTracks) {
+        synthSegmentTrack *pSegTrack;
+        int len;
+
+        pSegTrack = &(pSegments->pTracks[i]);
+
+        /* Mix each segment straight from the rendered notes */
+        len = 0;
+        while (len < numSamples && !pSegTrack->isDone) {
+            synthSegment *pSegment;
+            int count;
+
+            pSegment = &(pSegTrack->pSegments[pSegTrack->segment]);
+
+            count = pSegment->len - pSegTrack->position;
+            if (count > numSamples - len) {
+                count = numSamples - len;
+            }
+
+            synthMixer_accumulate(pBuf + len * numBytes, pSegTrack->pData +
+                    (pSegment->offset + pSegTrack->position) * numBytes,
+                    pSegments->mode, count);
+
+            len += count;
+            pSegTrack->position += count;
+
+            /* Move to the next iteration (or segment), if this one ended */
+            if (pSegTrack->position >= pSegment->len) {
+                pSegTrack->position = 0;
+                pSegTrack->iteration++;
+            }
+            if (pSegTrack->iteration >= pSegment->repeat) {
+                pSegTrack->iteration = 0;
+                pSegTrack->segment++;
+            }
+            if (pSegTrack->segment >= pSegTrack->numSegments) {
+                if (pSegTrack->canLoop) {
+                    pSegTrack->segment = pSegTrack->loopSegment;
+                }
+                else {
+                    pSegTrack->isDone = 1;
+                }
+            }
+        }
+
+        i++;
+    }
+
+    pSegments->position += numSamples;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
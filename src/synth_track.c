@@ -7,11 +7,14 @@
 #include <c_synth/synth_assert.h>
 #include <c_synth/synth_errors.h>
 
+#include <c_synth_internal/synth_cache.h>
+#include <c_synth_internal/synth_list.h>
 #include <c_synth_internal/synth_note.h>
 #include <c_synth_internal/synth_track.h>
 #include <c_synth_internal/synth_renderer.h>
 #include <c_synth_internal/synth_types.h>
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -29,145 +32,318 @@ synth_err synthTrack_init(synthTrack **ppTrack, synthCtx *pCtx) {
     SYNTH_ASSERT_ERR(ppTrack, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
 
-    /* Make sure there's enough space for another track */
-    SYNTH_ASSERT_ERR(pCtx->tracks.max == 0 ||
-            pCtx->tracks.used < pCtx->tracks.max, SYNTH_MEM_ERR);
-
-    /* Expand the array as necessary */
-    if (pCtx->tracks.used >= pCtx->tracks.len) {
-        /* 'Double' the current buffer; Note that this will never be called if
-         * the context was pre-alloc'ed, since 'max' will be set; The '+1' is
-         * for the first audio, in which len will be 0 */
-        pCtx->tracks.buf.pTracks = (synthTrack*)realloc(
-                pCtx->tracks.buf.pTracks, (1 + pCtx->tracks.len * 2) *
-                sizeof(synthTrack));
-        SYNTH_ASSERT_ERR(pCtx->tracks.buf.pTracks, SYNTH_MEM_ERR);
-        /* Clear only the new part of the buffer */
-        memset(&(pCtx->tracks.buf.pTracks[pCtx->tracks.used]), 0x0,
-                (1 + pCtx->tracks.len) * sizeof(synthTrack));
-        /* Actually increase the buffer length */
-        pCtx->tracks.len += 1 + pCtx->tracks.len;
-    }
-
-    /* Retrieve the next track */
-    *ppTrack = &(pCtx->tracks.buf.pTracks[pCtx->tracks.used]);
-    pCtx->tracks.used++;
+    /* Retrieve the next track (expanding the list as necessary) */
+    rv = synthList_append((void**)ppTrack, &(pCtx->tracks),
+            sizeof(synthTrack));
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     /* Initialize the track as not being looped and without any notes */
     (*ppTrack)->loopPoint = -1;
     (*ppTrack)->notesIndex = pCtx->notes.used;
+    (*ppTrack)->loopsIndex = pCtx->loops.used;
 
     rv = SYNTH_OK;
 __err:
     return rv;
 }
 
-/* !!!WARNING!!! This functions calls 'synthTrack_countSample', which in turn
- * MAY call this function back. Since the song is parsed from a file or from a
- * string it's guaranteed to end and there should be no infinite loops.
+/**
+ * Calculate and cache the length of every note in a track
+ * 
+ * Lengths are calculated in the exact same order as the track was originally
+ * rendered (i.e., from the last note to the first one, and only once for each
+ * loop's body), so every note keeps the length it would have had if the
+ * compass were tracked while rendering; Since every loop's body is visited
+ * only once, the loop notes themselves may simply be skipped
  * 
- * However, beware that "bad things may happen"... */
-static synth_err synthTrack_getLoopLength(int *pLen, synthTrack *pTrack,
-        synthCtx *pCtx, int pos);
+ * @param  [ in]pTrack    The track
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pRenderer Keeps track of the compass
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_COMPASS_OVERFLOW
+ */
+static synth_err synthTrack_cacheDurations(synthTrack *pTrack, synthCtx *pCtx,
+        synthRendererCtx *pRenderer) {
+    int i;
+    synth_err rv;
+
+    i = pTrack->num - 1;
+    while (i >= 0) {
+        synthNote *pNote;
+
+        pNote = SYNTH_NOTE(pCtx, pTrack->notesIndex + i);
+
+        if (synthNote_isLoop(pNote) != SYNTH_TRUE) {
+            int len;
+
+            rv = synthRenderer_getNoteLengthAndUpdate(&len, pRenderer, pNote);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            rv = synthNote_setSamplesDuration(pNote, len);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        }
+
+        i--;
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
 
 /**
- * Loop through some notes and accumulate their samples
+ * Append a loop to the context's loop table, expanding it as necessary
  * 
- * This was mostly done to avoid repeating the loop count, thus all
- * verifications are done in previous calls
+ * @param  [ in]pCtx         The synthesizer context
+ * @param  [ in]position     Position of the loop note within its track
+ * @param  [ in]jumpPosition Position of the loop's first note
+ * @param  [ in]repeat       How many times the loop's body is played
+ * @param  [ in]length       Length of a single pass through the body
+ * @return                   SYNTH_OK, SYNTH_MEM_ERR
+ */
+static synth_err synthTrack_appendLoop(synthCtx *pCtx, int position,
+        int jumpPosition, int repeat, int length) {
+    synthLoop *pLoop;
+    synth_err rv;
+
+    /* Make sure there's enough space for another loop */
+    SYNTH_ASSERT_ERR(pCtx->loops.max == 0 ||
+            pCtx->loops.used < pCtx->loops.max, SYNTH_MEM_ERR);
+
+    /* Expand the array as necessary */
+    if (pCtx->loops.used >= pCtx->loops.len) {
+        synthLoop *pLoops;
+
+        pLoops = (synthLoop*)realloc(pCtx->loops.buf.pLoops,
+                (1 + pCtx->loops.len * 2) * sizeof(synthLoop));
+        SYNTH_ASSERT_ERR(pLoops, SYNTH_MEM_ERR);
+
+        pCtx->loops.buf.pLoops = pLoops;
+        pCtx->loops.len += 1 + pCtx->loops.len;
+    }
+
+    pLoop = &(pCtx->loops.buf.pLoops[pCtx->loops.used]);
+    pLoop->position = position;
+    pLoop->jumpPosition = jumpPosition;
+    pLoop->repeat = repeat;
+    pLoop->length = length;
+    pCtx->loops.used++;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Add a loop to the track's loop table; Since tracks are parsed one at a time,
+ * it must be the last track of the context
  * 
- * Also, don't forget that the loop is done in inverse order, from the last note
- * to the first. So, initialPos must always be greater than finalPosition
+ * Its length is only calculated when the track is compiled (see
+ * 'synthTrack_cacheLengths')
  * 
- * @param  [out]pLen         The length of the track in samples
+ * @param  [out]pLoop        Index of the loop within the track's loop table
  * @param  [ in]pTrack       The track
  * @param  [ in]pCtx         The synthesizer context
- * @param  [ in]initalPos    Initial position (inclusive)
- * @param  [ in]finalPos     Final position (inclusive)
- * @return                   SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ * @param  [ in]position     Position of the loop note within the track
+ * @param  [ in]jumpPosition Position of the loop's first note
+ * @param  [ in]repeat       How many times the loop's body is played
+ * @return                   SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
  */
-static synth_err synthTrack_countSample(int *pLen, synthTrack *pTrack,
-        synthCtx *pCtx, int initialPos, int finalPosition) {
-    int i, len;
-    synthNote *pNote;
+synth_err synthTrack_addLoop(int *pLoop, synthTrack *pTrack, synthCtx *pCtx,
+        int position, int jumpPosition, int repeat) {
     synth_err rv;
 
-    len = 0;
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pLoop, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pTrack, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pTrack->loopsIndex + pTrack->loopsNum == pCtx->loops.used,
+            SYNTH_BAD_PARAM_ERR);
 
-    /* Simply loop though all notes */
-    i = initialPos;
-    while (i >= finalPosition) {
-        int tmp;
+    rv = synthTrack_appendLoop(pCtx, position, jumpPosition, repeat, 0);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-        /* Retrieve the current note */
-        pNote = &(pCtx->notes.buf.pNotes[pTrack->notesIndex + i]);
+    *pLoop = pTrack->loopsNum;
+    pTrack->loopsNum++;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve the loop (from the track's loop table) of a loop note
+ * 
+ * @param  [out]ppLoop The loop
+ * @param  [ in]pTrack The track
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]pNote  The loop note
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthTrack_getLoop(synthLoop **ppLoop, synthTrack *pTrack,
+        synthCtx *pCtx, synthNote *pNote) {
+    int loop;
+    synth_err rv;
+
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(ppLoop, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pTrack, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+
+    rv = synthNote_getLoop(&loop, pNote);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    SYNTH_ASSERT_ERR(loop < pTrack->loopsNum, SYNTH_BAD_PARAM_ERR);
+
+    *ppLoop = &(pCtx->loops.buf.pLoops[pTrack->loopsIndex + loop]);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Append an entry to the context's timeline, expanding it as necessary
+ * 
+ * @param  [ in]pCtx  The synthesizer context
+ * @param  [ in]start First sample of the entry
+ * @return            SYNTH_OK, SYNTH_MEM_ERR
+ */
+static synth_err synthTrack_appendTimeline(synthCtx *pCtx, int start) {
+    synth_err rv;
+
+    /* Make sure there's enough space for another entry */
+    SYNTH_ASSERT_ERR(pCtx->timeline.max == 0 ||
+            pCtx->timeline.used < pCtx->timeline.max, SYNTH_MEM_ERR);
+
+    /* Expand the array as necessary */
+    if (pCtx->timeline.used >= pCtx->timeline.len) {
+        synthTimelineEntry *pTimeline;
+
+        pTimeline = (synthTimelineEntry*)realloc(pCtx->timeline.buf.pTimeline,
+                (1 + pCtx->timeline.len * 2) * sizeof(synthTimelineEntry));
+        SYNTH_ASSERT_ERR(pTimeline, SYNTH_MEM_ERR);
+
+        pCtx->timeline.buf.pTimeline = pTimeline;
+        pCtx->timeline.len += 1 + pCtx->timeline.len;
+    }
+
+    pCtx->timeline.buf.pTimeline[pCtx->timeline.used].start = start;
+    pCtx->timeline.used++;
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Calculate the length of the track's loops and build its timeline, so any of
+ * its samples may be quickly found, and cache the track's length and intro
+ * length
+ * 
+ * The timeline has a single entry for each note (and another one for the
+ * track's end), with the sample where the note is first played; A loop note's
+ * entry marks where the loop's body starts being repeated. Thus, the timeline
+ * never takes more memory than the track itself
+ * 
+ * Tracks longer than what fits in an integer are rejected, since their samples
+ * couldn't be addressed anyway
+ * 
+ * @param  [ in]pTrack The track
+ * @param  [ in]pCtx   The synthesizer context
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR,
+ *                     SYNTH_COMPASS_OVERFLOW, SYNTH_BAD_LOOP_COUNT
+ */
+static synth_err synthTrack_cacheTimeline(synthTrack *pTrack, synthCtx *pCtx) {
+    int i, start;
+    synth_err rv;
+
+    pTrack->timelineIndex = pCtx->timeline.used;
+
+    start = 0;
+    i = 0;
+    while (i < pTrack->num) {
+        synthNote *pNote;
+
+        pNote = SYNTH_NOTE(pCtx, pTrack->notesIndex + i);
+
+        rv = synthTrack_appendTimeline(pCtx, start);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-        /* Check if note is a loop */
         if (synthNote_isLoop(pNote) == SYNTH_TRUE) {
-            int pos;
+            synthLoop *pLoop;
 
-            /* Retrieve the length of the loop, in samples (already taking into
-             * account the number of repetitions) */
-            rv = synthTrack_getLoopLength(&tmp, pTrack, pCtx, i);
+            rv = synthTrack_getLoop(&pLoop, pTrack, pCtx, pNote);
             SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-            /* Get the loop destination */
-            rv = synthNote_getJumpPosition(&pos, pNote);
-            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-            /* Update the curent note accordingly */
-            i = pos;
+            /* The loop's body was just played once */
+            pLoop->length = start - pCtx->timeline.buf.pTimeline[
+                    pTrack->timelineIndex + pLoop->jumpPosition].start;
 
-            len += tmp;
+            SYNTH_ASSERT_ERR(pLoop->length == 0 || pLoop->repeat - 1 <=
+                    (INT_MAX - start) / pLoop->length, SYNTH_BAD_LOOP_COUNT);
+            start += pLoop->length * (pLoop->repeat - 1);
         }
         else {
-            /* Accumulate the note duration */
-            rv = synthRenderer_getNoteLengthAndUpdate(&tmp, &(pCtx->renderCtx),
-                    pNote);
+            int len;
+
+            rv = synthNote_getSamplesDuration(&len, pNote);
             SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-            len += tmp;
+            SYNTH_ASSERT_ERR(len >= 0 && len <= INT_MAX - start,
+                    SYNTH_COMPASS_OVERFLOW);
+            start += len;
         }
 
-        i--;
+        i++;
+    }
+    /* Mark the track's end, so every note is followed by an entry */
+    rv = synthTrack_appendTimeline(pCtx, start);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* The loop point is always outside any loop, so it's played only once */
+    pTrack->cachedLength = start;
+    pTrack->cachedLoopPoint = 0;
+    if (pTrack->loopPoint != -1) {
+        pTrack->cachedLoopPoint = pCtx->timeline.buf.pTimeline[
+                pTrack->timelineIndex + pTrack->loopPoint].start;
     }
 
-    *pLen = len;
     rv = SYNTH_OK;
 __err:
     return rv;
 }
 
 /**
- * Count how many samples there are in a loop
+ * Calculate and cache the length of every note in a track, as well as the
+ * track's length, intro length, loops' lengths and timeline
  * 
- * Since loops are recursive, this function may also be called recursively
+ * This must be called once, after the track is compiled, since the lengths are
+ * afterward only ever retrieved from the cache (so neither the track is
+ * modified nor the compass is tracked while rendering)
  * 
- * @param  [out]pLen   The length of the track in samples
- * @param  [ in]pTrack The track
- * @param  [ in]pCtx   The synthesizer context
- * @param  [ in]pos    Position of the loop note
- * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ * @param  [ in]pTrack    The track
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pRenderer Renderer initialized for the track's audio
+ * @return                SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR,
+ *                        SYNTH_COMPASS_OVERFLOW, SYNTH_BAD_LOOP_COUNT
  */
-static synth_err synthTrack_getLoopLength(int *pLen, synthTrack *pTrack,
-        synthCtx *pCtx, int pos) {
-    int jumpPosition, repeatCount;
-    synthNote *pNote;
+synth_err synthTrack_cacheLengths(synthTrack *pTrack, synthCtx *pCtx,
+        synthRendererCtx *pRenderer) {
     synth_err rv;
 
-    /* Retrieve the current note */
-    pNote = &(pCtx->notes.buf.pNotes[pTrack->notesIndex + pos]);
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pTrack, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pRenderer, SYNTH_BAD_PARAM_ERR);
 
-    /* Retrieve the loop attributes */
-    rv = synthNote_getRepeat(&repeatCount, pNote);
+    /* Calculate every note's length from the last note, so it matches the
+     * position of the note within its compass */
+    rv = synthRenderer_resetPosition(pRenderer);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-    rv = synthNote_getJumpPosition(&jumpPosition, pNote);
+    rv = synthTrack_cacheDurations(pTrack, pCtx, pRenderer);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    /* Loop through all notes and calculate the total length */
-    rv = synthTrack_countSample(pLen, pTrack, pCtx, pos - 1, jumpPosition);
+    rv = synthTrack_cacheTimeline(pTrack, pCtx);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-    *pLen *= repeatCount;
     rv = SYNTH_OK;
 __err:
     return rv;
@@ -189,19 +365,6 @@ synth_err synthTrack_getLength(int *pLen, synthTrack *pTrack, synthCtx *pCtx) {
     SYNTH_ASSERT_ERR(pTrack, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
 
-    /* Check if the value has already been calculated */
-    if (pTrack->cachedLength == 0) {
-        int len;
-
-        /* Count from the last note so we can recursivelly calculate all loops
-         * lengths */
-        rv = synthTrack_countSample(&len, pTrack, pCtx, pTrack->num - 1, 0);
-        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
-        /* Cached the length so it can be used later */
-        pTrack->cachedLength = len;
-    }
-
     /* Retrieve the cached length */
     *pLen = pTrack->cachedLength;
 
@@ -227,25 +390,6 @@ synth_err synthTrack_getIntroLength(int *pLen, synthTrack *pTrack,
     SYNTH_ASSERT_ERR(pTrack, SYNTH_BAD_PARAM_ERR);
     SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
 
-    /* Check if the value needs to be calculated */
-    if (pTrack->cachedLoopPoint == 0) {
-        int len;
-
-        /* Count how many samples there are from the loop point to the song
-         * start */
-        if (pTrack->loopPoint != -1) {
-            rv = synthTrack_countSample(&len, pTrack, pCtx,
-                    pTrack->loopPoint - 1, 0);
-            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-        }
-        else {
-            len = 0;
-        }
-
-        /* Cache the value so it can be used later */
-        pTrack->cachedLoopPoint = len;
-    }
-
     /* Retrieve the cached value */
     *pLen = pTrack->cachedLoopPoint;
 
@@ -268,146 +412,257 @@ synth_bool synthTrack_isLoopable(synthTrack *pTrack) {
 }
 
 /**
- * Renders a sequence of notes
+ * Render a full track into a buffer
+ * 
+ * The buffer must be prepared by the caller, and it must have
+ * 'synth_getTrackLength' bytes times the number of bytes per samples
+ * 
+ * Notes are rendered from the first to the last one; Whenever a loop note is
+ * found, its body (which was just rendered) is copied as many times as
+ * necessary, with its length retrieved from the track's loop table. So the
+ * track is rendered in linear time, regardless of how deeply its loops nest
  * 
- * Note that the track is rendered in inverse order, from the last to the first
- * note. Therefore, 'i' must be greater than 'dst' (though it isn't checked!!)
+ * Only 'pPRNG' and 'pCache' are modified, so tracks may be rendered
+ * concurrently
  * 
- * @param  [out]pBytes How many bytes were rendered (so the buffer's position
- *                     can be updated accordingly)
- * @param  [ in]pBuf   End of the buffer to be filled with the rendered sequence
+ * @param  [ in]pBuf   Buffer that will be filled with the track
  * @param  [ in]pTrack The track
+ * @param  [ in]track  Position of the track within its song (which, along
+ *                     with each note's position, selects the noise)
  * @param  [ in]pCtx   The synthesizer context
- * @param  [ in]mode   Current rendering mode
- * @param  [ in]i      Current position into the sequence of notes
- * @param  [ in]dst    Last note to be rendered
- * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR, ...
+ * @param  [ in]pPRNG  Pseudo-random number generator used by noises
+ * @param  [ in]pCache Cache of rendered notes (may be NULL)
+ * @param  [ in]mode   Desired mode for the wave
+ * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
  */
-static synth_err synthTrack_renderSequence(int *pBytes, char *pBuf,
-        synthTrack *pTrack, synthCtx *pCtx, synthBufMode mode, int i, int dst) {
-    int bytes;
+synth_err synthTrack_render(char *pBuf, synthTrack *pTrack, int track,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, synthCache *pCache,
+        synthBufMode mode) {
+    synthLoop *pLoops;
+    int i, numBytes;
     synth_err rv;
 
-    bytes = 0;
+    /* Calculate the number of bytes per samples */
+    numBytes = 1;
+    if (mode & SYNTH_16BITS) {
+        numBytes = 2;
+    }
+    if (mode & SYNTH_2CHAN) {
+        numBytes *= 2;
+    }
+
+    /* Loops are found in the same order as they were added to the table */
+    pLoops = &(pCtx->loops.buf.pLoops[pTrack->loopsIndex]);
 
-    while (i >= dst) {
+    i = 0;
+    while (i < pTrack->num) {
         synthNote *pNote;
 
         /* Retrieve the current note */
-        pNote = &(pCtx->notes.buf.pNotes[pTrack->notesIndex + i]);
+        pNote = SYNTH_NOTE(pCtx, pTrack->notesIndex + i);
 
         /* Check if it's a loop or a common note */
         if (synthNote_isLoop(pNote) == SYNTH_TRUE) {
-            int count, jumpPosition, repeatCount, tmpBytes;
-
-            /* Get the loop parameters */
-            rv = synthNote_getRepeat(&repeatCount, pNote);
-            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-            rv = synthNote_getJumpPosition(&jumpPosition, pNote);
-            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
-
-            /* Render the loop and any sub-loops */
-            rv = synthTrack_renderSequence(&tmpBytes, pBuf, pTrack, pCtx, mode,
-                    i - 1, jumpPosition);
-            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            int bytes, count;
 
-            /* Move the buffer back as many bytes as were rendered */
-            pBuf -= tmpBytes;
+            bytes = pLoops->length * numBytes;
 
-            /* Copy the sequence back into the buffer as many times as
-             * necessary */
+            /* Copy the body (rendered right before the buffer) as many times
+             * as necessary */
             count = 1;
-            while (count < repeatCount) {
-                memcpy(pBuf - tmpBytes, pBuf, tmpBytes);
+            while (count < pLoops->repeat) {
+                memcpy(pBuf, pBuf - bytes, bytes);
+                pBuf += bytes;
                 count++;
-                /* Move the buffer back before the sequence */
-                pBuf -= tmpBytes;
             }
 
-            /* Update the number of bytes rendered */
-            bytes += tmpBytes * repeatCount;
-
-            /* Place the buffer as if it just rendered the last note on the
-             * loop (it will be decreased afterward */
-            i = jumpPosition;
+            pLoops++;
         }
         else {
-            int duration, durationSamples;
+            int duration;
 
             /* Get the note's duration in samples */
-            rv = synthRenderer_getNoteLengthAndUpdate(&durationSamples,
-                    &(pCtx->renderCtx), pNote);
+            rv = synthNote_getSamplesDuration(&duration, pNote);
             SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-            duration = durationSamples;
-            /* Convert the number of samples into bytes */
-            if (mode & SYNTH_16BITS) {
-                duration *= 2;
-            }
-            if (mode & SYNTH_2CHAN) {
-                duration *= 2;
-            }
-
-            /* Place the buffer at the start of the note */
-            pBuf -= duration;
-
-            /* Render the current note */
-            rv = synthNote_render(pBuf, pNote, pCtx, mode, pCtx->frequency, 
-                    durationSamples);
+            /* Render the note (or copy it, if it was already rendered) */
+            rv = synthCache_render(pBuf, pCache, pNote, pCtx, pPRNG, track, i,
+                    mode, duration);
             SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
-            /* Update the amount of bytes rendered */
-            bytes += duration;
+            pBuf += duration * numBytes;
         }
 
-        i--;
+        i++;
     }
 
-    *pBytes = bytes;
     rv = SYNTH_OK;
 __err:
     return rv;
 }
 
 /**
- * Render a full track into a buffer
+ * Find the note playing at a given sample
  * 
- * The buffer must be prepared by the caller, and it must have
- * 'synth_getTrackLength' bytes times the number of bytes per samples
+ * The last entry (on the track's timeline) that starts at or before the sample
+ * is searched; If it's a loop, the sample is within one of the body's repeated
+ * plays, so it's moved back into the first play and the loop's body is
+ * searched. Thus, this takes at most one search for each nested loop
  * 
- * @param  [ in]pBuf   Buffer that will be filled with the track
- * @param  [ in]pTrack The track
- * @param  [ in]pCtx   The synthesizer context
- * @param  [ in]mode   Desired mode for the wave
- * @return             SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ * @param  [out]pNote    Position of the note within the track
+ * @param  [out]pOffset  Sample of the note
+ * @param  [ in]pTrack   The track
+ * @param  [ in]pCtx     The synthesizer context
+ * @param  [ in]position The sample (must be within the track)
  */
-synth_err synthTrack_render(char *pBuf, synthTrack *pTrack, synthCtx *pCtx,
-        synthBufMode mode) {
-    int len, tmp;
+static void synthTrack_seek(int *pNote, int *pOffset, synthTrack *pTrack,
+        synthCtx *pCtx, int position) {
+    synthTimelineEntry *pTimeline;
+    int first, last;
+
+    pTimeline = &(pCtx->timeline.buf.pTimeline[pTrack->timelineIndex]);
+
+    first = 0;
+    last = pTrack->num - 1;
+    while (1) {
+        synthLoop *pLoop;
+        synthNote *pNote;
+        int jumpPosition;
+
+        /* Search the last entry that starts at or before the sample */
+        while (first < last) {
+            int middle;
+
+            /* Round up, so 'first' always moves forward */
+            middle = first + (last - first + 1) / 2;
+            if (pTimeline[middle].start <= position) {
+                first = middle;
+            }
+            else {
+                last = middle - 1;
+            }
+        }
+
+        pNote = SYNTH_NOTE(pCtx, pTrack->notesIndex + first);
+        if (synthNote_isLoop(pNote) != SYNTH_TRUE) {
+            break;
+        }
+
+        /* Since the sample is within this loop's repeated plays, the loop's
+         * body must be longer than 0 samples */
+        synthTrack_getLoop(&pLoop, pTrack, pCtx, pNote);
+        jumpPosition = pLoop->jumpPosition;
+        position = pTimeline[jumpPosition].start + (position -
+                pTimeline[first].start) % (pTimeline[first].start -
+                pTimeline[jumpPosition].start);
+
+        last = first - 1;
+        first = jumpPosition;
+    }
+
+    *pNote = first;
+    *pOffset = position - pTimeline[first].start;
+}
+
+/**
+ * Render only a range of a track into a buffer
+ * 
+ * Every note is found on the track's timeline (instead of walking through the
+ * whole track) and the first one is rendered from its middle, if needed.
+ * Samples past the end of the track go back to its loop point, as when the
+ * song is rendered, or are silent if the track doesn't loop
+ * 
+ * Only 'pPRNG' and 'pCache' are modified, so tracks may be rendered
+ * concurrently
+ * 
+ * @param  [ in]pBuf       Buffer that will be filled with 'numSamples'
+ * @param  [ in]pTrack     The track
+ * @param  [ in]track      Position of the track within its song
+ * @param  [ in]pCtx       The synthesizer context
+ * @param  [ in]pPRNG      Pseudo-random number generator used by noises
+ * @param  [ in]pCache     Cache of rendered notes (may be NULL)
+ * @param  [ in]mode       Desired mode for the wave
+ * @param  [ in]position   First sample to be rendered
+ * @param  [ in]numSamples How many samples should be rendered
+ * @return                 SYNTH_OK, SYNTH_BAD_PARAM_ERR
+ */
+synth_err synthTrack_renderRange(char *pBuf, synthTrack *pTrack, int track,
+        synthCtx *pCtx, synthPRNGCtx *pPRNG, synthCache *pCache,
+        synthBufMode mode, int position, int numSamples) {
+    int canLoop, intro, len, numBytes;
     synth_err rv;
 
-    /* Retrieve the track's duration in samples */
-    rv = synthTrack_getLength(&len, pTrack, pCtx);
-    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    /* Sanitize the arguments */
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pTrack, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(pCtx, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(position >= 0, SYNTH_BAD_PARAM_ERR);
+    SYNTH_ASSERT_ERR(numSamples >= 0, SYNTH_BAD_PARAM_ERR);
 
-    /* Convert the number of samples into bytes */
+    /* Calculate the number of bytes per samples */
+    numBytes = 1;
     if (mode & SYNTH_16BITS) {
-        len *= 2;
+        numBytes = 2;
     }
     if (mode & SYNTH_2CHAN) {
-        len *= 2;
+        numBytes *= 2;
     }
 
-    /* Place the buffer at its expected end */
-    pBuf += len;
-
-    /* Loop through all notes and render 'em */
-    rv = synthTrack_renderSequence(&tmp, pBuf, pTrack, pCtx, mode,
-            pTrack->num - 1, 0);
+    rv = synthTrack_getLength(&len, pTrack, pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+    rv = synthTrack_getIntroLength(&intro, pTrack, pCtx);
     SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
+    /* Only loop if there's actually something to be looped */
+    canLoop = (synthTrack_isLoopable(pTrack) == SYNTH_TRUE && len > intro);
+
+    while (numSamples > 0) {
+        synthNote *pNote;
+        synthNoteKernel kernel;
+        int count, duration, note, offset;
+
+        /* Go back to the loop point if the track already ended */
+        if (position >= len) {
+            if (!canLoop) {
+                break;
+            }
+            position = intro + (position - len) % (len - intro);
+        }
+
+        synthTrack_seek(&note, &offset, pTrack, pCtx, position);
+
+        pNote = SYNTH_NOTE(pCtx, pTrack->notesIndex + note);
+        rv = synthNote_getSamplesDuration(&duration, pNote);
+        SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+        count = duration - offset;
+        if (count > numSamples) {
+            count = numSamples;
+        }
+
+        if (offset == 0 && count == duration) {
+            /* Render the note (or copy it, if it was already rendered) */
+            rv = synthCache_render(pBuf, pCache, pNote, pCtx, pPRNG, track,
+                    note, mode, duration);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        }
+        else {
+            rv = synthNote_getKernel(&kernel, pNote, mode);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+            rv = synthNote_renderRange(pBuf, pNote, pCtx, pPRNG, kernel, track,
+                    note, duration, offset, count);
+            SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+        }
+
+        pBuf += count * numBytes;
+        position += count;
+        numSamples -= count;
+    }
+
+    /* Whatever is left is past the end of the track */
+    memset(pBuf, 0x0, numSamples * numBytes);
+
     rv = SYNTH_OK;
 __err:
     return rv;
 }
-
@@ -4,55 +4,177 @@
  * whenever a new volume is created it can never be deleted; However, if two
  * notes shares the same function, they will point to the same 'volume object'
  * 
- * Volumes are stored in a simple array, since they are only searched and
- * created on compilation time; So, even if lots of volumes are used and they
- * slow down the compilation, there will be no side effects while rendering the
- * song
+ * Volumes are only searched and created on compilation time, through an
+ * open-addressing hash index (keyed by the volume's amplitudes) kept alongside
+ * the list of volumes; So, looking up a volume takes the same time regardless
+ * of how many volumes (and songs) there are in the context
  * 
  * @file src/synth_volume.c
  */
 #include <c_synth/synth_assert.h>
 #include <c_synth/synth_errors.h>
 
+#include <c_synth_internal/synth_list.h>
 #include <c_synth_internal/synth_volume.h>
 #include <c_synth_internal/synth_types.h>
 
 #include <stdlib.h>
 #include <string.h>
 
+/** Minimum number of slots in a dynamically alloc'ed index */
+#define SYNTHVOLUME_MIN_INDEX_LEN 64
+
+/**
+ * Calculate a volume's position on the index
+ * 
+ * @param  [ in]ini The initial amplitude (already as a 16 bits value)
+ * @param  [ in]fin The final amplitude (already as a 16 bits value)
+ * @return          The volume's hash
+ */
+static unsigned int synthVolume_hash(int ini, int fin) {
+    unsigned int hash;
+
+    hash = ((unsigned int)ini * 0x9e3779b1u) ^
+            ((unsigned int)fin * 0x85ebca77u);
+    return hash ^ (hash >> 16);
+}
+
+/**
+ * Retrieve how many slots an index requires, so it's at most half full when
+ * holding every volume
+ * 
+ * @param  [ in]maxVolumes How many volumes may be indexed
+ * @return                 The number of slots (a power of 2)
+ */
+int synthVolume_getIndexLen(int maxVolumes) {
+    int len;
+
+    len = 1;
+    while (len < maxVolumes * 2) {
+        len <<= 1;
+    }
+
+    return len;
+}
+
+/**
+ * Initialize the index of volumes over a previously alloc'ed (or carved) array;
+ * Every volume in the context is indexed
+ * 
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]pIndex The index's slots
+ * @param  [ in]len    How many slots there are (a power of 2)
+ */
+void synthVolume_initIndex(synthCtx *pCtx, int *pIndex, int len) {
+    int i;
+
+    pCtx->pVolumeIndex = pIndex;
+    pCtx->volumeIndexLen = len;
+
+    i = 0;
+    while (i < len) {
+        pIndex[i] = -1;
+        i++;
+    }
+
+    i = 0;
+    while (i < pCtx->volumes.used) {
+        synthVolume *pVolume;
+        unsigned int slot;
+
+        pVolume = SYNTH_VOLUME(pCtx, i);
+        slot = synthVolume_hash(pVolume->ini, pVolume->fin) & (len - 1);
+        while (pIndex[slot] != -1) {
+            slot = (slot + 1) & (len - 1);
+        }
+        pIndex[slot] = i;
+
+        i++;
+    }
+}
+
 /**
- * Alloc and initialize a new volume
+ * Make sure there's room in the index for another volume, doubling it (and
+ * re-indexing every volume) as necessary; Static contexts have their index
+ * sized for every volume, so it's never expanded
  * 
- * @param [out]ppVol The new volume
- * @param [ in]pCtx  The synthesizer context
+ * @param  [ in]pCtx The synthesizer context
  * @return           SYNTH_OK, SYNTH_MEM_ERR
  */
-static synth_err synthVolume_init(synthVolume **ppVol, synthCtx *pCtx) {
+static synth_err synthVolume_expandIndex(synthCtx *pCtx) {
+    int *pIndex, len;
     synth_err rv;
 
-    /* Make sure there's enough space for another volume */
-    SYNTH_ASSERT_ERR(pCtx->volumes.max == 0 ||
-            pCtx->volumes.used < pCtx->volumes.max, SYNTH_MEM_ERR);
-
-    /* Check if the buffer must be expanded and do so */
-    if (pCtx->volumes.used >= pCtx->volumes.len) {
-        /* 'Double' the current buffer; Note that this will never be called if
-         * the context was pre-alloc'ed, since 'max' will be set; The '+1' is
-         * for the first volume, in which len will be 0 */
-        pCtx->volumes.buf.pVolumes = (synthVolume*)realloc(
-                pCtx->volumes.buf.pVolumes, (1 + pCtx->volumes.len * 2) *
-                sizeof(synthVolume));
-        SYNTH_ASSERT_ERR(pCtx->volumes.buf.pVolumes, SYNTH_MEM_ERR);
-        /* Clear only the new part of the buffer */
-        memset(&(pCtx->volumes.buf.pVolumes[pCtx->volumes.used]), 0x0,
-                (1 + pCtx->volumes.len) * sizeof(synthVolume));
-        /* Actually increase the buffer length */
-        pCtx->volumes.len += 1 + pCtx->volumes.len;
+    if (pCtx->volumes.max != 0 ||
+            (pCtx->volumes.used + 1) * 2 <= pCtx->volumeIndexLen) {
+        rv = SYNTH_OK;
+        goto __err;
     }
 
-    /* Retrieve the volume to be used */
-    *ppVol = &(pCtx->volumes.buf.pVolumes[pCtx->volumes.used]);
-    pCtx->volumes.used++;
+    len = pCtx->volumeIndexLen * 2;
+    if (len < SYNTHVOLUME_MIN_INDEX_LEN) {
+        len = SYNTHVOLUME_MIN_INDEX_LEN;
+    }
+    pIndex = (int*)malloc(len * sizeof(int));
+    SYNTH_ASSERT_ERR(pIndex, SYNTH_MEM_ERR);
+
+    if (pCtx->pVolumeIndex) {
+        free(pCtx->pVolumeIndex);
+    }
+    synthVolume_initIndex(pCtx, pIndex, len);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Retrieve a volume, creating it if it isn't found
+ * 
+ * @param  [out]pVol The index of the volume
+ * @param  [ in]pCtx The synthesizer context
+ * @param  [ in]ini  The initial amplitude (already as a 16 bits value)
+ * @param  [ in]fin  The final amplitude (already as a 16 bits value)
+ * @return           SYNTH_OK, SYNTH_MEM_ERR
+ */
+static synth_err synthVolume_get(int *pVol, synthCtx *pCtx, int ini, int fin) {
+    int mask;
+    synthVolume *pVolume;
+    unsigned int slot;
+    synth_err rv;
+
+    /* Expand the index before searching it, so the free slot (where the
+     * volume would be placed) is kept */
+    rv = synthVolume_expandIndex(pCtx);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    /* Search for the requested volume through the existing ones */
+    mask = pCtx->volumeIndexLen - 1;
+    slot = synthVolume_hash(ini, fin) & mask;
+    while (pCtx->pVolumeIndex[slot] != -1) {
+        pVolume = SYNTH_VOLUME(pCtx, pCtx->pVolumeIndex[slot]);
+        if (pVolume->ini == ini && pVolume->fin == fin) {
+            /* If a volume matched, simply return it */
+            *pVol = pCtx->pVolumeIndex[slot];
+            rv = SYNTH_OK;
+            goto __err;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    /* The volume wasn't found, so create a new one (expanding the list as
+     * necessary) */
+    rv = synthList_append((void**)&pVolume, &(pCtx->volumes),
+            sizeof(synthVolume));
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
+
+    pVolume->ini = ini;
+    pVolume->fin = fin;
+
+    /* Retrieve the volume's index and place it on the index */
+    *pVol = pCtx->volumes.used - 1;
+    pCtx->pVolumeIndex[slot] = *pVol;
+
     rv = SYNTH_OK;
 __err:
     return rv;
@@ -69,7 +191,6 @@ __err:
  * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
  */
 synth_err synthVolume_getConst(int *pVol, synthCtx *pCtx, int amp) {
-    int i;
     synth_err rv;
 
     /* Sanitize the arguments */
@@ -84,39 +205,10 @@ synth_err synthVolume_getConst(int *pVol, synthCtx *pCtx, int amp) {
         amp = 128;
     }
 
-    /* Increase the amplitude to a 16 bits value */
-    amp <<= 8;
-
-    /* Clean the return, so we now if anything was found */
-    *pVol = 0;
-
-    /* Search for the requested volume through the existing ones */
-    i = 0;
-    while (i < pCtx->volumes.used) {
-        if ((pCtx->volumes.buf.pVolumes[i].ini ==
-                pCtx->volumes.buf.pVolumes[i].fin) &&
-                (pCtx->volumes.buf.pVolumes[i].ini == amp)) {
-            /* If a volume matched, simply return it */
-            *pVol = i;
-            break;
-        }
-        i++;
-    }
-
-    /* If the volume wasn't found, create a new one */
-    if (*pVol == 0) {
-        synthVolume *pVolume;
-
-        rv = synthVolume_init(&pVolume, pCtx);
-        SYNTH_ASSERT(rv == SYNTH_OK);
-
-        /* Set both values to the same, since this is a constant volume */
-        pVolume->ini = amp;
-        pVolume->fin = amp;
-
-        /* Retrieve the volume's index */
-        *pVol = pCtx->volumes.used - 1;
-    }
+    /* Increase the amplitude to a 16 bits value; Both values are the same,
+     * since this is a constant volume */
+    rv = synthVolume_get(pVol, pCtx, amp << 8, amp << 8);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
 __err:
@@ -135,7 +227,6 @@ __err:
  * @return           SYNTH_OK, SYNTH_BAD_PARAM_ERR, SYNTH_MEM_ERR
  */
 synth_err synthVolume_getLinear(int *pVol, synthCtx *pCtx, int ini, int fin) {
-    int i;
     synth_err rv;
 
     /* Sanitize the arguments */
@@ -156,39 +247,9 @@ synth_err synthVolume_getLinear(int *pVol, synthCtx *pCtx, int ini, int fin) {
         fin = 128;
     }
 
-    /* Clean the return, so we now if anything was found */
-    *pVol = 0;
-
     /* Increase the amplitude to a 16 bits value */
-    ini <<= 8;
-    fin <<= 8;
-
-    /* Search for the requested volume through the existing ones */
-    i = 0;
-    while (i < pCtx->volumes.used) {
-        if (pCtx->volumes.buf.pVolumes[i].ini == ini &&
-                pCtx->volumes.buf.pVolumes[i].fin == fin) {
-            /* If a volume matched, simply return it */
-            *pVol = i;
-            break;
-        }
-        i++;
-    }
-
-    /* If the volume wasn't found, create a new one */
-    if (*pVol == 0) {
-        synthVolume *pVolume;
-
-        rv = synthVolume_init(&pVolume, pCtx);
-        SYNTH_ASSERT(rv == SYNTH_OK);
-
-        /* Set both values to the same, since this is a constant volume */
-        pVolume->ini = ini;
-        pVolume->fin = fin;
-
-        /* Retrieve the volume's index */
-        *pVol = pCtx->volumes.used - 1;
-    }
+    rv = synthVolume_get(pVol, pCtx, ini << 8, fin << 8);
+    SYNTH_ASSERT_ERR(rv == SYNTH_OK, rv);
 
     rv = SYNTH_OK;
 __err:
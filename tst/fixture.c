@@ -0,0 +1,84 @@
+/**
+ * Song and helpers shared by the tests
+ *
+ * @file tst/fixture.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fixture.h"
+
+/**
+ * Render a song into a newly alloc'ed buffer
+ *
+ * @param  [out]ppBuf  The rendered song
+ * @param  [out]pLen   The song's length, in bytes
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]handle Handle of the song
+ * @param  [ in]mode   Desired mode for the song
+ * @return             SYNTH_OK, SYNTH_MEM_ERR, ...
+ */
+synth_err fixture_renderSong(char **ppBuf, int *pLen, synthCtx *pCtx,
+        int handle, synthBufMode mode) {
+    char *pTmp;
+    synth_err rv;
+
+    pTmp = 0;
+
+    rv = synth_getSongLength(pLen, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    if (mode & SYNTH_16BITS) {
+        *pLen *= 2;
+    }
+    if (mode & SYNTH_2CHAN) {
+        *pLen *= 2;
+    }
+
+    *ppBuf = (char*)malloc(*pLen);
+    SYNTH_ASSERT_ERR(*ppBuf, SYNTH_MEM_ERR);
+    pTmp = (char*)malloc(*pLen);
+    SYNTH_ASSERT_ERR(pTmp, SYNTH_MEM_ERR);
+
+    rv = synth_renderSong(*ppBuf, pCtx, handle, mode, pTmp);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    if (pTmp) {
+        free(pTmp);
+    }
+
+    return rv;
+}
+
+/**
+ * Check that a rendered song is exactly the same as the expected one
+ *
+ * @param  [ in]pExpected     The expected song
+ * @param  [ in]expectedLen   The expected song's length, in bytes
+ * @param  [ in]pRendered     The rendered song
+ * @param  [ in]renderedLen   The rendered song's length, in bytes
+ * @param  [ in]pName         Name of the rendered song, for logging
+ * @param  [ in]pExpectedName Name of the expected song, for logging
+ * @return                    SYNTH_OK, SYNTH_INTERNAL_ERR
+ */
+synth_err fixture_checkSong(char *pExpected, int expectedLen, char *pRendered,
+        int renderedLen, char *pName, char *pExpectedName) {
+    int diff;
+    synth_err rv;
+
+    diff = (renderedLen != expectedLen) ||
+            memcmp(pRendered, pExpected, expectedLen);
+    printf("The %s %s %s\n", pName, diff ? "differs from" : "matches",
+            pExpectedName);
+    SYNTH_ASSERT_ERR(diff == 0, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
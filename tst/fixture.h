@@ -0,0 +1,49 @@
+/**
+ * Song and helpers shared by the tests
+ *
+ * @file tst/fixture.h
+ */
+#ifndef __TST_FIXTURE_H__
+#define __TST_FIXTURE_H__
+
+#include <c_synth/synth.h>
+#include <c_synth/synth_errors.h>
+
+/* Test song, with loops, nested loops, noises, envelopes, volumes and pans;
+ * Its last track is mostly noises */
+#define FIXTURE_SONG "MML t90 l16 o5 e e8 e r c e r g4 > g4 < $ " \
+        "[ e8 c8 g4 g2 [ g8 a8 > c4 < g2 ]2 ]2 ; " \
+        "v(20, 80) p30 o3 c4 e4 g4 c4 $ [ e4 g4 v60 e4 g4 ]6 ; " \
+        "w5 k10 q60 h80 o2 c8 c8 w10 v(90, 10) c4 w2 p80 c8 d8 e8 f8"
+
+/* Seed of the contexts' noise, so songs are rendered the same on any of them */
+#define FIXTURE_NOISE_SEED 0x5eed
+
+/**
+ * Render a song into a newly alloc'ed buffer
+ *
+ * @param  [out]ppBuf  The rendered song
+ * @param  [out]pLen   The song's length, in bytes
+ * @param  [ in]pCtx   The synthesizer context
+ * @param  [ in]handle Handle of the song
+ * @param  [ in]mode   Desired mode for the song
+ * @return             SYNTH_OK, SYNTH_MEM_ERR, ...
+ */
+synth_err fixture_renderSong(char **ppBuf, int *pLen, synthCtx *pCtx,
+        int handle, synthBufMode mode);
+
+/**
+ * Check that a rendered song is exactly the same as the expected one
+ *
+ * @param  [ in]pExpected     The expected song
+ * @param  [ in]expectedLen   The expected song's length, in bytes
+ * @param  [ in]pRendered     The rendered song
+ * @param  [ in]renderedLen   The rendered song's length, in bytes
+ * @param  [ in]pName         Name of the rendered song, for logging
+ * @param  [ in]pExpectedName Name of the expected song, for logging
+ * @return                    SYNTH_OK, SYNTH_INTERNAL_ERR
+ */
+synth_err fixture_checkSong(char *pExpected, int expectedLen, char *pRendered,
+        int renderedLen, char *pName, char *pExpectedName);
+
+#endif /* __TST_FIXTURE_H__ */
@@ -0,0 +1,228 @@
+/**
+ * Test that released songs have their handles invalidated and that songs
+ * compiled later reuse their memory, rendering exactly as if they were compiled
+ * on a clean context
+ *
+ * @file tst/tst_freeSong.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fixture.h"
+
+/* Simple test song, with loops, volumes and two tracks */
+static char __song[] = "MML t90 l16 o5 e e8 e r c e r g4 > g4 < $ "
+        "[ e8 c8 g4 > g2 < ]2 ; v(20, 80) o3 c4 e4 g4 c4 $ "
+        "[ e4 g4 v60 e4 g4 ]2";
+
+/* Another song, kept loaded while the first one is released */
+static char __otherSong[] = "MML t120 l8 o4 c d e f g a b > c";
+
+/* Limits of the static context; Only both songs fit in it */
+#define MAX_SONGS   2
+#define MAX_TRACKS  3
+#define MAX_NOTES   31
+#define MAX_VOLUMES 8
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char pChunk[16], *pClean, *pReused;
+    int cleanLen, freq, handle, i, newHandle, otherHandle, prevSize,
+            reusedLen, size;
+    synthCtx *pCleanCtx, *pCtx, *pStaticCtx;
+    synthCursor *pCursor, *pStaticCursor;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pCleanCtx = 0;
+    pCtx = 0;
+    pStaticCtx = 0;
+    pCursor = 0;
+    pStaticCursor = 0;
+    pClean = 0;
+    pReused = 0;
+
+    freq = 44100;
+
+    printf("Initialize the synthesizers...\n");
+    rv = synth_init(&pCtx, freq);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_init(&pCleanCtx, freq);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_initStatic(&pStaticCtx, 0, freq, MAX_SONGS, MAX_TRACKS,
+            MAX_NOTES, MAX_VOLUMES);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Compile both songs and release the first one */
+    printf("Compiling songs '%s' and '%s'...\n", __song, __otherSong);
+    rv = synth_compileSongFromStringStatic(&handle, pCtx, __song);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_compileSongFromStringStatic(&otherHandle, pCtx, __otherSong);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_initCursor(&pCursor, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_freeSong(pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Neither the handle nor its cursor may be used anymore */
+    rv = synth_getSongLength(&reusedLen, pCtx, handle);
+    printf("Retrieving the released song's length returned %i\n", rv);
+    SYNTH_ASSERT_ERR(rv == SYNTH_INVALID_INDEX, SYNTH_INTERNAL_ERR);
+    rv = synth_resetCursor(pCursor, pCtx);
+    printf("Resetting the released song's cursor returned %i\n", rv);
+    SYNTH_ASSERT_ERR(rv == SYNTH_INVALID_INDEX, SYNTH_INTERNAL_ERR);
+    rv = synth_freeSong(pCtx, handle);
+    printf("Releasing the song again returned %i\n", rv);
+    SYNTH_ASSERT_ERR(rv == SYNTH_INVALID_INDEX, SYNTH_INTERNAL_ERR);
+
+    /* Compile the song again, which should reuse the released memory */
+    rv = synth_compileSongFromStringStatic(&newHandle, pCtx, __song);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("The song was reloaded with handle %i (previously %i)\n",
+            newHandle, handle);
+    SYNTH_ASSERT_ERR(newHandle != handle, SYNTH_INTERNAL_ERR);
+    rv = synth_getSongLength(&reusedLen, pCtx, handle);
+    SYNTH_ASSERT_ERR(rv == SYNTH_INVALID_INDEX, SYNTH_INTERNAL_ERR);
+    rv = synth_renderSongChunk(pChunk, pCtx, handle, pCursor, sizeof(pChunk),
+            SYNTH_1CHAN_U8BITS);
+    SYNTH_ASSERT_ERR(rv == SYNTH_INVALID_INDEX, SYNTH_INTERNAL_ERR);
+
+    /* Reloading the song many times must not expand the context */
+    rv = synth_getContextSize(&prevSize, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    i = 0;
+    while (i < 10) {
+        rv = synth_freeSong(pCtx, newHandle);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        rv = synth_compileSongFromStringStatic(&newHandle, pCtx, __song);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        i++;
+    }
+
+    rv = synth_getContextSize(&size, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("The context used %i bytes and now uses %i bytes\n", prevSize,
+            size);
+    SYNTH_ASSERT_ERR(size == prevSize, SYNTH_INTERNAL_ERR);
+
+    /* Both songs must render exactly as if compiled on a clean context */
+    rv = fixture_renderSong(&pReused, &reusedLen, pCtx, newHandle,
+            SYNTH_1CHAN_U8BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_compileSongFromStringStatic(&handle, pCleanCtx, __song);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_renderSong(&pClean, &cleanLen, pCleanCtx, handle,
+            SYNTH_1CHAN_U8BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = fixture_checkSong(pClean, cleanLen, pReused, reusedLen,
+            "reloaded song", "the clean one");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    free(pReused);
+    pReused = 0;
+    free(pClean);
+    pClean = 0;
+
+    rv = fixture_renderSong(&pReused, &reusedLen, pCtx, otherHandle,
+            SYNTH_1CHAN_U8BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_compileSongFromStringStatic(&handle, pCleanCtx, __otherSong);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_renderSong(&pClean, &cleanLen, pCleanCtx, handle,
+            SYNTH_1CHAN_U8BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = fixture_checkSong(pClean, cleanLen, pReused, reusedLen,
+            "other song", "the clean one");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    free(pReused);
+    pReused = 0;
+
+    /* A static context must also reuse the released memory, even though the
+     * other song was compiled after it (and must then be moved back) */
+    rv = synth_compileSongFromStringStatic(&handle, pStaticCtx, __song);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_compileSongFromStringStatic(&otherHandle, pStaticCtx,
+            __otherSong);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_initCursor(&pStaticCursor, pStaticCtx, otherHandle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_renderSongChunk(pChunk, pStaticCtx, otherHandle, pStaticCursor,
+            sizeof(pChunk), SYNTH_1CHAN_U8BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_checkSong(pClean, sizeof(pChunk), pChunk, sizeof(pChunk),
+            "other song's first chunk", "the clean one");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    i = 0;
+    while (i < 10) {
+        rv = synth_freeSong(pStaticCtx, handle);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        rv = synth_compileSongFromStringStatic(&handle, pStaticCtx, __song);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        i++;
+    }
+    printf("The song was reloaded %i times on the static context\n", i);
+
+    /* The moved song, and its cursor, must be rendered just as before */
+    rv = fixture_renderSong(&pReused, &reusedLen, pStaticCtx, otherHandle,
+            SYNTH_1CHAN_U8BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_checkSong(pClean, cleanLen, pReused, reusedLen,
+            "moved song", "the clean one");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_renderSongChunk(pChunk, pStaticCtx, otherHandle, pStaticCursor,
+            sizeof(pChunk), SYNTH_1CHAN_U8BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_checkSong(pClean + sizeof(pChunk), sizeof(pChunk), pChunk,
+            sizeof(pChunk), "moved song's next chunk", "the clean one");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    printf("Releasing resources used by the lib...\n");
+    if (pCursor) {
+        synth_freeCursor(&pCursor);
+    }
+    if (pStaticCursor) {
+        synth_freeCursor(&pStaticCursor);
+    }
+    if (pCtx) {
+        synth_free(&pCtx);
+    }
+    if (pCleanCtx) {
+        synth_free(&pCleanCtx);
+    }
+    if (pStaticCtx) {
+        synth_free(&pStaticCtx);
+    }
+
+    if (pClean) {
+        free(pClean);
+    }
+    if (pReused) {
+        free(pReused);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
@@ -0,0 +1,155 @@
+/**
+ * Test that a context initialized over a caller-provided block of memory
+ * renders songs exactly as a dynamically alloc'ed one, and that its limits are
+ * enforced
+ *
+ * @file tst/tst_initStatic.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Simple test song, with loops, volumes and two tracks */
+static char __song[] = "MML t90 l16 o5 e e8 e r c e r g4 > g4 < $ "
+        "[ e8 c8 g4 > g2 < ]2 ; v(20, 80) o3 c4 e4 g4 c4 $ "
+        "[ e4 g4 v60 e4 g4 ]2";
+
+/* Limits of the static context; Only a single song fits in it */
+#define MAX_SONGS   1
+#define MAX_TRACKS  2
+#define MAX_NOTES   64
+#define MAX_VOLUMES 8
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pDynamic, *pStatic, *pTmp;
+    void *pMem;
+    int diff, dynamicLen, freq, handle, size, staticLen;
+    synthCtx *pDynamicCtx, *pSmallCtx, *pStaticCtx;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pDynamicCtx = 0;
+    pSmallCtx = 0;
+    pStaticCtx = 0;
+    pDynamic = 0;
+    pStatic = 0;
+    pTmp = 0;
+    pMem = 0;
+
+    freq = 44100;
+
+    /* Alloc the static context's memory */
+    rv = synth_getStaticContextSize(&size, MAX_SONGS, MAX_TRACKS, MAX_NOTES,
+            MAX_VOLUMES);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("A static context requires %i bytes\n", size);
+    pMem = malloc(size);
+    SYNTH_ASSERT_ERR(pMem, SYNTH_MEM_ERR);
+
+    /* Initialize both contexts with the same noise */
+    printf("Initialize the synthesizers...\n");
+    rv = synth_init(&pDynamicCtx, freq);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_setNoiseSeed(pDynamicCtx, 1);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_initStatic(&pStaticCtx, pMem, freq, MAX_SONGS, MAX_TRACKS,
+            MAX_NOTES, MAX_VOLUMES);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_setNoiseSeed(pStaticCtx, 1);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Compile the song on both */
+    printf("Compiling static song '%s'...\n", __song);
+    rv = synth_compileSongFromStringStatic(&handle, pDynamicCtx, __song);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_compileSongFromStringStatic(&handle, pStaticCtx, __song);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getContextSize(&size, pStaticCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("The static context uses %i bytes\n", size);
+
+    /* Render it on both */
+    rv = synth_getSongLength(&dynamicLen, pDynamicCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_getSongLength(&staticLen, pStaticCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Song requires %i (and %i) samples\n", dynamicLen, staticLen);
+    SYNTH_ASSERT_ERR(dynamicLen == staticLen, SYNTH_INTERNAL_ERR);
+
+    pDynamic = (char*)malloc(dynamicLen);
+    SYNTH_ASSERT_ERR(pDynamic, SYNTH_MEM_ERR);
+    pStatic = (char*)malloc(dynamicLen);
+    SYNTH_ASSERT_ERR(pStatic, SYNTH_MEM_ERR);
+    pTmp = (char*)malloc(dynamicLen);
+    SYNTH_ASSERT_ERR(pTmp, SYNTH_MEM_ERR);
+
+    rv = synth_renderSong(pDynamic, pDynamicCtx, handle, SYNTH_1CHAN_U8BITS,
+            pTmp);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_renderSong(pStatic, pStaticCtx, handle, SYNTH_1CHAN_U8BITS,
+            pTmp);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    diff = memcmp(pDynamic, pStatic, dynamicLen);
+    printf("The static context's song %s the dynamic one\n",
+            diff ? "differs from" : "matches");
+    SYNTH_ASSERT_ERR(diff == 0, SYNTH_INTERNAL_ERR);
+
+    /* There's no room for another song */
+    rv = synth_compileSongFromStringStatic(&handle, pStaticCtx, __song);
+    printf("Compiling another song returned %i\n", rv);
+    SYNTH_ASSERT_ERR(rv == SYNTH_MEM_ERR, SYNTH_INTERNAL_ERR);
+
+    /* Nor for a song with more notes than the limit (on a context alloc'ed by
+     * the library) */
+    rv = synth_initStatic(&pSmallCtx, 0, freq, 1, 2, 4, 1);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_compileSongFromStringStatic(&handle, pSmallCtx, __song);
+    printf("Compiling a song on a smaller context returned %i\n", rv);
+    SYNTH_ASSERT_ERR(rv != SYNTH_OK, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    printf("Releasing resources used by the lib...\n");
+    if (pDynamicCtx) {
+        synth_free(&pDynamicCtx);
+    }
+    if (pStaticCtx) {
+        synth_free(&pStaticCtx);
+    }
+    if (pSmallCtx) {
+        synth_free(&pSmallCtx);
+    }
+
+    if (pMem) {
+        free(pMem);
+    }
+    if (pDynamic) {
+        free(pDynamic);
+    }
+    if (pStatic) {
+        free(pStatic);
+    }
+    if (pTmp) {
+        free(pTmp);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
@@ -0,0 +1,106 @@
+/**
+ * Measure the lexer's throughput, tokenizing a large song kept in memory
+ *
+ * @file tst/tst_lexerBenchmark.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_lexer.h>
+#include <c_synth_internal/synth_types.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Header of the benchmarked song */
+static char __header[] = "MML t120 l8 o4 // benchmarked song\n";
+
+/* Phrase repeated throughout the song, using every kind of token */
+static char __phrase[] = "w2 v(20, 80) k10 q60 h80 p50 $ "
+        "[ c d+ e- f16. g8.. a4 b2 > c < r16 ]3 // repeat it\n"
+        "w4 v100 o3 l16 c e g > c < g e c r ; ";
+
+/** How many bytes the song should have */
+#define SONG_SIZE (4 * 1024 * 1024)
+/** How many times the song is tokenized */
+#define NUM_RUNS  4
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pSong;
+    double elapsed, mbytes;
+    int i, len, numTokens, phraseLen;
+    clock_t start;
+    synthLexCtx ctx;
+    synth_token token;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    memset(&ctx, 0x0, sizeof(synthLexCtx));
+    pSong = 0;
+
+    /* Build the song, repeating the phrase until it's large enough */
+    printf("Building a %i bytes song...\n", SONG_SIZE);
+    pSong = (char*)malloc(SONG_SIZE + 1);
+    SYNTH_ASSERT_ERR(pSong, SYNTH_MEM_ERR);
+
+    len = sizeof(__header) - 1;
+    memcpy(pSong, __header, len);
+    phraseLen = sizeof(__phrase) - 1;
+    while (len + phraseLen <= SONG_SIZE) {
+        memcpy(pSong + len, __phrase, phraseLen);
+        len += phraseLen;
+    }
+    pSong[len] = '\0';
+
+    printf("Tokenizing it %i times...\n", NUM_RUNS);
+    numTokens = 0;
+    start = clock();
+    i = 0;
+    while (i < NUM_RUNS) {
+        rv = synthLexer_initFromString(&ctx, pSong, len);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        token = T_MML;
+        while (token != T_DONE) {
+            rv = synthLexer_getToken(&ctx);
+            SYNTH_ASSERT(rv == SYNTH_OK);
+            rv = synthLexer_lookupToken(&token, &ctx);
+            SYNTH_ASSERT(rv == SYNTH_OK);
+            numTokens++;
+        }
+
+        i++;
+    }
+    elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    mbytes = (double)len * NUM_RUNS / (1024.0 * 1024.0);
+    printf("Read %i tokens from %.2f MB in %.3f s\n", numTokens, mbytes,
+            elapsed);
+    if (elapsed > 0.0) {
+        printf("Throughput: %.2f MB/s\n", mbytes / elapsed);
+    }
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    synthLexer_clear(&ctx);
+    if (pSong) {
+        free(pSong);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
@@ -0,0 +1,246 @@
+/**
+ * Test that a song larger than the lexer's block, with a token split between
+ * two blocks, is compiled from a file exactly as it's compiled from a string
+ *
+ * @file tst/tst_lexerBlocks.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fixture.h"
+
+#if defined(USE_MMAP)
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+/* Start of the song */
+static char __header[] = "MML t120 l8 o4 c d e f ";
+
+/* Comment repeated until the song is as large as a block */
+static char __filler[] = "// filler, so the song doesn't fit a single "
+        "block of the lexer\n";
+
+/* End of the song, whose first token is split between two blocks */
+static char __tail[] = "v100 g a b > c < c d e f ; "
+        "w2 o3 c4 e4 g4 c4 $ [ e g e g ]2";
+
+/* Where the song is saved */
+static char __filename[] = "tst_lexerBlocks.mml";
+
+/* Size of the lexer's block, from 'src/synth_lexer.c' */
+#define BLOCK_SIZE (64 * 1024)
+/* Offset, within '__tail', of the character that starts the second block */
+#define SPLIT_AT   2
+
+/**
+ * Compile a song from a file and check that it's the same as the one compiled
+ * from a string
+ *
+ * @param  [ in]pExpected The song compiled from a string, rendered
+ * @param  [ in]len       The rendered song's length, in bytes
+ * @param  [ in]numTracks How many tracks the song has
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pFilename The file
+ * @param  [ in]pName     Name of the file, for logging
+ * @return                SYNTH_OK, SYNTH_INTERNAL_ERR, ...
+ */
+static synth_err checkFile(char *pExpected, int len, int numTracks,
+        synthCtx *pCtx, char *pFilename, char *pName) {
+    char *pRendered;
+    int handle, num, rendered;
+    synth_err rv;
+
+    pRendered = 0;
+
+    printf("Compiling the song from %s...\n", pName);
+    rv = synth_compileSongFromFile(&handle, pCtx, pFilename);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getAudioTrackCount(&num, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("It has %i tracks (and the string's song has %i)\n", num,
+            numTracks);
+    SYNTH_ASSERT_ERR(num == numTracks, SYNTH_INTERNAL_ERR);
+
+    rv = fixture_renderSong(&pRendered, &rendered, pCtx, handle,
+            SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_checkSong(pExpected, len, pRendered, rendered,
+            "song compiled from it", "the one compiled from a string");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_freeSong(pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    if (pRendered) {
+        free(pRendered);
+    }
+
+    return rv;
+}
+
+#if defined(USE_MMAP)
+/**
+ * Compile a song from a pipe, so it can't be mapped into memory and must be
+ * read in blocks
+ *
+ * @param  [ in]pExpected The song compiled from a string, rendered
+ * @param  [ in]len       The rendered song's length, in bytes
+ * @param  [ in]numTracks How many tracks the song has
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]pSong     The song's MML
+ * @param  [ in]songLen   The MML's length
+ * @return                SYNTH_OK, SYNTH_INTERNAL_ERR, ...
+ */
+static synth_err checkPipe(char *pExpected, int len, int numTracks,
+        synthCtx *pCtx, char *pSong, int songLen) {
+    char pFilename[32];
+    int fds[2], status;
+    pid_t pid;
+    synth_err rv;
+
+    fds[0] = -1;
+    fds[1] = -1;
+    pid = -1;
+
+    SYNTH_ASSERT_ERR(pipe(fds) == 0, SYNTH_INTERNAL_ERR);
+
+    /* Write the song from another process, since it doesn't fit the pipe */
+    pid = fork();
+    SYNTH_ASSERT_ERR(pid >= 0, SYNTH_INTERNAL_ERR);
+    if (pid == 0) {
+        close(fds[0]);
+        status = (write(fds[1], pSong, songLen) == songLen) ? 0 : 1;
+        close(fds[1]);
+        _exit(status);
+    }
+    close(fds[1]);
+    fds[1] = -1;
+
+    /* The read end is kept open while the lexer opens it by its name */
+    sprintf(pFilename, "/dev/fd/%i", fds[0]);
+    rv = checkFile(pExpected, len, numTracks, pCtx, pFilename, "a pipe");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    if (fds[0] >= 0) {
+        close(fds[0]);
+    }
+    if (fds[1] >= 0) {
+        close(fds[1]);
+    }
+    if (pid > 0) {
+        waitpid(pid, &status, 0);
+    }
+
+    return rv;
+}
+#endif
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pExpected, *pSong;
+    FILE *pFile;
+    int handle, len, numTracks, songLen, splitPos;
+    synthCtx *pCtx;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pCtx = 0;
+    pExpected = 0;
+    pSong = 0;
+    pFile = 0;
+
+    /* Build the song, filling it with comments and then spaces until the
+     * tail's token is split at the end of the first block */
+    splitPos = BLOCK_SIZE - SPLIT_AT;
+    songLen = splitPos + sizeof(__tail) - 1;
+    pSong = (char*)malloc(songLen + 1);
+    SYNTH_ASSERT_ERR(pSong, SYNTH_MEM_ERR);
+
+    len = sizeof(__header) - 1;
+    memcpy(pSong, __header, len);
+    while (len + (int)sizeof(__filler) - 1 <= splitPos) {
+        memcpy(pSong + len, __filler, sizeof(__filler) - 1);
+        len += sizeof(__filler) - 1;
+    }
+    memset(pSong + len, ' ', splitPos - len);
+    memcpy(pSong + splitPos, __tail, sizeof(__tail));
+    printf("Built a %i bytes song, split at '%.*s|%c'\n", songLen, SPLIT_AT,
+            pSong + BLOCK_SIZE - SPLIT_AT, pSong[BLOCK_SIZE]);
+
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, 44100);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_setNoiseSeed(pCtx, FIXTURE_NOISE_SEED);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    printf("Compiling the song from a string...\n");
+    rv = synth_compileSongFromString(&handle, pCtx, pSong, songLen);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_getAudioTrackCount(&numTracks, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_renderSong(&pExpected, &len, pCtx, handle,
+            SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Found %i tracks and %i bytes\n", numTracks, len);
+
+    /* Save the song and compile it from that file (which, where supported, is
+     * mapped into memory instead of read in blocks) */
+    pFile = fopen(__filename, "wb");
+    SYNTH_ASSERT_ERR(pFile, SYNTH_OPEN_FILE_ERR);
+    SYNTH_ASSERT_ERR(fwrite(pSong, 1, songLen, pFile) == (size_t)songLen,
+            SYNTH_INTERNAL_ERR);
+    fclose(pFile);
+    pFile = 0;
+
+    rv = checkFile(pExpected, len, numTracks, pCtx, __filename, "a file");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+#if defined(USE_MMAP)
+    rv = checkPipe(pExpected, len, numTracks, pCtx, pSong, songLen);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+#endif
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pFile) {
+        fclose(pFile);
+    }
+    remove(__filename);
+
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+
+    if (pExpected) {
+        free(pExpected);
+    }
+    if (pSong) {
+        free(pSong);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
@@ -0,0 +1,280 @@
+/**
+ * Test that songs saved by 'synth_saveCompiled' are loaded (on any context with
+ * the same frequency) exactly as they were compiled, and that invalid songs are
+ * rejected
+ *
+ * @file tst/tst_loadCompiled.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fixture.h"
+
+/* Another song, compiled before the saved one so it's placed elsewhere on the
+ * context than the loaded ones */
+static char __otherSong[] = "MML t120 l8 o4 v30 c d e f g a b > c";
+
+/* Where the song is saved */
+static char __filename[] = "tst_loadCompiled.bin";
+
+
+/* Limits of the static context */
+#define MAX_SONGS   2
+#define MAX_TRACKS  4
+#define MAX_NOTES   96
+#define MAX_VOLUMES 8
+
+/* Layout of a saved song: the header's fields, and the sizes of its volumes,
+ * tracks and notes */
+#define HEADER_SIZE     (9 * 4)
+#define NUM_VOLUMES_OFF (5 * 4)
+#define NUM_TRACKS_OFF  (6 * 4)
+#define VOLUME_SIZE     (2 * 4)
+#define TRACK_SIZE      (3 * 4)
+
+/**
+ * Read an integer from a saved song, stored in little endian
+ *
+ * @param  [ in]pData The integer
+ * @return            The integer
+ */
+static int readInt(char *pData) {
+    unsigned char *pCur;
+
+    pCur = (unsigned char*)pData;
+    return (int)((unsigned int)pCur[0] | ((unsigned int)pCur[1] << 8) |
+            ((unsigned int)pCur[2] << 16) | ((unsigned int)pCur[3] << 24));
+}
+
+/**
+ * Write an integer into a saved song, in little endian
+ *
+ * @param  [ in]pData Where the integer is written
+ * @param  [ in]val   The integer
+ */
+static void writeInt(char *pData, int val) {
+    pData[0] = (char)(val & 0xff);
+    pData[1] = (char)((val >> 8) & 0xff);
+    pData[2] = (char)((val >> 16) & 0xff);
+    pData[3] = (char)((val >> 24) & 0xff);
+}
+
+/**
+ * Check that a loaded song renders exactly as the compiled one
+ *
+ * @param  [ in]pExpected The compiled song, rendered
+ * @param  [ in]len       The compiled song's length, in bytes
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]handle    Handle of the loaded song
+ * @param  [ in]pName     Name of the loaded song, for logging
+ * @return                SYNTH_OK, SYNTH_INTERNAL_ERR, ...
+ */
+static synth_err checkSong(char *pExpected, int len, synthCtx *pCtx,
+        int handle, char *pName) {
+    char *pRendered;
+    int rendered;
+    synth_err rv;
+
+    pRendered = 0;
+
+    rv = fixture_renderSong(&pRendered, &rendered, pCtx, handle,
+            SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_checkSong(pExpected, len, pRendered, rendered, pName,
+            "the compiled one");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    if (pRendered) {
+        free(pRendered);
+    }
+
+    return rv;
+}
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pData, *pExpected, *pNote;
+    FILE *pFp;
+    int freq, handle, i, len, loadedLen, otherHandle, prevSize, size;
+    synth_err loadedStatus, status;
+    synthCtx *pCtx, *pLoadCtx, *pOtherCtx, *pStaticCtx;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pCtx = 0;
+    pLoadCtx = 0;
+    pOtherCtx = 0;
+    pStaticCtx = 0;
+    pData = 0;
+    pExpected = 0;
+    pFp = 0;
+
+    freq = 44100;
+
+    printf("Initialize the synthesizers...\n");
+    rv = synth_init(&pCtx, freq);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_init(&pLoadCtx, freq);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_init(&pOtherCtx, freq / 2);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_initStatic(&pStaticCtx, 0, freq, MAX_SONGS, MAX_TRACKS,
+            MAX_NOTES, MAX_VOLUMES);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Noises must be the same on every context */
+    rv = synth_setNoiseSeed(pCtx, FIXTURE_NOISE_SEED);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_setNoiseSeed(pLoadCtx, FIXTURE_NOISE_SEED);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_setNoiseSeed(pStaticCtx, FIXTURE_NOISE_SEED);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Compile the song (after another one, so its items don't start at the
+     * beginning of the lists) and save it */
+    printf("Compiling song '%s'...\n", FIXTURE_SONG);
+    rv = synth_compileSongFromStringStatic(&otherHandle, pCtx, __otherSong);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_compileSongFromStringStatic(&handle, pCtx, FIXTURE_SONG);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_renderSong(&pExpected, &len, pCtx, handle,
+            SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    status = synth_canSongLoop(pCtx, handle);
+
+    printf("Saving it to '%s'...\n", __filename);
+    rv = synth_saveCompiled(pCtx, handle, __filename);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Load it on a context without any other song */
+    rv = synth_loadCompiled(&handle, pLoadCtx, __filename);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getSongLength(&loadedLen, pLoadCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    loadedStatus = synth_canSongLoop(pLoadCtx, handle);
+    printf("The loaded song has %i samples (and its loop status is %i)\n",
+            loadedLen, loadedStatus);
+    SYNTH_ASSERT_ERR(loadedLen * 4 == len && loadedStatus == status,
+            SYNTH_INTERNAL_ERR);
+    rv = checkSong(pExpected, len, pLoadCtx, handle, "loaded song");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Loading it again, after releasing it, must reuse its memory */
+    rv = synth_getContextSize(&prevSize, pLoadCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    i = 0;
+    while (i < 10) {
+        rv = synth_freeSong(pLoadCtx, handle);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        rv = synth_loadCompiled(&handle, pLoadCtx, __filename);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        i++;
+    }
+    rv = synth_getContextSize(&size, pLoadCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("The context used %i bytes and now uses %i bytes\n", prevSize,
+            size);
+    SYNTH_ASSERT_ERR(size == prevSize, SYNTH_INTERNAL_ERR);
+    rv = checkSong(pExpected, len, pLoadCtx, handle, "reloaded song");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Songs may also be loaded on static contexts */
+    rv = synth_loadCompiled(&handle, pStaticCtx, __filename);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = checkSong(pExpected, len, pStaticCtx, handle,
+            "statically loaded song");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Songs may only be loaded at the frequency they were compiled */
+    rv = synth_loadCompiled(&handle, pOtherCtx, __filename);
+    printf("Loading it at another frequency returned %i\n", rv);
+    SYNTH_ASSERT_ERR(rv == SYNTH_INVALID_COMPILED_SONG, SYNTH_INTERNAL_ERR);
+
+    /* Truncated and corrupted songs must be rejected */
+    pFp = fopen(__filename, "rb");
+    SYNTH_ASSERT_ERR(pFp, SYNTH_OPEN_FILE_ERR);
+    SYNTH_ASSERT_ERR(fseek(pFp, 0, SEEK_END) == 0, SYNTH_OPEN_FILE_ERR);
+    size = (int)ftell(pFp);
+    SYNTH_ASSERT_ERR(fseek(pFp, 0, SEEK_SET) == 0, SYNTH_OPEN_FILE_ERR);
+    pData = (char*)malloc(size);
+    SYNTH_ASSERT_ERR(pData, SYNTH_MEM_ERR);
+    SYNTH_ASSERT_ERR(fread(pData, 1, size, pFp) == (size_t)size,
+            SYNTH_OPEN_FILE_ERR);
+    fclose(pFp);
+    pFp = 0;
+
+    rv = synth_loadCompiledFromMemory(&handle, pLoadCtx, pData, size - 1);
+    printf("Loading a truncated song returned %i\n", rv);
+    SYNTH_ASSERT_ERR(rv == SYNTH_INVALID_COMPILED_SONG, SYNTH_INTERNAL_ERR);
+
+    /* Lengths are never loaded, so a corrupted length (on the first note,
+     * which isn't a loop) must simply be ignored */
+    pNote = pData + HEADER_SIZE + readInt(pData + NUM_VOLUMES_OFF) *
+            VOLUME_SIZE + readInt(pData + NUM_TRACKS_OFF) * TRACK_SIZE;
+    writeInt(pNote, 1000000);
+    rv = synth_loadCompiledFromMemory(&handle, pLoadCtx, pData, size);
+    printf("Loading a song with a corrupted length returned %i\n", rv);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = checkSong(pExpected, len, pLoadCtx, handle,
+            "song with a corrupted length");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* While a note longer than a compass must be rejected */
+    pNote[4] = (char)0xff;
+    pNote[5] = (char)0x7f;
+    rv = synth_loadCompiledFromMemory(&handle, pLoadCtx, pData, size);
+    printf("Loading a song with a corrupted duration returned %i\n", rv);
+    SYNTH_ASSERT_ERR(rv == SYNTH_INVALID_COMPILED_SONG, SYNTH_INTERNAL_ERR);
+
+    pData[0] = 'X';
+    rv = synth_loadCompiledFromMemory(&handle, pLoadCtx, pData, size);
+    printf("Loading a corrupted song returned %i\n", rv);
+    SYNTH_ASSERT_ERR(rv == SYNTH_INVALID_COMPILED_SONG, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    printf("Releasing resources used by the lib...\n");
+    if (pCtx) {
+        synth_free(&pCtx);
+    }
+    if (pLoadCtx) {
+        synth_free(&pLoadCtx);
+    }
+    if (pOtherCtx) {
+        synth_free(&pOtherCtx);
+    }
+    if (pStaticCtx) {
+        synth_free(&pStaticCtx);
+    }
+
+    if (pFp) {
+        fclose(pFp);
+    }
+    if (pData) {
+        free(pData);
+    }
+    if (pExpected) {
+        free(pExpected);
+    }
+    remove(__filename);
+
+    printf("Exiting...\n");
+    return rv;
+}
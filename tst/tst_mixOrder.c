@@ -0,0 +1,142 @@
+/**
+ * Test that the order of a song's tracks doesn't modify how it's mixed, even
+ * when the mix must be halved to fit the mode
+ *
+ * @file tst/tst_mixOrder.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fixture.h"
+
+/* Loud tracks, of different lengths and loop points, so the shorter ones are
+ * looped until the song's end (and without noises, whose samples depend on the
+ * order that tracks are rendered) */
+static char *__tracks[] = {
+    "l8 o5 v100 c e g > c < g e c e $ [ c e g e c g e g ]3",
+    "l4 v100 p20 o3 c e g e $ g c g c",
+    "l2 w4 v(30, 100) p80 o4 $ e g"
+};
+
+/* Every order of the tracks */
+static int __orders[][3] = {
+    {0, 1, 2},
+    {0, 2, 1},
+    {1, 0, 2},
+    {1, 2, 0},
+    {2, 0, 1},
+    {2, 1, 0}
+};
+
+/* Modes that the songs are rendered on */
+static synthBufMode __modes[] = {
+    SYNTH_2CHAN_16BITS,
+    SYNTH_1CHAN_U8BITS
+};
+
+/**
+ * Compile the song with its tracks on a given order
+ *
+ * @param  [out]pHandle Handle of the song
+ * @param  [ in]pCtx    The synthesizer context
+ * @param  [ in]pOrder  Index of each track on the song
+ * @return              SYNTH_OK, SYNTH_MEM_ERR, ...
+ */
+static synth_err compileSong(int *pHandle, synthCtx *pCtx, int *pOrder) {
+    char pSong[256];
+    int len;
+
+    len = sprintf(pSong, "MML t120 %s ; %s ; %s", __tracks[pOrder[0]],
+            __tracks[pOrder[1]], __tracks[pOrder[2]]);
+    printf("Compiling song '%s'...\n", pSong);
+
+    return synth_compileSongFromString(pHandle, pCtx, pSong, len);
+}
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pExpected, *pRendered;
+    int expected, handle, i, j, numModes, numOrders, rendered;
+    int pHandles[sizeof(__orders) / sizeof(__orders[0])];
+    synthCtx *pCtx;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pCtx = 0;
+    pExpected = 0;
+    pRendered = 0;
+
+    numModes = sizeof(__modes) / sizeof(__modes[0]);
+    numOrders = sizeof(__orders) / sizeof(__orders[0]);
+
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, 44100);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    i = 0;
+    while (i < numOrders) {
+        rv = compileSong(&handle, pCtx, __orders[i]);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        pHandles[i] = handle;
+        i++;
+    }
+
+    /* Every order must be rendered exactly as the first one */
+    i = 0;
+    while (i < numModes) {
+        printf("Rendering every order on mode 0x%04x...\n", __modes[i]);
+        rv = fixture_renderSong(&pExpected, &expected, pCtx, pHandles[0],
+                __modes[i]);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        j = 1;
+        while (j < numOrders) {
+            rv = fixture_renderSong(&pRendered, &rendered, pCtx, pHandles[j],
+                    __modes[i]);
+            SYNTH_ASSERT(rv == SYNTH_OK);
+
+            rv = fixture_checkSong(pExpected, expected, pRendered, rendered,
+                    "reordered song", "the first one");
+            SYNTH_ASSERT(rv == SYNTH_OK);
+
+            free(pRendered);
+            pRendered = 0;
+            j++;
+        }
+
+        free(pExpected);
+        pExpected = 0;
+        i++;
+    }
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+
+    if (pExpected) {
+        free(pExpected);
+    }
+    if (pRendered) {
+        free(pRendered);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
@@ -0,0 +1,292 @@
+/**
+ * Test that mixing tracks saturates every sample that doesn't fit the mode's
+ * range, and that such overflows are reported whether they happen on the
+ * vectorized part of the buffer or on the samples left after it
+ *
+ * @file tst/tst_mixerSaturate.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_mixer.h>
+#include <c_synth_internal/synth_types.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* How many samples are mixed; Not a multiple of a vector, so some samples are
+ * always left to the scalar code */
+#define NUM_SAMPLES 37
+/* Size of the buffers, in bytes (enough for 2 channels of 16 bits) */
+#define BUF_SIZE    (NUM_SAMPLES * 4)
+
+/* Every mode that may be mixed */
+static synthBufMode __modes[] = {
+    SYNTH_1CHAN_U8BITS,
+    SYNTH_1CHAN_8BITS,
+    SYNTH_1CHAN_U16BITS,
+    SYNTH_1CHAN_16BITS,
+    SYNTH_2CHAN_U8BITS,
+    SYNTH_2CHAN_8BITS,
+    SYNTH_2CHAN_U16BITS,
+    SYNTH_2CHAN_16BITS
+};
+
+/**
+ * Retrieve the range of a sample on a given mode
+ *
+ * @param  [out]pMax The largest sample
+ * @param  [out]pMin The smallest sample
+ * @param  [ in]mode The mode
+ */
+static void getRange(int *pMax, int *pMin, synthBufMode mode) {
+    if (mode & SYNTH_16BITS) {
+        *pMax = (mode & SYNTH_SIGNED) ? 0x7fff : 0xffff;
+        *pMin = (mode & SYNTH_SIGNED) ? -0x8000 : 0;
+    }
+    else {
+        *pMax = (mode & SYNTH_SIGNED) ? 0x7f : 0xff;
+        *pMin = (mode & SYNTH_SIGNED) ? -0x80 : 0;
+    }
+}
+
+/**
+ * Retrieve how many values (i.e., samples on every channel) there are on the
+ * buffers
+ *
+ * @param  [ in]mode The mode
+ * @return           The number of values
+ */
+static int getNumValues(synthBufMode mode) {
+    return (mode & SYNTH_2CHAN) ? NUM_SAMPLES * 2 : NUM_SAMPLES;
+}
+
+/**
+ * Read a value from a buffer
+ *
+ * @param  [ in]pBuf The buffer
+ * @param  [ in]i    Index of the value (not of the byte)
+ * @param  [ in]mode The buffer's mode
+ * @return           The value
+ */
+static int getValue(char *pBuf, int i, synthBufMode mode) {
+    if (mode & SYNTH_16BITS) {
+        int val;
+
+        val = (pBuf[i * 2] & 0xff) | ((pBuf[i * 2 + 1] & 0xff) << 8);
+        if ((mode & SYNTH_SIGNED) && (val & 0x8000)) {
+            val -= 0x10000;
+        }
+        return val;
+    }
+    else if (mode & SYNTH_SIGNED) {
+        return (signed char)pBuf[i];
+    }
+    return (unsigned char)pBuf[i];
+}
+
+/**
+ * Write a value into a buffer
+ *
+ * @param  [ in]pBuf The buffer
+ * @param  [ in]i    Index of the value (not of the byte)
+ * @param  [ in]val  The value
+ * @param  [ in]mode The buffer's mode
+ */
+static void setValue(char *pBuf, int i, int val, synthBufMode mode) {
+    if (mode & SYNTH_16BITS) {
+        pBuf[i * 2] = val & 0xff;
+        pBuf[i * 2 + 1] = (val >> 8) & 0xff;
+    }
+    else {
+        pBuf[i] = val & 0xff;
+    }
+}
+
+/**
+ * Generate a pseudo-random number, from a linear congruential generator
+ *
+ * @param  [ in]pSeed The generator's state (it's updated)
+ * @param  [ in]range How many numbers may be generated
+ * @return            A number in the range [0, range)
+ */
+static int getRandom(unsigned int *pSeed, int range) {
+    *pSeed = *pSeed * 1103515245 + 12345;
+    return (int)((*pSeed >> 8) & 0xffff) % range;
+}
+
+/**
+ * Mix two buffers and check that every value was saturated and that the
+ * overflow was reported only if any value didn't fit
+ *
+ * @param  [ in]pDst  Buffer that is mixed into (it's modified)
+ * @param  [ in]pSrc  Buffer that is mixed
+ * @param  [ in]mode  The buffers' mode
+ * @param  [ in]pName Name of the check, for logging
+ * @return            SYNTH_OK, SYNTH_INTERNAL_ERR
+ */
+static synth_err checkMix(char *pDst, char *pSrc, synthBufMode mode,
+        char *pName) {
+    int expected[BUF_SIZE];
+    int i, max, min, num;
+    synth_bool didOverflow, overflow;
+    synth_err rv;
+
+    getRange(&max, &min, mode);
+    num = getNumValues(mode);
+
+    /* Calculate the expected mix, without any wrapping */
+    overflow = SYNTH_FALSE;
+    i = 0;
+    while (i < num) {
+        expected[i] = getValue(pDst, i, mode) + getValue(pSrc, i, mode);
+        if (expected[i] > max) {
+            expected[i] = max;
+            overflow = SYNTH_TRUE;
+        }
+        else if (expected[i] < min) {
+            expected[i] = min;
+            overflow = SYNTH_TRUE;
+        }
+        i++;
+    }
+
+    didOverflow = synthMixer_accumulate(pDst, pSrc, mode, NUM_SAMPLES);
+
+    i = 0;
+    while (i < num) {
+        if (getValue(pDst, i, mode) != expected[i]) {
+            printf("Mode 0x%04x (%s): value %i was mixed into %i (expected "
+                    "%i)\n", mode, pName, i, getValue(pDst, i, mode),
+                    expected[i]);
+            SYNTH_ASSERT_ERR(0, SYNTH_INTERNAL_ERR);
+        }
+        i++;
+    }
+
+    if (didOverflow != overflow) {
+        printf("Mode 0x%04x (%s): the overflow was %sreported\n", mode, pName,
+                didOverflow ? "" : "not ");
+        SYNTH_ASSERT_ERR(0, SYNTH_INTERNAL_ERR);
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Mix two silent buffers, except for a single value on each
+ *
+ * @param  [ in]pDst  Buffer that is mixed into
+ * @param  [ in]pSrc  Buffer that is mixed
+ * @param  [ in]mode  The buffers' mode
+ * @param  [ in]i     Index of the value that isn't silent
+ * @param  [ in]dst   The value on the buffer that is mixed into
+ * @param  [ in]src   The value on the buffer that is mixed
+ * @param  [ in]pName Name of the check, for logging
+ * @return            SYNTH_OK, SYNTH_INTERNAL_ERR
+ */
+static synth_err checkValue(char *pDst, char *pSrc, synthBufMode mode, int i,
+        int dst, int src, char *pName) {
+    int j, num;
+
+    num = getNumValues(mode);
+    j = 0;
+    while (j < num) {
+        setValue(pDst, j, 0, mode);
+        setValue(pSrc, j, 0, mode);
+        j++;
+    }
+    setValue(pDst, i, dst, mode);
+    setValue(pSrc, i, src, mode);
+
+    return checkMix(pDst, pSrc, mode, pName);
+}
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char pDst[BUF_SIZE], pSrc[BUF_SIZE];
+    int i, j, last, max, min, num;
+    unsigned int seed;
+    synthBufMode mode;
+    synth_err rv;
+
+    seed = 0x5eed;
+
+    i = 0;
+    while (i < (int)(sizeof(__modes) / sizeof(__modes[0]))) {
+        mode = __modes[i];
+        getRange(&max, &min, mode);
+        num = getNumValues(mode);
+        last = num - 1;
+
+        printf("Mixing buffers on mode 0x%04x...\n", mode);
+
+        /* Loud buffers, most of whose values clip */
+        j = 0;
+        while (j < num) {
+            setValue(pDst, j, min + getRandom(&seed, max - min + 1), mode);
+            setValue(pSrc, j, min + getRandom(&seed, max - min + 1), mode);
+            j++;
+        }
+        rv = checkMix(pDst, pSrc, mode, "loud buffers");
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        /* Quiet buffers, which never clip */
+        j = 0;
+        while (j < num) {
+            setValue(pDst, j, min / 2 + getRandom(&seed, (max - min) / 2),
+                    mode);
+            setValue(pSrc, j, getRandom(&seed, (max + 1) / 4), mode);
+            j++;
+        }
+        rv = checkMix(pDst, pSrc, mode, "quiet buffers");
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        /* Values that reach, but don't cross, the range's limits */
+        rv = checkValue(pDst, pSrc, mode, 0, max - 1, 1, "first at the max");
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        rv = checkValue(pDst, pSrc, mode, last, max - 1, 1, "last at the max");
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        /* A single value that clips, either on the vectorized part or on the
+         * values left after it */
+        rv = checkValue(pDst, pSrc, mode, 0, max, 1, "first over the max");
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        rv = checkValue(pDst, pSrc, mode, last, max, 1, "last over the max");
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        if (mode & SYNTH_SIGNED) {
+            rv = checkValue(pDst, pSrc, mode, 0, min + 1, -1,
+                    "first at the min");
+            SYNTH_ASSERT(rv == SYNTH_OK);
+            rv = checkValue(pDst, pSrc, mode, 0, min, -1,
+                    "first under the min");
+            SYNTH_ASSERT(rv == SYNTH_OK);
+            rv = checkValue(pDst, pSrc, mode, last, min, -1,
+                    "last under the min");
+            SYNTH_ASSERT(rv == SYNTH_OK);
+        }
+
+        i++;
+    }
+
+    printf("Every mix was saturated and reported correctly\n");
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
@@ -0,0 +1,113 @@
+/**
+ * Test that noises generated by the shift register are deterministic and
+ * different from the default (gaussian) ones
+ *
+ * @file tst/tst_noiseMode.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fixture.h"
+
+
+/**
+ * Compile the song on a new context and render it into a newly alloc'ed buffer
+ *
+ * @param  [out]ppBuf The rendered song
+ * @param  [out]pLen  The song's length, in bytes
+ * @param  [ in]mode  How noises are generated
+ * @return            SYNTH_OK, SYNTH_MEM_ERR, ...
+ */
+static synth_err renderSong(char **ppBuf, int *pLen, synthNoiseMode mode) {
+    int handle;
+    synthCtx *pCtx;
+    synth_err rv;
+
+    pCtx = 0;
+
+    rv = synth_init(&pCtx, 44100);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_setNoiseSeed(pCtx, FIXTURE_NOISE_SEED);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_setNoiseMode(pCtx, mode);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_compileSongFromStringStatic(&handle, pCtx, FIXTURE_SONG);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = fixture_renderSong(ppBuf, pLen, pCtx, handle, SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    if (pCtx) {
+        synth_free(&pCtx);
+    }
+
+    return rv;
+}
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pGaussian, *pLFSR, *pOtherLFSR;
+    int diff, gaussian, lfsr, otherLFSR;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pGaussian = 0;
+    pLFSR = 0;
+    pOtherLFSR = 0;
+
+    printf("Rendering the song with gaussian noises...\n");
+    rv = renderSong(&pGaussian, &gaussian, SYNTH_NOISE_GAUSSIAN);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    printf("Rendering the song with noises from a shift register...\n");
+    rv = renderSong(&pLFSR, &lfsr, SYNTH_NOISE_LFSR);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* The same seed must give the same noises, even on another context */
+    printf("Rendering it again on another context...\n");
+    rv = renderSong(&pOtherLFSR, &otherLFSR, SYNTH_NOISE_LFSR);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = fixture_checkSong(pLFSR, lfsr, pOtherLFSR, otherLFSR,
+            "other context's song", "the first one");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    SYNTH_ASSERT_ERR(lfsr == gaussian, SYNTH_INTERNAL_ERR);
+    diff = memcmp(pLFSR, pGaussian, lfsr);
+    printf("The shift register noises %s the gaussian ones\n",
+            diff ? "differ from" : "match");
+    SYNTH_ASSERT_ERR(diff != 0, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pGaussian) {
+        free(pGaussian);
+    }
+    if (pLFSR) {
+        free(pLFSR);
+    }
+    if (pOtherLFSR) {
+        free(pOtherLFSR);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
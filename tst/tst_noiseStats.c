@@ -0,0 +1,231 @@
+/**
+ * Test that every noise generator has the expected distribution (both
+ * gaussians and the shift register's uniform one, with the same RMS) and that
+ * a span generated at once is exactly the same as one generated value by
+ * value, in any order
+ *
+ * @file tst/tst_noiseStats.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_prng.h>
+#include <c_synth_internal/synth_types.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* How many values are generated for the statistics */
+#define NUM_VALUES  (256 * 1024)
+/* How many values are generated value by value (many LFSR reseeds) */
+#define NUM_SPAN    4096
+/* Size of the chunks used to generate the span out of order */
+#define CHUNK       7
+/* Stream of the generated values */
+#define TRACK       1
+#define NOTE        2
+/* Standard deviation of every noise (i.e., of a gaussian divided by 6.7) */
+#define SIGMA       (1.0 / 6.7)
+
+/* Every noise generator, its name and the expected fraction of values within
+ * 1, 2 and 3 standard deviations from the mean */
+static enum enNoiseWaveType __types[] = {
+    NW_ZIGGURAT,
+    NW_BOXMULLER,
+    NW_LFSR
+};
+static char *__names[] = {
+    "ziggurat",
+    "Box-Muller",
+    "LFSR"
+};
+static double __within[][3] = {
+    {0.682689, 0.954500, 0.997300},
+    {0.682689, 0.954500, 0.997300},
+    /* A uniform distribution ends at sqrt(3) standard deviations */
+    {0.577350, 1.000000, 1.000000}
+};
+
+/**
+ * Check the mean, the variance and how many values fall within 1, 2 and 3
+ * standard deviations of a noise
+ *
+ * @param  [ in]pBuf    The generated noise
+ * @param  [ in]pWithin The expected fraction within each standard deviation
+ * @param  [ in]pName   Name of the generator, for logging
+ * @return              SYNTH_OK, SYNTH_INTERNAL_ERR
+ */
+static synth_err checkStats(double *pBuf, double *pWithin, char *pName) {
+    double mean, variance;
+    int i, j, pCount[3];
+    synth_err rv;
+
+    mean = 0.0;
+    variance = 0.0;
+    pCount[0] = 0;
+    pCount[1] = 0;
+    pCount[2] = 0;
+    i = 0;
+    while (i < NUM_VALUES) {
+        SYNTH_ASSERT_ERR(pBuf[i] >= -1.0 && pBuf[i] <= 1.0,
+                SYNTH_INTERNAL_ERR);
+
+        mean += pBuf[i];
+        variance += pBuf[i] * pBuf[i];
+        j = 0;
+        while (j < 3) {
+            if (fabs(pBuf[i]) < (j + 1) * SIGMA) {
+                pCount[j]++;
+            }
+            j++;
+        }
+        i++;
+    }
+    mean /= NUM_VALUES;
+    variance = variance / NUM_VALUES - mean * mean;
+
+    printf("The %s noise has mean %f and standard deviation %f (expected "
+            "%f)\n", pName, mean, sqrt(variance), SIGMA);
+    /* Allow 5 standard errors for the mean and 2% for the variance */
+    SYNTH_ASSERT_ERR(fabs(mean) < 5.0 * SIGMA / sqrt(NUM_VALUES),
+            SYNTH_INTERNAL_ERR);
+    SYNTH_ASSERT_ERR(fabs(variance / (SIGMA * SIGMA) - 1.0) < 0.02,
+            SYNTH_INTERNAL_ERR);
+
+    j = 0;
+    while (j < 3) {
+        double within;
+
+        within = (double)pCount[j] / NUM_VALUES;
+        printf("  %f of it is within %i standard deviations (expected %f)\n",
+                within, j + 1, pWithin[j]);
+        SYNTH_ASSERT_ERR(fabs(within - pWithin[j]) < 0.005,
+                SYNTH_INTERNAL_ERR);
+        j++;
+    }
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Check that generating a span value by value (forward and backward) and in
+ * chunks (from the last to the first) gives the same values as generating it
+ * at once
+ *
+ * @param  [ in]pBuf  The span, generated at once
+ * @param  [ in]pCtx  The context
+ * @param  [ in]pName Name of the generator, for logging
+ * @return            SYNTH_OK, SYNTH_INTERNAL_ERR, ...
+ */
+static synth_err checkSpan(double *pBuf, synthPRNGCtx *pCtx, char *pName) {
+    double pChunk[CHUNK];
+    double val;
+    int i, j, mismatches, num;
+    synth_err rv;
+
+    mismatches = 0;
+
+    i = 0;
+    while (i < NUM_SPAN) {
+        rv = synthPRNG_getNoise(&val, 1, pCtx, TRACK, NOTE, i);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        if (val != pBuf[i]) {
+            mismatches++;
+        }
+        i++;
+    }
+
+    i = NUM_SPAN - 1;
+    while (i >= 0) {
+        rv = synthPRNG_getNoise(&val, 1, pCtx, TRACK, NOTE, i);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        if (val != pBuf[i]) {
+            mismatches++;
+        }
+        i--;
+    }
+
+    i = (NUM_SPAN / CHUNK) * CHUNK;
+    while (i >= 0) {
+        num = NUM_SPAN - i;
+        if (num > CHUNK) {
+            num = CHUNK;
+        }
+
+        rv = synthPRNG_getNoise(pChunk, num, pCtx, TRACK, NOTE, i);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        j = 0;
+        while (j < num) {
+            if (pChunk[j] != pBuf[i + j]) {
+                mismatches++;
+            }
+            j++;
+        }
+        i -= CHUNK;
+    }
+
+    printf("The %s noise generated by parts had %i mismatches\n", pName,
+            mismatches);
+    SYNTH_ASSERT_ERR(mismatches == 0, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    double *pBuf;
+    int i;
+    synthPRNGCtx ctx;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pBuf = 0;
+
+    pBuf = (double*)malloc(NUM_VALUES * sizeof(double));
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_MEM_ERR);
+
+    rv = synthPRNG_init(&ctx, 0x5eed);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    i = 0;
+    while (i < (int)(sizeof(__types) / sizeof(__types[0]))) {
+        printf("Generating %i values of %s noise...\n", NUM_VALUES,
+                __names[i]);
+        rv = synthPRNG_setNoiseType(&ctx, __types[i]);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        rv = synthPRNG_getNoise(pBuf, NUM_VALUES, &ctx, TRACK, NOTE, 0);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        rv = checkStats(pBuf, __within[i], __names[i]);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        rv = checkSpan(pBuf, &ctx, __names[i]);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        i++;
+    }
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pBuf) {
+        free(pBuf);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
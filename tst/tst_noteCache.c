@@ -0,0 +1,170 @@
+/**
+ * Test that the cache of rendered notes doesn't modify the output, that it
+ * never grows past its size and that its counters are updated
+ *
+ * @file tst/tst_noteCache.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fixture.h"
+
+/* Size of a cache large enough for every note of the song */
+#define LARGE_CACHE (4 * 1024 * 1024)
+/* Size of a cache that only fits a few notes of the song */
+#define SMALL_CACHE (64 * 1024)
+
+/**
+ * Render a song and compare it against the expected one
+ *
+ * @param  [ in]pExpected The song rendered without the cache
+ * @param  [ in]pBuf      Buffer for the rendered song
+ * @param  [ in]pTmp      Temporary buffer, as large as the song
+ * @param  [ in]len       The song's length, in bytes
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]handle    Handle of the song
+ * @return                SYNTH_OK, SYNTH_INTERNAL_ERR, ...
+ */
+static synth_err checkSong(char *pExpected, char *pBuf, char *pTmp, int len,
+        synthCtx *pCtx, int handle) {
+    synth_err rv;
+
+    rv = synth_renderSong(pBuf, pCtx, handle, SYNTH_2CHAN_16BITS, pTmp);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = fixture_checkSong(pExpected, len, pBuf, len, "cached song",
+            "the uncached one");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pBuf, *pSong, *pTmp;
+    int bytes, handle, hits, len, misses, prevHits, prevMisses;
+    synthCtx *pCtx;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pCtx = 0;
+    pBuf = 0;
+    pSong = 0;
+    pTmp = 0;
+
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, 44100);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_setNoiseSeed(pCtx, FIXTURE_NOISE_SEED);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    printf("Compiling static song '%s'...\n", FIXTURE_SONG);
+    rv = synth_compileSongFromStringStatic(&handle, pCtx, FIXTURE_SONG);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getSongLength(&len, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    len *= 4;
+
+    pSong = (char*)malloc(len);
+    SYNTH_ASSERT_ERR(pSong, SYNTH_MEM_ERR);
+    pBuf = (char*)malloc(len);
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_MEM_ERR);
+    pTmp = (char*)malloc(len);
+    SYNTH_ASSERT_ERR(pTmp, SYNTH_MEM_ERR);
+
+    /* Render the song without the cache, which must then be left untouched */
+    printf("Rendering the song without the cache...\n");
+    rv = synth_setNoteCacheSize(pCtx, 0);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_renderSong(pSong, pCtx, handle, SYNTH_2CHAN_16BITS, pTmp);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getNoteCacheStats(&hits, &misses, &bytes, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Cache: %i hits, %i misses, %i bytes\n", hits, misses, bytes);
+    SYNTH_ASSERT_ERR(hits == 0 && misses == 0 && bytes == 0,
+            SYNTH_INTERNAL_ERR);
+
+    /* Render it with a cache large enough for every note; Notes that repeat
+     * must be copied from the cache */
+    printf("Rendering the song with a %i bytes cache...\n", LARGE_CACHE);
+    rv = synth_setNoteCacheSize(pCtx, LARGE_CACHE);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = checkSong(pSong, pBuf, pTmp, len, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getNoteCacheStats(&hits, &misses, &bytes, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Cache: %i hits, %i misses, %i bytes\n", hits, misses, bytes);
+    SYNTH_ASSERT_ERR(hits > 0 && misses > 0, SYNTH_INTERNAL_ERR);
+    SYNTH_ASSERT_ERR(bytes > 0 && bytes <= LARGE_CACHE, SYNTH_INTERNAL_ERR);
+
+    /* Render it again; Since every note was kept, none may be missed */
+    printf("Rendering the song again...\n");
+    prevHits = hits;
+    prevMisses = misses;
+    rv = checkSong(pSong, pBuf, pTmp, len, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getNoteCacheStats(&hits, &misses, &bytes, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Cache: %i hits, %i misses, %i bytes\n", hits, misses, bytes);
+    SYNTH_ASSERT_ERR(hits > prevHits && misses == prevMisses,
+            SYNTH_INTERNAL_ERR);
+
+    /* Render it with a cache too small for the song, which must not grow past
+     * its size (and still render the same song) */
+    printf("Rendering the song with a %i bytes cache...\n", SMALL_CACHE);
+    rv = synth_setNoteCacheSize(pCtx, SMALL_CACHE);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_getNoteCacheStats(&hits, &misses, &bytes, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    SYNTH_ASSERT_ERR(bytes == 0, SYNTH_INTERNAL_ERR);
+
+    prevMisses = misses;
+    rv = checkSong(pSong, pBuf, pTmp, len, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getNoteCacheStats(&hits, &misses, &bytes, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Cache: %i hits, %i misses, %i bytes\n", hits, misses, bytes);
+    SYNTH_ASSERT_ERR(misses > prevMisses, SYNTH_INTERNAL_ERR);
+    SYNTH_ASSERT_ERR(bytes > 0 && bytes <= SMALL_CACHE, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+
+    if (pBuf) {
+        free(pBuf);
+    }
+    if (pSong) {
+        free(pSong);
+    }
+    if (pTmp) {
+        free(pTmp);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
@@ -0,0 +1,175 @@
+/**
+ * Test that every note is rendered exactly the same by the selected (possibly
+ * vectorized) kernels and by the scalar ones
+ *
+ * @file tst/tst_noteKernels.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_list.h>
+#include <c_synth_internal/synth_note.h>
+#include <c_synth_internal/synth_types.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Song using every non-noise wave, with varying envelopes, volumes and pans */
+static char __song[] = "MML t120 l8 o4 "
+        "w0 c d w1 e f w2 g a w3 b > c < w4 c e r "
+        "k20 q50 h80 v(20, 100) p20 w0 c g w2 e w4 a "
+        "k0 q100 h100 v(100, 0) p80 w1 > c < w3 d w4 o1 c o8 b o4 "
+        "k60 q70 h90 v60 p0 w0 c4 w4 g4 p100 w3 e16 w1 c16 ";
+
+/* Every buffer mode */
+static synthBufMode __modes[] = {
+    SYNTH_1CHAN_U8BITS,
+    SYNTH_1CHAN_8BITS,
+    SYNTH_1CHAN_U16BITS,
+    SYNTH_1CHAN_16BITS,
+    SYNTH_2CHAN_U8BITS,
+    SYNTH_2CHAN_8BITS,
+    SYNTH_2CHAN_U16BITS,
+    SYNTH_2CHAN_16BITS
+};
+
+/* Note lengths (in samples) that exercise every partial iteration */
+static int __durations[] = { 1, 7, 8, 9, 15, 17, 100, 1023, 5513 };
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pExpected, *pRendered;
+    int handle, i, mismatches, num;
+    synthCtx *pCtx;
+    synth_err rv;
+
+    /* Clean the context, so it's not freed on error */
+    pCtx = 0;
+    pExpected = 0;
+    pRendered = 0;
+    mismatches = 0;
+    num = 0;
+
+    /* Initialize it */
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, 44100);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    printf("Compiling static song '%s'...\n", __song);
+    rv = synth_compileSongFromStringStatic(&handle, pCtx, __song);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Alloc enough memory for the longest note on the widest mode */
+    pExpected = (char*)malloc(5513 * 4);
+    SYNTH_ASSERT_ERR(pExpected, SYNTH_MEM_ERR);
+    pRendered = (char*)malloc(5513 * 4);
+    SYNTH_ASSERT_ERR(pRendered, SYNTH_MEM_ERR);
+
+    printf("Comparing kernels...\n");
+    i = 0;
+    while (i < pCtx->notes.used) {
+        synthNote *pNote;
+        int m;
+
+        pNote = SYNTH_NOTE(pCtx, i);
+        /* Noises have no vectorized kernel (and would consume the PRNG) */
+        if (synthNote_isLoop(pNote) == SYNTH_TRUE || pNote->wave >= W_NOISE) {
+            i++;
+            continue;
+        }
+
+        m = 0;
+        while (m < sizeof(__modes) / sizeof(synthBufMode)) {
+            synthNoteKernel kernel, scalar;
+            int d, numBytes;
+
+            rv = synthNote_getKernel(&kernel, pNote, __modes[m]);
+            SYNTH_ASSERT(rv == SYNTH_OK);
+            rv = synthNote_getScalarKernel(&scalar, pNote, __modes[m]);
+            SYNTH_ASSERT(rv == SYNTH_OK);
+
+            numBytes = 1;
+            if (__modes[m] & SYNTH_16BITS) {
+                numBytes *= 2;
+            }
+            if (__modes[m] & SYNTH_2CHAN) {
+                numBytes *= 2;
+            }
+
+            d = 0;
+            while (d < sizeof(__durations) / sizeof(int)) {
+                int duration, offset;
+
+                duration = __durations[d];
+
+                /* Render the whole note and, then, starting mid-note */
+                offset = 0;
+                while (offset < duration) {
+                    int count;
+
+                    count = duration - offset;
+
+                    memset(pExpected, 0xa5, count * numBytes);
+                    memset(pRendered, 0x5a, count * numBytes);
+
+                    rv = synthNote_renderRange(pExpected, pNote, pCtx,
+                            &(pCtx->prngCtx), scalar, 0, i,
+                            duration, offset, count);
+                    SYNTH_ASSERT(rv == SYNTH_OK);
+                    rv = synthNote_renderRange(pRendered, pNote, pCtx,
+                            &(pCtx->prngCtx), kernel, 0, i,
+                            duration, offset, count);
+                    SYNTH_ASSERT(rv == SYNTH_OK);
+
+                    if (memcmp(pExpected, pRendered, count * numBytes) != 0) {
+                        printf("Note %i (wave %i) differs on mode 0x%x, with "
+                                "%i samples starting at %i\n", i, pNote->wave,
+                                __modes[m], count, offset);
+                        mismatches++;
+                    }
+                    num++;
+
+                    offset += 1 + duration / 3;
+                }
+
+                d++;
+            }
+
+            m++;
+        }
+
+        i++;
+    }
+
+    printf("Compared %i renders, %i mismatches\n", num, mismatches);
+    SYNTH_ASSERT_ERR(mismatches == 0, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pExpected) {
+        free(pExpected);
+    }
+    if (pRendered) {
+        free(pRendered);
+    }
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
+
@@ -0,0 +1,168 @@
+/**
+ * Test that every note, on every octave, advances its phase (and is rendered)
+ * at the expected frequency, within a tolerance much smaller than a semitone
+ *
+ * @file tst/tst_notePitch.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_list.h>
+#include <c_synth_internal/synth_note.h>
+#include <c_synth_internal/synth_types.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Song with a single square note, whose pitch is modified */
+static char __song[] = "MML t120 l1 o4 w0 q100 c";
+
+/* Frequency of the synthesizer */
+#define FREQUENCY   44100
+/* How many samples are rendered for each note (i.e., a second) */
+#define NUM_SAMPLES FREQUENCY
+/* Maximum relative error of the frequency (a semitone is almost 6%) */
+#define TOLERANCE   0.005
+
+/**
+ * Calculate a note's frequency on the equal temperament; Note that the
+ * synthesizer's octaves are one lower than the usual ones (i.e., its A5 is
+ * 440Hz), since its table starts at B7 and is shifted by '9 - octave'
+ *
+ * @param  [ in]octave The note's octave
+ * @param  [ in]note   The note
+ * @return             The frequency, in Hz
+ */
+static double getFrequency(int octave, int note) {
+    return 440.0 * pow(2.0, ((octave - 5) * 12 + (note - N_A)) / 12.0);
+}
+
+/**
+ * Measure the frequency of a rendered square wave, from the distance between
+ * its first and last rising edges
+ *
+ * @param  [ in]pBuf The wave, as signed 16 bits samples
+ * @param  [ in]len  How many samples there are in the wave
+ * @return           The frequency, in Hz (or 0, if less than 2 edges were found)
+ */
+static double measureFrequency(short *pBuf, int len) {
+    int first, i, last, num;
+
+    first = -1;
+    last = -1;
+    num = 0;
+    i = 1;
+    while (i < len) {
+        if (pBuf[i - 1] <= 0 && pBuf[i] > 0) {
+            if (first == -1) {
+                first = i;
+            }
+            last = i;
+            num++;
+        }
+        i++;
+    }
+
+    if (num < 2) {
+        return 0.0;
+    }
+    return (num - 1) * (double)FREQUENCY / (last - first);
+}
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    short *pBuf;
+    int handle, mismatches, note, octave;
+    synthCtx *pCtx;
+    synthNote *pNote;
+    synthNoteKernel kernel;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pCtx = 0;
+    pBuf = 0;
+    mismatches = 0;
+
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, FREQUENCY);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    printf("Compiling static song '%s'...\n", __song);
+    rv = synth_compileSongFromStringStatic(&handle, pCtx, __song);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    pNote = SYNTH_NOTE(pCtx, 0);
+
+    pBuf = (short*)malloc(NUM_SAMPLES * sizeof(short));
+    SYNTH_ASSERT_ERR(pBuf, SYNTH_MEM_ERR);
+
+    printf("Checking every note from C1 to B8...\n");
+    octave = 1;
+    while (octave <= 8) {
+        note = N_C;
+        while (note <= N_B) {
+            double expected, measured, samples;
+
+            expected = getFrequency(octave, note);
+
+            /* The phase advanced each sample must be a cycle divided by the
+             * number of samples in a cycle */
+            samples = 4294967296.0 / pCtx->phaseIncrement[octave - 1][note];
+            if (fabs(samples * expected / FREQUENCY - 1.0) > TOLERANCE) {
+                printf("Note %i on octave %i takes %f samples per cycle "
+                        "(expected %f)\n", note, octave, samples,
+                        FREQUENCY / expected);
+                mismatches++;
+            }
+
+            /* And so must the rendered note */
+            rv = synthNote_setOctave(pNote, octave);
+            SYNTH_ASSERT(rv == SYNTH_OK);
+            rv = synthNote_setNote(pNote, note);
+            SYNTH_ASSERT(rv == SYNTH_OK);
+            rv = synthNote_getKernel(&kernel, pNote, SYNTH_1CHAN_16BITS);
+            SYNTH_ASSERT(rv == SYNTH_OK);
+            rv = synthNote_render((char*)pBuf, pNote, pCtx, &(pCtx->prngCtx),
+                    kernel, 0, 0, NUM_SAMPLES);
+            SYNTH_ASSERT(rv == SYNTH_OK);
+
+            measured = measureFrequency(pBuf, NUM_SAMPLES);
+            if (fabs(measured / expected - 1.0) > TOLERANCE) {
+                printf("Note %i on octave %i was rendered at %fHz "
+                        "(expected %fHz)\n", note, octave, measured, expected);
+                mismatches++;
+            }
+
+            note++;
+        }
+
+        octave++;
+    }
+
+    printf("Found %i mismatched pitches\n", mismatches);
+    SYNTH_ASSERT_ERR(mismatches == 0, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pBuf) {
+        free(pBuf);
+    }
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
@@ -0,0 +1,160 @@
+/**
+ * Test that a looping song played back from segments is exactly the same as
+ * the one rendered by a cursor, over many iterations of its loop
+ *
+ * @file tst/tst_renderSegments.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fixture.h"
+
+/* How many times the song's loop is played, after the song itself */
+#define NUM_LOOPS  3
+/* How many samples are rendered at a time */
+#define CHUNK_SIZE 4096
+/* How many bytes each sample takes */
+#define SAMPLE_SIZE 4
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pChunks, *pSegmented;
+    int bytes, diff, handle, intro, len, num, pos, total;
+    synthCtx *pCtx;
+    synthCursor *pCursor;
+    synthSegments *pSegments;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pCtx = 0;
+    pCursor = 0;
+    pSegments = 0;
+    pChunks = 0;
+    pSegmented = 0;
+
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, 44100);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_setNoiseSeed(pCtx, FIXTURE_NOISE_SEED);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    printf("Compiling static song '%s'...\n", FIXTURE_SONG);
+    rv = synth_compileSongFromStringStatic(&handle, pCtx, FIXTURE_SONG);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getSongLength(&len, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_getSongIntroLength(&intro, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    SYNTH_ASSERT_ERR(intro < len, SYNTH_INTERNAL_ERR);
+    printf("Song requires %i samples and loops at %i\n", len, intro);
+
+    /* Play the song and then its loop a few more times */
+    total = len + NUM_LOOPS * (len - intro);
+    pChunks = (char*)malloc((total + CHUNK_SIZE) * SAMPLE_SIZE);
+    SYNTH_ASSERT_ERR(pChunks, SYNTH_MEM_ERR);
+    pSegmented = (char*)malloc((total + CHUNK_SIZE) * SAMPLE_SIZE);
+    SYNTH_ASSERT_ERR(pSegmented, SYNTH_MEM_ERR);
+
+    printf("Rendering %i samples with a cursor...\n", total);
+    rv = synth_initCursor(&pCursor, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    pos = 0;
+    while (pos < total) {
+        rv = synth_renderSongChunk(pChunks + pos * SAMPLE_SIZE, pCtx, handle,
+                pCursor, CHUNK_SIZE, SYNTH_2CHAN_16BITS);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        pos += CHUNK_SIZE;
+    }
+
+    printf("Rendering %i samples from segments...\n", total);
+    rv = synth_initSegments(&pSegments, pCtx, handle, SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_getSegmentsSize(&bytes, pSegments);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Segments use %i bytes\n", bytes);
+
+    /* Use chunks of varying size, so they don't line up with the cursor's */
+    num = 1;
+    pos = 0;
+    while (pos < total) {
+        rv = synth_renderSegments(pSegmented + pos * SAMPLE_SIZE, pSegments,
+                num);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        pos += num;
+        num = num * 3 % CHUNK_SIZE + 1;
+    }
+
+    diff = 0;
+    pos = 0;
+    while (pos < total) {
+        if (memcmp(pChunks + pos * SAMPLE_SIZE, pSegmented + pos * SAMPLE_SIZE,
+                SAMPLE_SIZE) != 0) {
+            diff++;
+        }
+
+        pos++;
+    }
+    printf("Found %i mismatched samples (of %i)\n", diff, total);
+    SYNTH_ASSERT_ERR(diff == 0, SYNTH_INTERNAL_ERR);
+
+    /* Play it again after resetting both, in a single chunk each */
+    printf("Rendering it again after resetting both...\n");
+    rv = synth_resetCursor(pCursor, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_resetSegments(pSegments);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_renderSongChunk(pChunks, pCtx, handle, pCursor, total,
+            SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_renderSegments(pSegmented, pSegments, total);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    diff = memcmp(pChunks, pSegmented, total * SAMPLE_SIZE);
+    printf("The reset segments %s the cursor\n", diff ? "differ from" :
+            "match");
+    SYNTH_ASSERT_ERR(diff == 0, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pSegments) {
+        synth_freeSegments(&pSegments);
+    }
+    if (pCursor) {
+        synth_freeCursor(&pCursor);
+    }
+
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+
+    if (pChunks) {
+        free(pChunks);
+    }
+    if (pSegmented) {
+        free(pSegmented);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
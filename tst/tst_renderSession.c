@@ -0,0 +1,126 @@
+/**
+ * Test that a song rendered through a session is exactly the same as the one
+ * rendered by the context, and that sessions don't affect each other
+ *
+ * @file tst/tst_renderSession.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fixture.h"
+
+
+/**
+ * Render a song through a new session and compare it against the expected one
+ *
+ * @param  [ in]pExpected The song rendered by the context
+ * @param  [ in]pTmp      Temporary buffer, as large as the song
+ * @param  [ in]len       The song's length, in bytes
+ * @param  [ in]pCtx      The synthesizer context
+ * @param  [ in]handle    Handle of the song
+ * @param  [ in]pName     Name of the session, for logging
+ * @return                SYNTH_OK, SYNTH_INTERNAL_ERR, ...
+ */
+static synth_err checkSession(char *pExpected, char *pTmp, int len,
+        synthCtx *pCtx, int handle, char *pName) {
+    char *pRendered;
+    synthSession *pSession;
+    synth_err rv;
+
+    pRendered = 0;
+    pSession = 0;
+
+    rv = synth_initSession(&pSession, pCtx, FIXTURE_NOISE_SEED);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    pRendered = (char*)malloc(len);
+    SYNTH_ASSERT_ERR(pRendered, SYNTH_MEM_ERR);
+
+    rv = synth_renderSongSession(pRendered, pSession, handle,
+            SYNTH_2CHAN_16BITS, pTmp);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = fixture_checkSong(pExpected, len, pRendered, len, pName,
+            "the context's one");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    if (pSession) {
+        synth_freeSession(&pSession);
+    }
+    if (pRendered) {
+        free(pRendered);
+    }
+
+    return rv;
+}
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pSong, *pTmp;
+    int handle, len;
+    synthCtx *pCtx;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pCtx = 0;
+    pSong = 0;
+    pTmp = 0;
+
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, 44100);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_setNoiseSeed(pCtx, FIXTURE_NOISE_SEED);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    printf("Compiling static song '%s'...\n", FIXTURE_SONG);
+    rv = synth_compileSongFromStringStatic(&handle, pCtx, FIXTURE_SONG);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    printf("Rendering the song on the context...\n");
+    rv = fixture_renderSong(&pSong, &len, pCtx, handle, SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    pTmp = (char*)malloc(len);
+    SYNTH_ASSERT_ERR(pTmp, SYNTH_MEM_ERR);
+
+    /* Render it twice, each time through a new session, so the second one
+     * would catch anything left behind by the first */
+    printf("Rendering the song through two sessions, one after the other...\n");
+    rv = checkSession(pSong, pTmp, len, pCtx, handle, "first session");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = checkSession(pSong, pTmp, len, pCtx, handle, "second session");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+
+    if (pSong) {
+        free(pSong);
+    }
+    if (pTmp) {
+        free(pTmp);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
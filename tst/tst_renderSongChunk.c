@@ -0,0 +1,363 @@
+/**
+ * Simple test to render a song in chunks, as an audio callback would do
+ * 
+ * @file tst/tst_renderSongChunk.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Simple test song */
+static char __song[] = "MML t90 l16 o5 e e8 e r c e r g4 > g4 < $ [ e8 c8 g4 > g2 < ]2";
+
+/**
+ * Entry point
+ * 
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pChunks, *pSong, *pSrc, *pTmp;
+    int chunk, diff, freq, handle, i, intro, isFile, len, numBytes, num, pos,
+            total;
+    synthBufMode mode;
+    synthCtx *pCtx;
+    synthCursor *pCursor;
+    synth_err rv;
+
+    /* Clean the context, so it's not freed on error */
+    pCtx = 0;
+    pCursor = 0;
+    pChunks = 0;
+    pSong = 0;
+    pTmp = 0;
+
+    /* Store the default frequency */
+    freq = 44100;
+    /* Store the default mode */
+    mode = SYNTH_1CHAN_U8BITS;
+    /* Store the default chunk size (in samples) */
+    chunk = 1024;
+    isFile = 0;
+    pSrc = 0;
+    len = 0;
+    /* Check argc/argv */
+    if (argc > 1) {
+        int i;
+
+        i = 1;
+        while (i < argc) {
+#define IS_PARAM(l_cmd, s_cmd) \
+  if (strcmp(argv[i], l_cmd) == 0 || strcmp(argv[i], s_cmd) == 0)
+            IS_PARAM("--string", "-s") {
+                if (argc <= i + 1) {
+                    printf("Expected parameter but got nothing! Run "
+                            "'tst_renderSongChunk --help' for usage!\n");
+                    return 1;
+                }
+
+                /* Store the string and retrieve its length */
+                pSrc = argv[i + 1];
+                isFile = 0;
+                len = strlen(argv[i + 1]);
+            }
+            IS_PARAM("--file", "-f") {
+                if (argc <= i + 1) {
+                    printf("Expected parameter but got nothing! Run "
+                            "'tst_renderSongChunk --help' for usage!\n");
+                    return 1;
+                }
+
+                /* Store the filename */
+                pSrc = argv[i + 1];
+                isFile = 1;
+            }
+            IS_PARAM("--frequency", "-F") {
+                char *pNum;
+                int tmp;
+
+                if (argc <= i + 1) {
+                    printf("Expected parameter but got nothing! Run "
+                            "'tst_renderSongChunk --help' for usage!\n");
+                    return 1;
+                }
+
+                pNum = argv[i + 1];
+
+                tmp = 0;
+
+                while (*pNum != '\0') {
+                    tmp = tmp * 10 + (*pNum) - '0';
+                    pNum++;
+                }
+
+                freq = tmp;
+            }
+            IS_PARAM("--mode", "-m") {
+                char *pMode;
+
+                if (argc <= i + 1) {
+                    printf("Expected parameter but got nothing! Run "
+                            "'tst_renderSongChunk --help' for usage!\n");
+                    return 1;
+                }
+
+                pMode = argv[i + 1];
+
+                if (strcmp(pMode, "1chan-u8") == 0) {
+                    mode = SYNTH_1CHAN_U8BITS;
+                }
+                else if (strcmp(pMode, "1chan-8") == 0) {
+                    mode = SYNTH_1CHAN_8BITS;
+                }
+                else if (strcmp(pMode, "1chan-u16") == 0) {
+                    mode = SYNTH_1CHAN_U16BITS;
+                }
+                else if (strcmp(pMode, "1chan-16") == 0) {
+                    mode = SYNTH_1CHAN_16BITS;
+                }
+                else if (strcmp(pMode, "2chan-u8") == 0) {
+                    mode = SYNTH_2CHAN_U8BITS;
+                }
+                else if (strcmp(pMode, "2chan-8") == 0) {
+                    mode = SYNTH_2CHAN_8BITS;
+                }
+                else if (strcmp(pMode, "2chan-u16") == 0) {
+                    mode = SYNTH_2CHAN_U16BITS;
+                }
+                else if (strcmp(pMode, "2chan-16") == 0) {
+                    mode = SYNTH_2CHAN_16BITS;
+                }
+                else {
+                    printf("Invalid mode! Run 'tst_renderSongChunk --help' to "
+                            "check the usage!\n");
+                    return 1;
+                }
+            }
+            IS_PARAM("--chunk", "-c") {
+                char *pNum;
+                int tmp;
+
+                if (argc <= i + 1) {
+                    printf("Expected parameter but got nothing! Run "
+                            "'tst_renderSongChunk --help' for usage!\n");
+                    return 1;
+                }
+
+                pNum = argv[i + 1];
+
+                tmp = 0;
+
+                while (*pNum != '\0') {
+                    tmp = tmp * 10 + (*pNum) - '0';
+                    pNum++;
+                }
+
+                chunk = tmp;
+            }
+            IS_PARAM("--help", "-h") {
+                printf("A simple test for the c_synth library\n"
+                        "\n"
+                        "Usage: tst_renderSongChunk [--string | -s \"the song\"] "
+                            "[--file | -f <file>]\n"
+                        "                           [--frequency | -F <freq>] "
+                            "[--mode | -m <mode>] \n"
+                        "                           [--chunk | -c <samples>] "
+                            "[--help | -h]\n"
+                        "\n"
+                        "Compiles a single song and then render it in chunks, "
+                            "checking it against\n"
+                        "itself. Looping songs are rendered twice.\n"
+                        "'<mode>' must be one of the following:\n"
+                        "  1chan-u8 : 1 channel, unsigned  8 bits samples\n"
+                        "  1chan-8  : 1 channel,   signed  8 bits samples\n"
+                        "  1chan-u16: 1 channel, unsigned 16 bits samples\n"
+                        "  1chan-16 : 1 channel,   signed 16 bits samples\n"
+                        "  2chan-u8 : 2 channel, unsigned  8 bits samples\n"
+                        "  2chan-8  : 2 channel,   signed  8 bits samples\n"
+                        "  2chan-u16: 2 channel, unsigned 16 bits samples\n"
+                        "  2chan-16 : 2 channel,   signed 16 bits samples\n"
+                        "\n"
+                        "If no argument is passed, it will compile a simple "
+                            "test song.\n");
+                return 0;
+            }
+
+            i += 2;
+#undef IS_PARAM
+        }
+    }
+
+    /* Initialize it */
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, freq);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Compile a song */
+    if (pSrc != 0) {
+        if (isFile) {
+            printf("Compiling song from file '%s'...\n", pSrc);
+            rv = synth_compileSongFromFile(&handle, pCtx, pSrc);
+        }
+        else {
+            printf("Compiling song '%s'...\n", pSrc);
+            rv = synth_compileSongFromString(&handle, pCtx, pSrc, len);
+        }
+    }
+    else {
+        printf("Compiling static song '%s'...\n", __song);
+        rv = synth_compileSongFromStringStatic(&handle, pCtx, __song);
+    }
+
+    if (rv != SYNTH_OK) {
+        char *pError;
+        synth_err irv;
+
+        /* Retrieve and print the error */
+        irv = synth_getCompilerErrorString(&pError, pCtx);
+        SYNTH_ASSERT_ERR(irv == SYNTH_OK, irv);
+
+        printf("%s", pError);
+    }
+    else {
+        printf("Song compiled successfully!\n");
+    }
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    SYNTH_ASSERT_ERR(chunk > 0, SYNTH_BAD_PARAM_ERR);
+
+    /* Get the number of tracks in the song */
+    rv = synth_getAudioTrackCount(&num, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Found %i tracks\n", num);
+
+    /* Retrieve the song's length and loop point */
+    rv = synth_getSongLength(&len, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_getSongIntroLength(&intro, pCtx, handle);
+    if (rv == SYNTH_NOT_LOOPABLE) {
+        intro = len;
+    }
+    else {
+        SYNTH_ASSERT(rv == SYNTH_OK);
+    }
+    printf("Song requires %i samples and loops at %i\n", len, intro);
+
+    /* Retrieve the number of bytes required */
+    numBytes = 1;
+    if (mode & SYNTH_16BITS) {
+        numBytes = 2;
+    }
+    if (mode & SYNTH_2CHAN) {
+        numBytes *= 2;
+    }
+
+    /* Render the complete song, to check the chunks against it */
+    printf("Rendering the complete song...\n");
+    pSong = (char*)malloc(len * numBytes);
+    SYNTH_ASSERT_ERR(pSong, SYNTH_MEM_ERR);
+    pTmp = (char*)malloc(len * numBytes);
+    SYNTH_ASSERT_ERR(pTmp, SYNTH_MEM_ERR);
+    rv = synth_renderSong(pSong, pCtx, handle, mode, pTmp);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Render the song (and its loop, if any) in chunks */
+    total = len + (len - intro);
+    printf("Rendering %i samples in chunks of %i samples...\n", total, chunk);
+    pChunks = (char*)malloc((total + chunk) * numBytes);
+    SYNTH_ASSERT_ERR(pChunks, SYNTH_MEM_ERR);
+
+    rv = synth_initCursor(&pCursor, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    pos = 0;
+    while (pos < total) {
+        rv = synth_renderSongChunk(pChunks + pos * numBytes, pCtx, handle,
+                pCursor, chunk, mode);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        pos += chunk;
+    }
+    rv = synth_getCursorPosition(&i, pCursor);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    SYNTH_ASSERT_ERR(i == pos, SYNTH_INTERNAL_ERR);
+
+    /* Render it again, one sample at a time, and check that the chunks' size
+     * doesn't modify the output (noises included, since they are generated
+     * from each sample's position) */
+    printf("Rendering it again, one sample at a time...\n");
+    rv = synth_resetCursor(pCursor, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    diff = 0;
+    pos = 0;
+    while (pos < total) {
+        rv = synth_renderSongChunk(pTmp, pCtx, handle, pCursor, 1, mode);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        if (memcmp(pTmp, pChunks + pos * numBytes, numBytes) != 0) {
+            diff++;
+        }
+
+        pos++;
+    }
+    printf("Found %i mismatched samples (of %i)\n", diff, total);
+    SYNTH_ASSERT_ERR(diff == 0, SYNTH_INTERNAL_ERR);
+
+    /* A single looping track must simply repeat its loop */
+    if (num == 1 && len != intro) {
+        if (memcmp(pChunks + intro * numBytes, pChunks + len * numBytes,
+                (len - intro) * numBytes) == 0) {
+            printf("The song's loop was correctly repeated\n");
+        }
+        else {
+            printf("The song's loop was modified when repeated\n");
+        }
+    }
+
+    /* Compare the chunks against the complete song; Since overflowing samples
+     * are mixed differently, this is merely informative */
+    diff = 0;
+    i = 0;
+    while (i < len * numBytes) {
+        if (pSong[i] != pChunks[i]) {
+            diff++;
+        }
+
+        i++;
+    }
+    printf("Chunks differ from the complete song in %i bytes (of %i)\n", diff,
+            len * numBytes);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pCursor) {
+        synth_freeCursor(&pCursor);
+    }
+
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+
+    if (pChunks) {
+        free(pChunks);
+    }
+    if (pSong) {
+        free(pSong);
+    }
+    if (pTmp) {
+        free(pTmp);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
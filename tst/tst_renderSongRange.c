@@ -0,0 +1,262 @@
+/**
+ * Simple test to render a song starting at arbitrary samples, as an editor
+ * seeking through it would do
+ *
+ * @file tst/tst_renderSongRange.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Simple test song */
+static char __song[] = "MML t90 l16 o5 e e8 e r c e r g4 > g4 < $ [ e8 c8 g4 > g2 < ]2";
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pRange, *pSrc, *pTmp;
+    int diff, freq, handle, i, intro, isFile, len, numBytes, num, total;
+    unsigned int seed;
+    synthBufMode mode;
+    synthCtx *pCtx;
+    synth_err rv;
+
+    /* Clean the context, so it's not freed on error */
+    pCtx = 0;
+    pRange = 0;
+    pTmp = 0;
+
+    /* Store the default frequency */
+    freq = 44100;
+    /* Store the default mode */
+    mode = SYNTH_1CHAN_U8BITS;
+    isFile = 0;
+    pSrc = 0;
+    len = 0;
+    /* Check argc/argv */
+    if (argc > 1) {
+        int i;
+
+        i = 1;
+        while (i < argc) {
+#define IS_PARAM(l_cmd, s_cmd) \
+  if (strcmp(argv[i], l_cmd) == 0 || strcmp(argv[i], s_cmd) == 0)
+            IS_PARAM("--string", "-s") {
+                if (argc <= i + 1) {
+                    printf("Expected parameter but got nothing! Run "
+                            "'tst_renderSongRange --help' for usage!\n");
+                    return 1;
+                }
+
+                /* Store the string and retrieve its length */
+                pSrc = argv[i + 1];
+                isFile = 0;
+                len = strlen(argv[i + 1]);
+            }
+            IS_PARAM("--file", "-f") {
+                if (argc <= i + 1) {
+                    printf("Expected parameter but got nothing! Run "
+                            "'tst_renderSongRange --help' for usage!\n");
+                    return 1;
+                }
+
+                /* Store the filename */
+                pSrc = argv[i + 1];
+                isFile = 1;
+            }
+            IS_PARAM("--mode", "-m") {
+                char *pMode;
+
+                if (argc <= i + 1) {
+                    printf("Expected parameter but got nothing! Run "
+                            "'tst_renderSongRange --help' for usage!\n");
+                    return 1;
+                }
+
+                pMode = argv[i + 1];
+
+                if (strcmp(pMode, "1chan-u8") == 0) {
+                    mode = SYNTH_1CHAN_U8BITS;
+                }
+                else if (strcmp(pMode, "1chan-16") == 0) {
+                    mode = SYNTH_1CHAN_16BITS;
+                }
+                else if (strcmp(pMode, "2chan-u8") == 0) {
+                    mode = SYNTH_2CHAN_U8BITS;
+                }
+                else if (strcmp(pMode, "2chan-16") == 0) {
+                    mode = SYNTH_2CHAN_16BITS;
+                }
+                else {
+                    printf("Invalid mode! Run 'tst_renderSongRange --help' to "
+                            "check the usage!\n");
+                    return 1;
+                }
+            }
+            IS_PARAM("--help", "-h") {
+                printf("A simple test for the c_synth library\n"
+                        "\n"
+                        "Usage: tst_renderSongRange [--string | -s \"the song\"] "
+                            "[--file | -f <file>]\n"
+                        "                           [--mode | -m <mode>] "
+                            "[--help | -h]\n"
+                        "\n"
+                        "Compiles a single song, renders it (and its loop) "
+                            "at once and then checks\n"
+                        "that ranges starting at arbitrary samples match it.\n"
+                        "'<mode>' must be one of the following:\n"
+                        "  1chan-u8 : 1 channel, unsigned  8 bits samples\n"
+                        "  1chan-16 : 1 channel,   signed 16 bits samples\n"
+                        "  2chan-u8 : 2 channel, unsigned  8 bits samples\n"
+                        "  2chan-16 : 2 channel,   signed 16 bits samples\n"
+                        "\n"
+                        "If no argument is passed, it will compile a simple "
+                            "test song.\n");
+                return 0;
+            }
+
+            i += 2;
+#undef IS_PARAM
+        }
+    }
+
+    /* Initialize it */
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, freq);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Compile a song */
+    if (pSrc != 0) {
+        if (isFile) {
+            printf("Compiling song from file '%s'...\n", pSrc);
+            rv = synth_compileSongFromFile(&handle, pCtx, pSrc);
+        }
+        else {
+            printf("Compiling song '%s'...\n", pSrc);
+            rv = synth_compileSongFromString(&handle, pCtx, pSrc, len);
+        }
+    }
+    else {
+        printf("Compiling static song '%s'...\n", __song);
+        rv = synth_compileSongFromStringStatic(&handle, pCtx, __song);
+    }
+
+    if (rv != SYNTH_OK) {
+        char *pError;
+        synth_err irv;
+
+        /* Retrieve and print the error */
+        irv = synth_getCompilerErrorString(&pError, pCtx);
+        SYNTH_ASSERT_ERR(irv == SYNTH_OK, irv);
+
+        printf("%s", pError);
+    }
+    else {
+        printf("Song compiled successfully!\n");
+    }
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Get the number of tracks in the song */
+    rv = synth_getAudioTrackCount(&num, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Found %i tracks\n", num);
+
+    /* Retrieve the song's length and loop point */
+    rv = synth_getSongLength(&len, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_getSongIntroLength(&intro, pCtx, handle);
+    if (rv == SYNTH_NOT_LOOPABLE) {
+        intro = len;
+    }
+    else {
+        SYNTH_ASSERT(rv == SYNTH_OK);
+    }
+    printf("Song requires %i samples and loops at %i\n", len, intro);
+
+    /* Retrieve the number of bytes required */
+    numBytes = 1;
+    if (mode & SYNTH_16BITS) {
+        numBytes = 2;
+    }
+    if (mode & SYNTH_2CHAN) {
+        numBytes *= 2;
+    }
+
+    /* Render the song (and its loop, if any) as a single range */
+    total = len + (len - intro);
+    printf("Rendering %i samples at once...\n", total);
+    pRange = (char*)malloc(total * numBytes + 1);
+    SYNTH_ASSERT_ERR(pRange, SYNTH_MEM_ERR);
+    pTmp = (char*)malloc(total * numBytes + 1);
+    SYNTH_ASSERT_ERR(pTmp, SYNTH_MEM_ERR);
+    rv = synth_renderSongRange(pRange, pCtx, handle, 0, total, mode);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* A single track must match the track rendered by itself */
+    if (num == 1) {
+        rv = synth_renderTrack(pTmp, pCtx, handle, 0, mode);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        diff = memcmp(pTmp, pRange, len * numBytes);
+        printf("The range %s the rendered track\n", diff ? "differs from" :
+                "matches");
+        SYNTH_ASSERT_ERR(diff == 0, SYNTH_INTERNAL_ERR);
+    }
+
+    /* Render many ranges, starting anywhere (even in the middle of notes), and
+     * check that they match the previous render */
+    printf("Rendering ranges at arbitrary samples...\n");
+    diff = 0;
+    seed = 1;
+    i = 0;
+    while (i < 256) {
+        int count, start;
+
+        /* Simple LCG, so the ranges are always the same */
+        seed = seed * 1103515245 + 12345;
+        start = (int)((seed >> 8) % (unsigned int)total);
+        seed = seed * 1103515245 + 12345;
+        count = 1 + (int)((seed >> 8) % (unsigned int)(total - start));
+
+        rv = synth_renderSongRange(pTmp, pCtx, handle, start, count, mode);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+
+        if (memcmp(pTmp, pRange + start * numBytes, count * numBytes) != 0) {
+            diff++;
+        }
+
+        i++;
+    }
+    printf("Found %i mismatched ranges (of %i)\n", diff, i);
+    SYNTH_ASSERT_ERR(diff == 0, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+
+    if (pRange) {
+        free(pRange);
+    }
+    if (pTmp) {
+        free(pTmp);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
@@ -0,0 +1,168 @@
+/**
+ * Test that rendering a song on many threads gives exactly the same output as
+ * rendering it on a single one, even when there are more tracks than threads,
+ * and that the notes rendered by every thread are kept on the context's cache
+ *
+ * @file tst/tst_renderThreads.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fixture.h"
+
+/* Song with more tracks than threads, of different lengths and waves */
+static char __manyTracks[] = "MML t120 l8 o4 "
+        "c d e f g a b > c ; "
+        "w1 o3 v40 c4 e4 g4 > c4 ; "
+        "w2 p20 o5 [ c e g e ]4 ; "
+        "w3 v(80, 20) o2 c2 g2 c1 ; "
+        "w5 q50 o3 c c c c c c c c ; "
+        "w4 k20 h60 p70 o4 e g e g e g e g";
+
+/* How many threads are used to render the songs */
+#define NUM_THREADS 4
+/* Size of the context's cache, large enough for every note of the songs */
+#define CACHE_SIZE  (4 * 1024 * 1024)
+
+/**
+ * Compile a song and check that it's rendered the same on one and on many
+ * threads
+ *
+ * The song is first rendered on many threads with an empty cache, so it must
+ * be filled by the threads (without growing past its size); Rendering it
+ * again must then copy most notes from the cache (each thread only keeps its
+ * share of the cache, so a few notes may still be missed)
+ *
+ * @param  [ in]pCtx  The synthesizer context
+ * @param  [ in]pSong The song
+ * @return            SYNTH_OK, SYNTH_INTERNAL_ERR, ...
+ */
+static synth_err checkSong(synthCtx *pCtx, char *pSong) {
+    char *pCached, *pSingle, *pThreaded;
+    int bytes, cached, handle, hits, misses, num, prevHits, prevMisses, single;
+    int threaded;
+    synth_err rv;
+
+    pCached = 0;
+    pSingle = 0;
+    pThreaded = 0;
+
+    printf("Compiling song '%s'...\n", pSong);
+    rv = synth_compileSongFromString(&handle, pCtx, pSong, strlen(pSong));
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getAudioTrackCount(&num, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    /* Resizing the cache releases every note kept by the previous song */
+    rv = synth_setNoteCacheSize(pCtx, CACHE_SIZE);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    printf("Rendering its %i tracks on %i threads...\n", num, NUM_THREADS);
+    rv = synth_setRenderThreads(pCtx, NUM_THREADS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_renderSong(&pThreaded, &threaded, pCtx, handle,
+            SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getNoteCacheStats(&hits, &misses, &bytes, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Cache: %i hits, %i misses, %i bytes\n", hits, misses, bytes);
+    SYNTH_ASSERT_ERR(misses > 0, SYNTH_INTERNAL_ERR);
+    SYNTH_ASSERT_ERR(bytes > 0 && bytes <= CACHE_SIZE, SYNTH_INTERNAL_ERR);
+
+    printf("Rendering it again on %i threads...\n", NUM_THREADS);
+    prevHits = hits;
+    prevMisses = misses;
+    rv = fixture_renderSong(&pCached, &cached, pCtx, handle,
+            SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getNoteCacheStats(&hits, &misses, &bytes, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Cache: %i hits, %i misses, %i bytes\n", hits, misses, bytes);
+    SYNTH_ASSERT_ERR(hits > prevHits, SYNTH_INTERNAL_ERR);
+    SYNTH_ASSERT_ERR(misses - prevMisses < prevMisses, SYNTH_INTERNAL_ERR);
+    SYNTH_ASSERT_ERR(bytes <= CACHE_SIZE, SYNTH_INTERNAL_ERR);
+
+    printf("Rendering its %i tracks on a single thread...\n", num);
+    rv = synth_setRenderThreads(pCtx, 1);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_renderSong(&pSingle, &single, pCtx, handle,
+            SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = fixture_checkSong(pSingle, single, pThreaded, threaded,
+            "threaded song", "the single-threaded one");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_checkSong(pSingle, single, pCached, cached,
+            "cached threaded song", "the single-threaded one");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    if (pCached) {
+        free(pCached);
+    }
+    if (pSingle) {
+        free(pSingle);
+    }
+    if (pThreaded) {
+        free(pThreaded);
+    }
+
+    return rv;
+}
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    synthCtx *pCtx;
+    synth_err rv;
+
+    /* Clean the context, so it's not freed on error */
+    pCtx = 0;
+
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, 44100);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_setNoiseSeed(pCtx, FIXTURE_NOISE_SEED);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_setRenderThreads(pCtx, NUM_THREADS);
+    if (rv == SYNTH_FUNCTION_NOT_IMPLEMENTED) {
+        printf("The library was built without threads support\n");
+        rv = SYNTH_OK;
+        goto __err;
+    }
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = checkSong(pCtx, FIXTURE_SONG);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = checkSong(pCtx, __manyTracks);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
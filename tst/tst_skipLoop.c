@@ -0,0 +1,94 @@
+/**
+ * Test that a loop played 0 times is skipped, along with every loop within it,
+ * so the song is rendered exactly as if the loop weren't there
+ *
+ * @file tst/tst_skipLoop.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fixture.h"
+
+/* Song with skipped loops (one with nested loops and one that's a whole
+ * track) between and around its notes */
+static char __skipped[] = "MML t120 l4 o4 c d e f "
+        "[ g a b > c < [ c d e f ]3 ]0 $ [ c d e f ]2 [ g g g g ]0 ; "
+        "w2 [ g g g g ]0 c d e f ; "
+        "w3 [ e e e e ]0";
+
+/* The same song, without the skipped loops */
+static char __expected[] = "MML t120 l4 o4 c d e f $ [ c d e f ]2 ; "
+        "w2 c d e f";
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    char *pExpected, *pSkipped;
+    int expected, handle, intro, otherHandle, otherIntro, skipped;
+    synthCtx *pCtx;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pCtx = 0;
+    pExpected = 0;
+    pSkipped = 0;
+
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, 44100);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    printf("Compiling song '%s'...\n", __skipped);
+    rv = synth_compileSongFromStringStatic(&handle, pCtx, __skipped);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Compiling song '%s'...\n", __expected);
+    rv = synth_compileSongFromStringStatic(&otherHandle, pCtx, __expected);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = synth_getSongIntroLength(&intro, pCtx, handle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = synth_getSongIntroLength(&otherIntro, pCtx, otherHandle);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("The songs loop at %i and at %i\n", intro, otherIntro);
+    SYNTH_ASSERT_ERR(intro == otherIntro, SYNTH_INTERNAL_ERR);
+
+    rv = fixture_renderSong(&pSkipped, &skipped, pCtx, handle,
+            SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    rv = fixture_renderSong(&pExpected, &expected, pCtx, otherHandle,
+            SYNTH_2CHAN_16BITS);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = fixture_checkSong(pExpected, expected, pSkipped, skipped,
+            "song with skipped loops", "the one without them");
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+
+    if (pExpected) {
+        free(pExpected);
+    }
+    if (pSkipped) {
+        free(pSkipped);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}
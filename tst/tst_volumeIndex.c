@@ -0,0 +1,226 @@
+/**
+ * Test that the index of volumes finds every volume after many of them
+ * collided and after it grew past its initial size, and that a static
+ * context's index is never expanded (even after its list of volumes is full)
+ *
+ * @file tst/tst_volumeIndex.c
+ */
+#include <c_synth/synth.h>
+#include <c_synth/synth_assert.h>
+#include <c_synth/synth_errors.h>
+
+#include <c_synth_internal/synth_list.h>
+#include <c_synth_internal/synth_types.h>
+#include <c_synth_internal/synth_volume.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* How many volumes are created on the dynamic context */
+#define NUM_DYNAMIC 2000
+/* How many volumes fit the static context */
+#define MAX_VOLUMES 40
+
+/**
+ * Calculate a volume's hash, exactly as 'src/synth_volume.c' does
+ *
+ * @param  [ in]ini The initial amplitude (already as a 16 bits value)
+ * @param  [ in]fin The final amplitude (already as a 16 bits value)
+ * @return          The volume's hash
+ */
+static unsigned int getHash(int ini, int fin) {
+    unsigned int hash;
+
+    hash = ((unsigned int)ini * 0x9e3779b1u) ^
+            ((unsigned int)fin * 0x85ebca77u);
+    return hash ^ (hash >> 16);
+}
+
+/**
+ * Retrieve the k-th volume; Every k (up to 129 * 129) gives another volume
+ *
+ * @param  [out]pVol The index of the volume
+ * @param  [ in]pCtx The synthesizer context
+ * @param  [ in]k    Which volume should be retrieved
+ * @return           SYNTH_OK, SYNTH_MEM_ERR, ...
+ */
+static synth_err getVolume(int *pVol, synthCtx *pCtx, int k) {
+    return synthVolume_getLinear(pVol, pCtx, k % 129, (k / 129 + k) % 129);
+}
+
+/**
+ * Check that the index has room for another volume and that every volume is
+ * on it exactly once, and count how many volumes collided (i.e., aren't on
+ * the slot given by their hash)
+ *
+ * @param  [out]pCollisions How many volumes collided
+ * @param  [ in]pCtx        The synthesizer context
+ * @return                  SYNTH_OK, SYNTH_INTERNAL_ERR
+ */
+static synth_err checkIndex(int *pCollisions, synthCtx *pCtx) {
+    int i, len, num;
+    synth_err rv;
+
+    len = pCtx->volumeIndexLen;
+    SYNTH_ASSERT_ERR(len > 0 && (len & (len - 1)) == 0, SYNTH_INTERNAL_ERR);
+    SYNTH_ASSERT_ERR(pCtx->volumes.used * 2 <= len, SYNTH_INTERNAL_ERR);
+
+    *pCollisions = 0;
+    num = 0;
+    i = 0;
+    while (i < len) {
+        int vol;
+
+        vol = pCtx->pVolumeIndex[i];
+        if (vol != -1) {
+            synthVolume *pVolume;
+
+            SYNTH_ASSERT_ERR(vol >= 0 && vol < pCtx->volumes.used,
+                    SYNTH_INTERNAL_ERR);
+            pVolume = SYNTH_VOLUME(pCtx, vol);
+            if ((getHash(pVolume->ini, pVolume->fin) & (len - 1)) !=
+                    (unsigned int)i) {
+                (*pCollisions)++;
+            }
+            num++;
+        }
+        i++;
+    }
+    SYNTH_ASSERT_ERR(num == pCtx->volumes.used, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    return rv;
+}
+
+/**
+ * Create a few volumes and retrieve them again, checking that each retrieval
+ * gave the volume first created (and that no other volume was created)
+ *
+ * @param  [ in]pCtx The synthesizer context
+ * @param  [ in]num  How many volumes should be created
+ * @return           SYNTH_OK, SYNTH_INTERNAL_ERR, ...
+ */
+static synth_err checkVolumes(synthCtx *pCtx, int num) {
+    int *pHandles;
+    int i, used, vol;
+    synth_err rv;
+
+    pHandles = (int*)malloc(num * sizeof(int));
+    SYNTH_ASSERT_ERR(pHandles, SYNTH_MEM_ERR);
+
+    i = 0;
+    while (i < num) {
+        rv = getVolume(&(pHandles[i]), pCtx, i);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        i++;
+    }
+    used = pCtx->volumes.used;
+
+    /* Retrieve them backward, so the last ones are searched first */
+    i = num - 1;
+    while (i >= 0) {
+        rv = getVolume(&vol, pCtx, i);
+        SYNTH_ASSERT(rv == SYNTH_OK);
+        SYNTH_ASSERT_ERR(vol == pHandles[i], SYNTH_INTERNAL_ERR);
+        i--;
+    }
+    SYNTH_ASSERT_ERR(pCtx->volumes.used == used, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    if (pHandles) {
+        free(pHandles);
+    }
+
+    return rv;
+}
+
+/**
+ * Entry point
+ *
+ * @param  [ in]argc Number of arguments
+ * @param  [ in]argv List of arguments
+ * @return           The exit code
+ */
+int main(int argc, char *argv[]) {
+    void *pMem;
+    int *pIndex;
+    int collisions, len, num, size, vol;
+    synthCtx *pCtx, *pStaticCtx;
+    synth_err rv;
+
+    /* Clean everything, so it's not freed on error */
+    pCtx = 0;
+    pStaticCtx = 0;
+    pMem = 0;
+
+    printf("Initialize the synthesizer...\n");
+    rv = synth_init(&pCtx, 44100);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    len = pCtx->volumeIndexLen;
+
+    printf("Creating %i volumes on an index with %i slots...\n", NUM_DYNAMIC,
+            len);
+    rv = checkVolumes(pCtx, NUM_DYNAMIC);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = checkIndex(&collisions, pCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("The index grew to %i slots; %i of its %i volumes collided\n",
+            pCtx->volumeIndexLen, collisions, pCtx->volumes.used);
+    SYNTH_ASSERT_ERR(pCtx->volumeIndexLen > len, SYNTH_INTERNAL_ERR);
+    SYNTH_ASSERT_ERR(collisions > 0, SYNTH_INTERNAL_ERR);
+
+    /* A static context's index is carved from its memory, sized for all of
+     * its volumes */
+    rv = synth_getStaticContextSize(&size, 1, 1, 1, MAX_VOLUMES);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    pMem = malloc(size);
+    SYNTH_ASSERT_ERR(pMem, SYNTH_MEM_ERR);
+    rv = synth_initStatic(&pStaticCtx, pMem, 44100, 1, 1, 1, MAX_VOLUMES);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    pIndex = pStaticCtx->pVolumeIndex;
+    len = pStaticCtx->volumeIndexLen;
+
+    num = MAX_VOLUMES - pStaticCtx->volumes.used;
+    printf("Filling a static context with %i volumes...\n", num);
+    rv = checkVolumes(pStaticCtx, num);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+
+    rv = checkIndex(&collisions, pStaticCtx);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    printf("Its index has %i slots; %i of its %i volumes collided\n",
+            pStaticCtx->volumeIndexLen, collisions, pStaticCtx->volumes.used);
+    SYNTH_ASSERT_ERR(pStaticCtx->pVolumeIndex == pIndex, SYNTH_INTERNAL_ERR);
+    SYNTH_ASSERT_ERR(pStaticCtx->volumeIndexLen == len, SYNTH_INTERNAL_ERR);
+
+    /* Another volume doesn't fit, but the existing ones are still found */
+    printf("Creating another volume on the full context...\n");
+    rv = getVolume(&vol, pStaticCtx, num);
+    SYNTH_ASSERT_ERR(rv == SYNTH_MEM_ERR, SYNTH_INTERNAL_ERR);
+    rv = checkVolumes(pStaticCtx, num);
+    SYNTH_ASSERT(rv == SYNTH_OK);
+    SYNTH_ASSERT_ERR(pStaticCtx->pVolumeIndex == pIndex, SYNTH_INTERNAL_ERR);
+    SYNTH_ASSERT_ERR(pStaticCtx->volumeIndexLen == len, SYNTH_INTERNAL_ERR);
+
+    rv = SYNTH_OK;
+__err:
+    if (rv != SYNTH_OK) {
+        printf("An error happened!\n");
+    }
+
+    if (pCtx) {
+        printf("Releasing resources used by the lib...\n");
+        synth_free(&pCtx);
+    }
+    if (pStaticCtx) {
+        synth_free(&pStaticCtx);
+    }
+    if (pMem) {
+        free(pMem);
+    }
+
+    printf("Exiting...\n");
+    return rv;
+}